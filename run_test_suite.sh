@@ -2,6 +2,38 @@
 
 cp cme.ini cme.ini.OLD
 
+# The GIS and time series output of two test cases which differ only in the number of threads must be the same
+compare_thread_output()
+{
+   for FILE in out/test_suite/$1/*.tif out/test_suite/$1/*.shp out/test_suite/$1/*.csv
+   do
+      [ -f "$FILE" ] || continue
+      cmp -s "$FILE" "out/test_suite/$2/`basename "$FILE"`" || echo "ERROR: `basename "$FILE"` differs between $1 and $2"
+   done
+}
+
+# Runs a variant of the minimal_wave_angle_230 test case. The first argument is the name of the variant, each other argument overrides one item in minimal_wave_angle_230/minimal.dat and is given as "start of the item's description=new value". The variant's input data file is written to out/test_suite/<name>.dat
+run_minimal_variant()
+{
+   CASE=$1
+   shift
+
+   mkdir -p out/test_suite/$CASE/
+   rm -f out/test_suite/$CASE/*
+
+   cp in/test_suite/minimal_wave_angle_230/minimal.dat out/test_suite/$CASE.dat
+   for ITEM in "$@"
+   do
+      KEY=${ITEM%%=*}
+      VALUE=${ITEM#*=}
+      sed "s|^\($KEY[^:]*:\).*$|\1 $VALUE|" out/test_suite/$CASE.dat > out/test_suite/$CASE.dat.tmp
+      mv out/test_suite/$CASE.dat.tmp out/test_suite/$CASE.dat
+   done
+
+   sed -e "s|in/test_suite/minimal_wave_angle_230/minimal.dat|out/test_suite/$CASE.dat|" -e "s|out/test_suite/minimal_wave_angle_230/|out/test_suite/$CASE/|" in/test_suite/minimal_wave_angle_230/cme.ini > cme.ini
+   ./cme
+}
+
 mkdir -p out/test_suite/minimal_wave_angle_230/
 rm -f out/test_suite/minimal_wave_angle_230/*
 cp in/test_suite/minimal_wave_angle_230/cme.ini .
@@ -52,6 +84,40 @@ rm -f out/test_suite/minimal_with_sediment_input/*
 cp in/test_suite/minimal_with_sediment_input/cme.ini .
 ./cme
 
+# With flood lines. Checks that each coast's history survives the flood line tracing, so that it can be re-used next timestep
+run_minimal_variant minimal_check_flood_coast_history "GIS raster files to output=flood_setup_surge_mask flood_setup_surge_runup_mask" "Threads for end-of-timestep tasks=0" "Check optimised calculations=y"
+
+# Using CShore with two threads. Checks that the wave properties calculated for several profiles at once are the same as those calculated for one profile after another. With the re-entrant CShore library the two threads run CShore themselves, otherwise CShore is run by two CShore worker processes
+run_minimal_variant minimal_check_cshore_two_threads "Threads for end-of-timestep tasks=2" "Check optimised calculations=y"
+
+# Using CShore with one thread, so that CShore is run once for all the profiles on each coast. Checks that the wave properties are the same as those calculated by running CShore separately for each profile
+run_minimal_variant minimal_check_cshore_batches "Check optimised calculations=y"
+
+# Checks that filling wave calculation holes, and calculating polygon d50, in the active window only gives the same results as doing this over the whole grid
+run_minimal_variant minimal_check_active_window_hole_fill "Check optimised calculations=y" "If all cells have the same deep water waves=y"
+
+# With rising SWL. Checks that the sea mask, which is updated incrementally as cells are inundated, matches the sea mask found from scratch
+run_minimal_variant minimal_check_sea_mask "GIS raster files to output=sea_depth" "Final still water level=29.5" "Check optimised calculations=y"
+
+# With no sediment movement. Checks that the reused results of the last wave propagation match those of propagating waves again. The reuse tolerances are all zero, and since forcing, SWL and bathymetry do not change, the results are reused and checked
+run_minimal_variant minimal_check_wave_cache "GIS raster files to output=wave_height wave_orientation" "Simulate coast platform erosion?=n" "Simulate beach sediment transport?=n" "Simulate cliff collapse?=n" "Wave propagation reuse=3 0 0 0 0 0" "Check optimised calculations=y"
+
+# With flood lines, run with one thread. The output is compared with that of minimal_four_threads, which is the same except for the number of threads
+run_minimal_variant minimal_one_thread "GIS raster files to output=all" "Threads for end-of-timestep tasks=1"
+
+# With flood lines, run with four threads
+run_minimal_variant minimal_four_threads "GIS raster files to output=all" "Threads for end-of-timestep tasks=4"
+
+compare_thread_output minimal_one_thread minimal_four_threads
+
+# With flood lines, using COVE, run with one thread. The output is compared with that of minimal_cove_four_threads, which is the same except for the number of threads
+run_minimal_variant minimal_cove_one_thread "GIS raster files to output=all" "Wave propagation model=0" "Threads for end-of-timestep tasks=1"
+
+# With flood lines, using COVE, run with four threads
+run_minimal_variant minimal_cove_four_threads "GIS raster files to output=all" "Wave propagation model=0" "Threads for end-of-timestep tasks=4"
+
+compare_thread_output minimal_cove_one_thread minimal_cove_four_threads
+
 mkdir -p out/test_suite/Happisburgh/
 rm -f out/test_suite/Happisburgh/*
 cp in/test_suite/Happisburgh/cme.ini .
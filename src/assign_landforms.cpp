@@ -59,7 +59,7 @@ int CSimulation::nAssignAllCoastalLandforms(void)
          if (m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->nGetLFCategory() == LF_CAT_INTERVENTION || m_pRasterGrid->m_Cell[nX][nY].dGetInterventionHeight() > 0)
          {
             // There is, so create an intervention object on the vector coastline with these attributes
-            CACoastLandform* pIntervention = new CRWIntervention(&m_VCoast[nCoast], nCoast, j);
+            CACoastLandform* pIntervention = m_TimestepArena.pNew<CRWIntervention>(&m_VCoast[nCoast], nCoast, j);
             m_VCoast[nCoast].AppendCoastLandform(pIntervention);
 
 //             LogStream << j << " [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "} " << m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->nGetLFCategory() << " " << m_pRasterGrid->m_Cell[nX][nY].dGetInterventionHeight() << endl;
@@ -101,7 +101,7 @@ int CSimulation::nAssignAllCoastalLandforms(void)
                m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->SetCliffRemaining(m_dCellSide);
 
                // Create a cliff object on the vector coastline with these attributes
-               CACoastLandform* pCliff = new CRWCliff(&m_VCoast[nCoast], nCoast, j, m_dCellSide, 0, m_dThisIterSWL, 0);
+               CACoastLandform* pCliff = m_TimestepArena.pNew<CRWCliff>(&m_VCoast[nCoast], nCoast, j, m_dCellSide, 0, m_dThisIterSWL, 0);
                m_VCoast[nCoast].AppendCoastLandform(pCliff);
 
 //                LogStream << m_ulIter << ": CLIFF CREATED [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "}" << endl;
@@ -109,7 +109,7 @@ int CSimulation::nAssignAllCoastalLandforms(void)
             else
             {
                // First timestep: we have unconsolidated sediment at SWL, so this is a drift cell: create a drift object on the vector coastline with these attributes
-               CACoastLandform* pDrift = new CRWDrift(&m_VCoast[nCoast], nCoast, j);
+               CACoastLandform* pDrift = m_TimestepArena.pNew<CRWDrift>(&m_VCoast[nCoast], nCoast, j);
                m_VCoast[nCoast].AppendCoastLandform(pDrift);
 
                // Safety check
@@ -157,13 +157,13 @@ int CSimulation::nAssignAllCoastalLandforms(void)
                }
 
                // Create a cliff object on the vector coastline with these attributes
-               CACoastLandform* pCliff = new CRWCliff(&m_VCoast[nCoast], nCoast, j, m_dCellSide, dNotchDepth, dNotchBaseElev, dAccumWaveEnergy);
+               CACoastLandform* pCliff = m_TimestepArena.pNew<CRWCliff>(&m_VCoast[nCoast], nCoast, j, m_dCellSide, dNotchDepth, dNotchBaseElev, dAccumWaveEnergy);
                m_VCoast[nCoast].AppendCoastLandform(pCliff);
             }
             else
             {
                // We have unconsolidated sediment at SWL, so this is a drift cell: create a drift object on the vector coastline with these attributes
-               CACoastLandform* pDrift = new CRWDrift(&m_VCoast[nCoast], nCoast, j);
+               CACoastLandform* pDrift = m_TimestepArena.pNew<CRWDrift>(&m_VCoast[nCoast], nCoast, j);
                m_VCoast[nCoast].AppendCoastLandform(pDrift);
 
                // Safety check
@@ -330,11 +330,12 @@ int CSimulation::nLandformToGrid(int const nCoast, int const nPoint)
          if (nTopLayer == INT_NODATA)
             return RTN_ERR_NO_TOP_LAYER;
 
-         // Update the cell's layer elevations
+         // Update the cell's layer elevations, first telling the grid that this cell has changed
+         m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
          m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
 
          // And update the cell's sea depth
-         m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+         m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
       }
 
       // Always accumulate wave energy
@@ -355,41 +356,58 @@ int CSimulation::nLandformToGrid(int const nCoast, int const nPoint)
 //===============================================================================================================================
 int CSimulation::nAssignNonCoastlineLandforms(void)
 {
-   // Go through all cells in the RasterGrid array
-   for (int nX = 0; nX < m_nXGridMax; nX++)
+   // After the first timestep, only a cell which was on last timestep's coastline can need a change here. So do this timestep's active window (so far, this is just the coastline cells) plus last timestep's active window. In the first timestep every cell needs a landform: last timestep's active window is then the whole grid
+   int nXMin, nXEnd, nYMin, nYEnd;
+   GetActiveWindow(true, nXMin, nXEnd, nYMin, nYEnd);
+
+   // Go through the cells in the window, tile by tile. A uniform tile has had no coastline cells since its cells were last assigned a landform, so skip it
+   for (int nTile = 0; nTile < m_pRasterGrid->nGetNumTiles(); nTile++)
    {
-      for (int nY = 0; nY < m_nYGridMax; nY++)
+      CGeomGridTile const* pTile = m_pRasterGrid->pGetTile(nTile);
+      if (pTile->bIsUniform())
+         continue;
+
+      int
+         nTileXMin = tMax(pTile->nGetXMin(), nXMin),
+         nTileXEnd = tMin(pTile->nGetXEnd(), nXEnd),
+         nTileYMin = tMax(pTile->nGetYMin(), nYMin),
+         nTileYEnd = tMin(pTile->nGetYEnd(), nYEnd);
+
+      for (int nY = nTileYMin; nY < nTileYEnd; nY++)
       {
-         if (m_pRasterGrid->m_Cell[nX][nY].bBasementElevIsMissingValue())
-            continue;
+         for (int nX = nTileXMin; nX < nTileXEnd; nX++)
+         {
+            if (m_pRasterGrid->m_Cell[nX][nY].bBasementElevIsMissingValue())
+               continue;
 
-         CRWCellLandform* pLandform = m_pRasterGrid->m_Cell[nX][nY].pGetLandform();
-         int nCat = pLandform->nGetLFCategory();
+            CRWCellLandform* pLandform = m_pRasterGrid->m_Cell[nX][nY].pGetLandform();
+            int nCat = pLandform->nGetLFCategory();
 
-         if (nCat == LF_CAT_SEA)
-            // Do nothing
-            continue;
+            if (nCat == LF_CAT_SEA)
+               // Do nothing
+               continue;
 
-         // Ok, this is coast or inland
-         if (! m_pRasterGrid->m_Cell[nX][nY].bIsCoastline())
-         {
-            // Is not coastline
-            if (nCat == LF_CAT_CLIFF)
+            // Ok, this is coast or inland
+            if (! m_pRasterGrid->m_Cell[nX][nY].bIsCoastline())
             {
-               // This was a cliff during the last timestep, but it is no longer on the coastline. So classify it as a former cliff
-               pLandform->SetLFSubCategory(LF_SUBCAT_CLIFF_INLAND);
+               // Is not coastline
+               if (nCat == LF_CAT_CLIFF)
+               {
+                  // This was a cliff during the last timestep, but it is no longer on the coastline. So classify it as a former cliff
+                  pLandform->SetLFSubCategory(LF_SUBCAT_CLIFF_INLAND);
 
 //                LogStream << m_ulIter << ": FORMER CLIFF CREATED from cliff landform [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "}" << endl;
 
-               continue;
-            }
+                  continue;
+               }
 
-            if ((nCat == LF_CAT_DRIFT) || (nCat == LF_CAT_INTERVENTION))
-               // Do nothing
-               continue;
+               if ((nCat == LF_CAT_DRIFT) || (nCat == LF_CAT_INTERVENTION))
+                  // Do nothing
+                  continue;
 
-            // It must be hinterland
-            pLandform->SetLFCategory(LF_CAT_HINTERLAND);
+               // It must be hinterland
+               pLandform->SetLFCategory(LF_CAT_HINTERLAND);
+            }
          }
       }
    }
@@ -39,17 +39,36 @@ using std::inner_product;
 #include "coast.h"
 
 //===============================================================================================================================
-//! Calculates both detailed and smoothed curvature for every point on a coastline
+//! Calculates both detailed and smoothed curvature for every point on a coastline. If pOldHistory is not NULL, it holds last timestep's version of this coast: then curvature is only calculated near the coast's changed range, and is copied from pOldHistory elsewhere. On return the coast's changed range is widened to include every point at which curvature was calculated. Finally the curvature is copied into pNewHistory, for use next timestep
 //===============================================================================================================================
-void CSimulation::DoCoastCurvature(int const nCoast, int const nHandedness)
+void CSimulation::DoCoastCurvature(int const nCoast, int const nHandedness, CCoastHistory* pOldHistory, CCoastHistory* pNewHistory)
 {
    int nCoastSize = m_VCoast[nCoast].nGetCoastlineSize();
+   int nOldCoastSize = (pOldHistory == NULL ? 0 : pOldHistory->nGetSize());
+   int nOffset = m_VCoast[nCoast].nGetChangedPointOffset();
 
-   // Start with detailed curvature, do every point on the coastline, apart from the first and last points
+   // Points before nFirstChanged are the same as last timestep's points with the same index, points after nLastChanged are the same as last timestep's points with index reduced by nOffset
+   int nFirstChanged = m_VCoast[nCoast].nGetFirstChangedPoint();
+   int nLastChanged = m_VCoast[nCoast].nGetLastChangedPoint();
+
+   // Start with detailed curvature, do every point on the coastline, apart from the first and last points. The detailed curvature at a point depends only on the point, and the points before and after
+   int nFirstDetailedChanged = nCoastSize;
+   int nLastDetailedChanged = -1;
    for (int nThisCoastPoint = 1; nThisCoastPoint < (nCoastSize-1); nThisCoastPoint++)
    {
-      // Calculate the signed curvature based on this point, and the points before and after
-      double dCurvature = dCalcCurvature(nHandedness, m_VCoast[nCoast].pPtGetCoastlinePointExtCRS(nThisCoastPoint-1), m_VCoast[nCoast].pPtGetCoastlinePointExtCRS(nThisCoastPoint), m_VCoast[nCoast].pPtGetCoastlinePointExtCRS(nThisCoastPoint+1));
+      double dCurvature;
+      if ((pOldHistory != NULL) && (nThisCoastPoint + 1 < nFirstChanged))
+         dCurvature = pOldHistory->dGetDetailedCurvature(nThisCoastPoint);
+      else if ((pOldHistory != NULL) && (nThisCoastPoint - 1 > nLastChanged) && (nThisCoastPoint - nOffset >= 1))
+         dCurvature = pOldHistory->dGetDetailedCurvature(nThisCoastPoint - nOffset);
+      else
+      {
+         // Calculate the signed curvature based on this point, and the points before and after
+         dCurvature = dCalcCurvature(nHandedness, m_VCoast[nCoast].pPtGetCoastlinePointExtCRS(nThisCoastPoint-1), m_VCoast[nCoast].pPtGetCoastlinePointExtCRS(nThisCoastPoint), m_VCoast[nCoast].pPtGetCoastlinePointExtCRS(nThisCoastPoint+1));
+
+         nFirstDetailedChanged = tMin(nFirstDetailedChanged, nThisCoastPoint);
+         nLastDetailedChanged = nThisCoastPoint;
+      }
 
       // Set the detailed curvature
       m_VCoast[nCoast].SetDetailedCurvature(nThisCoastPoint, dCurvature);
@@ -62,12 +81,37 @@ void CSimulation::DoCoastCurvature(int const nCoast, int const nHandedness)
    dTemp = m_VCoast[nCoast].dGetDetailedCurvature(nCoastSize-2);
    m_VCoast[nCoast].SetDetailedCurvature(nCoastSize-1, dTemp);
 
+   // The first point's curvature has changed if the second point's has. The last point's curvature has changed if the last-but-one point's has, or if the last-but-one point's was copied from last timestep's point with the same index but the coast has changed length
+   if (nFirstDetailedChanged == 1)
+      nFirstDetailedChanged = 0;
+
+   if ((nLastDetailedChanged == nCoastSize-2) || ((nOffset != 0) && (nCoastSize-1 < nFirstChanged)))
+   {
+      nFirstDetailedChanged = tMin(nFirstDetailedChanged, nCoastSize-1);
+      nLastDetailedChanged = nCoastSize-1;
+   }
+
    // Now create the smoothed curvature
    int const nHalfWindow = m_nCoastCurvatureMovingWindowSize / 2;
+   int const nWindowAbove = m_nCoastCurvatureMovingWindowSize - nHalfWindow - 1;
 
    // Apply a running mean smoothing filter, with a variable window size at both ends of the coastline
+   int nFirstSmoothChanged = nCoastSize;
+   int nLastSmoothChanged = -1;
    for (int i = 0; i < nCoastSize; i++)
    {
+      if ((pOldHistory != NULL) && (i + nWindowAbove < nFirstDetailedChanged) && (i + nWindowAbove < nOldCoastSize))
+      {
+         m_VCoast[nCoast].SetSmoothCurvature(i, pOldHistory->dGetSmoothCurvature(i));
+         continue;
+      }
+
+      if ((pOldHistory != NULL) && (i - nHalfWindow > nLastDetailedChanged) && (i - nHalfWindow - nOffset >= 0))
+      {
+         m_VCoast[nCoast].SetSmoothCurvature(i, pOldHistory->dGetSmoothCurvature(i - nOffset));
+         continue;
+      }
+
       int nTmpWindow = 0;
       double dWindowTot = 0;
       for (int j = -nHalfWindow; j < m_nCoastCurvatureMovingWindowSize - nHalfWindow; j++)
@@ -83,8 +127,29 @@ void CSimulation::DoCoastCurvature(int const nCoast, int const nHandedness)
       }
 
       m_VCoast[nCoast].SetSmoothCurvature(i, dWindowTot / static_cast<double>(nTmpWindow));
+
+      nFirstSmoothChanged = tMin(nFirstSmoothChanged, i);
+      nLastSmoothChanged = i;
+   }
+
+   // Widen the coast's changed range to include every point at which curvature was calculated
+   if (nFirstDetailedChanged <= nLastDetailedChanged)
+   {
+      nFirstChanged = tMin(nFirstChanged, nFirstDetailedChanged);
+      nLastChanged = tMax(nLastChanged, nLastDetailedChanged);
    }
 
+   if (nFirstSmoothChanged <= nLastSmoothChanged)
+   {
+      nFirstChanged = tMin(nFirstChanged, nFirstSmoothChanged);
+      nLastChanged = tMax(nLastChanged, nLastSmoothChanged);
+   }
+
+   m_VCoast[nCoast].SetChangedRange(nFirstChanged, nLastChanged, nOffset);
+
+   // Keep the curvature for next timestep, before it is adjusted for a straight coast
+   pNewHistory->SetCurvature(m_VCoast[nCoast].pVGetDetailedCurvature(), m_VCoast[nCoast].pVGetSmoothCurvature());
+
    // Now calculate the mean and standard deviation of each set of curvature values
    vector<double>* pVDetailed = m_VCoast[nCoast].pVGetDetailedCurvature();
 
@@ -566,7 +566,10 @@ int CSimulation::nDoAllShadowZones(void)
 
             // If this is a sea cell, mark the shadow zone boundary cell as being in the shadow zone, but not yet processed (a -ve number)
             if (m_pRasterGrid->m_Cell[nTmpX][nTmpY].bIsInContiguousSea())
+            {
                m_pRasterGrid->m_Cell[nTmpX][nTmpY].SetShadowZoneNumber(-(nZone + 1));
+               ExpandActiveWindow(nTmpX, nTmpY);
+            }
 
             // If not already there, append this values to the two shadow boundary vectors
             LBoundary.AppendIfNotAlready(dGridCentroidXToExtCRSX(nTmpX), dGridCentroidYToExtCRSY(nTmpY));
@@ -756,6 +759,7 @@ int CSimulation::nFloodFillShadowZone(int const nZone, CGeom2DIPoint const* pPti
       {
          // Mark the cell as being in the shadow zone but not yet processed (a -ve number, with -1 being zone 1)
          m_pRasterGrid->m_Cell[nX][nY].SetShadowZoneNumber(-nZone - 1);
+         ExpandActiveWindow(nX, nY);
 
          //          LogStream << m_ulIter << ": [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "} marked as shadow zone" << endl;
 
@@ -930,6 +934,8 @@ void CSimulation::DoShadowZoneAndDownDriftZone(int const nCoast, int const nZone
 
          // Mark the cell (a +ve number, same as the associated shadow zone number i.e. starting from 1)
          m_pRasterGrid->m_Cell[nX][nY].SetDownDriftZoneNumber(nZone + 1);
+   ExpandActiveWindow(nX, nY);
+         ExpandActiveWindow(nX, nY);
 
          // Increment the boundary length
          nTotDownDriftBoundaryDistance++;
@@ -1261,6 +1267,7 @@ void CSimulation::ProcessShadowZoneCell(int const nX, int const nY, int const nS
    {
       // OK, we are in the shadow zone and have not already processed this cell, so mark it (a +ve number, starting from 1)
       m_pRasterGrid->m_Cell[nX][nY].SetShadowZoneNumber(nZone + 1);
+      ExpandActiveWindow(nX, nY);
 
       // Next calculate wave angle here: first calculate dOmega, the signed angle subtended between this end point and the start point, and this end point and the end of the shadow boundary
       CGeom2DIPoint
@@ -24,7 +24,6 @@ You should have received a copy of the GNU General Public License along with thi
 ==============================================================================================================================*/
 #include <assert.h>
 #include <cmath>
-#include <unistd.h>
 
 #include <string>
 using std::stoi;
@@ -50,6 +49,7 @@ using std::sort;
 
 #include "cme.h"
 #include "coast.h"
+#include "raster_grid.h"
 #include "simulation.h"
 
 #include "interpolate.h"
@@ -161,54 +161,119 @@ int CSimulation::nDoAllPropagateWaves(void)
        VdHeightXAll,
        VdHeightYAll;
 
-   // Calculate wave properties for every coast
-   bool bSomeNonStartOrEndOfCoastProfiles = false;
+   // Make a list of every profile on every coast, in the original (curvature-related) profile sequence. Each has its own slot for the results of nCalcWavePropertiesOnProfile(), these slots are kept between timesteps so that their memory is reused
+   m_VnWaveItemCoast.clear();
+   m_VnWaveItemProfile.clear();
    for (int nCoast = 0; nCoast < static_cast<int>(m_VCoast.size()); nCoast++)
    {
-      int
-          nCoastSize = m_VCoast[nCoast].nGetCoastlineSize(),
-          nNumProfiles = m_VCoast[nCoast].nGetNumProfiles();
+      for (int nProfile = 0; nProfile < m_VCoast[nCoast].nGetNumProfiles(); nProfile++)
+      {
+         m_VnWaveItemCoast.push_back(nCoast);
+         m_VnWaveItemProfile.push_back(nProfile);
+      }
+   }
 
-      // Calculate wave properties at every point along each valid profile, and for the cells under the profiles. Do this in the original (curvature-related) profile sequence
-      for (int nProfile = 0; nProfile < nNumProfiles; nProfile++)
+   int nNumItems = static_cast<int>(m_VnWaveItemCoast.size());
+   if (static_cast<int>(m_VVdWaveItemX.size()) < nNumItems)
+   {
+      m_VVdWaveItemX.resize(nNumItems);
+      m_VVdWaveItemY.resize(nNumItems);
+      m_VVdWaveItemHeightX.resize(nNumItems);
+      m_VVdWaveItemHeightY.resize(nNumItems);
+      m_VVbWaveItemBreaking.resize(nNumItems);
+      m_VstrWaveItemLog.resize(nNumItems);
+   }
+
+   for (int nItem = 0; nItem < nNumItems; nItem++)
+      m_VstrWaveItemLog[nItem].clear();
+
+   // The wave properties on each profile depend only on that profile and the cells under it. So with COVE, calculate them for all profiles at once using the task graph's threads. CShore keeps its state in a Fortran module, so with CShore this can only be done if the re-entrant CShore library is used, or if there is a CShore worker process for each thread; if not, do one profile at a time, below
+   bool bAllProfilesAtOnce = ((m_nWavePropagationModel == WAVE_MODEL_COVE) || (m_CShorePool.nGetNumWorkers() > 0));
+#ifdef CSHORE_REENTRANT
+   bAllProfilesAtOnce = true;
+#endif
+
+   // If CShore is run for one profile at a time in this process, then instead run it once for all the profiles on each coast
+   bool bCShoreBatches = false;
+#ifdef CSHORE_ARG_INOUT
+   bCShoreBatches = ((m_nWavePropagationModel == WAVE_MODEL_CSHORE) && (! bAllProfilesAtOnce));
+#endif
+
+   if (bAllProfilesAtOnce || bCShoreBatches)
+   {
+      int nRet;
+      if (bAllProfilesAtOnce)
+         nRet = m_TaskGraph.nRunForEach(TASK_PROPAGATE_WAVES_ON_PROFILE, nNumItems);
+      else
+         nRet = nCalcWavePropertiesUsingCShoreBatches(nNumItems);
+
+      if (nRet != RTN_OK)
       {
-         vector<bool> VbBreaking;
-         vector<double>
-             VdX,
-             VdY,
-             VdHeightX,
-             VdHeightY;
+         // Write whatever the profiles which were run wrote to their log text
+         for (int nItem = 0; nItem < nNumItems; nItem++)
+            LogStream << m_VstrWaveItemLog[nItem];
 
-         int nRet = nCalcWavePropertiesOnProfile(nCoast, nCoastSize, nProfile, &VdX, &VdY, &VdHeightX, &VdHeightY, &VbBreaking);
+         return nRet;
+      }
+
+      if (m_bCheckOptimisations)
+      {
+         nRet = nCheckWavePropertiesOnProfiles(nNumItems);
          if (nRet != RTN_OK)
             return nRet;
+      }
+   }
 
-         // Are the waves off-shore? If so, do nothing more with this profile. The wave values for cells have already been given the off-shore value
-         if (VbBreaking.empty())
-            continue;
+   // Now go through the profiles in order, so that the all-profile vectors are the same however many threads were used
+   bool bSomeNonStartOrEndOfCoastProfiles = false;
+   for (int nItem = 0; nItem < nNumItems; nItem++)
+   {
+      int
+          nCoast = m_VnWaveItemCoast[nItem],
+          nProfile = m_VnWaveItemProfile[nItem];
 
-         // Is this a start of coast or end of coast profile?
-         if ((!m_VCoast[nCoast].pGetProfile(nProfile)->bStartOfCoast()) && (! m_VCoast[nCoast].pGetProfile(nProfile)->bEndOfCoast()))
-         {
-            // It is neither a start of coast or an end of coast profile, so set switch
-            bSomeNonStartOrEndOfCoastProfiles = true;
-         }
+      int nRet = RTN_OK;
+      if ((! bAllProfilesAtOnce) && (! bCShoreBatches))
+         nRet = nDoTaskItem(TASK_PROPAGATE_WAVES_ON_PROFILE, nItem);
+
+      LogStream << m_VstrWaveItemLog[nItem];
+
+      if (nRet != RTN_OK)
+         return nRet;
+
+      vector<bool> const* pVbBreaking = &m_VVbWaveItemBreaking[nItem];
+      vector<double> const
+          *pVdX = &m_VVdWaveItemX[nItem],
+          *pVdY = &m_VVdWaveItemY[nItem],
+          *pVdHeightX = &m_VVdWaveItemHeightX[nItem],
+          *pVdHeightY = &m_VVdWaveItemHeightY[nItem];
 
-         // // DEBUG CODE
-         // for (int nn = 0; nn < VdX.size(); nn++)
-         // {
-         //    LogStream << "nProfile = " << nProfile << " nn = " << nn << " VdX[nn] = " << VdX[nn] << " VdY[nn] = " << VdY[nn] << " VdHeightX[nn] = " << VdHeightX[nn] << " VdHeightY[nn] = " << VdHeightY[nn] << " VbBreaking[nn] = " << VbBreaking[nn] << endl;
-         // }
-         // LogStream << endl;
-         // // DEBUG CODE
+      // Are the waves off-shore? If so, do nothing more with this profile. The wave values for cells have already been given the off-shore value
+      if (pVbBreaking->empty())
+         continue;
 
-         // Append to the all-profile vectors
-         VdXAll.insert(VdXAll.end(), VdX.begin(), VdX.end());
-         VdYAll.insert(VdYAll.end(), VdY.begin(), VdY.end());
-         VdHeightXAll.insert(VdHeightXAll.end(), VdHeightX.begin(), VdHeightX.end());
-         VdHeightYAll.insert(VdHeightYAll.end(), VdHeightY.begin(), VdHeightY.end());
-         VbBreakingAll.insert(VbBreakingAll.end(), VbBreaking.begin(), VbBreaking.end());
+      // Is this a start of coast or end of coast profile?
+      CGeomProfile const* pProfile = m_VCoast[nCoast].pGetProfile(nProfile);
+      if ((! pProfile->bStartOfCoast()) && (! pProfile->bEndOfCoast()))
+      {
+         // It is neither a start of coast or an end of coast profile, so set switch
+         bSomeNonStartOrEndOfCoastProfiles = true;
       }
+
+      // // DEBUG CODE
+      // for (int nn = 0; nn < pVdX->size(); nn++)
+      // {
+      //    LogStream << "nProfile = " << nProfile << " nn = " << nn << " VdX[nn] = " << pVdX->at(nn) << " VdY[nn] = " << pVdY->at(nn) << " VdHeightX[nn] = " << pVdHeightX->at(nn) << " VdHeightY[nn] = " << pVdHeightY->at(nn) << " VbBreaking[nn] = " << pVbBreaking->at(nn) << endl;
+      // }
+      // LogStream << endl;
+      // // DEBUG CODE
+
+      // Append to the all-profile vectors
+      VdXAll.insert(VdXAll.end(), pVdX->begin(), pVdX->end());
+      VdYAll.insert(VdYAll.end(), pVdY->begin(), pVdY->end());
+      VdHeightXAll.insert(VdHeightXAll.end(), pVdHeightX->begin(), pVdHeightX->end());
+      VdHeightYAll.insert(VdHeightYAll.end(), pVdHeightY->begin(), pVdHeightY->end());
+      VbBreakingAll.insert(VbBreakingAll.end(), pVbBreaking->begin(), pVbBreaking->end());
    }
 
    // OK, do we have some profiles other than start of coast or end of coast profiles in the all-profile vectors? We need to check this, because GDALGridCreate() in nInterpolateWavePropertiesToWithinPolygonCells() does not work if we give it only a start-of-coast or an end-of-coast profile to work with TODO 006 Is this still true?
@@ -412,8 +477,16 @@ int CSimulation::nDoAllPropagateWaves(void)
    if (nRet != RTN_OK)
       return nRet;
 
-   // Calculate the D50 for each polygon. Also fill in any artefactual 'holes' in active zone and wave property patterns
-   CalcD50AndFillWaveCalcHoles();
+   // Calculate the D50 for each polygon. Also fill in any artefactual 'holes' in active zone and wave property patterns. If all cells have the same deep water wave values, this may be done in the active window only
+   bool bActiveWindowOnly = (m_bFillHolesInActiveWindow && m_bSingleDeepWaterWaveValues);
+   if (bActiveWindowOnly && m_bCheckOptimisations)
+   {
+      nRet = nCheckActiveWindowHoleFill();
+      if (nRet != RTN_OK)
+         return nRet;
+   }
+   else
+      CalcD50AndFillWaveCalcHoles(bActiveWindowOnly);
 
    //    // DEBUG CODE ===========================================
    //    string strOutFile = m_strOutPath;
@@ -611,24 +684,108 @@ double CSimulation::dCalcWaveAngleToCoastNormal(double const dCoastAngle, double
    return dWaveToNormalAngle;
 }
 
+//===============================================================================================================================
+//! Called before profiles are created. Returns true if waves will be off-shore at every coast point, so that propagating waves would change nothing, and nor would shore platform erosion, cliff collapse, or beach erosion and deposition. This can only be known in advance if all cells have the same deep water wave values, since each profile is given the deep water wave orientation of the cell at its seaward end. Also returns false if unconsolidated sediment which was not deposited last timestep is waiting to be deposited by the beach stage
+//===============================================================================================================================
+bool CSimulation::bAreWavesOffshoreEverywhere(void)
+{
+   if (! m_bSingleDeepWaterWaveValues)
+      return false;
+
+   if ((m_dDepositionSandDiff > MASS_BALANCE_TOLERANCE) || (m_dDepositionCoarseDiff > MASS_BALANCE_TOLERANCE))
+      return false;
+
+   // All cells have the same deep water wave orientation, so read it back from one of them: this is the value (stored as diag_t) which profiles would be given
+   double dDeepWaterWaveAngle = m_pRasterGrid->m_Cell[0][0].dGetCellDeepWaterWaveAngle();
+
+   for (int nCoast = 0; nCoast < static_cast<int>(m_VCoast.size()); nCoast++)
+   {
+      int nSeaHand = m_VCoast[nCoast].nGetSeaHandedness();
+
+      for (int nPoint = 0; nPoint < m_VCoast[nCoast].nGetCoastlineSize(); nPoint++)
+      {
+         // This is the test which nCalcWavePropertiesOnProfile() makes for a profile which starts at this coast point
+         double dWaveToNormalAngle = dCalcWaveAngleToCoastNormal(m_VCoast[nCoast].dGetFluxOrientation(nPoint), dDeepWaterWaveAngle, nSeaHand);
+         if (! bFPIsEqual(dWaveToNormalAngle, DBL_NODATA, TOLERANCE))
+            return false;
+      }
+   }
+
+   return true;
+}
+
+//===============================================================================================================================
+//! Calculates wave properties along every coastline-normal profile using CShore, running CShore once for all the profiles on each coast. First the CShore input values for each of the coast's profiles are added to a batch, then CShore is run for the batch, then the calculation is finished for each profile in the batch using CShore's output values
+//===============================================================================================================================
+int CSimulation::nCalcWavePropertiesUsingCShoreBatches(int const nNumItems)
+{
+   int nFirstItem = 0;
+   while (nFirstItem < nNumItems)
+   {
+      // Find the items for the profiles on this coast
+      int
+          nCoast = m_VnWaveItemCoast[nFirstItem],
+          nLastItem = nFirstItem;
+
+      while ((nLastItem + 1 < nNumItems) && (m_VnWaveItemCoast[nLastItem + 1] == nCoast))
+         nLastItem++;
+
+      m_CShoreBatch.Clear();
+      m_bAddToCShoreBatch = true;
+
+      for (int nItem = nFirstItem; nItem <= nLastItem; nItem++)
+      {
+         int nRet = nDoTaskItem(TASK_PROPAGATE_WAVES_ON_PROFILE, nItem);
+         if (nRet != RTN_OK)
+         {
+            m_bAddToCShoreBatch = false;
+            return nRet;
+         }
+      }
+
+      m_bAddToCShoreBatch = false;
+      m_CShoreBatch.Run();
+
+      // Profiles which were not added to the batch (e.g. because the waves are off-shore) are already finished
+      for (int nItem = nFirstItem; nItem <= nLastItem; nItem++)
+      {
+         int nProfile = m_VnWaveItemProfile[nItem];
+         if (! m_CShoreBatch.bHasProfile(nProfile))
+            continue;
+
+         // Keep the log text which was written when this profile's input values were added to the batch
+         ostringstream strmLog;
+         int nRet = nCalcWavePropertiesOnProfileFromCShoreBatch(nCoast, nProfile, &m_VVdWaveItemX[nItem], &m_VVdWaveItemY[nItem], &m_VVdWaveItemHeightX[nItem], &m_VVdWaveItemHeightY[nItem], &m_VVbWaveItemBreaking[nItem], &strmLog);
+         m_VstrWaveItemLog[nItem] += strmLog.str();
+
+         if (nRet != RTN_OK)
+            return nRet;
+      }
+
+      nFirstItem = nLastItem + 1;
+   }
+
+   return RTN_OK;
+}
+
 //===============================================================================================================================
 //! Calculates wave properties along a coastline-normal profile using either the COVE linear wave theory approach or the external CShore model
 //===============================================================================================================================
-int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoastSize, int const nProfile, vector<double>* pVdX, vector<double>* pVdY, vector<double>* pVdHeightX, vector<double>* pVdHeightY, vector<bool>* pVbBreaking)
+int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoastSize, int const nProfile, vector<double>* pVdX, vector<double>* pVdY, vector<double>* pVdHeightX, vector<double>* pVdHeightY, vector<bool>* pVbBreaking, ostream* pLogStream)
 {
    CGeomProfile* pProfile = m_VCoast[nCoast].pGetProfile(nProfile);
 
    // Calculate some wave properties based on the wave period following Airy wave theory
    double dDeepWaterWavePeriod = pProfile->dGetProfileDeepWaterWavePeriod();
 
-   m_dC_0 = (m_dG * dDeepWaterWavePeriod) / (2 * PI); // Deep water (offshore) wave celerity (m/s)
-   m_dL_0 = m_dC_0 * dDeepWaterWavePeriod;            // Deep water (offshore) wave length (m)
+   double dC_0 = (m_dG * dDeepWaterWavePeriod) / (2 * PI); // Deep water (offshore) wave celerity (m/s)
+   double dL_0 = dC_0 * dDeepWaterWavePeriod;             // Deep water (offshore) wave length (m)
 
    // Only do this for profiles without problems. Still do start- and end-of-coast profiles however
    if (!pProfile->bOKIncStartAndEndOfCoast())
    {
       if (m_nLogFileDetail >= LOG_FILE_ALL)
-         LogStream << m_ulIter << ": Coast " << nCoast << ", profile " << nProfile << " has been marked invalid, will not calc wave properties on this profile" << endl;
+         *pLogStream << m_ulIter << ": Coast " << nCoast << ", profile " << nProfile << " has been marked invalid, will not calc wave properties on this profile" << endl;
 
       return RTN_OK;
    }
@@ -760,27 +917,8 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
       dWaveToNormalAngle = dFluxOrientationNext;
    }
 
-   // Initialize the wave properties at breaking for this profile
-   bool bBreaking = false;
-   int
-       nProfileSize = pProfile->nGetNumCellsInProfile(),
-       nProfileBreakingDist = 0;
-   double
-       dProfileBreakingWaveHeight = DBL_NODATA,
-       dProfileBreakingWaveAngle = 0,
-       dProfileBreakingDepth = 0,
-       dProfileWaveHeight = DBL_NODATA,
-       dProfileDeepWaterWaveHeight = pProfile->dGetProfileDeepWaterWaveHeight(),
-       dProfileWaveAngle = DBL_NODATA,
-       dProfileDeepWaterWaveAngle = pProfile->dGetProfileDeepWaterWaveAngle();
-   vector<bool>
-       VbWaveIsBreaking(nProfileSize, 0);
-   vector<double>
-       VdWaveHeight(nProfileSize, 0),
-       VdWaveSetupSurge(nProfileSize, 0),          // TODO 007 What is this for?
-       //  VdStormSurge(nProfileSize, 0),          // TODO 007 What is this for?
-       VdWaveSetupRunUp(nProfileSize, 0),
-       VdWaveDirection(nProfileSize, 0);
+   int nProfileSize = pProfile->nGetNumCellsInProfile();
+   double dProfileDeepWaterWaveHeight = pProfile->dGetProfileDeepWaterWaveHeight();
 
    if (m_nWavePropagationModel == WAVE_MODEL_CSHORE)
    {
@@ -788,18 +926,22 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
       double dCShoreTimeStep = 3600;   // In seconds, not important because we are not using CShore to erode the profile, just to get the hydrodynamics
       double dSurgeLevel = CSHORE_SURGE_LEVEL;
 
+      // The vectors used here belong to this thread's CShore workspace, so they keep their memory from one profile to the next
+      CCShoreWorkspace* pWorkspace = &m_VCShoreWorkspace[CTaskGraph::nGetThisThread()];
+      pWorkspace->ClearProfile();
+
       // Set up vectors for the coastline-normal profile elevations. The length of this vector line is given by the number of cells 'under' the profile. Thus each point on the vector relates to a single cell in the grid. This assumes that all points on the profile vector are equally spaced (not quite true, depends on the orientation of the line segments which comprise the profile)
       vector<double>
-          VdProfileZ,                  // Initial (pre-erosion) elevation of both consolidated and unconsolidated sediment for cells 'under' the profile, in CShore units
-          VdProfileDistXY,             // Along-profile distance measured from the seaward limit, in CShore units
-          VdProfileFrictionFactor;     // Along-profile friction factor from seaward limit
+          &VdProfileZ = pWorkspace->m_VdProfileZ,                           // Initial (pre-erosion) elevation of both consolidated and unconsolidated sediment for cells 'under' the profile, in CShore units
+          &VdProfileDistXY = pWorkspace->m_VdProfileDistXY,                 // Along-profile distance measured from the seaward limit, in CShore units
+          &VdProfileFrictionFactor = pWorkspace->m_VdProfileFrictionFactor; // Along-profile friction factor from seaward limit
 
       // The elevation of each of these profile points is the elevation of the centroid of the cell that is 'under' the point. However we cannot always be confident that this is the 'true' elevation of the point on the vector since (unless the profile runs planview N-S or W-E) the vector does not always run exactly through the centroid of the cell
-      int nRet = nGetThisProfileElevationVectorsForCShore(nCoast, nProfile, nProfileSize, &VdProfileDistXY, &VdProfileZ, &VdProfileFrictionFactor);
+      int nRet = nGetThisProfileElevationVectorsForCShore(nCoast, nProfile, nProfileSize, &VdProfileDistXY, &VdProfileZ, &VdProfileFrictionFactor, pLogStream);
       if (nRet != RTN_OK)
       {
          // Could not create the profile elevation vectors
-         LogStream << m_ulIter << ": could not create CShore profile elevation vectors for profile " << nProfile << endl;
+         *pLogStream << m_ulIter << ": could not create CShore profile elevation vectors for profile " << nProfile << endl;
 
          return nRet;
       }
@@ -807,7 +949,7 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
       if (VdProfileDistXY.empty())
       {
          // The profile elevation vector was created, but was not populated
-         LogStream << m_ulIter << ": could not populate CShore profile elevation vector for profile " << nProfile << endl;
+         *pLogStream << m_ulIter << ": could not populate CShore profile elevation vector for profile " << nProfile << endl;
 
          return RTN_ERR_CSHORE_EMPTY_PROFILE;
       }
@@ -818,13 +960,17 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
 
       int nProfileDistXYSize = static_cast<int>(VdProfileDistXY.size());
       vector<double>
-          VdFreeSurfaceStd(nProfileDistXYSize, 0),        // This is converted to Hrms by Hrms = sqr(8)*FreeSurfaceStd
-          VdSinWaveAngleRadians(nProfileDistXYSize, 0),   // This is converted to deg by asin(VdSinWaveAngleRadians)*(180/pi)
-          VdFractionBreakingWaves(nProfileDistXYSize, 0); // Is 0 if no wave breaking, and 1 if all waves breaking
+          &VdFreeSurfaceStd = pWorkspace->m_VdFreeSurfaceStd,               // This is converted to Hrms by Hrms = sqr(8)*FreeSurfaceStd
+          &VdSinWaveAngleRadians = pWorkspace->m_VdSinWaveAngleRadians,     // This is converted to deg by asin(VdSinWaveAngleRadians)*(180/pi)
+          &VdFractionBreakingWaves = pWorkspace->m_VdFractionBreakingWaves; // Is 0 if no wave breaking, and 1 if all waves breaking
+
+      VdFreeSurfaceStd.assign(nProfileDistXYSize, 0);
+      VdSinWaveAngleRadians.assign(nProfileDistXYSize, 0);
+      VdFractionBreakingWaves.assign(nProfileDistXYSize, 0);
 
       // Now define the other values that CShore requires
       int
-          nILine = 1,  // This is the number of cross-shore lines i.e. the number of CoastalME profiles. Only one at a time, at present
+          nILine = 1,  // This is the number of cross-shore lines i.e. the number of CoastalME profiles. Always one here: when CShore is run for all the profiles on a coast, CCShoreBatch gives it one line for each profile in the batch
           nIProfl = 0, // 0 for fixed bottom profile, 1 for profile evolution computation
           nIPerm = 0,  // 0 for impermeable bottom, 1 for permeable bottom of stone structure
           nIOver = 0,  // 0 for no wave overtopping and overflow on crest, 1 for wave overtopping and overflow
@@ -841,15 +987,15 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
           dSurgeInitTime = 0; // CShore surge start time                   // TODO 007 What is this for?
 
 #if defined CSHORE_FILE_INOUT || CSHORE_BOTH
-      // Move to the CShore folder
-      nRet = chdir(CSHORE_DIR.c_str());
-      if (nRet != RTN_OK)
-         return nRet;
+      // Tell CShore to read and write its files in this thread's scratch directory
+      int nScratchDirLength = static_cast<int>(pWorkspace->m_strScratchDir.size());
+      CShoreSetDirectory(&nScratchDirLength, pWorkspace->m_strScratchDir.c_str());
 #endif
 
 #if defined CSHORE_FILE_INOUT
       // We are communicating with CShore using ASCII files, so create an input file for this profile which will be read by CShore
-      nRet = nCreateCShoreInfile(nCoast, nProfile, nILine, nIProfl, nIPerm, nIOver, nIWCInt, nIRoll, nIWind, nITide, nILab, nNWave, nNSurge, dDX, dCShoreTimeStep, dWaveInitTime, dDeepWaterWavePeriod, dProfileDeepWaterWaveHeight, dWaveToNormalAngle, dSurgeInitTime, dSurgeLevel, &VdProfileDistXY, &VdProfileZ, &VdProfileFrictionFactor);
+      string strInfile = pWorkspace->m_strScratchDir + CSHORE_INFILE;
+      nRet = nCreateCShoreInfile(&strInfile, nCoast, nProfile, nILine, nIProfl, nIPerm, nIOver, nIWCInt, nIRoll, nIWind, nITide, nILab, nNWave, nNSurge, dDX, dCShoreTimeStep, dWaveInitTime, dDeepWaterWavePeriod, dProfileDeepWaterWaveHeight, dWaveToNormalAngle, dSurgeInitTime, dSurgeLevel, &VdProfileDistXY, &VdProfileZ, &VdProfileFrictionFactor, pLogStream);
       if (nRet != RTN_OK)
          return nRet;
 
@@ -905,19 +1051,19 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
       }
 
       // Fetch the CShore results by reading files written by CShore
-      string strOSETUP = "OSETUP";
-      string strOYVELO = "OYVELO";
-      string strOPARAM = "OPARAM";
+      string strOSETUP = pWorkspace->m_strScratchDir + "OSETUP";
+      string strOYVELO = pWorkspace->m_strScratchDir + "OYVELO";
+      string strOPARAM = pWorkspace->m_strScratchDir + "OPARAM";
 
-      nRet = nReadCShoreOutput(nProfile, &strOSETUP, 4, 4, &VdProfileDistXY, &VdFreeSurfaceStd);
+      nRet = nReadCShoreOutput(nProfile, &strOSETUP, 4, 4, &VdProfileDistXY, &VdFreeSurfaceStd, pLogStream);
       if (nRet != RTN_OK)
          return nRet;
 
-      nRet = nReadCShoreOutput(nProfile, &strOYVELO, 4, 2, &VdProfileDistXY, &VdSinWaveAngleRadians);
+      nRet = nReadCShoreOutput(nProfile, &strOYVELO, 4, 2, &VdProfileDistXY, &VdSinWaveAngleRadians, pLogStream);
       if (nRet != RTN_OK)
          return nRet;
 
-      nRet = nReadCShoreOutput(nProfile, &strOPARAM, 4, 3, &VdProfileDistXY, &VdFractionBreakingWaves);
+      nRet = nReadCShoreOutput(nProfile, &strOPARAM, 4, 3, &VdProfileDistXY, &VdFractionBreakingWaves, pLogStream);
       if (nRet != RTN_OK)
          return nRet;
 
@@ -925,33 +1071,20 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
       // VdTSurg = {dSurgeInitTime, dCShoreTimeStep},                           // Ditto
       // VdSWLin = {dSurgeLevel, dSurgeLevel},                                  // Ditto
 
-      // Clean up the CShore outputs
-#ifdef _WIN32
-      nRet = system("./clean.bat");
-#else
+      // The wave setup plus surge is not read from the CShore output files
+      pWorkspace->m_VdWaveSetupSurge.assign(nProfileSize, 0);
+
+      // Save the CShore outputs if required, then delete them
       if (SAVE_CSHORE_OUTPUT)
       {
-         string strCommand = "./save_CShore_output.sh ";
-         strCommand += to_string(m_ulIter);
-         strCommand += " ";
-         strCommand += to_string(nCoast);
-         strCommand += " ";
-         strCommand += to_string(nProfile);
-
-         nRet = system(strCommand.c_str());
-         if (nRet != RTN_OK)
-            return nRet;
+         if (! pWorkspace->bSaveScratchFiles(m_strCMEDir + CSHORE_DIR, to_string(m_ulIter) + ": coast " + to_string(nCoast) + " profile " + to_string(nProfile)))
+         {
+            *pLogStream << m_ulIter << ": " << ERR << "cannot save CShore output files for coast " << nCoast << " profile " << nProfile << endl;
+            return RTN_ERR_CSHORE_SCRATCH_DIR;
+         }
       }
 
-      nRet = system("./clean.sh");
-#endif
-      if (nRet != RTN_OK)
-         return nRet;
-
-      // And return to the CoastalME folder
-      nRet = chdir(m_strCMEDir.c_str());
-      if (nRet != RTN_OK)
-         return nRet;
+      pWorkspace->CleanScratchDir();
 #endif
 
 #if defined CSHORE_ARG_INOUT || CSHORE_BOTH
@@ -961,21 +1094,21 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
       // Set the error flag: this will be changed within CShore if there is a problem
       nRet = 0;
 
+      double
+          dInitTime[] = {dWaveInitTime, dCShoreTimeStep},                        // Size is nNwave+1, value 1 is for the start of the CShore run, value 2 for end of CShore run
+          dTPIn[] = {dDeepWaterWavePeriod, dDeepWaterWavePeriod},                // Ditto
+          dHrmsIn[] = {dProfileDeepWaterWaveHeight, dProfileDeepWaterWaveHeight}, // Ditto
+          dWangIn[] = {dWaveToNormalAngle, dWaveToNormalAngle},                  // Ditto
+          dTSurg[] = {dSurgeInitTime, dCShoreTimeStep},                          // Ditto
+          dSWLin[] = {dSurgeLevel, dSurgeLevel};                                 // Ditto
+
+      // The output from CShore, these vectors hold as many values as CShore outputs for each profile
       vector<double>
-          VdInitTime = {dWaveInitTime, dCShoreTimeStep},                         // Size is nNwave+1, value 1 is for the start of the CShore run, value 2 for end of CShore run
-          VdTPIn = {dDeepWaterWavePeriod, dDeepWaterWavePeriod},                 // Ditto
-          VdHrmsIn = {dProfileDeepWaterWaveHeight, dProfileDeepWaterWaveHeight}, // Ditto
-          VdWangIn = {dWaveToNormalAngle, dWaveToNormalAngle},                   // Ditto
-          VdTSurg = {dSurgeInitTime, dCShoreTimeStep},                           // Ditto
-          VdSWLin = {dSurgeLevel, dSurgeLevel},                                  // Ditto
-          VdFPInp = VdProfileFrictionFactor,                                     // Set the value for wave friction at every point of the normal profile
-          VdXYDistFromCShoreOut(CSHOREARRAYOUTSIZE, 0),                          // Output from CShore
-          VdFreeSurfaceStdOut(CSHOREARRAYOUTSIZE, 0),                            // Ditto
-          VdWaveSetupSurgeOut(CSHOREARRAYOUTSIZE, 0),                            // TODO 007 Info needed
-         //  VdStormSurgeOut(CSHOREARRAYOUTSIZE, 0),                             // TODO 007 Info needed
-          VdWaveSetupRunUpOut(CSHOREARRAYOUTSIZE, 0),                            // TODO 007 Info needed
-          VdSinWaveAngleRadiansOut(CSHOREARRAYOUTSIZE, 0),                       // Ditto
-          VdFractionBreakingWavesOut(CSHOREARRAYOUTSIZE, 0);                     // Ditto
+          &VdXYDistFromCShoreOut = pWorkspace->m_VdXYDistOut,                    // Output from CShore
+          &VdFreeSurfaceStdOut = pWorkspace->m_VdFreeSurfaceStdOut,              // Ditto
+          &VdWaveSetupSurgeOut = pWorkspace->m_VdWaveSetupSurgeOut,              // TODO 007 Info needed
+          &VdSinWaveAngleRadiansOut = pWorkspace->m_VdSinWaveAngleRadiansOut,    // Ditto
+          &VdFractionBreakingWavesOut = pWorkspace->m_VdFractionBreakingWavesOut; // Ditto
 
       // Call CShore using the argument-passing wrapper
       // long lIter = static_cast<long>(m_ulIter);    // Bodge to get round compiler 'invalid conversion' error
@@ -988,105 +1121,283 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
       //    LogStream << nn << "\t" << VdProfileDistXY[nn] << "\t" << VdProfileDistXY[nn] << "\t" << VdProfileZ[nn] << endl;         
       // }
           
-      CShoreWrapper(&nILine,                          /* In_ILINE */
-                    &nIProfl,                         /* In_IPROFL */
-                    &nIPerm,                          /* In_IPERM */
-                    &nIOver,                          /* In_IOVER */
-                    &nIWCInt,                         /* In_IWCINT */
-                    &nIRoll,                          /* In_IROLL */
-                    &nIWind,                          /* In_IWIND */
-                    &nITide,                          /* In_ITIDE */
-                    &nILab,                           /* In_ILAB */
-                    &nNWave,                          /* In_NWAVE */
-                    &nNSurge,                         /* In_NSURG */                   // TODO 007 Info needed
-                    &dDX,                             /* In_DX */
-                    &m_dBreakingWaveHeightDepthRatio, /* In_GAMMA */
-                    &VdInitTime[0],                   /* In_TWAVE */
-                    &VdTPIn[0],                       /* In_TPIN */
-                    &VdHrmsIn[0],                     /* In_HRMSIN */
-                    &VdWangIn[0],                     /* In_WANGIN */
-                    &VdTSurg[0],                      /* In_TSURG */
-                    &VdSWLin[0],                      /* In_SWLIN */
-                    &nProfileDistXYSize,              /* In_NBINP */
-                    &VdProfileDistXY[0],              /* In_XBINP */
-                    &VdProfileZ[0],                   /* In_ZBINP */
-                    &VdFPInp[0],                      /* In_FBINP */
-                    &nRet,                            /* Out_IError */
-                    &nOutSize,                        /* Out_nOutSize */
-                    &VdXYDistFromCShoreOut[0],        /* Out_XYDist */
-                    &VdFreeSurfaceStdOut[0],          /* Out_FreeSurfaceStd */
-                    &VdWaveSetupSurgeOut[0],          /* Out_WaveSetupSurge */         // TODO 007 Info needed
-                    &VdSinWaveAngleRadiansOut[0],     /* Out_SinWaveAngleRadians */
-                    &VdFractionBreakingWavesOut[0]);  /* Out_FractionBreakingWaves */
-      
-      // OK, now check for warnings and errors
-      if (nOutSize < 2)
+      // If CShore is being run once for all the profiles on this coast, then add this profile's input values to the batch and finish with this profile for now. It is finished by nCalcWavePropertiesOnProfileFromCShoreBatch() once CShore has been run for the batch
+      if (m_bAddToCShoreBatch)
       {
-         // CShore sometimes returns only one row of results, which contains data only for the seaward point of the profile. This happens when all other (more coastward) points give an invalid result during CShore's calculations. This is a problem. We don't want to abandon the simulation just because of this, so instead we just put some dummy data into the second row, and carry on with these two rows. The profile will get ignored later, since it is too small to be useful
-         if (m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL)
-            LogStream << m_ulIter << ": " << WARN << "for coast " << nCoast << " profile " << nProfile << ", only " << nOutSize << " CShore output row" << endl;
-
-         // Set dummy data in the second row
-         VdXYDistFromCShoreOut[1] = 1e-5;    // Dummy data, must not be the same as VdXYDistFromCShoreOut[0] tho', or get crash in linear interpolation routine
-         VdFreeSurfaceStdOut[1] = VdFreeSurfaceStdOut[0];
-         VdSinWaveAngleRadiansOut[1] = VdSinWaveAngleRadiansOut[0];
-         VdFractionBreakingWavesOut[1] = VdFractionBreakingWavesOut[0];
-         VdWaveSetupSurgeOut[1] = VdWaveSetupSurgeOut[0];                              // TODO 007 Info needed
-         // VdStormSurgeOut[1] = VdStormSurgeOut[0];                                   // TODO 007 Info needed
-         // VdWaveSetupRunUpOut[1] = VdWaveSetupRunUpOut[0];
+         m_CShoreBatch.AddProfile(nProfile, &nIProfl, &nIPerm, &nIOver, &nIWCInt, &nIRoll, &nIWind, &nITide, &nILab, &nNWave, &nNSurge, &dDX, &m_dBreakingWaveHeightDepthRatio, dInitTime, dTPIn, dHrmsIn, dWangIn, dTSurg, dSWLin, &nProfileDistXYSize, &VdProfileDistXY[0], &VdProfileZ[0], &VdProfileFrictionFactor[0]);
 
-         // And increase the expected number of rows
-         nOutSize = 2;
+         return RTN_OK;
       }
 
+      pWorkspace->ClearOutput();
+
+      // This may be running for several profiles at once, in which case CShore is run by one of the CShore worker processes
+      bool bCShoreOK = m_CShorePool.bRunCShore(&nILine,                          /* In_ILINE */
+                                               &nIProfl,                         /* In_IPROFL */
+                                               &nIPerm,                          /* In_IPERM */
+                                               &nIOver,                          /* In_IOVER */
+                                               &nIWCInt,                         /* In_IWCINT */
+                                               &nIRoll,                          /* In_IROLL */
+                                               &nIWind,                          /* In_IWIND */
+                                               &nITide,                          /* In_ITIDE */
+                                               &nILab,                           /* In_ILAB */
+                                               &nNWave,                          /* In_NWAVE */
+                                               &nNSurge,                         /* In_NSURG */                   // TODO 007 Info needed
+                                               &dDX,                             /* In_DX */
+                                               &m_dBreakingWaveHeightDepthRatio, /* In_GAMMA */
+                                               dInitTime,                        /* In_TWAVE */
+                                               dTPIn,                            /* In_TPIN */
+                                               dHrmsIn,                          /* In_HRMSIN */
+                                               dWangIn,                          /* In_WANGIN */
+                                               dTSurg,                           /* In_TSURG */
+                                               dSWLin,                           /* In_SWLIN */
+                                               &nProfileDistXYSize,              /* In_NBINP */
+                                               &VdProfileDistXY[0],              /* In_XBINP */
+                                               &VdProfileZ[0],                   /* In_ZBINP */
+                                               &VdProfileFrictionFactor[0],      /* In_FBINP */
+                                               &nRet,                            /* Out_IError */
+                                               &nOutSize,                        /* Out_nOutSize */
+                                               &VdXYDistFromCShoreOut[0],        /* Out_XYDist */
+                                               &VdFreeSurfaceStdOut[0],          /* Out_FreeSurfaceStd */
+                                               &VdWaveSetupSurgeOut[0],          /* Out_WaveSetupSurge */         // TODO 007 Info needed
+                                               &VdSinWaveAngleRadiansOut[0],     /* Out_SinWaveAngleRadians */
+                                               &VdFractionBreakingWavesOut[0]);  /* Out_FractionBreakingWaves */
+
+      if (! bCShoreOK)
+         return RTN_ERR_CSHORE_WORKER;
+
+      // Check CShore's output values for warnings and errors, then interpolate them onto the profile
+      nRet = nInterpolateCShoreOutputOnProfile(nCoast, nProfile, nRet, nOutSize, pWorkspace, pLogStream);
       if (nRet != RTN_OK)
-      {
-         string strErr;
+         return nRet;
+#endif
 
-         switch (nRet)
+#if defined CSHORE_BOTH
+      // Save the CShore output files if required, then delete them
+      if (SAVE_CSHORE_OUTPUT)
+      {
+         if (! pWorkspace->bSaveScratchFiles(m_strCMEDir + CSHORE_DIR, to_string(m_ulIter) + ": coast " + to_string(nCoast) + " profile " + to_string(nProfile)))
          {
-            case -1:
-               strErr = to_string(m_ulIter) + ": CShore ERROR: negative depth at the first node ";
-               break;
+            *pLogStream << m_ulIter << ": " << ERR << "cannot save CShore output files for coast " << nCoast << " profile " << nProfile << endl;
+            return RTN_ERR_CSHORE_SCRATCH_DIR;
+         }
+      }
 
-            case 2:
-               strErr = to_string(m_ulIter) + ": CShore WARNING 2: negative value at end of landward marching computation ";
-               break;
+      pWorkspace->CleanScratchDir();
+#endif
 
-            case 3:
-               strErr = to_string(m_ulIter) + ": CShore WARNING 3: large energy gradients at the first node: small waves with short period at sea boundary ";
-               break;
+      // OK we have the CShore output, so now we must convert this to wave height and wave direction and update wave profile attributes
+      CalcWavePropertiesFromCShoreOutput(nCoast, nProfile, pWorkspace, pVdX, pVdY, pVdHeightX, pVdHeightY, pVbBreaking);
+   }
 
-            case 4:
-               strErr = to_string(m_ulIter) + ": CShore WARNING 4: zero energy at the first node ";
-               break;
+   else if (m_nWavePropagationModel == WAVE_MODEL_COVE)
+   {
+      // We are using COVE's linear wave theory to propagate the waves
 
-            case 5:
-               strErr = to_string(m_ulIter) + ": CShore WARNING 5: at end of landward marching computation, insufficient water depth ";
-               break;
+      // Initialize the wave properties at breaking for this profile
+      bool bBreaking = false;
+      int nProfileBreakingDist = 0;
+      double
+          dProfileBreakingWaveHeight = DBL_NODATA,
+          dProfileBreakingWaveAngle = 0,
+          dProfileBreakingDepth = 0,
+          dProfileWaveHeight = DBL_NODATA,
+          dProfileWaveAngle = DBL_NODATA,
+          dProfileDeepWaterWaveAngle = pProfile->dGetProfileDeepWaterWaveAngle();
+      vector<bool>
+          VbWaveIsBreaking(nProfileSize, 0);
+      vector<double>
+          VdWaveHeight(nProfileSize, 0),
+          VdWaveSetupSurge(nProfileSize, 0),          // TODO 007 What is this for?
+          VdWaveDirection(nProfileSize, 0);
 
-            case 7:
-               strErr = to_string(m_ulIter) + ": CShore WARNING 7: did not reach convergence ";
-               break;
-         }
+      double dDepthLookupMax = m_dWaveDepthRatioForWaveCalcs * dProfileDeepWaterWaveHeight;
 
-         strErr += "(coast " + to_string(nCoast) + " profile " + to_string(nProfile) + " profile length " + to_string(nOutSize) + ")\n";
-         
-         if (nRet < -1)
+      // Go landwards along the profile, calculating wave height and wave angle for every inundated point on the profile (don't do point zero, this is on the coastline) until the waves start to break  after breaking wave height is assumed to decrease linearly to zero at the shoreline and wave angle is equalt to wave angle at breaking
+      for (int nProfilePoint = (nProfileSize - 1); nProfilePoint >= 0; nProfilePoint--)
+      {
+         int
+             nX = pProfile->pPtiGetCellInProfile(nProfilePoint)->nGetX(),
+             nY = pProfile->pPtiGetCellInProfile(nProfilePoint)->nGetY();
+
+         // Safety check
+         if (! m_pRasterGrid->m_Cell[nX][nY].bIsInContiguousSea())
+            continue;
+
+         double dSeaDepth = m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth(); // Water depth for the cell 'under' this point in the profile
+         if (dSeaDepth > dDepthLookupMax)
          {
-            // This is serious, so give up for this profile
-            cerr << strErr;
-            return RTN_ERR_CSHORE_ERROR;
+            // Sea depth is too large relative to wave height to feel the bottom, so do nothing since each cell under the profile has already been initialised with deep water wave height and wave direction
+            dProfileWaveHeight = dProfileDeepWaterWaveHeight;
+            dProfileWaveAngle = dProfileDeepWaterWaveAngle;
          }
+         else
+         {
+            if (! bBreaking)
+            {
+               // Start calculating wave properties using linear wave theory
+               double dL = dL_0 * sqrt(tanh((2 * PI * dSeaDepth) / dL_0));                              // Wavelength (m) in intermediate-shallow waters
+               double dC = dC_0 * tanh((2 * PI * dSeaDepth) / dL);                                      // Wave speed (m/s) set by dSeaDepth, dL and dC_0
+               double dk = 2 * PI / dL;                                                                 // Wave number (1/m)
+               double dn = ((2 * dSeaDepth * dk) / (sinh(2 * dSeaDepth * dk)) + 1) / 2;                 // Shoaling factor
+               double dKs = sqrt(dC_0 / (dn * dC * 2));                                                 // Shoaling coefficient
+               double dAlpha = (180 / PI) * asin((dC / dC_0) * sin((PI / 180) * dWaveToNormalAngle));   // Calculate angle between wave direction and the normal to the coast tangent
+               double dKr = sqrt(cos((PI / 180) * dWaveToNormalAngle) / cos((PI / 180) * dAlpha));      // Refraction coefficient
+               dProfileWaveHeight = dProfileDeepWaterWaveHeight * dKs * dKr;                            // Calculate wave height, based on the previous (more seaward) wave height
+               if (nSeaHand == LEFT_HANDED)
+                  dProfileWaveAngle = dKeepWithin360(dAlpha + 90 + dFluxOrientationThis);
+               else
+                  dProfileWaveAngle = dKeepWithin360(dAlpha + 270 + dFluxOrientationThis);
 
-         // Not too serious, so carry on
+               // Test to see if the wave breaks at this depth
+               if (dProfileWaveHeight < (dSeaDepth * m_dBreakingWaveHeightDepthRatio))
+               {
+                  dProfileBreakingWaveHeight = dProfileWaveHeight;
+                  dProfileBreakingWaveAngle = dProfileWaveAngle;
+               }
+            }
+            else
+            {
+               // It does
+               bBreaking = true;
+
+               // Wave has already broken
+               dProfileWaveAngle = dProfileBreakingWaveAngle; // Wave orientation remains equal to wave orientation at breaking
+
+               dProfileWaveHeight = dProfileBreakingWaveHeight * (nProfilePoint / nProfileBreakingDist); // Wave height decreases linearly to zero at shoreline
+               // dProfileWaveHeight = dSeaDepth * m_dBreakingWaveHeightDepthRatio; // Wave height is limited by depth
+               dProfileBreakingDepth = dSeaDepth;
+               nProfileBreakingDist = nProfilePoint;
+            }
+         }
+
+         // Save current wave attributes
+         VdWaveDirection[nProfilePoint] = dProfileWaveAngle;
+         VdWaveHeight[nProfilePoint] = dProfileWaveHeight;
+         VbWaveIsBreaking[nProfilePoint] = bBreaking;
       }
+
+      // Store the wave properties for this profile
+      SetWavePropertiesOnProfile(nCoast, nProfile, &VdWaveHeight, &VdWaveDirection, &VbWaveIsBreaking, &VdWaveSetupSurge, nProfileBreakingDist, dProfileBreakingWaveHeight, dProfileBreakingWaveAngle, dProfileBreakingDepth, pVdX, pVdY, pVdHeightX, pVdHeightY, pVbBreaking);
+   }
+
+   return RTN_OK;
+}
+
+//===============================================================================================================================
+//! Finishes calculating wave properties along a coastline-normal profile whose CShore input values were added to this coast's CShore batch, once CShore has been run for the batch. The profile's along-profile distances are fetched from the batch, so none of the profile's CShore input values are calculated again: CShore's output values for the profile are just interpolated onto the profile, then converted to wave properties
+//===============================================================================================================================
+int CSimulation::nCalcWavePropertiesOnProfileFromCShoreBatch(int const nCoast, int const nProfile, vector<double>* pVdX, vector<double>* pVdY, vector<double>* pVdHeightX, vector<double>* pVdHeightY, vector<bool>* pVbBreaking, ostream* pLogStream)
+{
+   CCShoreWorkspace* pWorkspace = &m_VCShoreWorkspace[CTaskGraph::nGetThisThread()];
+
+   int
+       nRet = 0,
+       nOutSize = 0;
+
+   m_CShoreBatch.GetProfileDistXY(nProfile, &pWorkspace->m_VdProfileDistXY);
+   m_CShoreBatch.GetProfileResults(nProfile, &nRet, &nOutSize, &pWorkspace->m_VdXYDistOut[0], &pWorkspace->m_VdFreeSurfaceStdOut[0], &pWorkspace->m_VdWaveSetupSurgeOut[0], &pWorkspace->m_VdSinWaveAngleRadiansOut[0], &pWorkspace->m_VdFractionBreakingWavesOut[0]);
+
+   // Check CShore's output values for warnings and errors, then interpolate them onto the profile
+   nRet = nInterpolateCShoreOutputOnProfile(nCoast, nProfile, nRet, nOutSize, pWorkspace, pLogStream);
+   if (nRet != RTN_OK)
+      return nRet;
+
+   // Now convert these to wave height and wave direction and update wave profile attributes
+   CalcWavePropertiesFromCShoreOutput(nCoast, nProfile, pWorkspace, pVdX, pVdY, pVdHeightX, pVdHeightY, pVbBreaking);
+
+   return RTN_OK;
+}
+
+//===============================================================================================================================
+//! Checks the CShore output values for a profile for warnings and errors, then interpolates them onto the profile's points. The output values are in this thread's CShore workspace, and the interpolated values are put there too
+//===============================================================================================================================
+int CSimulation::nInterpolateCShoreOutputOnProfile(int const nCoast, int const nProfile, int const nCShoreError, int nOutSize, CCShoreWorkspace* pWorkspace, ostream* pLogStream)
+{
+   // The output from CShore, these vectors hold as many values as CShore outputs for each profile
+   vector<double>
+       &VdXYDistFromCShoreOut = pWorkspace->m_VdXYDistOut,
+       &VdFreeSurfaceStdOut = pWorkspace->m_VdFreeSurfaceStdOut,
+       &VdWaveSetupSurgeOut = pWorkspace->m_VdWaveSetupSurgeOut,              // TODO 007 Info needed
+       &VdSinWaveAngleRadiansOut = pWorkspace->m_VdSinWaveAngleRadiansOut,
+       &VdFractionBreakingWavesOut = pWorkspace->m_VdFractionBreakingWavesOut;
+
+   // The output from CShore once it has been interpolated onto the profile's points
+   vector<double>
+       &VdProfileDistXY = pWorkspace->m_VdProfileDistXY,
+       &VdFreeSurfaceStd = pWorkspace->m_VdFreeSurfaceStd,
+       &VdWaveSetupSurge = pWorkspace->m_VdWaveSetupSurge,                    // TODO 007 What is this for?
+       &VdSinWaveAngleRadians = pWorkspace->m_VdSinWaveAngleRadians,
+       &VdFractionBreakingWaves = pWorkspace->m_VdFractionBreakingWaves;
+
+   // OK, now check for warnings and errors
+   if (nOutSize < 2)
+   {
+      // CShore sometimes returns only one row of results, which contains data only for the seaward point of the profile. This happens when all other (more coastward) points give an invalid result during CShore's calculations. This is a problem. We don't want to abandon the simulation just because of this, so instead we just put some dummy data into the second row, and carry on with these two rows. The profile will get ignored later, since it is too small to be useful
+      if (m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL)
+         *pLogStream << m_ulIter << ": " << WARN << "for coast " << nCoast << " profile " << nProfile << ", only " << nOutSize << " CShore output row" << endl;
+
+      // Set dummy data in the second row
+      VdXYDistFromCShoreOut[1] = 1e-5;    // Dummy data, must not be the same as VdXYDistFromCShoreOut[0] tho', or get crash in linear interpolation routine
+      VdFreeSurfaceStdOut[1] = VdFreeSurfaceStdOut[0];
+      VdSinWaveAngleRadiansOut[1] = VdSinWaveAngleRadiansOut[0];
+      VdFractionBreakingWavesOut[1] = VdFractionBreakingWavesOut[0];
+      VdWaveSetupSurgeOut[1] = VdWaveSetupSurgeOut[0];                              // TODO 007 Info needed
+      // VdStormSurgeOut[1] = VdStormSurgeOut[0];                                   // TODO 007 Info needed
+      // VdWaveSetupRunUpOut[1] = VdWaveSetupRunUpOut[0];
+
+      // And increase the expected number of rows
+      nOutSize = 2;
+   }
+
+   if (nCShoreError != RTN_OK)
+   {
+      string strErr;
+
+      switch (nCShoreError)
+      {
+         case -1:
+            strErr = to_string(m_ulIter) + ": CShore ERROR: negative depth at the first node ";
+            break;
+
+         case 2:
+            strErr = to_string(m_ulIter) + ": CShore WARNING 2: negative value at end of landward marching computation ";
+            break;
+
+         case 3:
+            strErr = to_string(m_ulIter) + ": CShore WARNING 3: large energy gradients at the first node: small waves with short period at sea boundary ";
+            break;
+
+         case 4:
+            strErr = to_string(m_ulIter) + ": CShore WARNING 4: zero energy at the first node ";
+            break;
+
+         case 5:
+            strErr = to_string(m_ulIter) + ": CShore WARNING 5: at end of landward marching computation, insufficient water depth ";
+            break;
+
+         case 7:
+            strErr = to_string(m_ulIter) + ": CShore WARNING 7: did not reach convergence ";
+            break;
+      }
+
+      strErr += "(coast " + to_string(nCoast) + " profile " + to_string(nProfile) + " profile length " + to_string(nOutSize) + ")\n";
       
-      // TEST nOutsize < nOutSize occasionally
-      //assert(static_cast<int>(VdFreeSurfaceStd.size()) == nOutSize);
-      //LogStream << "VdFreeSurfaceStd.size() = " << nOutSize << " nOutSize = " << nOutSize << endl;
-      
-      // TEST
+      if (nCShoreError < -1)
+      {
+         // This is serious, so give up for this profile
+         cerr << strErr;
+         return RTN_ERR_CSHORE_ERROR;
+      }
+
+      // Not too serious, so carry on
+   }
+   
+   // TEST nOutsize < nOutSize occasionally
+   //assert(static_cast<int>(VdFreeSurfaceStd.size()) == nOutSize);
+   //LogStream << "VdFreeSurfaceStd.size() = " << nOutSize << " nOutSize = " << nOutSize << endl;
+   
+   // TEST
 //       for (int nn = 0; nn < static_cast<int>(VdFreeSurfaceStd.size()); nn++)
 //       {
 //          assert(isfinite(VdProfileDistXY[nn]));
@@ -1102,11 +1413,11 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
 //          assert(isfinite(VdSinWaveAngleRadians[nn]));
 //          assert(isfinite(VdFractionBreakingWaves[nn]));
 //       }
-      
-      // Now interpolate the output
-      InterpolateCShoreOutput(&VdProfileDistXY, nOutSize, &VdXYDistFromCShoreOut, &VdFreeSurfaceStdOut, &VdWaveSetupSurgeOut, &VdSinWaveAngleRadiansOut, &VdFractionBreakingWavesOut, &VdFreeSurfaceStd, &VdWaveSetupSurge, &VdSinWaveAngleRadians, &VdFractionBreakingWaves);
-      
-      // TEST
+   
+   // Now interpolate the output
+   InterpolateCShoreOutput(&VdProfileDistXY, nOutSize, &VdXYDistFromCShoreOut, &VdFreeSurfaceStdOut, &VdWaveSetupSurgeOut, &VdSinWaveAngleRadiansOut, &VdFractionBreakingWavesOut, &VdFreeSurfaceStd, &VdWaveSetupSurge, &VdSinWaveAngleRadians, &VdFractionBreakingWaves, &pWorkspace->m_VdXYDistCShore);
+   
+   // TEST
 //       for (int nn = 0; nn < static_cast<int>(VdFreeSurfaceStd.size()); nn++)
 //       {
 //          assert(isfinite(VdProfileDistXY[nn]));
@@ -1122,161 +1433,123 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
 //          assert(isfinite(VdSinWaveAngleRadians[nn]));
 //          assert(isfinite(VdFractionBreakingWaves[nn]));
 //       }
-#endif
 
-#if defined CSHORE_BOTH
-   #if ! defined _WIN32
-      if (SAVE_CSHORE_OUTPUT)
-      {
-         string strCommand = "./save_CShore_output.sh ";
-         strCommand += to_string(m_ulIter);
-         strCommand += " ";
-         strCommand += to_string(nCoast);
-         strCommand += " ";
-         strCommand += to_string(nProfile);
-
-         nRet = system(strCommand.c_str());
-         if (nRet != RTN_OK)
-            return nRet;
-      }
-   #endif
+   return RTN_OK;
+}
 
-      // Return to the CoastalME folder
-      nRet = chdir(m_strCMEDir.c_str());
-      if (nRet != RTN_OK)
-         return nRet;
-#endif
+//===============================================================================================================================
+//! Converts the CShore output values for a profile, once these have been interpolated onto the profile's points, to wave height and wave direction, then stores the wave properties for the profile
+//===============================================================================================================================
+void CSimulation::CalcWavePropertiesFromCShoreOutput(int const nCoast, int const nProfile, CCShoreWorkspace* pWorkspace, vector<double>* pVdX, vector<double>* pVdY, vector<double>* pVdHeightX, vector<double>* pVdHeightY, vector<bool>* pVbBreaking)
+{
+   CGeomProfile* pProfile = m_VCoast[nCoast].pGetProfile(nProfile);
 
-      // OK we have the CShore output, so now we must convert this to wave height and wave direction and update wave profile attributes
-      for (int nProfilePoint = (nProfileSize - 1); nProfilePoint >= 0; nProfilePoint--)
-      {
-         int
-             nX = pProfile->pPtiGetCellInProfile(nProfilePoint)->nGetX(),
-             nY = pProfile->pPtiGetCellInProfile(nProfilePoint)->nGetY();
-             
-         // Safety check: deal with NaN values
-         if (! isfinite(VdFreeSurfaceStd[nProfilePoint]))
-            VdFreeSurfaceStd[nProfilePoint] = 0;
-             
-         VdWaveHeight[nProfilePoint] = sqrt(8) * VdFreeSurfaceStd[nProfilePoint];
-         
-         // Another safety check: deal with NaN values
-         if (! isfinite(VdSinWaveAngleRadians[nProfilePoint]))
-         {
-            VdSinWaveAngleRadians[nProfilePoint] = 0;
-            VdWaveHeight[nProfilePoint] = 0;
-         }
-         
-         // More safety checks: constrain to the interval -1 to +1 to keep asin() happy
-         if (VdSinWaveAngleRadians[nProfilePoint] < -1)
-            VdSinWaveAngleRadians[nProfilePoint] = -1;
-         if (VdSinWaveAngleRadians[nProfilePoint] > 1)
-            VdSinWaveAngleRadians[nProfilePoint] = 1;
-
-         double dAlpha = asin(VdSinWaveAngleRadians[nProfilePoint]) * (180 / PI);
-         if (nSeaHand == LEFT_HANDED)
-            VdWaveDirection[nProfilePoint] = dKeepWithin360(dAlpha + 90 + dFluxOrientationThis);
-         else
-            VdWaveDirection[nProfilePoint] = dKeepWithin360(dAlpha + 270 + dFluxOrientationThis);
-         
-         // Yet another safety check: deal with NaN values
-         if (! isfinite(VdFractionBreakingWaves[nProfilePoint]))
-         {
-            VdFractionBreakingWaves[nProfilePoint] = 0;
-            VdWaveHeight[nProfilePoint] = 0;
-         }
+   int
+       nSeaHand = m_VCoast[nCoast].nGetSeaHandedness(),
+       nProfileSize = pProfile->nGetNumCellsInProfile();
+   double
+       dFluxOrientationThis = m_VCoast[nCoast].dGetFluxOrientation(pProfile->nGetNumCoastPoint()),
+       dProfileDeepWaterWaveHeight = pProfile->dGetProfileDeepWaterWaveHeight();
 
-         // if ((VdFractionBreakingWaves[nProfilePoint] >= 0.10) && (! bBreaking)) // Sometimes is possible that waves break again
-         if ((VdFractionBreakingWaves[nProfilePoint] >= 0.10) && (m_dDepthOfClosure >= m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth()) && (! bBreaking))
-         {
-            bBreaking = true;
-            // assert(VdWaveHeight[nProfilePoint] >= 0);
-            dProfileBreakingWaveHeight = VdWaveHeight[nProfilePoint];
-            dProfileBreakingWaveAngle = VdWaveDirection[nProfilePoint];
-            dProfileBreakingDepth = m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth(); // Water depth for the cell 'under' this point in the profile
-            nProfileBreakingDist = nProfilePoint + 1;                             // At the nearest point nProfilePoint = 0, so, plus one
-
-            //             LogStream << m_ulIter << ": CShore breaking at [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "} nProfile = " << nProfile << ", nProfilePoint = " << nProfilePoint << ", dBreakingWaveHeight = " << dBreakingWaveHeight << ", dBreakingWaveAngle = " << dBreakingWaveAngle << ", dProfileBreakingDepth = " << dProfileBreakingDepth << ", nProfileBreakingDist = " << nProfileBreakingDist << endl;
-         }
+   // The output from CShore once it has been interpolated onto the profile's points
+   vector<double>
+       &VdFreeSurfaceStd = pWorkspace->m_VdFreeSurfaceStd,               // This is converted to Hrms by Hrms = sqr(8)*FreeSurfaceStd
+       &VdSinWaveAngleRadians = pWorkspace->m_VdSinWaveAngleRadians,     // This is converted to deg by asin(VdSinWaveAngleRadians)*(180/pi)
+       &VdFractionBreakingWaves = pWorkspace->m_VdFractionBreakingWaves; // Is 0 if no wave breaking, and 1 if all waves breaking
 
-         VbWaveIsBreaking[nProfilePoint] = bBreaking;
+   // Initialize the wave properties at breaking for this profile
+   bool bBreaking = false;
+   int nProfileBreakingDist = 0;
+   double
+       dProfileBreakingWaveHeight = DBL_NODATA,
+       dProfileBreakingWaveAngle = 0,
+       dProfileBreakingDepth = 0;
+   vector<bool>
+       VbWaveIsBreaking(nProfileSize, 0);
+   vector<double>
+       VdWaveHeight(nProfileSize, 0),
+       VdWaveDirection(nProfileSize, 0);
+
+   for (int nProfilePoint = (nProfileSize - 1); nProfilePoint >= 0; nProfilePoint--)
+   {
+      int
+          nX = pProfile->pPtiGetCellInProfile(nProfilePoint)->nGetX(),
+          nY = pProfile->pPtiGetCellInProfile(nProfilePoint)->nGetY();
+          
+      // Safety check: deal with NaN values
+      if (! isfinite(VdFreeSurfaceStd[nProfilePoint]))
+         VdFreeSurfaceStd[nProfilePoint] = 0;
+          
+      VdWaveHeight[nProfilePoint] = sqrt(8) * VdFreeSurfaceStd[nProfilePoint];
+      
+      // Another safety check: deal with NaN values
+      if (! isfinite(VdSinWaveAngleRadians[nProfilePoint]))
+      {
+         VdSinWaveAngleRadians[nProfilePoint] = 0;
+         VdWaveHeight[nProfilePoint] = 0;
       }
       
-      if (dProfileBreakingWaveHeight >= dProfileDeepWaterWaveHeight)
+      // More safety checks: constrain to the interval -1 to +1 to keep asin() happy
+      if (VdSinWaveAngleRadians[nProfilePoint] < -1)
+         VdSinWaveAngleRadians[nProfilePoint] = -1;
+      if (VdSinWaveAngleRadians[nProfilePoint] > 1)
+         VdSinWaveAngleRadians[nProfilePoint] = 1;
+
+      double dAlpha = asin(VdSinWaveAngleRadians[nProfilePoint]) * (180 / PI);
+      if (nSeaHand == LEFT_HANDED)
+         VdWaveDirection[nProfilePoint] = dKeepWithin360(dAlpha + 90 + dFluxOrientationThis);
+      else
+         VdWaveDirection[nProfilePoint] = dKeepWithin360(dAlpha + 270 + dFluxOrientationThis);
+      
+      // Yet another safety check: deal with NaN values
+      if (! isfinite(VdFractionBreakingWaves[nProfilePoint]))
       {
-         dProfileBreakingWaveHeight = DBL_NODATA; // checking poorly conditions profiles problems for cshore
+         VdFractionBreakingWaves[nProfilePoint] = 0;
+         VdWaveHeight[nProfilePoint] = 0;
       }
-   }
-
-   else if (m_nWavePropagationModel == WAVE_MODEL_COVE)
-   {
-      // We are using COVE's linear wave theory to propagate the waves
-      double dDepthLookupMax = m_dWaveDepthRatioForWaveCalcs * dProfileDeepWaterWaveHeight;
 
-      // Go landwards along the profile, calculating wave height and wave angle for every inundated point on the profile (don't do point zero, this is on the coastline) until the waves start to break  after breaking wave height is assumed to decrease linearly to zero at the shoreline and wave angle is equalt to wave angle at breaking
-      for (int nProfilePoint = (nProfileSize - 1); nProfilePoint >= 0; nProfilePoint--)
+      // if ((VdFractionBreakingWaves[nProfilePoint] >= 0.10) && (! bBreaking)) // Sometimes is possible that waves break again
+      if ((VdFractionBreakingWaves[nProfilePoint] >= 0.10) && (m_dDepthOfClosure >= m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth()) && (! bBreaking))
       {
-         int
-             nX = pProfile->pPtiGetCellInProfile(nProfilePoint)->nGetX(),
-             nY = pProfile->pPtiGetCellInProfile(nProfilePoint)->nGetY();
-
-         // Safety check
-         if (! m_pRasterGrid->m_Cell[nX][nY].bIsInContiguousSea())
-            continue;
+         bBreaking = true;
+         // assert(VdWaveHeight[nProfilePoint] >= 0);
+         dProfileBreakingWaveHeight = VdWaveHeight[nProfilePoint];
+         dProfileBreakingWaveAngle = VdWaveDirection[nProfilePoint];
+         dProfileBreakingDepth = m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth(); // Water depth for the cell 'under' this point in the profile
+         nProfileBreakingDist = nProfilePoint + 1;                             // At the nearest point nProfilePoint = 0, so, plus one
+
+         //             LogStream << m_ulIter << ": CShore breaking at [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "} nProfile = " << nProfile << ", nProfilePoint = " << nProfilePoint << ", dBreakingWaveHeight = " << dBreakingWaveHeight << ", dBreakingWaveAngle = " << dBreakingWaveAngle << ", dProfileBreakingDepth = " << dProfileBreakingDepth << ", nProfileBreakingDist = " << nProfileBreakingDist << endl;
+      }
 
-         double dSeaDepth = m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth(); // Water depth for the cell 'under' this point in the profile
-         if (dSeaDepth > dDepthLookupMax)
-         {
-            // Sea depth is too large relative to wave height to feel the bottom, so do nothing since each cell under the profile has already been initialised with deep water wave height and wave direction
-            dProfileWaveHeight = dProfileDeepWaterWaveHeight;
-            dProfileWaveAngle = dProfileDeepWaterWaveAngle;
-         }
-         else
-         {
-            if (! bBreaking)
-            {
-               // Start calculating wave properties using linear wave theory
-               double dL = m_dL_0 * sqrt(tanh((2 * PI * dSeaDepth) / m_dL_0));                          // Wavelength (m) in intermediate-shallow waters
-               double dC = m_dC_0 * tanh((2 * PI * dSeaDepth) / dL);                                    // Wave speed (m/s) set by dSeaDepth, dL and m_dC_0
-               double dk = 2 * PI / dL;                                                                 // Wave number (1/m)
-               double dn = ((2 * dSeaDepth * dk) / (sinh(2 * dSeaDepth * dk)) + 1) / 2;                 // Shoaling factor
-               double dKs = sqrt(m_dC_0 / (dn * dC * 2));                                               // Shoaling coefficient
-               double dAlpha = (180 / PI) * asin((dC / m_dC_0) * sin((PI / 180) * dWaveToNormalAngle)); // Calculate angle between wave direction and the normal to the coast tangent
-               double dKr = sqrt(cos((PI / 180) * dWaveToNormalAngle) / cos((PI / 180) * dAlpha));      // Refraction coefficient
-               dProfileWaveHeight = dProfileDeepWaterWaveHeight * dKs * dKr;                            // Calculate wave height, based on the previous (more seaward) wave height
-               if (nSeaHand == LEFT_HANDED)
-                  dProfileWaveAngle = dKeepWithin360(dAlpha + 90 + dFluxOrientationThis);
-               else
-                  dProfileWaveAngle = dKeepWithin360(dAlpha + 270 + dFluxOrientationThis);
+      VbWaveIsBreaking[nProfilePoint] = bBreaking;
+   }
+   
+   if (dProfileBreakingWaveHeight >= dProfileDeepWaterWaveHeight)
+   {
+      dProfileBreakingWaveHeight = DBL_NODATA; // checking poorly conditions profiles problems for cshore
+   }
 
-               // Test to see if the wave breaks at this depth
-               if (dProfileWaveHeight < (dSeaDepth * m_dBreakingWaveHeightDepthRatio))
-               {
-                  dProfileBreakingWaveHeight = dProfileWaveHeight;
-                  dProfileBreakingWaveAngle = dProfileWaveAngle;
-               }
-            }
-            else
-            {
-               // It does
-               bBreaking = true;
+   // Store the wave properties for this profile
+   SetWavePropertiesOnProfile(nCoast, nProfile, &VdWaveHeight, &VdWaveDirection, &VbWaveIsBreaking, &pWorkspace->m_VdWaveSetupSurge, nProfileBreakingDist, dProfileBreakingWaveHeight, dProfileBreakingWaveAngle, dProfileBreakingDepth, pVdX, pVdY, pVdHeightX, pVdHeightY, pVbBreaking);
+}
 
-               // Wave has already broken
-               dProfileWaveAngle = dProfileBreakingWaveAngle; // Wave orientation remains equal to wave orientation at breaking
+//===============================================================================================================================
+//! Stores the wave properties which have been calculated along a coastline-normal profile: the wave properties at each of the profile's inundated cells are appended to the profile's vectors, and the wave properties at the profile's coast point are set
+//===============================================================================================================================
+void CSimulation::SetWavePropertiesOnProfile(int const nCoast, int const nProfile, vector<double> const* pVdWaveHeight, vector<double> const* pVdWaveDirection, vector<bool> const* pVbWaveIsBreaking, vector<double> const* pVdWaveSetupSurge, int const nProfileBreakingDist, double const dProfileBreakingWaveHeight, double const dProfileBreakingWaveAngle, double const dProfileBreakingDepth, vector<double>* pVdX, vector<double>* pVdY, vector<double>* pVdHeightX, vector<double>* pVdHeightY, vector<bool>* pVbBreaking)
+{
+   CGeomProfile* pProfile = m_VCoast[nCoast].pGetProfile(nProfile);
 
-               dProfileWaveHeight = dProfileBreakingWaveHeight * (nProfilePoint / nProfileBreakingDist); // Wave height decreases linearly to zero at shoreline
-               // dProfileWaveHeight = dSeaDepth * m_dBreakingWaveHeightDepthRatio; // Wave height is limited by depth
-               dProfileBreakingDepth = dSeaDepth;
-               nProfileBreakingDist = nProfilePoint;
-            }
-         }
+   int
+       nCoastPoint = pProfile->nGetNumCoastPoint(),
+       nProfileSize = pProfile->nGetNumCellsInProfile();
+   double dDeepWaterWavePeriod = pProfile->dGetProfileDeepWaterWavePeriod();
 
-         // Save current wave attributes
-         VdWaveDirection[nProfilePoint] = dProfileWaveAngle;
-         VdWaveHeight[nProfilePoint] = dProfileWaveHeight;
-         VbWaveIsBreaking[nProfilePoint] = bBreaking;
-      }
-   }
+   vector<bool> const& VbWaveIsBreaking = *pVbWaveIsBreaking;
+   vector<double> const
+       &VdWaveHeight = *pVdWaveHeight,
+       &VdWaveDirection = *pVdWaveDirection,
+       &VdWaveSetupSurge = *pVdWaveSetupSurge;
 
    // Go landwards along the profile, fetching the calculated wave height and wave angle for every inundated point on this profile
    for (int nProfilePoint = (nProfileSize - 1); nProfilePoint >= 0; nProfilePoint--)
@@ -1294,7 +1567,7 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
           dWaveHeight = VdWaveHeight[nProfilePoint],
           dWaveAngle = VdWaveDirection[nProfilePoint];
 
-      bBreaking = VbWaveIsBreaking[nProfilePoint];
+      bool bBreaking = VbWaveIsBreaking[nProfilePoint];
 
       // And store the wave properties for this point in the all-profiles vectors
       pVdX->push_back(nX);
@@ -1439,22 +1712,21 @@ int CSimulation::nCalcWavePropertiesOnProfile(int const nCoast, int const nCoast
       //       LogStream << m_ulIter << ": nProfile = " << nProfile << ", nCoastPoint = " << nCoastPoint << " NOT in active zone" << endl;
    }
 
-   return RTN_OK;
 }
 
 #if defined CSHORE_FILE_INOUT
 //===============================================================================================================================
 //! Create and write to the CShore input file
 //===============================================================================================================================
-int CSimulation::nCreateCShoreInfile(int const nCoast, int const nProfile, int const nILine, int const nIProfl, int const nIPerm, int const nIOver, int const nIWcint, int const nIRoll, int const nIWind, int const nITide, int const nILab, int const nWave, int const nSurge, double const dX, double const dTimestep, double const dWaveInitTime, double const dWavePeriod, double const dHrms, double const dWaveAngle, double const dSurgeInitTime, double const dSurgeLevel, vector<double> const* pVdXdist, vector<double> const* pVdBottomElevation, vector<double> const* pVdWaveFriction)
+int CSimulation::nCreateCShoreInfile(string const* pstrInfile, int const nCoast, int const nProfile, int const nILine, int const nIProfl, int const nIPerm, int const nIOver, int const nIWcint, int const nIRoll, int const nIWind, int const nITide, int const nILab, int const nWave, int const nSurge, double const dX, double const dTimestep, double const dWaveInitTime, double const dWavePeriod, double const dHrms, double const dWaveAngle, double const dSurgeInitTime, double const dSurgeLevel, vector<double> const* pVdXdist, vector<double> const* pVdBottomElevation, vector<double> const* pVdWaveFriction, ostream* pLogStream)
 {
    // Create the CShore input file
    ofstream CShoreOutStream;
-   CShoreOutStream.open(CSHORE_INFILE.c_str(), ios::out | ios::app);
+   CShoreOutStream.open(pstrInfile->c_str(), ios::out | ios::trunc);
    if (CShoreOutStream.fail())
    {
       // Error, cannot open file for writing
-      LogStream << m_ulIter << ": " << ERR << "cannot write to CShore input file '" << CSHORE_INFILE << "'" << endl;
+      *pLogStream << m_ulIter << ": " << ERR << "cannot write to CShore input file '" << *pstrInfile << "'" << endl;
       return RTN_ERR_CSHORE_FILE_INPUT;
    }
 
@@ -1518,7 +1790,7 @@ int CSimulation::nCreateCShoreInfile(int const nCoast, int const nProfile, int c
 //===============================================================================================================================
 //! Get profile horizontal distance and bottom elevation vectors in CShore units
 //===============================================================================================================================
-int CSimulation::nGetThisProfileElevationVectorsForCShore(int const nCoast, int const nProfile, int const nProfSize, vector<double> *VdDistXY, vector<double> *VdVZ, vector<double> *VdFricF)
+int CSimulation::nGetThisProfileElevationVectorsForCShore(int const nCoast, int const nProfile, int const nProfSize, vector<double> *VdDistXY, vector<double> *VdVZ, vector<double> *VdFricF, ostream* pLogStream)
 {
    bool bIsBehindIntervention = false;
 
@@ -1581,7 +1853,7 @@ int CSimulation::nGetThisProfileElevationVectorsForCShore(int const nCoast, int
             VdVZ->push_back(0.5);      // TODO 053 Set it to a smal +ve elevation. However there must be a better way of doing this
             
             // Could not create the profile elevation vectors
-            LogStream << m_ulIter << ": landward location is negative. Changing for CShore profile elevation vector " << nProfile << endl;
+            *pLogStream << m_ulIter << ": landward location is negative. Changing for CShore profile elevation vector " << nProfile << endl;
          }
          else
          {
@@ -1623,7 +1895,7 @@ int CSimulation::nGetThisProfileElevationVectorsForCShore(int const nCoast, int
 //===============================================================================================================================
 //! Reads a CShore output file and creates a vector holding interpolated values
 //===============================================================================================================================
-int CSimulation::nReadCShoreOutput(int const nProfile, string const *strCShoreFilename, int const nExpectedColumns, int const nCShorecolumn, vector<double> const* pVdProfileDistXYCME, vector<double>* pVdInterpolatedValues)
+int CSimulation::nReadCShoreOutput(int const nProfile, string const *strCShoreFilename, int const nExpectedColumns, int const nCShorecolumn, vector<double> const* pVdProfileDistXYCME, vector<double>* pVdInterpolatedValues, ostream* pLogStream)
 {
    // Read in the first column (contains XY distance relative to seaward limit) and CShore column from the CShore output file
    ifstream InStream;
@@ -1633,7 +1905,7 @@ int CSimulation::nReadCShoreOutput(int const nProfile, string const *strCShoreFi
    if (! InStream.is_open())
    {
       // Error: cannot open CShore file for input
-      LogStream << m_ulIter << ": " << ERR << "for profile " << nProfile << ", cannot open " << *strCShoreFilename << " for input" << endl;
+      *pLogStream << m_ulIter << ": " << ERR << "for profile " << nProfile << ", cannot open " << *strCShoreFilename << " for input" << endl;
 
       return RTN_ERR_READING_CSHORE_FILE_OUTPUT;
    }
@@ -1659,7 +1931,7 @@ int CSimulation::nReadCShoreOutput(int const nProfile, string const *strCShoreFi
          {
             string strErr = ERR + "invalid integer for number of expected rows '" + VstrItems[1] + "' in " + *strCShoreFilename + "\n";
             cerr << strErr;
-            LogStream << strErr;
+            *pLogStream << strErr;
 
             return RTN_ERR_READING_CSHORE_FILE_OUTPUT;
          }
@@ -1676,7 +1948,7 @@ int CSimulation::nReadCShoreOutput(int const nProfile, string const *strCShoreFi
          if (nCols != nExpectedColumns)
          {
             // Error: did not read the expected number of CShore output columns
-            LogStream << m_ulIter << ": " << ERR << "for profile " << nProfile << ", expected " << nExpectedColumns << " CShore output columns but read " << nCols << " columns from header section of file " << *strCShoreFilename << endl;
+            *pLogStream << m_ulIter << ": " << ERR << "for profile " << nProfile << ", expected " << nExpectedColumns << " CShore output columns but read " << nCols << " columns from header section of file " << *strCShoreFilename << endl;
 
             return RTN_ERR_READING_CSHORE_FILE_OUTPUT;
          }
@@ -1692,7 +1964,7 @@ int CSimulation::nReadCShoreOutput(int const nProfile, string const *strCShoreFi
    if (nReadRows != nExpectedRows)
    {
       // Error: did not get nExpectedRows CShore output rows
-      LogStream << m_ulIter << ": " << ERR << "for profile " << nProfile << ", expected " << nExpectedRows << " CShore output rows, but read " << nReadRows << " rows from file " << *strCShoreFilename << endl;
+      *pLogStream << m_ulIter << ": " << ERR << "for profile " << nProfile << ", expected " << nExpectedRows << " CShore output rows, but read " << nReadRows << " rows from file " << *strCShoreFilename << endl;
 
       return RTN_ERR_READING_CSHORE_FILE_OUTPUT;
    }
@@ -1701,7 +1973,7 @@ int CSimulation::nReadCShoreOutput(int const nProfile, string const *strCShoreFi
    {
       // CShore sometimes returns only one row, which contains data for the seaward point of the profile. This happens when all other (more coastward) points give an invalid result during CShore's calculations. This is a problem. We don't want to abandon the simulation just because of this, so instead we just duplicate the row, so that the profile will later get marked as invalid
       if (m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL)
-         LogStream << m_ulIter << ": " << WARN << "for profile " << nProfile << ", only " << nReadRows << " CShore output rows in file " << *strCShoreFilename << endl;
+         *pLogStream << m_ulIter << ": " << WARN << "for profile " << nProfile << ", only " << nReadRows << " CShore output rows in file " << *strCShoreFilename << endl;
 
       // Duplicate the data
       VdXYDistCShore.push_back(VdXYDistCShore[0]);
@@ -1723,50 +1995,31 @@ int CSimulation::nReadCShoreOutput(int const nProfile, string const *strCShoreFi
    reverse(VdValuesCShore.begin(), VdValuesCShore.end());
 
    // Using a simple linear interpolation approach
-   vector<double> VdDistXYCopy(pVdProfileDistXYCME->begin(), pVdProfileDistXYCME->end());
-
    // assertVdXYDistCShoreTmp.size() == VdValuesCShore.size());
-   *pVdInterpolatedValues = VdInterpolateCShoreProfileOutput(&VdXYDistCShoreTmp, &VdValuesCShore, &VdDistXYCopy);
+   InterpolateCShoreProfileOutput(&VdXYDistCShoreTmp, &VdValuesCShore, pVdProfileDistXYCME, pVdInterpolatedValues);
 
    return RTN_OK;
 }
 #endif
 
-#if defined CSHORE_ARG_INOUT || CSHORE_BOTH
 //===============================================================================================================================
-//! Interpolates CShore output
+//! Interpolates CShore output. The CShore cross-shore distances, with the origin at the shoreline, are put in pVdXYDistCShore
 //===============================================================================================================================
-void CSimulation::InterpolateCShoreOutput(vector<double> const* pVdProfileDistXYCME, int const nOutSize, vector<double> const* pVdXYDistFromCShoreOut, vector<double> const* pVdFreeSurfaceStdCShore, vector<double> const* pVdWaveSetupSurgeCShore, vector<double> const* pVdSinWaveAngleRadiansCShore, vector<double> const* pVdFractionBreakingWavesCShore, vector<double>* pVdFreeSurfaceStdCME, vector<double>* pVdWaveSetupSurgeCME, vector<double>* pVdSinWaveAngleRadiansCME, vector<double>* pVdFractionBreakingWavesCME)
+void CSimulation::InterpolateCShoreOutput(vector<double> const* pVdProfileDistXYCME, int const nOutSize, vector<double> const* pVdXYDistFromCShoreOut, vector<double> const* pVdFreeSurfaceStdCShore, vector<double> const* pVdWaveSetupSurgeCShore, vector<double> const* pVdSinWaveAngleRadiansCShore, vector<double> const* pVdFractionBreakingWavesCShore, vector<double>* pVdFreeSurfaceStdCME, vector<double>* pVdWaveSetupSurgeCME, vector<double>* pVdSinWaveAngleRadiansCME, vector<double>* pVdFractionBreakingWavesCME, vector<double>* pVdXYDistCShore)
 {
-   // The CShore cross-shore distance has its origin at the seaward end, so create a copy of the valid part of this which is in the CME convention (i.e. with the origin at the shoreline)
-   vector<double> VdXYDistCShoreTmp(nOutSize, 0);
+   // The CShore cross-shore distance has its origin at the seaward end, so put the valid part of this into the CME convention (i.e. with the origin at the shoreline)
+   pVdXYDistCShore->resize(nOutSize);
    for (int i = 0; i < nOutSize; i++)
-      VdXYDistCShoreTmp[i] = pVdXYDistFromCShoreOut->at(nOutSize - 1) - pVdXYDistFromCShoreOut->at(i);
-
-   vector<double> VdFreeSurfaceStdCShoreTmp(pVdFreeSurfaceStdCShore->begin(), pVdFreeSurfaceStdCShore->begin() + nOutSize);
-   vector<double> VdWaveSetupSurgeCShoreTmp(pVdWaveSetupSurgeCShore->begin(), pVdWaveSetupSurgeCShore->begin() + nOutSize);   // TODO 057 Sometimes get -ve values here, is this OK?
-   vector<double> VdSinWaveAngleRadiansCShoreTmp(pVdSinWaveAngleRadiansCShore->begin(), pVdSinWaveAngleRadiansCShore->begin() + nOutSize);
-   vector<double> VdFractionBreakingWavesCShoreTmp(pVdFractionBreakingWavesCShore->begin(), pVdFractionBreakingWavesCShore->begin() + nOutSize);
-   
-   // And reverse these to fit the CME convention, with the origin at the shoreline
-   reverse(VdFreeSurfaceStdCShoreTmp.begin(), VdFreeSurfaceStdCShoreTmp.end());
-   reverse(VdWaveSetupSurgeCShoreTmp.begin(), VdWaveSetupSurgeCShoreTmp.end());
-   // reverse(VdStormSurgeCShoreTmp.begin(), VdStormSurgeCShoreTmp.end());
-   // reverse(VdWaveSetupRunUpCShoreTmp.begin(), VdWaveSetupRunUpCShoreTmp.end());
-   reverse(VdSinWaveAngleRadiansCShoreTmp.begin(), VdSinWaveAngleRadiansCShoreTmp.end());
-   reverse(VdFractionBreakingWavesCShoreTmp.begin(), VdFractionBreakingWavesCShoreTmp.end());
-
-   // Using the simple linear approach
-   vector<double> VdDistXYCopy(pVdProfileDistXYCME->begin(), pVdProfileDistXYCME->end());
-
-   *pVdFreeSurfaceStdCME = VdInterpolateCShoreProfileOutput(&VdXYDistCShoreTmp, pVdFreeSurfaceStdCShore, &VdDistXYCopy);
-   *pVdWaveSetupSurgeCME = VdInterpolateCShoreProfileOutput(&VdXYDistCShoreTmp, pVdWaveSetupSurgeCShore, &VdDistXYCopy);
-   // *pVdStormSurgeCME = VdInterpolateCShoreProfileOutput(&VdXYDistCShoreTmp, pVdStormSurgeCShore, &VdDistXYCopy);
-   // *pVdWaveSetupRunUpCME = VdInterpolateCShoreProfileOutput(&VdXYDistCShoreTmp, pVdWaveSetupRunUpCShore, &VdDistXYCopy);
-   *pVdSinWaveAngleRadiansCME = VdInterpolateCShoreProfileOutput(&VdXYDistCShoreTmp, pVdSinWaveAngleRadiansCShore, &VdDistXYCopy);
-   *pVdFractionBreakingWavesCME = VdInterpolateCShoreProfileOutput(&VdXYDistCShoreTmp, pVdFractionBreakingWavesCShore, &VdDistXYCopy);
+      pVdXYDistCShore->at(i) = pVdXYDistFromCShoreOut->at(nOutSize - 1) - pVdXYDistFromCShoreOut->at(i);
+
+   // Using the simple linear approach. Note that the CShore output values are interpolated as they were output by CShore, i.e. they are not reversed to fit the CME convention
+   InterpolateCShoreProfileOutput(pVdXYDistCShore, pVdFreeSurfaceStdCShore, pVdProfileDistXYCME, pVdFreeSurfaceStdCME);
+   InterpolateCShoreProfileOutput(pVdXYDistCShore, pVdWaveSetupSurgeCShore, pVdProfileDistXYCME, pVdWaveSetupSurgeCME);   // TODO 057 Sometimes get -ve values here, is this OK?
+   // InterpolateCShoreProfileOutput(pVdXYDistCShore, pVdStormSurgeCShore, pVdProfileDistXYCME, pVdStormSurgeCME);
+   // InterpolateCShoreProfileOutput(pVdXYDistCShore, pVdWaveSetupRunUpCShore, pVdProfileDistXYCME, pVdWaveSetupRunUpCME);
+   InterpolateCShoreProfileOutput(pVdXYDistCShore, pVdSinWaveAngleRadiansCShore, pVdProfileDistXYCME, pVdSinWaveAngleRadiansCME);
+   InterpolateCShoreProfileOutput(pVdXYDistCShore, pVdFractionBreakingWavesCShore, pVdProfileDistXYCME, pVdFractionBreakingWavesCME);
 }
-#endif
 
 //===============================================================================================================================
 //! Modifies the wave breaking properties at coastline points of profiles within the shadow zone
@@ -2140,16 +2393,27 @@ void CSimulation::CalcCoastTangents(int const nCoast)
 }
 
 //===============================================================================================================================
-//! Calculates an average d50 for each polygon. Also fills in 'holes' in active zone and wave calcs i.e. orphan cells which should have been included in the active zone but which have been omitted because of rounding problems
+//! Calculates an average d50 for each polygon. Also fills in 'holes' in active zone and wave calcs i.e. orphan cells which should have been included in the active zone but which have been omitted because of rounding problems. If bActiveWindowOnly is true, only the cells in the active window are done: this must only be asked for if all cells have the same deep water wave values
 //===============================================================================================================================
-void CSimulation::CalcD50AndFillWaveCalcHoles(void)
+void CSimulation::CalcD50AndFillWaveCalcHoles(bool const bActiveWindowOnly)
 {
    vector<int> VnPolygonD50Count(m_nGlobalPolygonID + 1, 0);
    vector<double> VdPolygonD50(m_nGlobalPolygonID + 1, 0);
 
-   for (int nX = 0; nX < m_nXGridMax; nX++)
+   m_WaveCache.m_bCalcPolygonD50 = true;
+
+   // Polygons, the active zone, and shadow and downdrift zones all lie within the active window. If all cells have the same deep water wave values, then a sea cell outside the active window has those values, so filling holes changes it little if at all: if asked, just do the active window. See CSimulation::nCheckActiveWindowHoleFill(), which checks this. But if deep water wave values vary from cell to cell, then filling holes will smooth them everywhere, so the whole grid must be done
+   int
+      nXMin = 0,
+      nXEnd = m_nXGridMax,
+      nYMin = 0,
+      nYEnd = m_nYGridMax;
+   if (bActiveWindowOnly)
+      GetActiveWindow(false, nXMin, nXEnd, nYMin, nYEnd);
+
+   for (int nX = nXMin; nX < nXEnd; nX++)
    {
-      for (int nY = 0; nY < m_nYGridMax; nY++)
+      for (int nY = nYMin; nY < nYEnd; nY++)
       {
          if (m_pRasterGrid->m_Cell[nX][nY].bIsInContiguousSea())
          {
@@ -2400,3 +2664,353 @@ void CSimulation::CalcD50AndFillWaveCalcHoles(void)
       }
    }
 }
+
+//===============================================================================================================================
+//! Calculates an average d50 for each polygon, from the active zone cells which have unconsolidated sediment. This is used when wave propagation results are reused, since the active zone is then already known but the sediment may have changed
+//===============================================================================================================================
+void CSimulation::CalcAllPolygonD50(void)
+{
+   vector<int> VnPolygonD50Count(m_nGlobalPolygonID + 1, 0);
+   vector<double> VdPolygonD50(m_nGlobalPolygonID + 1, 0);
+
+   // The active zone lies within the active window
+   int
+      nXMin = 0,
+      nXEnd = 0,
+      nYMin = 0,
+      nYEnd = 0;
+   GetActiveWindow(false, nXMin, nXEnd, nYMin, nYEnd);
+
+   for (int nX = nXMin; nX < nXEnd; nX++)
+   {
+      for (int nY = nYMin; nY < nYEnd; nY++)
+      {
+         if ((! m_pRasterGrid->m_Cell[nX][nY].bIsInContiguousSea()) || (! m_pRasterGrid->m_Cell[nX][nY].bIsInActiveZone()))
+            continue;
+
+         int nID = m_pRasterGrid->m_Cell[nX][nY].nGetPolygonID();
+         if (nID == INT_NODATA)
+            continue;
+
+         // If dGetUnconsD50() returns DBL_NODATA, there is no unconsolidated sediment on this cell
+         double dTmpd50 = m_pRasterGrid->m_Cell[nX][nY].dGetUnconsD50();
+         if (! bFPIsEqual(dTmpd50, DBL_NODATA, TOLERANCE))
+         {
+            VnPolygonD50Count[nID]++;
+            VdPolygonD50[nID] += dTmpd50;
+         }
+      }
+   }
+
+   for (int nCoast = 0; nCoast < static_cast<int>(m_VCoast.size()); nCoast++)
+   {
+      for (int nPoly = 0; nPoly < m_VCoast[nCoast].nGetNumPolygons(); nPoly++)
+      {
+         CGeomCoastPolygon* pPolygon = m_VCoast[nCoast].pGetPolygon(nPoly);
+         int nID = pPolygon->nGetGlobalID();
+
+         if (VnPolygonD50Count[nID] > 0)
+            VdPolygonD50[nID] /= VnPolygonD50Count[nID];
+
+         pPolygon->SetAvgUnconsD50(VdPolygonD50[nID]);
+      }
+   }
+}
+
+//===============================================================================================================================
+//! Called just before waves are fully propagated, when the results may later be reused (or checked against results which are reused). Keeps, in the given wave cache, the total wave height and total wave orientation of every cell, so that the change made to these by propagating waves can be found
+//===============================================================================================================================
+void CSimulation::StartWaveCache(CWaveCache* pCache)
+{
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+   diag_t const* ptTotWaveHeight = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_WAVE_HEIGHT);
+   diag_t const* ptTotWaveAngle = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_WAVE_ANGLE);
+
+   pCache->Invalidate();
+   pCache->m_bCalcPolygonD50 = false;
+   pCache->m_VdTotWaveHeightChange.assign(ptTotWaveHeight, ptTotWaveHeight + ulNumCells);
+   pCache->m_VdTotWaveAngleChange.assign(ptTotWaveAngle, ptTotWaveAngle + ulNumCells);
+}
+
+//===============================================================================================================================
+//! Called just after waves have been fully propagated, stores in the given wave cache the results of doing so, and the inputs from which these were calculated, so that the results may be reused on later timesteps
+//===============================================================================================================================
+void CSimulation::SaveWaveCache(CWaveCache* pCache)
+{
+   // The deep water wave forcing, and the still water level
+   if (m_bSingleDeepWaterWaveValues)
+   {
+      pCache->m_VdDeepWaterWaveHeight.assign(1, m_dAllCellsDeepWaterWaveHeight);
+      pCache->m_VdDeepWaterWaveAngle.assign(1, m_dAllCellsDeepWaterWaveAngle);
+      pCache->m_VdDeepWaterWavePeriod.assign(1, m_dAllCellsDeepWaterWavePeriod);
+   }
+   else
+   {
+      pCache->m_VdDeepWaterWaveHeight = m_VdThisIterDeepWaterWaveStationHeight;
+      pCache->m_VdDeepWaterWaveAngle = m_VdThisIterDeepWaterWaveStationAngle;
+      pCache->m_VdDeepWaterWavePeriod = m_VdThisIterDeepWaterWaveStationPeriod;
+   }
+
+   pCache->m_dSWL = m_dThisIterSWL;
+
+   // The coasts and profiles, and the wave values at each coast point
+   int nNumCoasts = static_cast<int>(m_VCoast.size());
+   pCache->m_VnCoastSize.resize(nNumCoasts);
+   pCache->m_VnCoastStartX.resize(nNumCoasts);
+   pCache->m_VnCoastStartY.resize(nNumCoasts);
+   pCache->m_VnNumProfiles.resize(nNumCoasts);
+   pCache->m_VVLShadowBoundary.resize(nNumCoasts);
+   pCache->m_VVLShadowDowndriftBoundary.resize(nNumCoasts);
+
+   pCache->m_VnProfileCoastPoint.clear();
+   pCache->m_VbProfileOK.clear();
+   pCache->m_VdProfileDeepWaterWaveHeight.clear();
+   pCache->m_VdProfileDeepWaterWaveAngle.clear();
+   pCache->m_VdProfileDeepWaterWavePeriod.clear();
+
+   pCache->m_VnBreakingDistance.clear();
+   pCache->m_VdBreakingWaveHeight.clear();
+   pCache->m_VdCoastWaveHeight.clear();
+   pCache->m_VdBreakingWaveAngle.clear();
+   pCache->m_VdWaveSetupSurge.clear();
+   pCache->m_VdRunUp.clear();
+   pCache->m_VdDepthOfBreaking.clear();
+   pCache->m_VdWaveEnergyAtBreaking.clear();
+
+   for (int nCoast = 0; nCoast < nNumCoasts; nCoast++)
+   {
+      int
+         nCoastSize = m_VCoast[nCoast].nGetCoastlineSize(),
+         nNumProfiles = m_VCoast[nCoast].nGetNumProfiles();
+
+      pCache->m_VnCoastSize[nCoast] = nCoastSize;
+      pCache->m_VnCoastStartX[nCoast] = m_VCoast[nCoast].pPtiGetCellMarkedAsCoastline(0)->nGetX();
+      pCache->m_VnCoastStartY[nCoast] = m_VCoast[nCoast].pPtiGetCellMarkedAsCoastline(0)->nGetY();
+      pCache->m_VnNumProfiles[nCoast] = nNumProfiles;
+
+      for (int nProfile = 0; nProfile < nNumProfiles; nProfile++)
+      {
+         CGeomProfile const* pProfile = m_VCoast[nCoast].pGetProfile(nProfile);
+
+         pCache->m_VnProfileCoastPoint.push_back(pProfile->nGetNumCoastPoint());
+         pCache->m_VbProfileOK.push_back(pProfile->bOKIncStartAndEndOfCoast());
+         pCache->m_VdProfileDeepWaterWaveHeight.push_back(pProfile->dGetProfileDeepWaterWaveHeight());
+         pCache->m_VdProfileDeepWaterWaveAngle.push_back(pProfile->dGetProfileDeepWaterWaveAngle());
+         pCache->m_VdProfileDeepWaterWavePeriod.push_back(pProfile->dGetProfileDeepWaterWavePeriod());
+      }
+
+      for (int nPoint = 0; nPoint < nCoastSize; nPoint++)
+      {
+         pCache->m_VnBreakingDistance.push_back(m_VCoast[nCoast].nGetBreakingDistance(nPoint));
+         pCache->m_VdBreakingWaveHeight.push_back(m_VCoast[nCoast].dGetBreakingWaveHeight(nPoint));
+         pCache->m_VdCoastWaveHeight.push_back(m_VCoast[nCoast].dGetCoastWaveHeight(nPoint));
+         pCache->m_VdBreakingWaveAngle.push_back(m_VCoast[nCoast].dGetBreakingWaveAngle(nPoint));
+         pCache->m_VdWaveSetupSurge.push_back(m_VCoast[nCoast].dGetWaveSetupSurge(nPoint));
+         pCache->m_VdRunUp.push_back(m_VCoast[nCoast].dGetRunUp(nPoint));
+         pCache->m_VdDepthOfBreaking.push_back(m_VCoast[nCoast].dGetDepthOfBreaking(nPoint));
+         pCache->m_VdWaveEnergyAtBreaking.push_back(m_VCoast[nCoast].dGetWaveEnergyAtBreaking(nPoint));
+      }
+
+      pCache->m_VVLShadowBoundary[nCoast].clear();
+      for (int n = 0; n < m_VCoast[nCoast].nGetNumShadowBoundaries(); n++)
+         pCache->m_VVLShadowBoundary[nCoast].push_back(*m_VCoast[nCoast].pGetShadowBoundary(n));
+
+      pCache->m_VVLShadowDowndriftBoundary[nCoast].clear();
+      for (int n = 0; n < m_VCoast[nCoast].nGetNumShadowDowndriftBoundaries(); n++)
+         pCache->m_VVLShadowDowndriftBoundary[nCoast].push_back(*m_VCoast[nCoast].pGetShadowDowndriftBoundary(n));
+   }
+
+   // The wave, active zone, and shadow zone values of every cell. StartWaveCache() left the total wave height and orientation before waves were propagated in m_VdTotWaveHeightChange and m_VdTotWaveAngleChange, so replace these by the change
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+   unsigned long ulNumWords = m_pRasterGrid->ulGetNumFlagWords();
+   diag_t const* ptWaveHeight = m_pRasterGrid->ptGetDiagField(CELL_DIAG_WAVE_HEIGHT);
+   diag_t const* ptWaveAngle = m_pRasterGrid->ptGetDiagField(CELL_DIAG_WAVE_ANGLE);
+   diag_t const* ptTotWaveHeight = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_WAVE_HEIGHT);
+   diag_t const* ptTotWaveAngle = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_WAVE_ANGLE);
+   int const* pnShadowZone = m_pRasterGrid->pnGetField(CELL_INT_SHADOW_ZONE);
+   int const* pnDownDriftZone = m_pRasterGrid->pnGetField(CELL_INT_DOWNDRIFT_ZONE);
+   uint64_t const* pulSea = m_pRasterGrid->pulGetFlagWords(CELL_FLAG_IN_CONTIGUOUS_SEA);
+   uint64_t const* pulActiveZone = m_pRasterGrid->pulGetFlagWords(CELL_FLAG_IN_ACTIVE_ZONE);
+   uint64_t const* pulShadowBoundary = m_pRasterGrid->pulGetFlagWords(CELL_FLAG_SHADOW_BOUNDARY);
+
+   pCache->m_VdWaveHeight.assign(ptWaveHeight, ptWaveHeight + ulNumCells);
+   pCache->m_VdWaveAngle.assign(ptWaveAngle, ptWaveAngle + ulNumCells);
+   for (unsigned long n = 0; n < ulNumCells; n++)
+   {
+      pCache->m_VdTotWaveHeightChange[n] = ptTotWaveHeight[n] - pCache->m_VdTotWaveHeightChange[n];
+      pCache->m_VdTotWaveAngleChange[n] = ptTotWaveAngle[n] - pCache->m_VdTotWaveAngleChange[n];
+   }
+
+   pCache->m_VnShadowZone.assign(pnShadowZone, pnShadowZone + ulNumCells);
+   pCache->m_VnDownDriftZone.assign(pnDownDriftZone, pnDownDriftZone + ulNumCells);
+   pCache->m_VulSea.assign(pulSea, pulSea + ulNumWords);
+   pCache->m_VulActiveZone.assign(pulActiveZone, pulActiveZone + ulNumWords);
+   pCache->m_VulShadowBoundary.assign(pulShadowBoundary, pulShadowBoundary + ulNumWords);
+
+   pCache->m_nXMinActiveWindow = m_nXMinActiveWindow;
+   pCache->m_nXMaxActiveWindow = m_nXMaxActiveWindow;
+   pCache->m_nYMinActiveWindow = m_nYMinActiveWindow;
+   pCache->m_nYMaxActiveWindow = m_nYMaxActiveWindow;
+
+   pCache->m_dBedChange = 0;
+   pCache->m_nConsecutiveReuses = 0;
+   pCache->m_ulNumComputed++;
+   pCache->m_bValid = true;
+}
+
+//===============================================================================================================================
+//! Returns true if the stored results of the last full wave propagation may be reused this timestep. They may be if: they have not already been reused for the maximum number of consecutive timesteps; the coasts and profiles are the same; and the changes in deep water wave forcing, still water level and sediment thickness since then are all within the user-supplied tolerances
+//===============================================================================================================================
+bool CSimulation::bCanReuseWaveCache(void)
+{
+   if ((m_nMaxWaveReuses <= 0) || (! m_WaveCache.bIsValid()) || (m_WaveCache.m_nConsecutiveReuses >= m_nMaxWaveReuses))
+      return false;
+
+   // A sediment input event changes the sediment thickness during this timestep, after the change in sediment thickness has been checked
+   if (m_bSedimentInputThisIter)
+      return false;
+
+   if (m_WaveCache.m_dBedChange > m_dWaveReuseBedTolerance)
+      return false;
+
+   if (tAbs(m_dThisIterSWL - m_WaveCache.m_dSWL) > m_dWaveReuseSWLTolerance)
+      return false;
+
+   // Compare the deep water wave forcing
+   if (m_bSingleDeepWaterWaveValues)
+   {
+      if (m_WaveCache.m_VdDeepWaterWaveHeight.size() != 1)
+         return false;
+
+      if ((tAbs(m_dAllCellsDeepWaterWaveHeight - m_WaveCache.m_VdDeepWaterWaveHeight[0]) > m_dWaveReuseHeightTolerance) || (tAbs(m_dAllCellsDeepWaterWavePeriod - m_WaveCache.m_VdDeepWaterWavePeriod[0]) > m_dWaveReusePeriodTolerance) || (CWaveCache::dGetAngleDifference(m_dAllCellsDeepWaterWaveAngle, m_WaveCache.m_VdDeepWaterWaveAngle[0]) > m_dWaveReuseAngleTolerance))
+         return false;
+   }
+   else
+   {
+      if (m_WaveCache.m_VdDeepWaterWaveHeight.size() != m_VdThisIterDeepWaterWaveStationHeight.size())
+         return false;
+
+      for (unsigned int n = 0; n < m_VdThisIterDeepWaterWaveStationHeight.size(); n++)
+      {
+         if ((tAbs(m_VdThisIterDeepWaterWaveStationHeight[n] - m_WaveCache.m_VdDeepWaterWaveHeight[n]) > m_dWaveReuseHeightTolerance) || (tAbs(m_VdThisIterDeepWaterWaveStationPeriod[n] - m_WaveCache.m_VdDeepWaterWavePeriod[n]) > m_dWaveReusePeriodTolerance) || (CWaveCache::dGetAngleDifference(m_VdThisIterDeepWaterWaveStationAngle[n], m_WaveCache.m_VdDeepWaterWaveAngle[n]) > m_dWaveReuseAngleTolerance))
+            return false;
+      }
+   }
+
+   // Compare the coasts and profiles. A coast which is unchanged since last timestep is also unchanged since the results were stored, since otherwise waves would have been propagated again
+   int nNumCoasts = static_cast<int>(m_VCoast.size());
+   if (nNumCoasts != static_cast<int>(m_WaveCache.m_VnCoastSize.size()))
+      return false;
+
+   int nProfileIndex = 0;
+   for (int nCoast = 0; nCoast < nNumCoasts; nCoast++)
+   {
+      if (! m_VCoast[nCoast].bIsUnchanged())
+         return false;
+
+      if (m_VCoast[nCoast].nGetCoastlineSize() != m_WaveCache.m_VnCoastSize[nCoast])
+         return false;
+
+      CGeom2DIPoint const* pPtiStart = m_VCoast[nCoast].pPtiGetCellMarkedAsCoastline(0);
+      if ((pPtiStart->nGetX() != m_WaveCache.m_VnCoastStartX[nCoast]) || (pPtiStart->nGetY() != m_WaveCache.m_VnCoastStartY[nCoast]))
+         return false;
+
+      int nNumProfiles = m_VCoast[nCoast].nGetNumProfiles();
+      if (nNumProfiles != m_WaveCache.m_VnNumProfiles[nCoast])
+         return false;
+
+      for (int nProfile = 0; nProfile < nNumProfiles; nProfile++, nProfileIndex++)
+      {
+         CGeomProfile const* pProfile = m_VCoast[nCoast].pGetProfile(nProfile);
+
+         if ((pProfile->nGetNumCoastPoint() != m_WaveCache.m_VnProfileCoastPoint[nProfileIndex]) || (pProfile->bOKIncStartAndEndOfCoast() != m_WaveCache.m_VbProfileOK[nProfileIndex]))
+            return false;
+
+         if ((tAbs(pProfile->dGetProfileDeepWaterWaveHeight() - m_WaveCache.m_VdProfileDeepWaterWaveHeight[nProfileIndex]) > m_dWaveReuseHeightTolerance) || (tAbs(pProfile->dGetProfileDeepWaterWavePeriod() - m_WaveCache.m_VdProfileDeepWaterWavePeriod[nProfileIndex]) > m_dWaveReusePeriodTolerance) || (CWaveCache::dGetAngleDifference(pProfile->dGetProfileDeepWaterWaveAngle(), m_WaveCache.m_VdProfileDeepWaterWaveAngle[nProfileIndex]) > m_dWaveReuseAngleTolerance))
+            return false;
+      }
+   }
+
+   return true;
+}
+
+//===============================================================================================================================
+//! Reuses the stored results of the last full wave propagation, instead of propagating waves. The wave values of cells which are sea cells both now and when the results were stored are replaced by the stored values; other sea cells keep their deep water wave values
+//===============================================================================================================================
+void CSimulation::RestoreWaveCache(void)
+{
+   // The wave values at each coast point, and the shadow zone boundaries
+   int nPointIndex = 0;
+   for (int nCoast = 0; nCoast < static_cast<int>(m_VCoast.size()); nCoast++)
+   {
+      for (int nPoint = 0; nPoint < m_VCoast[nCoast].nGetCoastlineSize(); nPoint++, nPointIndex++)
+      {
+         m_VCoast[nCoast].SetBreakingDistance(nPoint, m_WaveCache.m_VnBreakingDistance[nPointIndex]);
+         m_VCoast[nCoast].SetBreakingWaveHeight(nPoint, m_WaveCache.m_VdBreakingWaveHeight[nPointIndex]);
+         m_VCoast[nCoast].SetCoastWaveHeight(nPoint, m_WaveCache.m_VdCoastWaveHeight[nPointIndex]);
+         m_VCoast[nCoast].SetBreakingWaveAngle(nPoint, m_WaveCache.m_VdBreakingWaveAngle[nPointIndex]);
+         m_VCoast[nCoast].SetWaveSetupSurge(nPoint, m_WaveCache.m_VdWaveSetupSurge[nPointIndex]);
+         m_VCoast[nCoast].SetRunUp(nPoint, m_WaveCache.m_VdRunUp[nPointIndex]);
+         m_VCoast[nCoast].SetDepthOfBreaking(nPoint, m_WaveCache.m_VdDepthOfBreaking[nPointIndex]);
+         m_VCoast[nCoast].SetWaveEnergyAtBreaking(nPoint, m_WaveCache.m_VdWaveEnergyAtBreaking[nPointIndex]);
+      }
+
+      for (unsigned int n = 0; n < m_WaveCache.m_VVLShadowBoundary[nCoast].size(); n++)
+         m_VCoast[nCoast].AppendShadowBoundary(&m_WaveCache.m_VVLShadowBoundary[nCoast][n]);
+
+      for (unsigned int n = 0; n < m_WaveCache.m_VVLShadowDowndriftBoundary[nCoast].size(); n++)
+         m_VCoast[nCoast].AppendShadowDowndriftBoundary(&m_WaveCache.m_VVLShadowDowndriftBoundary[nCoast][n]);
+   }
+
+   // The wave, active zone and shadow zone values of each cell, a flag word (64 cells) at a time
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+   unsigned long ulNumWords = m_pRasterGrid->ulGetNumFlagWords();
+   diag_t* ptWaveHeight = m_pRasterGrid->ptGetDiagField(CELL_DIAG_WAVE_HEIGHT);
+   diag_t* ptWaveAngle = m_pRasterGrid->ptGetDiagField(CELL_DIAG_WAVE_ANGLE);
+   diag_t* ptTotWaveHeight = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_WAVE_HEIGHT);
+   diag_t* ptTotWaveAngle = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_WAVE_ANGLE);
+   int* pnShadowZone = m_pRasterGrid->pnGetField(CELL_INT_SHADOW_ZONE);
+   int* pnDownDriftZone = m_pRasterGrid->pnGetField(CELL_INT_DOWNDRIFT_ZONE);
+   uint64_t const* pulSea = m_pRasterGrid->pulGetFlagWords(CELL_FLAG_IN_CONTIGUOUS_SEA);
+
+   for (unsigned long nWord = 0; nWord < ulNumWords; nWord++)
+   {
+      uint64_t ulBits = pulSea[nWord] & m_WaveCache.m_VulSea[nWord];
+      if (ulBits == 0)
+         continue;
+
+      uint64_t ulActiveZone = m_WaveCache.m_VulActiveZone[nWord];
+      uint64_t ulShadowBoundary = m_WaveCache.m_VulShadowBoundary[nWord];
+      unsigned long nEnd = tMin(nWord * 64 + 64, ulNumCells);
+      for (unsigned long n = nWord * 64; n < nEnd; n++, ulBits >>= 1, ulActiveZone >>= 1, ulShadowBoundary >>= 1)
+      {
+         if (! (ulBits & 1))
+            continue;
+
+         ptWaveHeight[n] = tToDiag(m_WaveCache.m_VdWaveHeight[n]);
+         ptWaveAngle[n] = tToDiag(m_WaveCache.m_VdWaveAngle[n]);
+         ptTotWaveHeight[n] += tToDiag(m_WaveCache.m_VdTotWaveHeightChange[n]);
+         ptTotWaveAngle[n] += tToDiag(m_WaveCache.m_VdTotWaveAngleChange[n]);
+
+         pnShadowZone[n] = m_WaveCache.m_VnShadowZone[n];
+         pnDownDriftZone[n] = m_WaveCache.m_VnDownDriftZone[n];
+
+         m_pRasterGrid->SetFlag(CELL_FLAG_IN_ACTIVE_ZONE, n, (ulActiveZone & 1) != 0);
+         m_pRasterGrid->SetFlag(CELL_FLAG_SHADOW_BOUNDARY, n, (ulShadowBoundary & 1) != 0);
+      }
+   }
+
+   // The shadow zones and downdrift zones lie within the stored active window
+   if (m_WaveCache.m_nXMinActiveWindow <= m_WaveCache.m_nXMaxActiveWindow)
+   {
+      ExpandActiveWindow(m_WaveCache.m_nXMinActiveWindow, m_WaveCache.m_nYMinActiveWindow);
+      ExpandActiveWindow(m_WaveCache.m_nXMaxActiveWindow, m_WaveCache.m_nYMaxActiveWindow);
+   }
+
+   // The sediment has changed since the results were stored, so calculate the D50 of each polygon again
+   if (m_WaveCache.m_bCalcPolygonD50)
+      CalcAllPolygonD50();
+
+   m_WaveCache.m_nConsecutiveReuses++;
+   m_WaveCache.m_ulNumReused++;
+}
@@ -26,59 +26,9 @@ You should have received a copy of the GNU General Public License along with thi
 #include "cme.h"
 #include "cell.h"
 
-//! Constructor with initialization list
+//! Constructor. The initial values of this cell's scalar values are set by CGeomRasterGrid, when the field planes are created
 CGeomCell::CGeomCell()
-    : m_bInContiguousSea(false),
-      m_bInContiguousFlood(false),        // TODO 007 What is this?
-      m_bIsInActiveZone(false),
-      m_bCoastline(false),
-      m_bFloodLine(false),
-      m_bWaveFlood(false),
-      // m_bCheckCell(false),             // TODO 007 What is this?
-      m_bCheckFloodCell(false),           // TODO 007 What is this?
-      m_bShadowBoundary(false),
-      m_bPossibleCoastStartCell(false),
-      m_bPossibleFloodStartCell(false),   // TODO 007 What is this?
-      m_nBoundingBoxEdge(NO_DIRECTION),
-      m_nPolygonID(INT_NODATA),
-      m_nCoastlineNormal(INT_NODATA),
-      m_nShadowZoneNumber(0),
-      m_nDownDriftZoneNumber(0),
-      m_dLocalConsSlope(0),
-      m_dBasementElevation(0),
-      m_dSeaDepth(0),
-      m_dTotSeaDepth(0),
-      m_dWaveHeight(0),
-      m_dTotWaveHeight(0),
-      m_dWaveAngle(DBL_NODATA),
-      m_dTotWaveAngle(DBL_NODATA),
-      m_dDeepWaterWaveHeight(DBL_NODATA),
-      m_dDeepWaterWaveAngle(DBL_NODATA),
-      m_dBeachProtectionFactor(DBL_NODATA),
-      m_dSuspendedSediment(0),
-      m_dTotSuspendedSediment(0),
-      m_dPotentialPlatformErosionThisIter(0),
-      m_dTotPotentialPlatformErosion(0),
-      m_dActualPlatformErosionThisIter(0),
-      m_dTotActualPlatformErosion(0),
-      m_dCliffCollapseFineThisIter(0),
-      m_dCliffCollapseSandThisIter(0),
-      m_dCliffCollapseCoarseThisIter(0),
-      m_dTotFineCliffCollapse(0),
-      m_dTotSandCliffCollapse(0),
-      m_dTotCoarseCliffCollapse(0),
-      m_dTalusSandDepositionThisIter(0),
-      m_dTotTalusSandDeposition(0),
-      m_dTalusCoarseDepositionThisIter(0),
-      m_dTotTalusCoarseDeposition(0),
-      m_dPotentialBeachErosionThisIter(0),
-      m_dTotPotentialBeachErosion(0),
-      m_dActualBeachErosionThisIter(0),
-      m_dTotActualBeachErosion(0),
-      m_dBeachDepositionThisIter(0),
-      m_dTotBeachDeposition(0),
-      m_dUnconsD50(0),
-      m_dInterventionHeight(0)
+: m_pGrid(NULL)
 {
    m_Landform.SetLFCategory(LF_NONE);
 }
@@ -88,177 +38,237 @@ CGeomCell::~CGeomCell(void)
 {
 }
 
+//! Sets the raster grid which holds this cell's values
+void CGeomCell::SetGrid(CGeomRasterGrid* pGrid)
+{
+   m_pGrid = pGrid;
+}
+
+//! Returns this cell's index into the CGeomRasterGrid field planes
+inline unsigned long CGeomCell::ulGetIndex(void) const
+{
+   return static_cast<unsigned long>(this - m_pGrid->m_pCellBlock);
+}
+
+//! Returns a read-only pointer to this cell's sediment layers, which are held by the grid tile containing this cell (layer 0 being just above basement)
+inline CRWCellLayer const* CGeomCell::pGetLayers(void) const
+{
+   return m_pGrid->pGetCellLayers(ulGetIndex());
+}
+
+//! Returns a pointer to this cell's sediment layers (layer 0 being just above basement), so that they can be written. If this cell's tile is compact, the tile is expanded first
+inline CRWCellLayer* CGeomCell::pGetLayersForWrite(void)
+{
+   return m_pGrid->pGetCellLayersForWrite(ulGetIndex());
+}
+
+//! Returns a pointer to this cell's horizon top elevations in the grid's horizon cube (element 0 being the top of the basement)
+inline double* CGeomCell::pdGetAllHorizonTopElev(void) const
+{
+   return m_pGrid->m_pdHorizonTopElev + (ulGetIndex() * (m_pGrid->m_nLayers + 1));
+}
+
+//! Returns this cell's value in one of the grid's flag bit planes
+inline bool CGeomCell::bGetCellFlag(int const nFlag) const
+{
+   return m_pGrid->bGetFlag(nFlag, ulGetIndex());
+}
+
+//! Sets or clears this cell's value in one of the grid's flag bit planes
+inline void CGeomCell::SetCellFlag(int const nFlag, bool const bValue) const
+{
+   m_pGrid->SetFlag(nFlag, ulGetIndex(), bValue);
+}
+
+//! Returns a reference to this cell's value in one of the grid's int-valued field planes
+inline int& CGeomCell::nField(int const nCode) const
+{
+   return m_pGrid->m_pnCellField[nCode][ulGetIndex()];
+}
+
+//! Returns a reference to this cell's value in one of the grid's double-valued field planes
+inline double& CGeomCell::dField(int const nCode) const
+{
+   return m_pGrid->m_pdCellField[nCode][ulGetIndex()];
+}
+
+//! Returns a reference to this cell's value in one of the grid's diagnostic and wave field planes
+inline diag_t& CGeomCell::tDiagField(int const nCode) const
+{
+   return m_pGrid->m_ptDiagField[nCode][ulGetIndex()];
+}
+
 //! Set the edge number if this cell is an edge bounding-box cell
 void CGeomCell::SetBoundingBoxEdge(int const nDirection)
 {
-   m_nBoundingBoxEdge = nDirection;
+   nField(CELL_INT_BOUNDING_BOX_EDGE) = nDirection;
 }
 
 //! Returns the number of the bounding-box edge, or NO_DIRECTION if it is not
 int CGeomCell::nGetBoundingBoxEdge(void) const
 {
-   return m_nBoundingBoxEdge;
+   return nField(CELL_INT_BOUNDING_BOX_EDGE);
 }
 
 //! Is this an edge bounding-box cell?
 bool CGeomCell::bIsBoundingBoxEdge(void) const
 {
-   return (m_nBoundingBoxEdge != NO_DIRECTION);
+   return (nField(CELL_INT_BOUNDING_BOX_EDGE) != NO_DIRECTION);
 }
 
 //! Set this cell as a sea cell
 void CGeomCell::SetInContiguousSea(void)
 {
-   m_bInContiguousSea = true;
+   SetCellFlag(CELL_FLAG_IN_CONTIGUOUS_SEA, true);
 }
 
 //! Is this a sea cell?
 bool CGeomCell::bIsInContiguousSea(void) const
 {
-   return m_bInContiguousSea;
+   return bGetCellFlag(CELL_FLAG_IN_CONTIGUOUS_SEA);
 }
 
 //! TODO 007 What do this do? Does it duplicate SetInContiguousSea()?
 void CGeomCell::SetInContiguousFlood(void)
 {
-   m_bInContiguousFlood = true;
+   SetCellFlag(CELL_FLAG_IN_CONTIGUOUS_FLOOD, true);
 }
 
 //! TODO 007 What does this do? Is it just the inverse of SetInContiguousSea()?
 void CGeomCell::UnSetInContiguousFlood(void)
 {
-   m_bInContiguousFlood = false;
+   SetCellFlag(CELL_FLAG_IN_CONTIGUOUS_FLOOD, false);
 }
 
 //! TODO 007 What does this do? Set this cell as flood by setup surger
 void CGeomCell::SetFloodBySetupSurge(void)
 {
-   m_bFloodBySetupSurge = true;
+   SetCellFlag(CELL_FLAG_FLOOD_BY_SETUP_SURGE, true);
 }
 
 //! TODO 007 What does this do? Is this cell flood by setup surge?
 bool CGeomCell::bIsFloodBySetupSurge(void) const
 {
-   return m_bFloodBySetupSurge;
+   return bGetCellFlag(CELL_FLAG_FLOOD_BY_SETUP_SURGE);
 }
 
 //! TODO 007 What does this do? Set this cell as flood by setup surge runup
 void CGeomCell::SetFloodBySetupSurgeRunup(void)
 {
-   m_bFloodBySetupSurgeRunup = true;
+   SetCellFlag(CELL_FLAG_FLOOD_BY_SETUP_SURGE_RUNUP, true);
 }
 
 //! TODO 007 What does this do? Is this cell flood by setup surge runup?
 bool CGeomCell::bIsFloodBySetupSurgeRunup(void) const
 {
-   return m_bFloodBySetupSurgeRunup;
+   return bGetCellFlag(CELL_FLAG_FLOOD_BY_SETUP_SURGE_RUNUP);
 }
 
 //! TODO 007 What does this do? Does it just duplicate bIsInContiguousSea()?
 bool CGeomCell::bIsInContiguousFlood(void) const
 {
-   return m_bInContiguousFlood;
+   return bGetCellFlag(CELL_FLAG_IN_CONTIGUOUS_FLOOD);
 }
 
 //! Sets a flag to show whether this cell is in the active zone
-void CGeomCell::SetInActiveZone(bool const bFlag)
+void CGeomCell::SetInActiveZone(bool const bNewFlag)
 {
-   m_bIsInActiveZone = bFlag;
+   SetCellFlag(CELL_FLAG_IN_ACTIVE_ZONE, bNewFlag);
 }
 
 //! Returns a flag which shows whether this cell is in the active zone
 bool CGeomCell::bIsInActiveZone(void) const
 {
-   return m_bIsInActiveZone;
+   return bGetCellFlag(CELL_FLAG_IN_ACTIVE_ZONE);
 }
 
 //! Sets a flag to show that this cell is a shadow zone boundary
 void CGeomCell::SetShadowZoneBoundary(void)
 {
-   m_bShadowBoundary = true;
+   SetCellFlag(CELL_FLAG_SHADOW_BOUNDARY, true);
 }
 
 //! Returns a flag which shows whether this cell is a shadow zone boundary
 bool CGeomCell::bIsShadowZoneBoundary(void) const
 {
-   return m_bShadowBoundary;
+   return bGetCellFlag(CELL_FLAG_SHADOW_BOUNDARY);
 }
 
 //! Sets a flag to show that this cell has been flagged as a possible start- or end-point for a coastline
 void CGeomCell::SetPossibleCoastStartCell(void)
 {
-   m_bPossibleCoastStartCell = true;
+   SetCellFlag(CELL_FLAG_POSSIBLE_COAST_START, true);
 }
 
 //! Returns a flag which shows whether this cell has been flagged as a possible start- or end-point for a coastline
 bool CGeomCell::bIsPossibleCoastStartCell(void) const
 {
-   return m_bPossibleCoastStartCell;
+   return bGetCellFlag(CELL_FLAG_POSSIBLE_COAST_START);
 }
 
 //! TODO 007 What is this for? Sets a flag to show that this cell has been flagged as a possible start-point for a coastline
 void CGeomCell::SetPossibleFloodStartCell(void)
 {
-   m_bPossibleFloodStartCell = true;
+   SetCellFlag(CELL_FLAG_POSSIBLE_FLOOD_START, true);
 }
 
 // //! TODO 007 What is this for? Returns a flag which shows whether this cell has been flagged as a possible start- or end-point for a coastline
 // bool CGeomCell::bIsPossibleFloodStartCell(void) const
 // {
-//    return m_bPossibleFloodStartCell;
+//    return bGetCellFlag(CELL_FLAG_POSSIBLE_FLOOD_START);
 // }
 
 //! Returns true if this cell has had potential erosion this timestep
 bool CGeomCell::bPotentialPlatformErosion(void) const
 {
-   return (m_dPotentialPlatformErosionThisIter > 0);
+   return (dField(CELL_DBL_POTENTIAL_PLATFORM_EROSION) > 0);
 }
 
 // bool CGeomCell::bActualPlatformErosion(void) const
 // {
-//    return (m_dActualPlatformErosionThisIter > 0);
+//    return (dField(CELL_DBL_ACTUAL_PLATFORM_EROSION) > 0);
 // }
 
 //! Marks this cell as 'under' a coastline
 void CGeomCell::SetAsCoastline(bool const bNewFlag)
 {
-   m_bCoastline = bNewFlag;
+   SetCellFlag(CELL_FLAG_COASTLINE, bNewFlag);
 }
 
 //! Returns true if the cell is 'under' a coastline
 bool CGeomCell::bIsCoastline(void) const
 {
-   return m_bCoastline;
+   return bGetCellFlag(CELL_FLAG_COASTLINE);
 }
 
 //! Marks this cell is flood line
 void CGeomCell::SetAsFloodLine(bool const bNewFlag)
 {
-   m_bFloodLine = bNewFlag;
+   SetCellFlag(CELL_FLAG_FLOOD_LINE, bNewFlag);
 }
 
 //! Returns true if the cell is flood line
 bool CGeomCell::bIsFloodLine(void) const
 {
-   return m_bFloodLine;
+   return bGetCellFlag(CELL_FLAG_FLOOD_LINE);
 }
 
 //! Marks this cell as 'under' a coastline-normal profile
 void CGeomCell::SetProfile(int const nNormal)
 {
-   m_nCoastlineNormal = nNormal;
+   nField(CELL_INT_COASTLINE_NORMAL) = nNormal;
 }
 
 //! If this cell is 'under' a coastline-normal profile, returns the number of the profile. Otherwise it returns INT_NODATA
 int CGeomCell::nGetProfile(void) const
 {
-   return m_nCoastlineNormal;
+   return nField(CELL_INT_COASTLINE_NORMAL);
 }
 
 //! Returns true if this cell is 'under' a coastline normal
 bool CGeomCell::bIsProfile(void) const
 {
-   if (m_nCoastlineNormal == INT_NODATA)
+   if (nField(CELL_INT_COASTLINE_NORMAL) == INT_NODATA)
       return false;
 
    return true;
@@ -267,31 +277,31 @@ bool CGeomCell::bIsProfile(void) const
 //! Sets the global ID number of the polygon which 'contains' this cell
 void CGeomCell::SetPolygonID(int const nPolyID)
 {
-   m_nPolygonID = nPolyID;
+   nField(CELL_INT_POLYGON_ID) = nPolyID;
 }
 
 //! Returns the global ID number of the polygon which 'contains' this cell (returns INT_NODATA if the cell is not 'in' a polygon)
 int CGeomCell::nGetPolygonID(void) const
 {
-   return m_nPolygonID;
+   return nField(CELL_INT_POLYGON_ID);
 }
 
 //! Set the number of the shadow zone that this cell is in
 void CGeomCell::SetShadowZoneNumber(int const nCode)
 {
-   m_nShadowZoneNumber = nCode;
+   nField(CELL_INT_SHADOW_ZONE) = nCode;
 }
 
 //! Gets the number of the shadow zone that this cell is in
 int CGeomCell::nGetShadowZoneNumber(void) const
 {
-   return m_nShadowZoneNumber;
+   return nField(CELL_INT_SHADOW_ZONE);
 }
 
 //! Returns true if this cell is in the shadow zone with number given by the parameter, false otherwise
 bool CGeomCell::bIsinThisShadowZone(int const nZone) const
 {
-   if (m_nShadowZoneNumber == nZone)
+   if (nField(CELL_INT_SHADOW_ZONE) == nZone)
       return true;
 
    return false;
@@ -300,7 +310,7 @@ bool CGeomCell::bIsinThisShadowZone(int const nZone) const
 //! Returns true if this cell is in any shadow zone, false otherwise
 bool CGeomCell::bIsinAnyShadowZone(void) const
 {
-   if (m_nShadowZoneNumber != 0)
+   if (nField(CELL_INT_SHADOW_ZONE) != 0)
       return true;
 
    return false;
@@ -309,7 +319,7 @@ bool CGeomCell::bIsinAnyShadowZone(void) const
 // Set this cell as flooded by swl + surge + setup + runup
 // void CGeomCell::SetWaveFlood(void)
 // {
-//    m_bWaveFlood = true;
+//    SetCellFlag(CELL_FLAG_WAVE_FLOOD, true);
 // }
 
 // void CGeomCell::SetWaveSetup(int const dWaveSetup)
@@ -337,10 +347,10 @@ bool CGeomCell::bIsinAnyShadowZone(void) const
 //    return m_dTotLevel;
 // }
 
-//! Returns true if the top elevation of this cell (sediment plus any intervention) is less than this iteration's total water level
-bool CGeomCell::bIsElevLessThanWaterLevel(void) const
+//! Returns true if the top elevation of this cell (sediment plus any intervention) is less than the given water level, which is this iteration's total water level plus SWL
+bool CGeomCell::bIsElevLessThanWaterLevel(double const dWaterLevel) const
 {
-   return ((m_VdAllHorizonTopElev.back() + m_dInterventionHeight) < (m_pGrid->pGetSim()->dGetThisIterTotWaterLevel() + m_pGrid->pGetSim()->dGetThisIterSWL()));
+   return ((dField(CELL_DBL_SEDIMENT_TOP_ELEV) + dField(CELL_DBL_INTERVENTION_HEIGHT)) < dWaterLevel);
 }
 
 // //! Set this cell as checked TODO What is this used for?
@@ -358,31 +368,31 @@ bool CGeomCell::bIsElevLessThanWaterLevel(void) const
 //! Set this cell as checked (flood switch)
 void CGeomCell::SetCheckFloodCell(void)
 {
-   m_bCheckFloodCell = true;
+   SetCellFlag(CELL_FLAG_CHECK_FLOOD, true);
 }
 
 //! Set the cell as not checked (flood switch)
 void CGeomCell::UnSetCheckFloodCell(void)
 {
-   m_bCheckFloodCell = false;
+   SetCellFlag(CELL_FLAG_CHECK_FLOOD, false);
 }
 
 //! Returns true if this cell is checked, false otherwise (flood switch)
 bool CGeomCell::bIsCellFloodCheck(void) const
 {
-   return m_bCheckFloodCell;
+   return bGetCellFlag(CELL_FLAG_CHECK_FLOOD);
 }
 
 //! Sets the down drift zone number
 void CGeomCell::SetDownDriftZoneNumber(int const nCode)
 {
-   m_nDownDriftZoneNumber = nCode;
+   nField(CELL_INT_DOWNDRIFT_ZONE) = nCode;
 }
 
 //! Gets the down drift zone number
 int CGeomCell::nGetDownDriftZoneNumber(void) const
 {
-   return m_nDownDriftZoneNumber;
+   return nField(CELL_INT_DOWNDRIFT_ZONE);
 }
 
 //! Returns a pointer to this cell's CRWCellLandform object
@@ -394,31 +404,31 @@ CRWCellLandform *CGeomCell::pGetLandform(void)
 //! Sets the local slope of the consolidated sediment only
 void CGeomCell::SetLocalConsSlope(double const dNewSlope)
 {
-   m_dLocalConsSlope = dNewSlope;
+   tDiagField(CELL_DIAG_LOCAL_CONS_SLOPE) = tToDiag(dNewSlope);
 }
 
 //! Returns the local slope of the consolidated sediment only
 double CGeomCell::dGetLocalConsSlope(void) const
 {
-   return m_dLocalConsSlope;
+   return tDiagField(CELL_DIAG_LOCAL_CONS_SLOPE);
 }
 
 //! Sets this cell's basement elevation
 void CGeomCell::SetBasementElev(double const dNewElev)
 {
-   m_dBasementElevation = dNewElev;
+   dField(CELL_DBL_BASEMENT_ELEV) = dNewElev;
 }
 
 //! Returns this cell's basement elevation
 double CGeomCell::dGetBasementElev(void) const
 {
-   return (m_dBasementElevation);
+   return (dField(CELL_DBL_BASEMENT_ELEV));
 }
 
 //! Returns true if this cells's basement data is NODATA, is needed for irregularly-shaped DEMs
 bool CGeomCell::bBasementElevIsMissingValue(void) const
 {
-   if (bFPIsEqual(m_dBasementElevation, m_pGrid->pGetSim()->CSimulation::dGetMissingValue(), TOLERANCE))
+   if (bFPIsEqual(dField(CELL_DBL_BASEMENT_ELEV), m_pGrid->pGetSim()->CSimulation::dGetMissingValue(), TOLERANCE))
       return true;
 
    return false;
@@ -427,51 +437,52 @@ bool CGeomCell::bBasementElevIsMissingValue(void) const
 //! Returns the depth of seawater on this cell
 double CGeomCell::dGetSeaDepth(void) const
 {
-   return (m_dSeaDepth);
+   return (dField(CELL_DBL_SEA_DEPTH));
 }
 
 //! Returns the total depth of seawater on this cell
 double CGeomCell::dGetTotSeaDepth(void) const
 {
-   return (m_dTotSeaDepth);
+   return (tDiagField(CELL_DIAG_TOT_SEA_DEPTH));
 }
 
 //! Sets this cell's suspended sediment depth equivalent, it also increments the running total of suspended sediment depth equivalent
 void CGeomCell::SetSuspendedSediment(double const dNewSedDepth)
 {
    // Note no checks here to see if new equiv depth is sensible (e.g. non-negative)
-   m_dSuspendedSediment = dNewSedDepth;
-   m_dTotSuspendedSediment += dNewSedDepth;
+   dField(CELL_DBL_SUSP_SED) = dNewSedDepth;
+   tDiagField(CELL_DIAG_TOT_SUSP_SED) += tToDiag(dNewSedDepth);
 }
 
 //! Adds to this cell's suspended sediment depth equivalent, it also increments the running total of suspended sediment depth equivalent
 void CGeomCell::AddSuspendedSediment(double const dIncSedDepth)
 {
    // Note no checks here to see if increment equiv depth is sensible (e.g. non-negative)
-   m_dSuspendedSediment += dIncSedDepth;
-   m_dTotSuspendedSediment += dIncSedDepth;
+   dField(CELL_DBL_SUSP_SED) += dIncSedDepth;
+   tDiagField(CELL_DIAG_TOT_SUSP_SED) += tToDiag(dIncSedDepth);
 }
 
 //! Returns the suspended sediment depth equivalent on this cell
 double CGeomCell::dGetSuspendedSediment(void) const
 {
-   return (m_dSuspendedSediment);
+   return (dField(CELL_DBL_SUSP_SED));
 }
 
 //! Returns the total suspended sediment depth equivalent on this cell
 double CGeomCell::dGetTotSuspendedSediment(void) const
 {
-   return (m_dTotSuspendedSediment);
+   return (tDiagField(CELL_DIAG_TOT_SUSP_SED));
 }
 
 //! Returns the index of the topmost sediment layer (layer 0 being the one just above basement) with non-zero thickness. If there is no such layer, it returns NO_NONZERO_THICKNESS_LAYERS
 int CGeomCell::nGetTopNonZeroLayerAboveBasement(void) const
 {
-   if (m_VLayerAboveBasement.empty())
+   if (m_pGrid->m_nLayers == 0)
       return INT_NODATA;
 
-   int nTop = static_cast<int>(m_VLayerAboveBasement.size()) - 1;
-   while (m_VLayerAboveBasement[nTop].dGetTotalThickness() <= 0)
+   CRWCellLayer const* pLayer = pGetLayers();
+   int nTop = m_pGrid->m_nLayers - 1;
+   while (pLayer[nTop].dGetTotalThickness() <= 0)
    {
       if (--nTop < 0)
          return NO_NONZERO_THICKNESS_LAYERS;
@@ -483,25 +494,26 @@ int CGeomCell::nGetTopNonZeroLayerAboveBasement(void) const
 //! Returns the index of the topmost sediment layer (layer 0 being the one just above basement), which could have zero thickness
 int CGeomCell::nGetTopLayerAboveBasement(void) const
 {
-   if (m_VLayerAboveBasement.empty())
+   if (m_pGrid->m_nLayers == 0)
       return INT_NODATA;
 
-   return static_cast<int>(m_VLayerAboveBasement.size()) - 1;
+   return m_pGrid->m_nLayers - 1;
 }
 
 //! Returns the elevation of the top of the consolidated sediment only, for a given layer (layer 0 being the one just above basement)
 double CGeomCell::dGetConsSedTopForLayerAboveBasement(int const nLayer) const
 {
-   // Note no check to see if nLayer < m_VLayerAboveBasement.size()
-   double dTopElev = m_dBasementElevation;
+   // Note no check to see if nLayer < the number of layers
+   CRWCellLayer const* pLayer = pGetLayers();
+   double dTopElev = dField(CELL_DBL_BASEMENT_ELEV);
 
    for (int n = 0; n < nLayer; n++)
    {
-      dTopElev += m_VLayerAboveBasement[n].dGetUnconsolidatedThickness();
-      dTopElev += m_VLayerAboveBasement[n].dGetConsolidatedThickness();
+      dTopElev += pLayer[n].dGetUnconsolidatedThickness();
+      dTopElev += pLayer[n].dGetConsolidatedThickness();
    }
 
-   dTopElev += m_VLayerAboveBasement[nLayer].dGetConsolidatedThickness();
+   dTopElev += pLayer[nLayer].dGetConsolidatedThickness();
 
    return dTopElev;
 }
@@ -510,13 +522,20 @@ double CGeomCell::dGetConsSedTopForLayerAboveBasement(int const nLayer) const
 CRWCellLayer *CGeomCell::pGetLayerAboveBasement(int const nLayer)
 {
    // TODO 055 No check that nLayer < size()
-   return &m_VLayerAboveBasement[nLayer];
+   return pGetLayersForWrite() + nLayer;
+}
+
+//! Return a read-only reference to the Nth sediment layer (layer 0 being just above basement). Unlike pGetLayerAboveBasement(), this never expands a compact tile
+CRWCellLayer const* CGeomCell::pGetConstLayerAboveBasement(int const nLayer) const
+{
+   // TODO 055 No check that nLayer < size()
+   return pGetLayers() + nLayer;
 }
 
 // //! Returns the volume-equivalent elevation of the sediment's top surface for this cell (i.e. if there is a cliff notch, then lower the elevation by the notch's volume)
 // double CGeomCell::dGetVolEquivSedTopElev(void) const
 // {
-//    double dTopElev = m_dBasementElevation;
+//    double dTopElev = dField(CELL_DBL_BASEMENT_ELEV);
 //    for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
 //    {
 //       dTopElev += (m_VLayerAboveBasement[n].dGetUnconsolidatedThickness() - m_VLayerAboveBasement[n].dGetNotchUnconsolidatedLost());
@@ -529,49 +548,37 @@ CRWCellLayer *CGeomCell::pGetLayerAboveBasement(int const nLayer)
 //! Returns the true elevation of the sediment's top surface for this cell (if there is a cliff notch, ignore the missing volume)
 double CGeomCell::dGetSedimentTopElev(void) const
 {
-   return m_VdAllHorizonTopElev.back();
+   return dField(CELL_DBL_SEDIMENT_TOP_ELEV);
 }
 
 //! Returns the true elevation of the sediment's top surface for this cell (if there is a cliff notch, ignore the missing volume) plus the height of any intervention
 double CGeomCell::dGetSedimentPlusInterventionTopElev(void) const
 {
-   return m_VdAllHorizonTopElev.back() + m_dInterventionHeight;
+   return dField(CELL_DBL_SEDIMENT_TOP_ELEV) + dField(CELL_DBL_INTERVENTION_HEIGHT);
 }
 
 //! Returns the highest elevation of the cell, which is either the sediment top elevation plus intervention height, or the sea surface elevation
 double CGeomCell::dGetOverallTopElev(void) const
 {
-   return m_VdAllHorizonTopElev.back() + m_dInterventionHeight + m_dSeaDepth;
+   return dField(CELL_DBL_SEDIMENT_TOP_ELEV) + dField(CELL_DBL_INTERVENTION_HEIGHT) + dField(CELL_DBL_SEA_DEPTH);
 }
 
-//! Returns true if the elevation of the sediment top surface for this cell (plus any intervention) is less than the grid's this-timestep still water elevation
-bool CGeomCell::bIsInundated(void) const
+//! Returns true if the elevation of the sediment top surface for this cell (plus any intervention) is less than the given still water elevation, which is normally this timestep's SWL. See also CGeomRasterGrid::GetInundationRowSpan(), which does the same test in bulk
+bool CGeomCell::bIsInundated(double const dSWL) const
 {
-   return ((m_VdAllHorizonTopElev.back() + m_dInterventionHeight) < m_pGrid->pGetSim()->CSimulation::dGetThisIterSWL());
-}
-
-//! Returns the sea surface elevation at current iteration
-double CGeomCell::dGetThisIterSWL(void) const
-{
-   return m_pGrid->pGetSim()->CSimulation::dGetThisIterSWL();
-}
-
-//! Returns the total water level at current iteration
-double CGeomCell::dGetThisIterTotWaterLevel(void) const
-{
-   return m_pGrid->pGetSim()->CSimulation::dGetThisIterTotWaterLevel();
+   return ((dField(CELL_DBL_SEDIMENT_TOP_ELEV) + dField(CELL_DBL_INTERVENTION_HEIGHT)) < dSWL);
 }
 
 // //! Returns true if the elevation of the sediment top surface for this cell is greater than or equal to the grid's this-timestep still water elevation. Also returns true if the cell has unconsolidated sediment on it and the elevation of the sediment top surface, minus a tolerance value, is less than the grid's this-timestep still water elevation
 // bool CGeomCell::bIsSeaIncBeach(void) const
 // {
-//    if (m_bInContiguousSea)
+//    if (bGetCellFlag(CELL_FLAG_IN_CONTIGUOUS_SEA))
 //       // Sea
 //       return true;
 //
 //    double
 //        dWaterLevel = m_pGrid->pGetSim()->CSimulation::dGetThisIterSWL(),
-//        dSedTop = m_VdAllHorizonTopElev.back();
+//        dSedTop = dField(CELL_DBL_SEDIMENT_TOP_ELEV);
 //
 //    // Beach
 //    if ((m_VLayerAboveBasement.back().dGetUnconsolidatedThickness() > 0) && ((dSedTop - m_pGrid->pGetSim()->CSimulation::dGetMaxBeachElevAboveSWL()) < dWaterLevel))
@@ -583,12 +590,12 @@ double CGeomCell::dGetThisIterTotWaterLevel(void) const
 //! Returns the total thickness of fine consolidated sediment on this cell, minus the depth-equivalent of any cliff notch
 double CGeomCell::dGetTotConsFineThickConsiderNotch(void) const
 {
+   CRWCellLayer const* pLayer = pGetLayers();
    double dTotThick = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
    {
-      CRWCellLayer m_Layer = m_VLayerAboveBasement[n];
-      double dLayerThick = m_Layer.dGetFineConsolidatedThickness();
-      double dNotchEquiv = m_Layer.pGetConsolidatedSediment()->dGetNotchFineLost();
+      double dLayerThick = pLayer[n].dGetFineConsolidatedThickness();
+      double dNotchEquiv = pLayer[n].pGetConsolidatedSediment()->dGetNotchFineLost();
       
       dTotThick += (dLayerThick - dNotchEquiv);
    }
@@ -599,9 +606,10 @@ double CGeomCell::dGetTotConsFineThickConsiderNotch(void) const
 //! Returns the total thickness of fine unconsolidated sediment on this cell
 double CGeomCell::dGetTotUnconsFine(void) const
 {
+   CRWCellLayer const* pLayer = pGetLayers();
    double dTotThick = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
-      dTotThick += m_VLayerAboveBasement[n].dGetFineUnconsolidatedThickness();
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
+      dTotThick += pLayer[n].dGetFineUnconsolidatedThickness();
 
    return dTotThick;   
 }
@@ -609,12 +617,12 @@ double CGeomCell::dGetTotUnconsFine(void) const
 //! Returns the total thickness of sand-sized consolidated sediment on this cell, minus the depth-equivalent of any cliff notch
 double CGeomCell::dGetTotConsSandThickConsiderNotch(void) const
 {
+   CRWCellLayer const* pLayer = pGetLayers();
    double dTotThick = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
    {
-      CRWCellLayer m_Layer = m_VLayerAboveBasement[n];
-      double dLayerThick = m_Layer.dGetSandConsolidatedThickness();
-      double dNotchEquiv = m_Layer.pGetConsolidatedSediment()->dGetNotchSandLost();
+      double dLayerThick = pLayer[n].dGetSandConsolidatedThickness();
+      double dNotchEquiv = pLayer[n].pGetConsolidatedSediment()->dGetNotchSandLost();
       
       dTotThick += (dLayerThick - dNotchEquiv);
    }
@@ -625,9 +633,10 @@ double CGeomCell::dGetTotConsSandThickConsiderNotch(void) const
 //! Returns the total thickness of sand-sized unconsolidated sediment on this cell
 double CGeomCell::dGetTotUnconsSand(void) const
 {
+   CRWCellLayer const* pLayer = pGetLayers();
    double dTotThick = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
-      dTotThick += m_VLayerAboveBasement[n].dGetSandUnconsolidatedThickness();
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
+      dTotThick += pLayer[n].dGetSandUnconsolidatedThickness();
 
    return dTotThick;   
 }
@@ -635,12 +644,12 @@ double CGeomCell::dGetTotUnconsSand(void) const
 //! Returns the total thickness of coarse consolidated sediment on this cell, minus the depth-equivalent of any cliff notch
 double CGeomCell::dGetTotConsCoarseThickConsiderNotch(void) const
 {
+   CRWCellLayer const* pLayer = pGetLayers();
    double dTotThick = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
    {
-      CRWCellLayer m_Layer = m_VLayerAboveBasement[n];
-      double dLayerThick = m_Layer.dGetCoarseConsolidatedThickness();
-      double dNotchEquiv = m_Layer.pGetConsolidatedSediment()->dGetNotchCoarseLost();
+      double dLayerThick = pLayer[n].dGetCoarseConsolidatedThickness();
+      double dNotchEquiv = pLayer[n].pGetConsolidatedSediment()->dGetNotchCoarseLost();
       
       dTotThick += (dLayerThick - dNotchEquiv);
    }
@@ -651,19 +660,41 @@ double CGeomCell::dGetTotConsCoarseThickConsiderNotch(void) const
 //! Returns the total thickness of coarse unconsolidated sediment on this cell
 double CGeomCell::dGetTotUnconsCoarse(void) const
 {
-double dTotThick = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
-      dTotThick += m_VLayerAboveBasement[n].dGetCoarseUnconsolidatedThickness();
+   CRWCellLayer const* pLayer = pGetLayers();
+   double dTotThick = 0;
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
+      dTotThick += pLayer[n].dGetCoarseUnconsolidatedThickness();
 
    return dTotThick;   
 }
 
+//! Sets the NUM_SEDIMENT_TOTALS elements of pdTotals (indexed by the SEDIMENT_TOTAL_* codes) to this cell's total thicknesses of consolidated (minus the depth-equivalent of any cliff notch) and unconsolidated sediment, for each size class. This gives the same values as the six dGetTotCons*ThickConsiderNotch() and dGetTotUncons*() functions, but visits the layers only once
+void CGeomCell::GetSedimentTotals(double* pdTotals) const
+{
+   CRWCellLayer const* pLayer = pGetLayers();
+   for (int m = 0; m < NUM_SEDIMENT_TOTALS; m++)
+      pdTotals[m] = 0;
+
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
+   {
+      CRWCellSediment const* pCons = pLayer[n].pGetConsolidatedSediment();
+      pdTotals[SEDIMENT_TOTAL_CONS_FINE] += (pLayer[n].dGetFineConsolidatedThickness() - pCons->dGetNotchFineLost());
+      pdTotals[SEDIMENT_TOTAL_CONS_SAND] += (pLayer[n].dGetSandConsolidatedThickness() - pCons->dGetNotchSandLost());
+      pdTotals[SEDIMENT_TOTAL_CONS_COARSE] += (pLayer[n].dGetCoarseConsolidatedThickness() - pCons->dGetNotchCoarseLost());
+
+      pdTotals[SEDIMENT_TOTAL_UNCONS_FINE] += pLayer[n].dGetFineUnconsolidatedThickness();
+      pdTotals[SEDIMENT_TOTAL_UNCONS_SAND] += pLayer[n].dGetSandUnconsolidatedThickness();
+      pdTotals[SEDIMENT_TOTAL_UNCONS_COARSE] += pLayer[n].dGetCoarseUnconsolidatedThickness();
+   }
+}
+
 //! Returns the total thickness of consolidated sediment (all size classes) on this cell
 double CGeomCell::dGetTotConsThickness(void) const
 {
+   CRWCellLayer const* pLayer = pGetLayers();
    double dTotThick = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
-      dTotThick += m_VLayerAboveBasement[n].dGetConsolidatedThickness();
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
+      dTotThick += pLayer[n].dGetConsolidatedThickness();
 
    return dTotThick;
 }
@@ -671,9 +702,10 @@ double CGeomCell::dGetTotConsThickness(void) const
 //! Returns the total thickness of unconsolidated sediment (all size classes) on this cell
 double CGeomCell::dGetTotUnconsThickness(void) const
 {
+   CRWCellLayer const* pLayer = pGetLayers();
    double dTotThick = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
-      dTotThick += m_VLayerAboveBasement[n].dGetUnconsolidatedThickness();
+   for (int n = 0; n < m_pGrid->m_nLayers; n++)
+      dTotThick += pLayer[n].dGetUnconsolidatedThickness();
 
    return dTotThick;
 }
@@ -684,39 +716,40 @@ double CGeomCell::dGetTotAllSedThickness(void) const
    return (this->dGetTotUnconsThickness() + this->dGetTotConsThickness());
 }
 
-//! Appends sediment layers
-void CGeomCell::AppendLayers(int const nLayer)
-{
-   for (int i = 0; i < nLayer; i++)
-      m_VLayerAboveBasement.push_back(CRWCellLayer());
-}
-
 //! For this cell, calculates the elevation of the top of every layer, and the d50 for the topmost unconsolidated sediment layer
 void CGeomCell::CalcAllLayerElevsAndD50(void)
 {
-   m_VdAllHorizonTopElev.clear();
-   m_VdAllHorizonTopElev.push_back(m_dBasementElevation);         // Elevation of top of the basement
+   CRWCellLayer const* pLayer = pGetLayers();
+   double* pdHorizonTopElev = pdGetAllHorizonTopElev();
+   int nLayers = m_pGrid->m_nLayers;
+
+   pdHorizonTopElev[0] = dField(CELL_DBL_BASEMENT_ELEV);                // Elevation of top of the basement
 
    // Calculate the elevation of the top of all other layers
-   int m = 0;
-   for (unsigned int n = 0; n < m_VLayerAboveBasement.size(); n++)
-      m_VdAllHorizonTopElev.push_back(m_VLayerAboveBasement[n].dGetTotalThickness() + m_VdAllHorizonTopElev[m++]); // Elevation of top of layer n
+   for (int n = 0; n < nLayers; n++)
+      pdHorizonTopElev[n + 1] = pLayer[n].dGetTotalThickness() + pdHorizonTopElev[n];       // Elevation of top of layer n
 
-   // Now calculate the d50 of the topmost unconsolidated sediment layer with non-zero thickness. If there is no unconsolidated sediment, m_dUnconsD50 is set to DBL_NODATA
-   m_dUnconsD50 = DBL_NODATA;
-   for (int n = static_cast<int>(m_VLayerAboveBasement.size()) - 1; n >= 0; n--)
+   // And cache the elevation of the sediment top surface
+   dField(CELL_DBL_SEDIMENT_TOP_ELEV) = pdHorizonTopElev[nLayers];
+
+   // This is called after every change to the cell's sediment, so tell the grid: this cell's tile can no longer be treated as uniform
+   m_pGrid->SetCellSedimentChanged(ulGetIndex());
+
+   // Now calculate the d50 of the topmost unconsolidated sediment layer with non-zero thickness. If there is no unconsolidated sediment, dField(CELL_DBL_UNCONS_D50) is set to DBL_NODATA
+   dField(CELL_DBL_UNCONS_D50) = DBL_NODATA;
+   for (int n = nLayers - 1; n >= 0; n--)
    {
-      double dUnconsThick = m_VLayerAboveBasement[n].dGetUnconsolidatedThickness();
+      double dUnconsThick = pLayer[n].dGetUnconsolidatedThickness();
       if (dUnconsThick > 0)
       {
          // This is a layer with non-zero thickness of unconsolidated sediment
-         CRWCellSediment const* pUnconsSedLayer = m_VLayerAboveBasement[n].pGetUnconsolidatedSediment();
+         CRWCellSediment const* pUnconsSedLayer = pLayer[n].pGetUnconsolidatedSediment();
          double dFineProp = pUnconsSedLayer->dGetFineDepth() / dUnconsThick;
          double dSandProp = pUnconsSedLayer->dGetSandDepth() / dUnconsThick;
          double dCoarseProp = pUnconsSedLayer->dGetCoarseDepth() / dUnconsThick;
 
          // Calculate d50 for the unconsolidated sediment
-         m_dUnconsD50 = (dFineProp * m_pGrid->pGetSim()->dGetD50Fine()) + (dSandProp * m_pGrid->pGetSim()->dGetD50Sand()) + (dCoarseProp * m_pGrid->pGetSim()->dGetD50Coarse());
+         dField(CELL_DBL_UNCONS_D50) = (dFineProp * m_pGrid->pGetSim()->dGetD50Fine()) + (dSandProp * m_pGrid->pGetSim()->dGetD50Sand()) + (dCoarseProp * m_pGrid->pGetSim()->dGetD50Coarse());
 
          break;
       }
@@ -727,12 +760,15 @@ void CGeomCell::CalcAllLayerElevsAndD50(void)
 int CGeomCell::nGetLayerAtElev(double const dElev) const
 {
    /*! Returns ELEV_IN_BASEMENT if in basement, ELEV_ABOVE_SEDIMENT_TOP if higher than or equal to sediment top, or layer number (0 to n),  */
-   if (dElev < m_VdAllHorizonTopElev[0])
+   CRWCellLayer const* pLayer = pGetLayers();
+   double const* pdHorizonTopElev = pdGetAllHorizonTopElev();
+
+   if (dElev < pdHorizonTopElev[0])
       return ELEV_IN_BASEMENT;
 
-   for (unsigned int nLayer = 1; nLayer < m_VdAllHorizonTopElev.size(); nLayer++)
+   for (int nLayer = 1; nLayer <= m_pGrid->m_nLayers; nLayer++)
    {
-      if ((m_VLayerAboveBasement[nLayer - 1].dGetTotalThickness() > 0) && (dElev >= m_VdAllHorizonTopElev[nLayer - 1]) && (dElev <= m_VdAllHorizonTopElev[nLayer]))
+      if ((pLayer[nLayer - 1].dGetTotalThickness() > 0) && (dElev >= pdHorizonTopElev[nLayer - 1]) && (dElev <= pdHorizonTopElev[nLayer]))
          return (nLayer - 1);
    }
 
@@ -742,11 +778,12 @@ int CGeomCell::nGetLayerAtElev(double const dElev) const
 //! For this cell, calculates the elevation of the top of a given layer
 double CGeomCell::dCalcLayerElev(const int nLayer)
 {
-   // Note no check to see if nLayer < m_VLayerAboveBasement.size()
-   double dTopElev = m_dBasementElevation;
+   // Note no check to see if nLayer < the number of layers
+   CRWCellLayer const* pLayer = pGetLayers();
+   double dTopElev = dField(CELL_DBL_BASEMENT_ELEV);
 
    for (int n = 0; n <= nLayer; n++)
-      dTopElev += m_VLayerAboveBasement[n].dGetTotalThickness();
+      dTopElev += pLayer[n].dGetTotalThickness();
 
    return dTopElev;
 }
@@ -754,345 +791,344 @@ double CGeomCell::dCalcLayerElev(const int nLayer)
 //! Set potential (unconstrained) shore platform erosion and increment total shore platform potential erosion
 void CGeomCell::SetPotentialPlatformErosion(double const dPotentialIn)
 {
-   m_dPotentialPlatformErosionThisIter = dPotentialIn;
-   m_dTotPotentialPlatformErosion += dPotentialIn;
+   dField(CELL_DBL_POTENTIAL_PLATFORM_EROSION) = dPotentialIn;
+   tDiagField(CELL_DIAG_TOT_POTENTIAL_PLATFORM_EROSION) += tToDiag(dPotentialIn);
 }
 
 //! Get potential (unconstrained) shore platform erosion
 double CGeomCell::dGetPotentialPlatformErosion(void) const
 {
-   return m_dPotentialPlatformErosionThisIter;
+   return dField(CELL_DBL_POTENTIAL_PLATFORM_EROSION);
 }
 
 //! Get total potential (unconstrained) shore platform erosion
 double CGeomCell::dGetTotPotentialPlatformErosion(void) const
 {
-   return m_dTotPotentialPlatformErosion;
+   return tDiagField(CELL_DIAG_TOT_POTENTIAL_PLATFORM_EROSION);
 }
 
 //! Set this-timestep actual (constrained) shore platform erosion and increment total actual shore platform erosion
 void CGeomCell::SetActualPlatformErosion(double const dThisActualErosion)
 {
-   m_dActualPlatformErosionThisIter = dThisActualErosion;
-   m_dTotActualPlatformErosion += dThisActualErosion;
+   dField(CELL_DBL_ACTUAL_PLATFORM_EROSION) = dThisActualErosion;
+   tDiagField(CELL_DIAG_TOT_ACTUAL_PLATFORM_EROSION) += tToDiag(dThisActualErosion);
 }
 
 //! Get actual (constrained) shore platform erosion
 double CGeomCell::dGetActualPlatformErosion(void) const
 {
-   return m_dActualPlatformErosionThisIter;
+   return dField(CELL_DBL_ACTUAL_PLATFORM_EROSION);
 }
 
 //! Get total actual (constrained) shore platform erosion
 double CGeomCell::dGetTotActualPlatformErosion(void) const
 {
-   return m_dTotActualPlatformErosion;
+   return tDiagField(CELL_DIAG_TOT_ACTUAL_PLATFORM_EROSION);
 }
 
-//! Returns the depth of seawater on this cell if the sediment top is < SWL, or zero
-void CGeomCell::SetSeaDepth(void)
+//! Sets the depth of seawater on this cell if the sediment top is < the given still water elevation (normally this timestep's SWL), or zero
+void CGeomCell::SetSeaDepth(double const dSWL)
 {
-   m_dSeaDepth = tMax(m_pGrid->pGetSim()->CSimulation::dGetThisIterSWL() - (m_VdAllHorizonTopElev.back() + m_dInterventionHeight), 0.0);
+   dField(CELL_DBL_SEA_DEPTH) = tMax(dSWL - (dField(CELL_DBL_SEDIMENT_TOP_ELEV) + dField(CELL_DBL_INTERVENTION_HEIGHT)), 0.0);
 }
 
-//! Initialise values for this cell
+//! Initialise values for this cell. Note that CGeomRasterGrid::InitAllCells() does the same for all cells at once
 void CGeomCell::InitCell(void)
 {
-   m_bInContiguousSea =
-   m_bInContiguousFlood =           // TODO 007 What is this?
-   m_bCoastline =
-   m_bFloodLine =
-   m_bIsInActiveZone =
-   // m_bEstimated =
-   m_bShadowBoundary =
-   m_bPossibleCoastStartCell =      // TODO 007 What is this?
-   m_bPossibleFloodStartCell =
-   m_bWaveFlood =
-   // m_bCheckCell =                // TODO 007 What is this?
-   m_bCheckFloodCell = false;
-
-   m_nPolygonID =
-   m_nCoastlineNormal = INT_NODATA;
-
-   m_nShadowZoneNumber =
-   m_nDownDriftZoneNumber = 0;
-
-   m_dLocalConsSlope =
-   m_dPotentialPlatformErosionThisIter =
-   m_dActualPlatformErosionThisIter =
-   m_dCliffCollapseFineThisIter =
-   m_dCliffCollapseSandThisIter =
-   m_dCliffCollapseCoarseThisIter =
-   m_dTalusSandDepositionThisIter =
-   m_dTotTalusSandDeposition = 
-   m_dTalusCoarseDepositionThisIter = 
-   m_dTotTalusCoarseDeposition = 
-   m_dPotentialBeachErosionThisIter =
-   m_dActualBeachErosionThisIter =
-   m_dBeachDepositionThisIter =
-   m_dSeaDepth =
-   m_dWaveHeight =
-   m_dWaveAngle = 0;
-
-   m_dBeachProtectionFactor = DBL_NODATA;
+   SetCellFlag(CELL_FLAG_IN_CONTIGUOUS_SEA, false);
+   SetCellFlag(CELL_FLAG_IN_CONTIGUOUS_FLOOD, false);          // TODO 007 What is this?
+   SetCellFlag(CELL_FLAG_COASTLINE, false);
+   SetCellFlag(CELL_FLAG_FLOOD_LINE, false);
+   SetCellFlag(CELL_FLAG_IN_ACTIVE_ZONE, false);
+   SetCellFlag(CELL_FLAG_SHADOW_BOUNDARY, false);
+   SetCellFlag(CELL_FLAG_POSSIBLE_COAST_START, false);         // TODO 007 What is this?
+   SetCellFlag(CELL_FLAG_POSSIBLE_FLOOD_START, false);
+   SetCellFlag(CELL_FLAG_WAVE_FLOOD, false);
+   SetCellFlag(CELL_FLAG_CHECK_FLOOD, false);
+
+   nField(CELL_INT_POLYGON_ID) =
+   nField(CELL_INT_COASTLINE_NORMAL) = INT_NODATA;
+
+   nField(CELL_INT_SHADOW_ZONE) =
+   nField(CELL_INT_DOWNDRIFT_ZONE) = 0;
+
+   dField(CELL_DBL_POTENTIAL_PLATFORM_EROSION) =
+   dField(CELL_DBL_ACTUAL_PLATFORM_EROSION) =
+   dField(CELL_DBL_CLIFF_COLLAPSE_FINE) =
+   dField(CELL_DBL_CLIFF_COLLAPSE_SAND) =
+   dField(CELL_DBL_CLIFF_COLLAPSE_COARSE) =
+   dField(CELL_DBL_TALUS_SAND_DEPOSITION) =
+   dField(CELL_DBL_TALUS_COARSE_DEPOSITION) =
+   dField(CELL_DBL_POTENTIAL_BEACH_EROSION) =
+   dField(CELL_DBL_ACTUAL_BEACH_EROSION) =
+   dField(CELL_DBL_BEACH_DEPOSITION) =
+   dField(CELL_DBL_SEA_DEPTH) = 0;
+
+   tDiagField(CELL_DIAG_LOCAL_CONS_SLOPE) =
+   tDiagField(CELL_DIAG_TOT_TALUS_SAND_DEPOSITION) =
+   tDiagField(CELL_DIAG_TOT_TALUS_COARSE_DEPOSITION) =
+   tDiagField(CELL_DIAG_WAVE_HEIGHT) =
+   tDiagField(CELL_DIAG_WAVE_ANGLE) = 0;
+
+   dField(CELL_DBL_BEACH_PROTECTION) = DBL_NODATA;
 }
 
 //! Sets the wave height on this cell, also increments the total wave height
 void CGeomCell::SetWaveHeight(double const dWaveHeight)
 {
-   m_dWaveHeight = dWaveHeight;
-   m_dTotWaveHeight += dWaveHeight;
+   tDiagField(CELL_DIAG_WAVE_HEIGHT) = tToDiag(dWaveHeight);
+   tDiagField(CELL_DIAG_TOT_WAVE_HEIGHT) += tToDiag(dWaveHeight);
 
-   //    if (m_dWaveHeight != DBL_NODATA)
-   //       assert(m_dWaveHeight >= 0);
+   //    if (tDiagField(CELL_DIAG_WAVE_HEIGHT) != DBL_NODATA)
+   //       assert(tDiagField(CELL_DIAG_WAVE_HEIGHT) >= 0);
 }
 
 //! Returns the wave height on this cell
 double CGeomCell::dGetWaveHeight(void) const
 {
-   return m_dWaveHeight;
+   return tDiagField(CELL_DIAG_WAVE_HEIGHT);
 }
 
 //! Returns the total wave height on this cell
 double CGeomCell::dGetTotWaveHeight(void) const
 {
-   return m_dTotWaveHeight;
+   return tDiagField(CELL_DIAG_TOT_WAVE_HEIGHT);
 }
 
 //! Sets the wave orientation on this cell, also increments the total wave orientation
 void CGeomCell::SetWaveAngle(double const dWaveAngle)
 {
-   m_dWaveAngle = dWaveAngle;
-   m_dTotWaveAngle += dWaveAngle;
+   tDiagField(CELL_DIAG_WAVE_ANGLE) = tToDiag(dWaveAngle);
+   tDiagField(CELL_DIAG_TOT_WAVE_ANGLE) += tToDiag(dWaveAngle);
 }
 
 //! Returns the wave orientation on this cell
 double CGeomCell::dGetWaveAngle(void) const
 {
-   return m_dWaveAngle;
+   return tDiagField(CELL_DIAG_WAVE_ANGLE);
 }
 
 //! Returns the total wave orientation on this cell
 double CGeomCell::dGetTotWaveAngle(void) const
 {
-   return m_dTotWaveAngle;
+   return tDiagField(CELL_DIAG_TOT_WAVE_ANGLE);
 }
 
 //! Sets the deep water wave height on this cell
 void CGeomCell::SetCellDeepWaterWaveHeight(double const dWaveHeight)
 {
-   m_dDeepWaterWaveHeight = dWaveHeight;
+   tDiagField(CELL_DIAG_DEEP_WATER_WAVE_HEIGHT) = tToDiag(dWaveHeight);
 }
 
 //! Returns the deep water wave height on this cell
 double CGeomCell::dGetCellDeepWaterWaveHeight(void) const
 {
-   return m_dDeepWaterWaveHeight;
+   return tDiagField(CELL_DIAG_DEEP_WATER_WAVE_HEIGHT);
 }
 
 //! Sets the deep water wave orientation on this cell
 void CGeomCell::SetCellDeepWaterWaveAngle(double const dWaveAngle)
 {
-   m_dDeepWaterWaveAngle = dWaveAngle;
+   tDiagField(CELL_DIAG_DEEP_WATER_WAVE_ANGLE) = tToDiag(dWaveAngle);
 }
 
 //! Returns the deep water wave orientation on this cell
 double CGeomCell::dGetCellDeepWaterWaveAngle(void) const
 {
-   return m_dDeepWaterWaveAngle;
+   return tDiagField(CELL_DIAG_DEEP_WATER_WAVE_ANGLE);
 }
 
 //! Sets the deep water wave Period on this cell
 void CGeomCell::SetCellDeepWaterWavePeriod(double const dWavePeriod)
 {
-   m_dDeepWaterWavePeriod = dWavePeriod;
+   tDiagField(CELL_DIAG_DEEP_WATER_WAVE_PERIOD) = tToDiag(dWavePeriod);
 }
 
 //! Returns the deep water wave period on this cell
 double CGeomCell::dGetCellDeepWaterWavePeriod(void) const
 {
-   return m_dDeepWaterWavePeriod;
+   return tDiagField(CELL_DIAG_DEEP_WATER_WAVE_PERIOD);
 }
 
 //! Sets wave height to the deep water wave height value, and sets wave orientation to the deep water wave orientation value
 void CGeomCell::SetWaveValuesToDeepWaterWaveValues(void)
 {
-   m_dWaveHeight = m_dDeepWaterWaveHeight;
-   m_dWaveAngle = m_dDeepWaterWaveAngle;
-   m_dWavePeriod = m_dDeepWaterWavePeriod;
+   tDiagField(CELL_DIAG_WAVE_HEIGHT) = tDiagField(CELL_DIAG_DEEP_WATER_WAVE_HEIGHT);
+   tDiagField(CELL_DIAG_WAVE_ANGLE) = tDiagField(CELL_DIAG_DEEP_WATER_WAVE_ANGLE);
+   tDiagField(CELL_DIAG_WAVE_PERIOD) = tDiagField(CELL_DIAG_DEEP_WATER_WAVE_PERIOD);
 }
 
 // Sets this cell's beach protection factor
 void CGeomCell::SetBeachProtectionFactor(double const dFactor)
 {
-   m_dBeachProtectionFactor = dFactor;
+   dField(CELL_DBL_BEACH_PROTECTION) = dFactor;
 }
 
 //! Returns this cell's beach protection factor
 double CGeomCell::dGetBeachProtectionFactor(void) const
 {
-   return m_dBeachProtectionFactor;
+   return dField(CELL_DBL_BEACH_PROTECTION);
 }
 
 //! Increments the fine, sand, and coarse depths of this-timestep cliff collapse on this cell, also increments the totals
 void CGeomCell::IncrCliffCollapseErosion(double const dFineDepth, double const dSandDepth, double const dCoarseDepth)
 {
-   m_dCliffCollapseFineThisIter += dFineDepth;
-   m_dCliffCollapseSandThisIter += dSandDepth;
-   m_dCliffCollapseCoarseThisIter += dCoarseDepth;
+   dField(CELL_DBL_CLIFF_COLLAPSE_FINE) += dFineDepth;
+   dField(CELL_DBL_CLIFF_COLLAPSE_SAND) += dSandDepth;
+   dField(CELL_DBL_CLIFF_COLLAPSE_COARSE) += dCoarseDepth;
 
-   m_dTotFineCliffCollapse += dFineDepth;
-   m_dTotSandCliffCollapse += dSandDepth;
-   m_dTotCoarseCliffCollapse += dCoarseDepth;
+   tDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_FINE) += tToDiag(dFineDepth);
+   tDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_SAND) += tToDiag(dSandDepth);
+   tDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_COARSE) += tToDiag(dCoarseDepth);
 }
 
 //! Returns the depth of this-timestep fine-sized sediment cliff collapse on this cell
 double CGeomCell::dGetThisIterCliffCollapseErosionFine(void) const
 {
-   return m_dCliffCollapseFineThisIter;
+   return dField(CELL_DBL_CLIFF_COLLAPSE_FINE);
 }
 
 //! Returns the depth of this-timestep sand-sized sediment cliff collapse on this cell
 double CGeomCell::dGetThisIterCliffCollapseErosionSand(void) const
 {
-   return m_dCliffCollapseSandThisIter;
+   return dField(CELL_DBL_CLIFF_COLLAPSE_SAND);
 }
 
 //! Returns the depth of this-timestep coarse-sized sediment cliff collapse on this cell
 double CGeomCell::dGetThisIterCliffCollapseErosionCoarse(void) const
 {
-   return m_dCliffCollapseCoarseThisIter;
+   return dField(CELL_DBL_CLIFF_COLLAPSE_COARSE);
 }
 
 //! Returns the running total depth of fine-sized sediment eroded by cliff collapse on this cell
 double CGeomCell::dGetTotCliffCollapseFine(void) const
 {
-   return m_dTotFineCliffCollapse;
+   return tDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_FINE);
 }
 
 //! Returns the running total depth of sand-sized sediment eroded by cliff collapse on this cell
 double CGeomCell::dGetTotCliffCollapseSand(void) const
 {
-   return m_dTotSandCliffCollapse;
+   return tDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_SAND);
 }
 
 //! Returns the running total depth of coarse-sized sediment eroded by cliff collapse on this cell
 double CGeomCell::dGetTotCliffCollapseCoarse(void) const
 {
-   return m_dTotCoarseCliffCollapse;
+   return tDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_COARSE);
 }
 
 //! Increments the depth of this-timestep sand-sized talus from cliff collapse on this cell, also increments the total
 void CGeomCell::AddSandTalusDeposition(double const dDepth)
 {
-   m_dTalusSandDepositionThisIter += dDepth;
-   m_dTotTalusSandDeposition += dDepth;
+   dField(CELL_DBL_TALUS_SAND_DEPOSITION) += dDepth;
+   tDiagField(CELL_DIAG_TOT_TALUS_SAND_DEPOSITION) += tToDiag(dDepth);
 }
 
 //! Increments the depth of this-timestep coarse-sized talus from cliff collapse on this cell, also increments the total
 void CGeomCell::AddCoarseTalusDeposition(double const dDepth)
 {
-   m_dTalusCoarseDepositionThisIter += dDepth;
-   m_dTotTalusCoarseDeposition += dDepth;
+   dField(CELL_DBL_TALUS_COARSE_DEPOSITION) += dDepth;
+   tDiagField(CELL_DIAG_TOT_TALUS_COARSE_DEPOSITION) += tToDiag(dDepth);
 }
 
 //! Returns the depth of this-timestep sand talus deposition from cliff collapse on this cell
 double CGeomCell::dGetThisIterCliffCollapseSandTalusDeposition(void) const
 {
-   return m_dTalusSandDepositionThisIter;
+   return dField(CELL_DBL_TALUS_SAND_DEPOSITION);
 }
 
 //! Retuns the depth of this-timestep coarse talus deposition from cliff collapse on this cell
 double CGeomCell::dGetThisIterCliffCollapseCoarseTalusDeposition(void) const
 {
-   return m_dTalusCoarseDepositionThisIter;
+   return dField(CELL_DBL_TALUS_COARSE_DEPOSITION);
 }
 
 //! Returns the total depth of sand talus deposition from cliff collapse on this cell
 double CGeomCell::dGetTotSandTalusDeposition(void) const
 {
-   return m_dTotTalusSandDeposition;
+   return tDiagField(CELL_DIAG_TOT_TALUS_SAND_DEPOSITION);
 }
 
 //! Returns the total depth of coarse talus deposition from cliff collapse on this cell
 double CGeomCell::dGetTotCoarseTalusDeposition(void) const
 {
-   return m_dTotTalusCoarseDeposition;
+   return tDiagField(CELL_DIAG_TOT_TALUS_COARSE_DEPOSITION);
 }
 
 //! Set potential (unconstrained) beach erosion and increment total beach potential erosion
 void CGeomCell::SetPotentialBeachErosion(double const dPotentialIn)
 {
-   m_dPotentialBeachErosionThisIter = dPotentialIn;
-   m_dTotPotentialBeachErosion += dPotentialIn;
+   dField(CELL_DBL_POTENTIAL_BEACH_EROSION) = dPotentialIn;
+   tDiagField(CELL_DIAG_TOT_POTENTIAL_BEACH_EROSION) += tToDiag(dPotentialIn);
 }
 
 //! Get potential (unconstrained) beach erosion
 double CGeomCell::dGetPotentialBeachErosion(void) const
 {
-   return m_dPotentialBeachErosionThisIter;
+   return dField(CELL_DBL_POTENTIAL_BEACH_EROSION);
 }
 
 //! Get total potential (supply-unconstrained) beach erosion
 double CGeomCell::dGetTotPotentialBeachErosion(void) const
 {
-   return m_dTotPotentialBeachErosion;
+   return tDiagField(CELL_DIAG_TOT_POTENTIAL_BEACH_EROSION);
 }
 
 //! Set this-timestep actual (supply-constrained) beach erosion and increment total actual beach erosion
 void CGeomCell::SetActualBeachErosion(double const dThisActualErosion)
 {
-   m_dActualBeachErosionThisIter = dThisActualErosion;
-   m_dTotActualBeachErosion += dThisActualErosion;
+   dField(CELL_DBL_ACTUAL_BEACH_EROSION) = dThisActualErosion;
+   tDiagField(CELL_DIAG_TOT_ACTUAL_BEACH_EROSION) += tToDiag(dThisActualErosion);
 }
 
 //! Get actual (supply-constrained) beach erosion
 double CGeomCell::dGetActualBeachErosion(void) const
 {
-   return m_dActualBeachErosionThisIter;
+   return dField(CELL_DBL_ACTUAL_BEACH_EROSION);
 }
 
 //! Get total actual (supply-constrained) beach erosion
 double CGeomCell::dGetTotActualBeachErosion(void) const
 {
-   return m_dTotActualBeachErosion;
+   return tDiagField(CELL_DIAG_TOT_ACTUAL_BEACH_EROSION);
 }
 
 // //! Returns true if there has been actual beach erosion this timestep
 // bool CGeomCell::bActualBeachErosionThisIter(void) const
 // {
-//    return (m_dActualBeachErosionThisIter > 0 ? true : false);
+//    return (dField(CELL_DBL_ACTUAL_BEACH_EROSION) > 0 ? true : false);
 // }
 
 //! Increment this-timestep beach deposition, also increment total beach deposition
 void CGeomCell::IncrBeachDeposition(double const dThisDeposition)
 {
-   m_dBeachDepositionThisIter += dThisDeposition;
-   m_dTotBeachDeposition += dThisDeposition;
+   dField(CELL_DBL_BEACH_DEPOSITION) += dThisDeposition;
+   tDiagField(CELL_DIAG_TOT_BEACH_DEPOSITION) += tToDiag(dThisDeposition);
 }
 
 //! Get beach deposition
 double CGeomCell::dGetBeachDeposition(void) const
 {
-   return m_dBeachDepositionThisIter;
+   return dField(CELL_DBL_BEACH_DEPOSITION);
 }
 
 //! Get beach erosion
 double CGeomCell::dGetTotBeachDeposition(void) const
 {
-   return m_dTotBeachDeposition;
+   return tDiagField(CELL_DIAG_TOT_BEACH_DEPOSITION);
 }
 
 // //! Returns true if there has been beach deposition this timestep
 // bool CGeomCell::bBeachDepositionThisIter(void) const
 // {
-//    return (m_dBeachDepositionThisIter > 0 ? true : false);
+//    return (dField(CELL_DBL_BEACH_DEPOSITION) > 0 ? true : false);
 // }
 
 //! Returns true only if this cell has had no deposition or erosion this timestep
 bool CGeomCell::bBeachErosionOrDepositionThisIter(void) const
 {
-   if ((m_dActualBeachErosionThisIter > 0) || (m_dBeachDepositionThisIter > 0))
+   if ((dField(CELL_DBL_ACTUAL_BEACH_EROSION) > 0) || (dField(CELL_DBL_BEACH_DEPOSITION) > 0))
       return true;
 
    return false;
@@ -1101,7 +1137,7 @@ bool CGeomCell::bBeachErosionOrDepositionThisIter(void) const
 //! Returns the D50 of unconsolidated sediment on this cell
 double CGeomCell::dGetUnconsD50(void) const
 {
-   return m_dUnconsD50;
+   return dField(CELL_DBL_UNCONS_D50);
 }
 
 //! Sets the landform category and subcategory for an intervention
@@ -1137,17 +1173,17 @@ int CGeomCell::nGetInterventionClass(void) const
 //! Sets the intervention height
 void CGeomCell::SetInterventionHeight(double const dHeight)
 {
-   m_dInterventionHeight = dHeight;
+   dField(CELL_DBL_INTERVENTION_HEIGHT) = dHeight;
 }
 
 //! Returns the intervention height
 double CGeomCell::dGetInterventionHeight(void) const
 {
-   return m_dInterventionHeight;
+   return dField(CELL_DBL_INTERVENTION_HEIGHT);
 }
 
 //! Returns the elevation of the top of the intervention, assuming it rests on the sediment-top surface
 double CGeomCell::dGetInterventionTopElev(void) const
 {
-   return m_VdAllHorizonTopElev.back() + m_dInterventionHeight;
+   return dField(CELL_DBL_SEDIMENT_TOP_ELEV) + dField(CELL_DBL_INTERVENTION_HEIGHT);
 }
@@ -29,194 +29,40 @@ You should have received a copy of the GNU General Public License along with thi
 #include "cme.h"
 #include "cell_landform.h"
 #include "cell_layer.h"
-#include "raster_grid.h"
+
+class CGeomRasterGrid;     // Forward declaration
 
 class CGeomCell
 {
    friend class CSimulation;
 
 private:
-   //! Switch to indicate if this is a sea cell, contiguous with other sea cells
-   bool m_bInContiguousSea;
-
-   //! TODO 007 What is this?
-   bool m_bInContiguousFlood;
-
-   //! Switch to indicate that this cell is in the active zone
-   bool m_bIsInActiveZone;
-
-   //! Switch to indicate that this cell is 'under' a coastline
-   bool m_bCoastline;
-
-   //! TODO 007 What is this used for? Switch to indicate that this cell is 'under' a flood line
-   bool m_bFloodLine;
-
-   //! TODO 007 What is this used for? Switch to indicate that this cell is 'under' a wave flood line
-   bool m_bWaveFlood;
-
-   // //! TODO 007 What is this used for?
-   // bool m_bCheckCell;
-
-   //! TODO 007 What is this used for?
-   bool m_bCheckFloodCell;
-
-   //! Switch to show this cell is 'under' a shadow boundaryu
-   bool m_bShadowBoundary;
-
-   //! Switch to show that this cell could be the start of a coastline
-   bool m_bPossibleCoastStartCell;
-
-   //! TODO 007 What is this used for?
-   bool m_bPossibleFloodStartCell;
-
-   //! TODO 007 What is this used for?
-   bool m_bFloodBySetupSurge;
-
-   //! TODO 007 What is this used for?
-   bool m_bFloodBySetupSurgeRunup;
-
-   //! If this cell is an edge (or bounding box) cell, this specifies the edge
-   int m_nBoundingBoxEdge;
-
-   //! If this cell is within a polygon, this is the ID of the polygon
-   int m_nPolygonID;
-
-   //! If this cell is 'under' a coastline normal, this is the number of the normal
-   int m_nCoastlineNormal;
-
-   //! If this cell is within a shadow zone, this is the number of the shadow zone
-   int m_nShadowZoneNumber;
-
-   //! If this cell is within a downdrift zone, this is the number of the downdrift zone
-   int m_nDownDriftZoneNumber;
-
-   //! Used in erosion calculations, stored here for display purposes
-   double m_dLocalConsSlope;
-
-   //! Elevation of basement surface (m)
-   double m_dBasementElevation;
-
-   //! Depth of still water (m), is zero if not inundated
-   double m_dSeaDepth;
-
-   //! Total depth of still water (m) since beginning of simulation (used to calc average)
-   double m_dTotSeaDepth;
-
-   //! Wave height (m)
-   double m_dWaveHeight;
-
-   //! Total wave height (m) (used to calc average)
-   double m_dTotWaveHeight;
-
-   //! Wave orientation
-   double m_dWaveAngle;
-
-   //! Wave period (s)
-   double m_dWavePeriod;
-
-   //! Total wave orientation  (used to calc average)
-   double m_dTotWaveAngle;
-
-   //! Wave height if this is a deep water cell
-   double m_dDeepWaterWaveHeight;
-
-   //! Wave orientation if this is a deep water cell
-   double m_dDeepWaterWaveAngle;
-
-   //! Wave period if this is a deep water cell
-   double m_dDeepWaterWavePeriod;
-
-   //! Only meaningful if in zone of platform erosion. 0 is fully protected; 1 = no protection
-   double m_dBeachProtectionFactor;
-
-   //! Suspended sediment as depth equivalent (m)
-   double m_dSuspendedSediment;
-
-   //! Total depth of suspended sediment (m) since simulation start (used to calc average)
-   double m_dTotSuspendedSediment;
-
-   //! Depth of sediment on the shore platform that could be eroded this timestep, if no supply-limitation
-   double m_dPotentialPlatformErosionThisIter;
-
-   //! Total depth of sediment eroded from the shore platform, if no supply-limitation
-   double m_dTotPotentialPlatformErosion;
-
-   //! Depth of sediment actually eroded from the shore platform this timestep
-   double m_dActualPlatformErosionThisIter;
-
-   //! Total depth of sediment actually eroded from the shore platform
-   double m_dTotActualPlatformErosion;
-
-   //! Depth of fine sediment (consolidated and unconsolidated) removed via cliff collapse this timestep
-   double m_dCliffCollapseFineThisIter;
-
-   //! Depth of sand sediment (consolidated and unconsolidated) removed via cliff collapse this timestep
-   double m_dCliffCollapseSandThisIter;
-
-   //! Depth of coarse sediment (consolidated and unconsolidated) removed via cliff collapse this timestep
-   double m_dCliffCollapseCoarseThisIter;
-
-   //! Total depth of fine sediment (consolidated and unconsolidated) removed via cliff collapse
-   double m_dTotFineCliffCollapse;
-
-   //! Total depth of sand sediment (consolidated and unconsolidated) removed via cliff collapse
-   double m_dTotSandCliffCollapse;
-
-   //! Total depth of coarse sediment (consolidated and unconsolidated) removed via cliff collapse
-   double m_dTotCoarseCliffCollapse;
-
-   //! Depth of unconsolidated sand sediment deposited as a result of cliff collapse this timestep
-   double m_dTalusSandDepositionThisIter;
-
-   //! Total depth of unconsolidated sand sediment deposited as a result of cliff collapse
-   double m_dTotTalusSandDeposition;
-
-   //! Depth of unconsolidated coarse sediment deposited as a result of cliff collapse this timestep
-   double m_dTalusCoarseDepositionThisIter;
-
-   //! Total depth of unconsolidated coarse sediment deposited as a result of cliff collapse
-   double m_dTotTalusCoarseDeposition;
-
-   //! Depth of unconsolidated beach sediment that could be eroded this timestep, if no supply-limitation
-   double m_dPotentialBeachErosionThisIter;
-
-   //! Total depth of unconsolidated beach sediment eroded; if no supply-limitation
-   double m_dTotPotentialBeachErosion;
-
-   //! Depth of unconsolidated beach sediment actually eroded this timestep
-   double m_dActualBeachErosionThisIter;
-
-   //! Total depth of unconsolidated beach sediment actually eroded
-   double m_dTotActualBeachErosion;
-
-   //! Depth of unconsolidated beach sediment deposited this timestep
-   double m_dBeachDepositionThisIter;
-
-   //! Total depth of unconsolidated beach sediment deposited
-   double m_dTotBeachDeposition;
-
-   //! d50 of unconsolidated sediment on top layer with unconsolidated sediment depth > 0
-   double m_dUnconsD50;
-
-   //! Height of intervention structure
-   double m_dInterventionHeight;
+   // Note that this cell's scalar values (flags, int values, and double values) are not held here, but in the field planes of the CGeomRasterGrid object, at this cell's index. See the CELL_DBL_*, CELL_DIAG_*, CELL_INT_* and CELL_FLAG_* codes in cme.h
 
    //! This cell's landform data
    CRWCellLandform m_Landform;
 
-   // Initialize these as empty vectors
-   //! Number of layers NOT including the basement. Layer 0 is the lowest
-   vector<CRWCellLayer> m_VLayerAboveBasement;
+   // Note also that this cell's sediment layers (layer 0 is the lowest) and its layer-top elevations (element 0 is the top of the basement) are held in the CGeomRasterGrid object: the layers in the grid tile which contains this cell, the elevations in the grid's horizon cube
 
-   //! Number of layer-top elevations (inc. that of the basement, which is m_VdAllHorizonTopElev[0]); size 1 greater than size of m_VLayerAboveBasement
-   vector<double> m_VdAllHorizonTopElev;
+   unsigned long ulGetIndex(void) const;
+   CRWCellLayer const* pGetLayers(void) const;
+   CRWCellLayer* pGetLayersForWrite(void);
+   double* pdGetAllHorizonTopElev(void) const;
+   bool bGetCellFlag(int const) const;
+   void SetCellFlag(int const, bool const) const;
+   int& nField(int const) const;
+   double& dField(int const) const;
+   diag_t& tDiagField(int const) const;
 
-public:
-    static CGeomRasterGrid *m_pGrid;
+   //! The raster grid which holds this cell's values
+   CGeomRasterGrid* m_pGrid;
 
+public:
     CGeomCell();
     ~CGeomCell(void);
 
+    void SetGrid(CGeomRasterGrid*);
+
     void SetInContiguousSea(void);
     bool bIsInContiguousSea(void) const;
 
@@ -260,7 +106,7 @@ public:
     CRWCellLandform* pGetLandform(void);
 
     void SetWaveFlood(void);
-    bool bIsElevLessThanWaterLevel(void) const;
+    bool bIsElevLessThanWaterLevel(double const) const;
 
     void SetCheckCell(void);
     bool bIsCellCheck(void) const;
@@ -281,11 +127,9 @@ public:
     double dGetSedimentPlusInterventionTopElev(void) const;
     double dGetOverallTopElev(void) const;
 
-    bool bIsInundated(void) const;
-    double dGetThisIterSWL(void) const;
-    double dGetThisIterTotWaterLevel(void) const;
+    bool bIsInundated(double const) const;
     // bool bIsSeaIncBeach(void) const;
-    void SetSeaDepth(void);
+    void SetSeaDepth(double const);
     double dGetSeaDepth(void) const;
     void InitCell(void);
     double dGetTotSeaDepth(void) const;
@@ -319,7 +163,7 @@ public:
 
     double dGetConsSedTopForLayerAboveBasement(int const) const;
     CRWCellLayer* pGetLayerAboveBasement(int const);
-    void AppendLayers(int const);
+    CRWCellLayer const* pGetConstLayerAboveBasement(int const) const;
     void CalcAllLayerElevsAndD50(void);
     int nGetLayerAtElev(double const) const;
     double dCalcLayerElev(const int);
@@ -330,6 +174,7 @@ public:
     double dGetTotUnconsSand(void) const;
     double dGetTotConsCoarseThickConsiderNotch(void) const;
     double dGetTotUnconsCoarse(void) const;
+    void GetSedimentTotals(double*) const;
 
     double dGetTotConsThickness(void) const;
     double dGetTotUnconsThickness(void) const;
@@ -388,4 +233,7 @@ public:
     void SetDownDriftZoneNumber(int const);
     int nGetDownDriftZoneNumber(void) const;
 };
+
+// This is included after the CGeomCell definition, since the inline cell-addressing functions in raster_grid.h need CGeomCell to be a complete type
+#include "raster_grid.h"
 #endif // CELL_H
@@ -44,6 +44,18 @@ CRWCellSediment* CRWCellLayer::pGetConsolidatedSediment(void)
    return &m_ConsolidatedSediment;
 }
 
+//! Returns a read-only pointer to the cell's unconsolidated sediment object
+CRWCellSediment const* CRWCellLayer::pGetUnconsolidatedSediment(void) const
+{
+   return &m_UnconsolidatedSediment;
+}
+
+//! Returns a read-only pointer to the cell's consolidated sediment object
+CRWCellSediment const* CRWCellLayer::pGetConsolidatedSediment(void) const
+{
+   return &m_ConsolidatedSediment;
+}
+
 //! Returns the thickness of this cell's fine unconsolidated sediment
 double CRWCellLayer::dGetFineUnconsolidatedThickness(void) const
 {
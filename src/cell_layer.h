@@ -49,6 +49,8 @@ public:
 
    CRWCellSediment* pGetUnconsolidatedSediment(void);
    CRWCellSediment* pGetConsolidatedSediment(void);
+   CRWCellSediment const* pGetUnconsolidatedSediment(void) const;
+   CRWCellSediment const* pGetConsolidatedSediment(void) const;
    
    double dGetFineUnconsolidatedThickness(void) const;
    double dGetFineConsolidatedThickness(void) const;
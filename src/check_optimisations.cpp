@@ -0,0 +1,317 @@
+/*!
+ *
+ * \file check_optimisations.cpp
+ * \brief Checks the results of optimised calculations against the results of the calculations which they replace
+ * \details These checks are only done if "Check optimised calculations" is set in the run data file. They are for testing, and make the simulation run more slowly
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*==============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+==============================================================================================================================*/
+#include <iostream>
+using std::endl;
+
+#include <algorithm>
+using std::copy;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "cme.h"
+#include "simulation.h"
+#include "coast.h"
+
+//===============================================================================================================================
+//! Checks the sea mask which was updated incrementally, from last timestep's sea mask, against the sea mask found from scratch by flood-filling from the grid edges
+//===============================================================================================================================
+int CSimulation::nCheckSeaMask(void)
+{
+   // Keep the incrementally-updated sea mask, then find the sea mask from scratch
+   vector<unsigned char> VucIncrementalSeaMask(m_VucSeaMask);
+   FloodFillSeaFromEdges();
+
+   unsigned long ulNumDiffer = 0;
+   unsigned long ulFirstDiffer = 0;
+   for (unsigned long n = 0; n < m_VucSeaMask.size(); n++)
+   {
+      if (VucIncrementalSeaMask[n] != m_VucSeaMask[n])
+      {
+         if (ulNumDiffer == 0)
+            ulFirstDiffer = n;
+
+         ulNumDiffer++;
+      }
+   }
+
+   if (ulNumDiffer > 0)
+   {
+      int nX = static_cast<int>(ulFirstDiffer % m_nXGridMax);
+      int nY = static_cast<int>(ulFirstDiffer / m_nXGridMax);
+      LogStream << m_ulIter << ": " << ERR << "optimisation check: incrementally-updated sea mask differs from sea mask found from scratch at " << ulNumDiffer << " cells, the first is [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "} which is " << (VucIncrementalSeaMask[ulFirstDiffer] ? "sea" : "not sea") << " in the incrementally-updated sea mask" << endl;
+      return RTN_ERR_OPTIMISATION_CHECK;
+   }
+
+   return RTN_OK;
+}
+
+//===============================================================================================================================
+//! Checks that, at the end of the timestep, there is a coast history for each of this timestep's coasts, and that it matches the coast. If not, next timestep's coasts would be smoothed, and have their profiles placed, from scratch
+//===============================================================================================================================
+int CSimulation::nCheckCoastHistory(void)
+{
+   if (m_VCoastHistory.size() != m_VCoast.size())
+   {
+      LogStream << m_ulIter << ": " << ERR << "optimisation check: " << m_VCoast.size() << " coasts but " << m_VCoastHistory.size() << " coast histories at end of timestep" << endl;
+      return RTN_ERR_OPTIMISATION_CHECK;
+   }
+
+   for (unsigned int nCoast = 0; nCoast < m_VCoast.size(); nCoast++)
+   {
+      int nCoastSize = m_VCoast[nCoast].nGetCoastlineSize();
+      if ((m_VCoastHistory[nCoast].nGetSize() != nCoastSize) || (! m_VCoastHistory[nCoast].bIsSameCoast(m_VCoast[nCoast].pPtiGetCellMarkedAsCoastline(0), m_VCoast[nCoast].nGetSeaHandedness())) || (! m_VCoastHistory[nCoast].bHasSameEdges(m_VCoast[nCoast].nGetStartEdge(), m_VCoast[nCoast].nGetEndEdge())))
+      {
+         LogStream << m_ulIter << ": " << ERR << "optimisation check: coast history " << nCoast << " does not match coast " << nCoast << " at end of timestep" << endl;
+         return RTN_ERR_OPTIMISATION_CHECK;
+      }
+   }
+
+   return RTN_OK;
+}
+
+//===============================================================================================================================
+//! Checks the wave properties which were calculated for all profiles at once (using the task graph's threads, the CShore worker processes, or a CShore batch for each coast) against the wave properties calculated for one profile after another in this thread. For the check, CShore is run in this process by a single call to CShoreWrapper() for each profile, with newly allocated vectors
+//===============================================================================================================================
+int CSimulation::nCheckWavePropertiesOnProfiles(int const nNumItems)
+{
+   // Keep the results of the optimised calculation, and the text which it wrote to the log
+   vector<vector<bool>> VVbBreaking(m_VVbWaveItemBreaking.begin(), m_VVbWaveItemBreaking.begin() + nNumItems);
+   vector<vector<double>>
+       VVdX(m_VVdWaveItemX.begin(), m_VVdWaveItemX.begin() + nNumItems),
+       VVdY(m_VVdWaveItemY.begin(), m_VVdWaveItemY.begin() + nNumItems),
+       VVdHeightX(m_VVdWaveItemHeightX.begin(), m_VVdWaveItemHeightX.begin() + nNumItems),
+       VVdHeightY(m_VVdWaveItemHeightY.begin(), m_VVdWaveItemHeightY.begin() + nNumItems);
+   vector<string> VstrLog(m_VstrWaveItemLog.begin(), m_VstrWaveItemLog.begin() + nNumItems);
+
+   m_CShorePool.SetRunInThisProcess(true);
+
+   int nRet = RTN_OK;
+   for (int nItem = 0; (nItem < nNumItems) && (nRet == RTN_OK); nItem++)
+   {
+      // So that this does not depend on the CShore vectors being reused from one profile to the next, run each profile with vectors which are allocated afresh
+      if (m_nWavePropagationModel == WAVE_MODEL_CSHORE)
+      {
+         CCShoreWorkspace* pWorkspace = &m_VCShoreWorkspace[CTaskGraph::nGetThisThread()];
+         pWorkspace->ReleaseMemory();
+         pWorkspace->SetArrayOutSize(m_nCShoreArrayOutSize);
+      }
+
+      nRet = nDoTaskItem(TASK_PROPAGATE_WAVES_ON_PROFILE, nItem);
+   }
+
+   m_CShorePool.SetRunInThisProcess(false);
+
+   if (nRet != RTN_OK)
+      return nRet;
+
+   for (int nItem = 0; nItem < nNumItems; nItem++)
+   {
+      if ((m_VVdWaveItemX[nItem] != VVdX[nItem]) || (m_VVdWaveItemY[nItem] != VVdY[nItem]) || (m_VVdWaveItemHeightX[nItem] != VVdHeightX[nItem]) || (m_VVdWaveItemHeightY[nItem] != VVdHeightY[nItem]) || (m_VVbWaveItemBreaking[nItem] != VVbBreaking[nItem]))
+      {
+         LogStream << m_ulIter << ": " << ERR << "optimisation check: wave properties on coast " << m_VnWaveItemCoast[nItem] << " profile " << m_VnWaveItemProfile[nItem] << " differ from those calculated for the profile alone" << endl;
+         return RTN_ERR_OPTIMISATION_CHECK;
+      }
+
+      m_VstrWaveItemLog[nItem].swap(VstrLog[nItem]);
+   }
+
+   return RTN_OK;
+}
+
+//===============================================================================================================================
+//! Called instead of CSimulation::RestoreWaveCache() when the stored results of the last full wave propagation could be reused, and the reuse tolerances are all zero. Waves are propagated again, and the results are checked against the stored results which would have been reused: these are the wave values at each coast point, the shadow zone boundaries, and the wave, active zone and shadow zone values of each cell which is sea both now and when the results were stored
+//===============================================================================================================================
+int CSimulation::nCheckWaveCache(void)
+{
+   CWaveCache FreshCache;
+   StartWaveCache(&FreshCache);
+
+   int nRet = nDoAllPropagateWaves();
+   if (nRet != RTN_OK)
+      return nRet;
+
+   SaveWaveCache(&FreshCache);
+
+   // The wave values at each coast point. The coasts and profiles are the same as when the results were stored, since otherwise they could not have been reused
+   int nPointIndex = 0;
+   for (int nCoast = 0; nCoast < static_cast<int>(m_VCoast.size()); nCoast++)
+   {
+      for (int nPoint = 0; nPoint < m_VCoast[nCoast].nGetCoastlineSize(); nPoint++, nPointIndex++)
+      {
+         if ((FreshCache.m_VnBreakingDistance[nPointIndex] != m_WaveCache.m_VnBreakingDistance[nPointIndex]) || (! bBitwiseEqual(FreshCache.m_VdBreakingWaveHeight[nPointIndex], m_WaveCache.m_VdBreakingWaveHeight[nPointIndex])) || (! bBitwiseEqual(FreshCache.m_VdCoastWaveHeight[nPointIndex], m_WaveCache.m_VdCoastWaveHeight[nPointIndex])) || (! bBitwiseEqual(FreshCache.m_VdBreakingWaveAngle[nPointIndex], m_WaveCache.m_VdBreakingWaveAngle[nPointIndex])) || (! bBitwiseEqual(FreshCache.m_VdWaveSetupSurge[nPointIndex], m_WaveCache.m_VdWaveSetupSurge[nPointIndex])) || (! bBitwiseEqual(FreshCache.m_VdRunUp[nPointIndex], m_WaveCache.m_VdRunUp[nPointIndex])) || (! bBitwiseEqual(FreshCache.m_VdDepthOfBreaking[nPointIndex], m_WaveCache.m_VdDepthOfBreaking[nPointIndex])) || (! bBitwiseEqual(FreshCache.m_VdWaveEnergyAtBreaking[nPointIndex], m_WaveCache.m_VdWaveEnergyAtBreaking[nPointIndex])))
+         {
+            LogStream << m_ulIter << ": " << ERR << "optimisation check: wave values at coast " << nCoast << " point " << nPoint << " differ from the reused wave values" << endl;
+            return RTN_ERR_OPTIMISATION_CHECK;
+         }
+      }
+
+      // The shadow zone boundaries
+      for (int nBoundaryType = 0; nBoundaryType < 2; nBoundaryType++)
+      {
+         vector<CGeomLine>* pVLFresh = (nBoundaryType == 0 ? &FreshCache.m_VVLShadowBoundary[nCoast] : &FreshCache.m_VVLShadowDowndriftBoundary[nCoast]);
+         vector<CGeomLine>* pVLReused = (nBoundaryType == 0 ? &m_WaveCache.m_VVLShadowBoundary[nCoast] : &m_WaveCache.m_VVLShadowDowndriftBoundary[nCoast]);
+
+         bool bSame = (pVLFresh->size() == pVLReused->size());
+         for (unsigned int n = 0; bSame && (n < pVLFresh->size()); n++)
+         {
+            bSame = ((*pVLFresh)[n].nGetSize() == (*pVLReused)[n].nGetSize());
+            for (int m = 0; bSame && (m < (*pVLFresh)[n].nGetSize()); m++)
+               bSame = ((*pVLFresh)[n][m] == (*pVLReused)[n][m]);
+         }
+
+         if (! bSame)
+         {
+            LogStream << m_ulIter << ": " << ERR << "optimisation check: " << (nBoundaryType == 0 ? "shadow zone boundaries" : "shadow zone downdrift boundaries") << " of coast " << nCoast << " differ from the reused boundaries" << endl;
+            return RTN_ERR_OPTIMISATION_CHECK;
+         }
+      }
+   }
+
+   // The values of each cell which is sea both now and when the results were stored
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+   for (unsigned long n = 0; n < ulNumCells; n++)
+   {
+      unsigned long ulWord = n / 64;
+      uint64_t ulBit = static_cast<uint64_t>(1) << (n % 64);
+      if (! (FreshCache.m_VulSea[ulWord] & m_WaveCache.m_VulSea[ulWord] & ulBit))
+         continue;
+
+      if ((! bBitwiseEqual(FreshCache.m_VdWaveHeight[n], m_WaveCache.m_VdWaveHeight[n])) || (! bBitwiseEqual(FreshCache.m_VdWaveAngle[n], m_WaveCache.m_VdWaveAngle[n])) || (! bBitwiseEqual(FreshCache.m_VdTotWaveHeightChange[n], m_WaveCache.m_VdTotWaveHeightChange[n])) || (! bBitwiseEqual(FreshCache.m_VdTotWaveAngleChange[n], m_WaveCache.m_VdTotWaveAngleChange[n])) || (FreshCache.m_VnShadowZone[n] != m_WaveCache.m_VnShadowZone[n]) || (FreshCache.m_VnDownDriftZone[n] != m_WaveCache.m_VnDownDriftZone[n]) || ((FreshCache.m_VulActiveZone[ulWord] ^ m_WaveCache.m_VulActiveZone[ulWord]) & ulBit) || ((FreshCache.m_VulShadowBoundary[ulWord] ^ m_WaveCache.m_VulShadowBoundary[ulWord]) & ulBit))
+      {
+         int nX = static_cast<int>(n % m_nXGridMax);
+         int nY = static_cast<int>(n / m_nXGridMax);
+         LogStream << m_ulIter << ": " << ERR << "optimisation check: wave values of [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "} differ from the reused wave values" << endl;
+         return RTN_ERR_OPTIMISATION_CHECK;
+      }
+   }
+
+   // The check passed, so count this timestep as one in which the stored results were reused. This means that the timesteps on which waves are fully propagated are the same as if no check had been made
+   m_WaveCache.m_nConsecutiveReuses++;
+   m_WaveCache.m_ulNumReused++;
+
+   return RTN_OK;
+}
+
+//===============================================================================================================================
+//! Called instead of CSimulation::CalcD50AndFillWaveCalcHoles() when polygon d50 is to be calculated, and wave calculation holes filled, in the active window only. Both this and the whole-grid calculation are done, starting from the same values, and the results are compared: these are the wave height and orientation, active zone, and shadow and downdrift zones of each cell, and the average d50 of each polygon. The results of the whole-grid calculation are kept
+//===============================================================================================================================
+int CSimulation::nCheckActiveWindowHoleFill(void)
+{
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+   unsigned long ulNumFlagWords = m_pRasterGrid->ulGetNumFlagWords();
+   diag_t* ptWaveHeight = m_pRasterGrid->ptGetDiagField(CELL_DIAG_WAVE_HEIGHT);
+   diag_t* ptWaveAngle = m_pRasterGrid->ptGetDiagField(CELL_DIAG_WAVE_ANGLE);
+   diag_t* ptTotWaveHeight = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_WAVE_HEIGHT);
+   diag_t* ptTotWaveAngle = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_WAVE_ANGLE);
+   int* pnShadowZone = m_pRasterGrid->pnGetField(CELL_INT_SHADOW_ZONE);
+   int* pnDownDriftZone = m_pRasterGrid->pnGetField(CELL_INT_DOWNDRIFT_ZONE);
+   uint64_t* pulActiveZone = m_pRasterGrid->m_pulCellFlag[CELL_FLAG_IN_ACTIVE_ZONE];
+
+   // Keep the values which filling holes may change
+   vector<diag_t>
+       VtWaveHeight(ptWaveHeight, ptWaveHeight + ulNumCells),
+       VtWaveAngle(ptWaveAngle, ptWaveAngle + ulNumCells),
+       VtTotWaveHeight(ptTotWaveHeight, ptTotWaveHeight + ulNumCells),
+       VtTotWaveAngle(ptTotWaveAngle, ptTotWaveAngle + ulNumCells);
+   vector<int>
+       VnShadowZone(pnShadowZone, pnShadowZone + ulNumCells),
+       VnDownDriftZone(pnDownDriftZone, pnDownDriftZone + ulNumCells);
+   vector<uint64_t> VulActiveZone(pulActiveZone, pulActiveZone + ulNumFlagWords);
+
+   // Do the active window only, and keep the results
+   CalcD50AndFillWaveCalcHoles(true);
+
+   vector<diag_t>
+       VtWindowWaveHeight(ptWaveHeight, ptWaveHeight + ulNumCells),
+       VtWindowWaveAngle(ptWaveAngle, ptWaveAngle + ulNumCells);
+   vector<int>
+       VnWindowShadowZone(pnShadowZone, pnShadowZone + ulNumCells),
+       VnWindowDownDriftZone(pnDownDriftZone, pnDownDriftZone + ulNumCells);
+   vector<uint64_t> VulWindowActiveZone(pulActiveZone, pulActiveZone + ulNumFlagWords);
+   vector<double> VdWindowPolygonD50;
+   for (int nCoast = 0; nCoast < static_cast<int>(m_VCoast.size()); nCoast++)
+   {
+      for (int nPoly = 0; nPoly < m_VCoast[nCoast].nGetNumPolygons(); nPoly++)
+         VdWindowPolygonD50.push_back(m_VCoast[nCoast].pGetPolygon(nPoly)->dGetAvgUnconsD50());
+   }
+
+   // Put back the values as they were, then do the whole grid
+   copy(VtWaveHeight.begin(), VtWaveHeight.end(), ptWaveHeight);
+   copy(VtWaveAngle.begin(), VtWaveAngle.end(), ptWaveAngle);
+   copy(VtTotWaveHeight.begin(), VtTotWaveHeight.end(), ptTotWaveHeight);
+   copy(VtTotWaveAngle.begin(), VtTotWaveAngle.end(), ptTotWaveAngle);
+   copy(VnShadowZone.begin(), VnShadowZone.end(), pnShadowZone);
+   copy(VnDownDriftZone.begin(), VnDownDriftZone.end(), pnDownDriftZone);
+   copy(VulActiveZone.begin(), VulActiveZone.end(), pulActiveZone);
+
+   CalcD50AndFillWaveCalcHoles(false);
+
+   // Compare the results. The zones must be the same, the wave values must be the same within TOLERANCE
+   unsigned long ulNumDiffer = 0;
+   unsigned long ulFirstDiffer = 0;
+   for (unsigned long n = 0; n < ulNumCells; n++)
+   {
+      double dWindowWaveHeight = VtWindowWaveHeight[n];
+      double dWindowWaveAngle = VtWindowWaveAngle[n];
+      double dWaveHeight = ptWaveHeight[n];
+      double dWaveAngle = ptWaveAngle[n];
+      uint64_t ulBit = static_cast<uint64_t>(1) << (n % 64);
+
+      if ((! bFPIsEqual(dWindowWaveHeight, dWaveHeight, TOLERANCE)) || (! bFPIsEqual(dWindowWaveAngle, dWaveAngle, TOLERANCE)) || (VnWindowShadowZone[n] != pnShadowZone[n]) || (VnWindowDownDriftZone[n] != pnDownDriftZone[n]) || ((VulWindowActiveZone[n / 64] ^ pulActiveZone[n / 64]) & ulBit))
+      {
+         if (ulNumDiffer == 0)
+            ulFirstDiffer = n;
+
+         ulNumDiffer++;
+      }
+   }
+
+   if (ulNumDiffer > 0)
+   {
+      int nX = static_cast<int>(ulFirstDiffer % m_nXGridMax);
+      int nY = static_cast<int>(ulFirstDiffer / m_nXGridMax);
+      LogStream << m_ulIter << ": " << ERR << "optimisation check: filling wave calculation holes in the active window only gives different wave values at " << ulNumDiffer << " cells, the first is [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "}" << endl;
+      return RTN_ERR_OPTIMISATION_CHECK;
+   }
+
+   int nPolygonIndex = 0;
+   for (int nCoast = 0; nCoast < static_cast<int>(m_VCoast.size()); nCoast++)
+   {
+      for (int nPoly = 0; nPoly < m_VCoast[nCoast].nGetNumPolygons(); nPoly++, nPolygonIndex++)
+      {
+         if (! bFPIsEqual(VdWindowPolygonD50[nPolygonIndex], m_VCoast[nCoast].pGetPolygon(nPoly)->dGetAvgUnconsD50(), TOLERANCE))
+         {
+            LogStream << m_ulIter << ": " << ERR << "optimisation check: calculating d50 in the active window only gives a different average d50 for coast " << nCoast << " polygon " << nPoly << endl;
+            return RTN_ERR_OPTIMISATION_CHECK;
+         }
+      }
+   }
+
+   return RTN_OK;
+}
@@ -253,6 +253,13 @@ double const CLOCK_T_RANGE = static_cast<double>(ULONG_MAX);
 // #define EQUAL(a, b) (STRCASECMP(a, b) == 0)
 // #endif
 
+// The storage type of the raster grid's diagnostic and wave field planes. Define CME_FLOAT_DIAGNOSTICS to hold these as single precision, which roughly halves the memory used by the grid. Sediment depths and elevations are always double precision
+#if defined CME_FLOAT_DIAGNOSTICS
+typedef float diag_t;
+#else
+typedef double diag_t;
+#endif
+
 //===================================================== hard-wired constants ====================================================
 char const COLON = ':';
 char const COMMA = ',';
@@ -271,14 +278,19 @@ bool const SAVE_CSHORE_OUTPUT = true;                          // #ifdef CSHORE_
 bool const USE_DEEP_WATER_FOR_SHADOW_LINE = true;              // Use deep water wave orientation in determining shadow line orientation?
 
 // Not likely that user will need to change these
+int const ARENA_ALIGNMENT = 16;                                // In bytes: each allocation from the per-timestep arena is aligned to this
+int const ARENA_CHUNK_SIZE = 262144;                           // In bytes: the per-timestep arena grows by chunks of at least this size
 int const BUF_SIZE = 2048;                                     // Max length (inc. terminating NULL) of any C-type string
+int const ACTIVE_WINDOW_MARGIN = 32;                           // In cells: the active window is widened by this much. Wave hole-filling can spread outwards a cell at a time, but its effect at least halves with each cell
 int const CAPE_POINT_MIN_SPACING = 10;                         // In cells: for shadow zone stuff, cape points must not be closer than this
 int const CLOCK_CHECK_ITERATION = 5000;                        // If have done this many timesteps then reset the CPU time running total
 int const COAST_LENGTH_MAX = 10;                               // For safety check when tracing coast
 int const COAST_LENGTH_MIN_X_PROF_SPACE = 20;                  // Ignore very short coasts less than this x profile spacing
-int const CSHOREARRAYOUTSIZE = 500;                            // The size of the arrays output by CShore, this must be the same as the value set when CShore is compiled TODO 070
 int const FLOOD_FILL_START_OFFSET = 2;                         // In cells: flood fill starts this distance inside polygon
 int const GRID_MARGIN = 10;                                    // Ignore this many along-coast grid-edge points re. shadow zone calcs
+int const GRID_PLANE_ALIGNMENT = 64;                           // In bytes: the start of each raster grid field plane is aligned to this (one cache line)
+int const GRID_TILE_HALO = 1;                                  // In tiles: a tile is active (its cells are swept) if it is within this many tiles of a coastline or profile cell
+int const GRID_TILE_SIZE = 64;                                 // In cells: the raster grid is divided into square tiles of this size
 int const INT_NODATA = -9999;                                  // CME's internal NODATA value for ints
 int const MAX_CLIFF_TALUS_LENGTH = 100;                        // In cells: maximum length of the Dean profile for cliff collapse talus
 int const MAX_LEN_SHADOW_LINE_TO_IGNORE = 200;                 // In cells: if can't find flood fill start point, continue if short shadow line
@@ -291,6 +303,8 @@ int const MIN_PROFILE_SIZE = 3;                                // In cells: min
 int const MIN_PROFILE_SPACING = 20;                            // In cells: profile creation does not work well if profiles are too closely spaced
 int const NUMBER_OF_INTERVENTION_CAPES = 4;                    // Max number of intervention cape profiles
 int const SAVGOL_POLYNOMIAL_MAX_ORDER = 6;                     // Maximum order of Savitsky-Golay smoothing polynomial
+int const STAGE_PROFILER_HISTOGRAM_BINS = 40;                  // Number of power-of-two bins (upwards from one microsecond) in each main loop stage's timing histogram
+int const TILE_QUIET_TIMESTEPS_FOR_UNIFORM = 2;                // A grid tile must be away from coastlines and profiles for this many timesteps before it is uniform
 
 // Log file detail level
 int const NO_LOG_FILE = 0;
@@ -554,7 +568,10 @@ int const RTN_ERR_SEDIMENT_INPUT_EVENT = 65;
 int const RTN_ERR_SEDIMENT_INPUT_EVENT_LOCATION = 66;
 int const RTN_ERR_FLOOD_LOCATION = 67;
 int const RTN_ERR_CLIFF_NOT_IN_POLYGON = 68;
-int const RTN_ERR_UNKNOWN = 69;
+int const RTN_ERR_CSHORE_WORKER = 69;
+int const RTN_ERR_CSHORE_SCRATCH_DIR = 70;
+int const RTN_ERR_OPTIMISATION_CHECK = 71;
+int const RTN_ERR_UNKNOWN = 72;
 
 // Elevation and 'slice' codes
 int const ELEV_IN_BASEMENT = -1;
@@ -579,6 +596,134 @@ int const WAVE_MODEL_CSHORE = 1;
 int const UNCONS_SEDIMENT_EQUATION_CERC = 0;
 int const UNCONS_SEDIMENT_EQUATION_KAMPHUIS = 1;
 
+// Raster grid field codes: each per-cell value is held by CGeomRasterGrid in a contiguous field plane, these are the plane indices. Double-valued fields first: these are the values on which the sediment budget depends, so are always held as doubles
+int const CELL_DBL_BASEMENT_ELEV = 0;
+int const CELL_DBL_SEA_DEPTH = 1;
+int const CELL_DBL_BEACH_PROTECTION = 2;
+int const CELL_DBL_SUSP_SED = 3;
+int const CELL_DBL_POTENTIAL_PLATFORM_EROSION = 4;
+int const CELL_DBL_ACTUAL_PLATFORM_EROSION = 5;
+int const CELL_DBL_CLIFF_COLLAPSE_FINE = 6;
+int const CELL_DBL_CLIFF_COLLAPSE_SAND = 7;
+int const CELL_DBL_CLIFF_COLLAPSE_COARSE = 8;
+int const CELL_DBL_TALUS_SAND_DEPOSITION = 9;
+int const CELL_DBL_TALUS_COARSE_DEPOSITION = 10;
+int const CELL_DBL_POTENTIAL_BEACH_EROSION = 11;
+int const CELL_DBL_ACTUAL_BEACH_EROSION = 12;
+int const CELL_DBL_BEACH_DEPOSITION = 13;
+int const CELL_DBL_UNCONS_D50 = 14;
+int const CELL_DBL_INTERVENTION_HEIGHT = 15;
+int const CELL_DBL_SEDIMENT_TOP_ELEV = 16;
+int const NUM_CELL_DBL_FIELDS = 17;
+
+// Raster grid field codes, diagnostic and wave fields. These are held as diag_t, so are single precision if CME_FLOAT_DIAGNOSTICS is defined
+int const CELL_DIAG_LOCAL_CONS_SLOPE = 0;
+int const CELL_DIAG_TOT_SEA_DEPTH = 1;
+int const CELL_DIAG_WAVE_HEIGHT = 2;
+int const CELL_DIAG_TOT_WAVE_HEIGHT = 3;
+int const CELL_DIAG_WAVE_ANGLE = 4;
+int const CELL_DIAG_WAVE_PERIOD = 5;
+int const CELL_DIAG_TOT_WAVE_ANGLE = 6;
+int const CELL_DIAG_DEEP_WATER_WAVE_HEIGHT = 7;
+int const CELL_DIAG_DEEP_WATER_WAVE_ANGLE = 8;
+int const CELL_DIAG_DEEP_WATER_WAVE_PERIOD = 9;
+int const CELL_DIAG_TOT_SUSP_SED = 10;
+int const CELL_DIAG_TOT_POTENTIAL_PLATFORM_EROSION = 11;
+int const CELL_DIAG_TOT_ACTUAL_PLATFORM_EROSION = 12;
+int const CELL_DIAG_TOT_CLIFF_COLLAPSE_FINE = 13;
+int const CELL_DIAG_TOT_CLIFF_COLLAPSE_SAND = 14;
+int const CELL_DIAG_TOT_CLIFF_COLLAPSE_COARSE = 15;
+int const CELL_DIAG_TOT_TALUS_SAND_DEPOSITION = 16;
+int const CELL_DIAG_TOT_TALUS_COARSE_DEPOSITION = 17;
+int const CELL_DIAG_TOT_POTENTIAL_BEACH_EROSION = 18;
+int const CELL_DIAG_TOT_ACTUAL_BEACH_EROSION = 19;
+int const CELL_DIAG_TOT_BEACH_DEPOSITION = 20;
+int const NUM_CELL_DIAG_FIELDS = 21;
+
+// Raster grid field codes, int-valued fields
+int const CELL_INT_BOUNDING_BOX_EDGE = 0;
+int const CELL_INT_POLYGON_ID = 1;
+int const CELL_INT_COASTLINE_NORMAL = 2;
+int const CELL_INT_SHADOW_ZONE = 3;
+int const CELL_INT_DOWNDRIFT_ZONE = 4;
+int const NUM_CELL_INT_FIELDS = 5;
+
+// Raster grid field codes, flags
+int const CELL_FLAG_IN_CONTIGUOUS_SEA = 0;
+int const CELL_FLAG_IN_CONTIGUOUS_FLOOD = 1;
+int const CELL_FLAG_IN_ACTIVE_ZONE = 2;
+int const CELL_FLAG_COASTLINE = 3;
+int const CELL_FLAG_FLOOD_LINE = 4;
+int const CELL_FLAG_WAVE_FLOOD = 5;
+int const CELL_FLAG_CHECK_FLOOD = 6;
+int const CELL_FLAG_SHADOW_BOUNDARY = 7;
+int const CELL_FLAG_POSSIBLE_COAST_START = 8;
+int const CELL_FLAG_POSSIBLE_FLOOD_START = 9;
+int const CELL_FLAG_FLOOD_BY_SETUP_SURGE = 10;
+int const CELL_FLAG_FLOOD_BY_SETUP_SURGE_RUNUP = 11;
+int const CELL_FLAG_SEDIMENT_DIRTY = 12;
+int const CELL_FLAG_IN_CONTIGUOUS_FLOOD_RUNUP = 13;       // The wave setup plus surge plus run-up flood level's own copies of the flood flags, see CSimulation::nLocateFloodAndCoasts()
+int const CELL_FLAG_FLOOD_LINE_RUNUP = 14;
+int const CELL_FLAG_CHECK_FLOOD_RUNUP = 15;
+int const CELL_FLAG_POSSIBLE_FLOOD_START_RUNUP = 16;
+int const NUM_CELL_FLAGS = 17;
+
+// Sediment totals for a single cell, as returned by CGeomCell::GetSedimentTotals(). Consolidated totals consider cliff notches
+int const SEDIMENT_TOTAL_CONS_FINE = 0;
+int const SEDIMENT_TOTAL_CONS_SAND = 1;
+int const SEDIMENT_TOTAL_CONS_COARSE = 2;
+int const SEDIMENT_TOTAL_UNCONS_FINE = 3;
+int const SEDIMENT_TOTAL_UNCONS_SAND = 4;
+int const SEDIMENT_TOTAL_UNCONS_COARSE = 5;
+int const NUM_SEDIMENT_TOTALS = 6;
+
+// Bits of the per-cell inundation state which is evaluated in bulk by CGeomRasterGrid::GetInundationRowSpan()
+int const INUNDATION_WET = 1;                            // The top of the sediment plus any intervention is below the water level
+int const INUNDATION_NODATA_BASEMENT = 2;                // The basement elevation is NODATA
+
+// Stages of the main loop which are timed by CStageProfiler
+int const STAGE_UPDATE_INTERVENTION = 0;
+int const STAGE_EXTERNAL_FORCING = 1;
+int const STAGE_INIT_GRID = 2;
+int const STAGE_LOCATE_SEA_AND_COASTS = 3;
+int const STAGE_CLASSIFY_TILES = 4;
+int const STAGE_ASSIGN_LANDFORMS = 5;
+int const STAGE_SEDIMENT_INPUT = 6;
+int const STAGE_CREATE_PROFILES = 7;
+int const STAGE_CREATE_POLYGONS = 8;
+int const STAGE_PROPAGATE_WAVES = 9;
+int const STAGE_PLATFORM_EROSION = 10;
+int const STAGE_CLIFF_COLLAPSE = 11;
+int const STAGE_BEACH_SEDIMENT = 12;
+int const STAGE_UPDATE_GRID = 13;
+int const STAGE_LOCATE_FLOOD = 14;
+int const STAGE_SAVE_GIS = 15;
+int const STAGE_WRITE_TEXT = 16;
+int const NUM_STAGES = 17;
+
+// Tasks of the end of each timestep, which are run by CTaskGraph via CSimulation::nDoTask()
+int const TASK_UPDATE_GRID = 0;
+int const TASK_LOCATE_FLOOD_SETUP_SURGE = 1;
+int const TASK_LOCATE_FLOOD_SETUP_SURGE_RUNUP = 2;
+int const TASK_FINISH_LOCATE_FLOOD = 3;
+int const TASK_SAVE_RASTER_GIS = 4;
+int const TASK_SAVE_VECTOR_GIS = 5;
+int const TASK_WRITE_PER_TIMESTEP_RESULTS = 6;
+int const TASK_WRITE_TIME_SERIES = 7;
+
+// Tasks which are run once for each of a number of independent items, by CTaskGraph via CSimulation::nDoTaskItem()
+int const TASK_PROPAGATE_WAVES_ON_PROFILE = 8;
+
+// Bits for the parts of the simulation's state which each task reads and writes, from which CTaskGraph finds the dependencies between tasks
+unsigned long const TASK_STATE_GRID = 1;                       // The raster grid, apart from the flood flags
+unsigned long const TASK_STATE_COASTS = 2;                     // The coastlines, profiles and polygons
+unsigned long const TASK_STATE_TOTALS = 4;                     // The per-timestep and running totals
+unsigned long const TASK_STATE_FLOOD_SETUP_SURGE = 8;          // The wave setup plus surge flood flags, flood line and water level
+unsigned long const TASK_STATE_FLOOD_SETUP_SURGE_RUNUP = 16;   // The wave setup plus surge plus run-up flood flags, flood line and water level
+unsigned long const TASK_STATE_LOG_FILE = 32;                  // The log file, and messages to the console
+unsigned long const TASK_STATE_OUT_FILE = 64;
+unsigned long const TASK_STATE_TIME_SERIES_FILES = 128;
+
 int const CLIFF_COLLAPSE_LENGTH_INCREMENT = 10;          // Increment the planview length of the cliff talus Dean profile, if we have not been able to deposit enough
 
 unsigned long const MASK = 0xfffffffful;
@@ -609,6 +754,7 @@ double const STRAIGHT_COAST_MAX_DETAILED_CURVATURE = -5;
 double const STRAIGHT_COAST_MAX_SMOOTH_CURVATURE = -1;
 double const MIN_LENGTH_OF_SHADOW_ZONE_LINE = 10;        // Used in shadow line tracing
 double const MAX_LAND_LENGTH_OF_SHADOW_ZONE_LINE = 5;    // Used in shadow line tracing
+double const SEA_MASK_MAX_CHANGED_FRACTION = 0.05;       // If the inundation state of more than this fraction of cells changes, the sea is re-flooded from the grid edges rather than being updated incrementally
 double const CLIFF_COLLAPSE_HEIGHT_INCREMENT = 0.1;      // Increment the fractional height of the cliff talus Dean profile, if we have not been able to deposit enough
 
 double const DBL_NODATA = -9999;
@@ -675,9 +821,12 @@ string const EMAIL_ERROR = "Could not send email";
 string const SCAPE_DIR = "scape/";
 string const SCAPE_SHAPE_FUNCTION_FILE = "ShapeFunction.dat";
 string const EROSION_POTENTIAL_LOOKUP_FILE = "ErosionPotential.csv";
+string const GRID_MMAP_FILE = "GridPlanes.mmap";
 
 string const CSHORE_DIR = "cshore/";
 string const CSHORE_INFILE = "infile";
+string const CSHORE_SCRATCH_DIR_PREFIX = "cme_cshore_";       // Each thread's CShore scratch directory is this, then the process ID and thread number
+string const CSHORE_MASTER_FILE_PREFIX = "master_";           // With SAVE_CSHORE_OUTPUT, each CShore output file is appended to this, then its name, then ".txt"
 
 string const ERR = "*** ERROR ";
 string const WARN = "WARNING ";
@@ -1019,6 +1168,9 @@ string const TIME_SERIES_FLOOD_SETUP_SURGE_CODE = "flood_setup_surge";
 string const TIME_SERIES_FLOOD_SETUP_SURGE_RUNUP_NAME = "flood_setup_surge_runup";
 string const TIME_SERIES_FLOOD_SETUP_SURGE_RUNUP_CODE = "flood_setup_surge_runup";
 
+string const TIME_SERIES_STAGE_TIMES_NAME = "stage_times";
+string const TIME_SERIES_STAGE_TIMES_CODE = "stage_times";
+
 // CShore stuff
 string const WAVE_ENERGY_FLUX = "wave_energy_flux";
 string const WAVE_HEIGHT_X_FILENAME = "wave_height_x.csv";
@@ -1058,6 +1210,19 @@ T tAbs(T a)
     return ((a < 0) ? -a : a);
 }
 
+// Narrows a double to diag_t, the storage type of the diagnostic and wave field planes. The narrowing is written only here, so that neither storage type gives a conversion warning
+#if defined CME_FLOAT_DIAGNOSTICS
+inline diag_t tToDiag(double const dValue)
+{
+   return static_cast<diag_t>(dValue);
+}
+#else
+inline diag_t tToDiag(double const dValue)
+{
+   return dValue;
+}
+#endif
+
 template <class T>
 bool bIsBetween(T a, T b, T c)
 {
@@ -1101,6 +1266,7 @@ bool bFPIsEqual(const T d1, const T d2, const T dEpsilon)
 // Definitions are in utilsglobal.cpp
 double dRound(double const);
 int nRound(double const);
+bool bBitwiseEqual(double const, double const);
 // bool bIsWhole(double const);
 bool bIsStringValidDouble(string &);
 bool bIsStringValidInt(string &);
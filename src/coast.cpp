@@ -40,18 +40,22 @@ CRWCoast::CRWCoast(void)
       m_dCurvatureDetailedMean(0),
       m_dCurvatureDetailedSTD(0),
       m_dCurvatureSmoothMean(0),
-      m_dCurvatureSmoothSTD(0)
+      m_dCurvatureSmoothSTD(0),
+      m_nFirstChangedPoint(0),
+      m_nLastChangedPoint(INT_MAX),
+      m_nChangedPointOffset(0)
 {
 }
 
 //! Destructor
 CRWCoast::~CRWCoast(void)
 {
+   // The landforms and polygons were constructed in the per-timestep arena, so are destroyed here but their memory is not freed: that happens when the arena is reset
    for (unsigned int i = 0; i < m_pVLandforms.size(); i++)
-      delete m_pVLandforms[i];
+      m_pVLandforms[i]->~CACoastLandform();
 
    for (unsigned int i = 0; i < m_pVPolygon.size(); i++)
-      delete m_pVPolygon[i];
+      m_pVPolygon[i]->~CGeomCoastPolygon();
 }
 
 //! Sets the handedness of the coast
@@ -90,6 +94,44 @@ int CRWCoast::nGetEndEdge(void) const
    return m_nEndEdge;
 }
 
+//! Sets the range of points on the coast which may differ from the last timestep's coast, and the change in the number of points. If nFirst > nLast, no point differs
+void CRWCoast::SetChangedRange(int const nFirst, int const nLast, int const nOffset)
+{
+   m_nFirstChangedPoint = nFirst;
+   m_nLastChangedPoint = nLast;
+   m_nChangedPointOffset = nOffset;
+}
+
+//! Gets the first point on the coast which may differ from the last timestep's coast
+int CRWCoast::nGetFirstChangedPoint(void) const
+{
+   return m_nFirstChangedPoint;
+}
+
+//! Gets the last point on the coast which may differ from the last timestep's coast
+int CRWCoast::nGetLastChangedPoint(void) const
+{
+   return m_nLastChangedPoint;
+}
+
+//! Gets the number of points on the coast, less the number of points on the last timestep's coast. A point after the changed range is the same as the last timestep's point with index reduced by this
+int CRWCoast::nGetChangedPointOffset(void) const
+{
+   return m_nChangedPointOffset;
+}
+
+//! Returns true if no point on the coast differs from the last timestep's coast
+bool CRWCoast::bIsUnchanged(void) const
+{
+   return (m_nFirstChangedPoint > m_nLastChangedPoint);
+}
+
+//! Returns true if the given point on the coast may differ from the last timestep's coast
+bool CRWCoast::bPointHasChanged(int const nPoint) const
+{
+   return ((nPoint >= m_nFirstChangedPoint) && (nPoint <= m_nLastChangedPoint));
+}
+
 //! Given the vector line of a coast initializes, initializes coastline values (curvature, breaking wave height, wave angle, and flux orientation etc.)
 void CRWCoast::SetCoastlineExtCRS(CGeomLine const* pLCoast)
 {
@@ -429,6 +471,16 @@ void CRWCoast::AppendProfile(int const nCoastPoint, int const nProfile)
    m_VnProfileNumber[nCoastPoint] = nProfile;
 }
 
+//! Removes all profiles from this coast
+void CRWCoast::RemoveAllProfiles(void)
+{
+   for (unsigned int n = 0; n < m_VProfile.size(); n++)
+      m_VnProfileNumber[m_VProfile[n].nGetNumCoastPoint()] = INT_NODATA;
+
+   m_VProfile.clear();
+   m_VnProfileCoastIndex.clear();
+}
+
 // void CRWCoast::ReplaceProfile(int const nProfile, vector<CGeom2DPoint> const* pPtVProfileNew)
 // {
 //    // TODO 055 Maybe add a safety check? that nProfile < m_VProfile.size()
@@ -715,10 +767,10 @@ int CRWCoast::nGetPolygonNode(int const nPoint) const
    return m_VnPolygonNode[nPoint];
 }
 
-//! Creates a coast polygon
-void CRWCoast::CreatePolygon(int const nGlobalID, int const nCoastID, int const nCoastPoint, CGeom2DIPoint const *PtiNode, CGeom2DIPoint const* PtiAntiNode, int const nProfileUpCoast, int const nProfileDownCoast, vector<CGeom2DPoint> const* pVIn, int const nPointsUpCoastProfile, int const nPointsDownCoastProfile, int const nPointInPolygonStartPoint)
+//! Creates a coast polygon, in the per-timestep arena
+void CRWCoast::CreatePolygon(CTimestepArena* pArena, int const nGlobalID, int const nCoastID, int const nCoastPoint, CGeom2DIPoint const *PtiNode, CGeom2DIPoint const* PtiAntiNode, int const nProfileUpCoast, int const nProfileDownCoast, vector<CGeom2DPoint> const* pVIn, int const nPointsUpCoastProfile, int const nPointsDownCoastProfile, int const nPointInPolygonStartPoint)
 {
-   CGeomCoastPolygon* pPolygon = new CGeomCoastPolygon(nGlobalID, nCoastID, nCoastPoint, nProfileUpCoast, nProfileDownCoast, pVIn, nPointsUpCoastProfile, nPointsDownCoastProfile, PtiNode, PtiAntiNode, nPointInPolygonStartPoint);
+   CGeomCoastPolygon* pPolygon = pArena->pNew<CGeomCoastPolygon>(nGlobalID, nCoastID, nCoastPoint, nProfileUpCoast, nProfileDownCoast, pVIn, nPointsUpCoastProfile, nPointsDownCoastProfile, PtiNode, PtiAntiNode, nPointInPolygonStartPoint);
 
    m_pVPolygon.push_back(pPolygon);
 }
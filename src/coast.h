@@ -60,6 +60,15 @@ private:
    //! The standard deviaton of the coast's smoothed curvature
    double m_dCurvatureSmoothSTD;
 
+   //! The first point on m_LCoastlineExtCRS which may differ from the last timestep's coast. Points before this are the same as the last timestep's points with the same index
+   int m_nFirstChangedPoint;
+
+   //! The last point on m_LCoastlineExtCRS which may differ from the last timestep's coast. Points after this are the same as the last timestep's points with index reduced by m_nChangedPointOffset
+   int m_nLastChangedPoint;
+
+   //! The number of points on this coast, less the number of points on the last timestep's coast
+   int m_nChangedPointOffset;
+
    //! Smoothed line of points (external CRS) giving the plan view of the vector coast
    CGeomLine m_LCoastlineExtCRS;
 
@@ -164,6 +173,13 @@ public:
    void SetEndEdge(int const);
    int nGetEndEdge(void) const;
 
+   void SetChangedRange(int const, int const, int const);
+   int nGetFirstChangedPoint(void) const;
+   int nGetLastChangedPoint(void) const;
+   int nGetChangedPointOffset(void) const;
+   bool bIsUnchanged(void) const;
+   bool bPointHasChanged(int const) const;
+
    void SetCoastlineExtCRS(CGeomLine const*);
    // void AppendPointToCoastlineExtCRS(double const, double const);
    CGeomLine* pLGetCoastlineExtCRS(void);
@@ -205,6 +221,7 @@ public:
 
    CGeomProfile* pGetProfile(int const);
    void AppendProfile(int const, int const);
+   void RemoveAllProfiles(void);
 //    void ReplaceProfile(int const, vector<CGeom2DPoint> const*);
    int nGetNumProfiles(void) const;
    bool bIsProfileStartPoint(int const) const;
@@ -261,7 +278,7 @@ public:
 
    void SetPolygonNode(int const, int const);
    int nGetPolygonNode(int const) const;
-   void CreatePolygon(int const, int const, int const, CGeom2DIPoint const*, CGeom2DIPoint const*, int const, int const, vector<CGeom2DPoint> const*, int const, int const, int const);
+   void CreatePolygon(CTimestepArena*, int const, int const, int const, CGeom2DIPoint const*, CGeom2DIPoint const*, int const, int const, vector<CGeom2DPoint> const*, int const, int const, int const);
    int nGetNumPolygons(void) const;
    CGeomCoastPolygon* pGetPolygon(int const) const;
 
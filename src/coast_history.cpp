@@ -0,0 +1,168 @@
+/*!
+ *
+ * \file coast_history.cpp
+ * \brief CCoastHistory routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include "cme.h"
+#include "coast_history.h"
+
+//! Constructor, copies the coast's unsmoothed and smoothed coastlines
+CCoastHistory::CCoastHistory(int const nHandedness, int const nStartEdge, int const nEndEdge, CGeomILine const* pILCoastlineGridCRS, CGeomLine const* pLCoastlineExtCRS)
+: m_nSeaHandedness(nHandedness),
+  m_nStartEdge(nStartEdge),
+  m_nEndEdge(nEndEdge),
+  m_ILCoastlineGridCRS(*pILCoastlineGridCRS),
+  m_LCoastlineExtCRS(*pLCoastlineExtCRS),
+  m_bHasProfilePlacement(false),
+  m_nProfileRandomDraws(0)
+{
+   m_PtiStart = m_ILCoastlineGridCRS[0];
+}
+
+//! Returns true if a coast which starts at the given cell, and has the given handedness, is the same coast as this one
+bool CCoastHistory::bIsSameCoast(CGeom2DIPoint const* pPtiStart, int const nHandedness) const
+{
+   return ((nHandedness == m_nSeaHandedness) && (m_PtiStart == pPtiStart));
+}
+
+//! Returns true if a coast with the given start and end edges has the same edges as this one. If not, the smoothing near both ends of the coast may be different
+bool CCoastHistory::bHasSameEdges(int const nStartEdge, int const nEndEdge) const
+{
+   return ((nStartEdge == m_nStartEdge) && (nEndEdge == m_nEndEdge));
+}
+
+//! Compares a new unsmoothed coastline with this one. Returns the number of leading points which are the same in both (nPrefix), and the number of trailing points which are the same in both (nSuffix). The leading and trailing runs do not overlap in either coastline
+void CCoastHistory::FindCommonPoints(CGeomILine* pILNew, int& nPrefix, int& nSuffix)
+{
+   int nNewSize = pILNew->nGetSize();
+   int nOldSize = m_ILCoastlineGridCRS.nGetSize();
+   int nMinSize = tMin(nNewSize, nOldSize);
+
+   nPrefix = 0;
+   while ((nPrefix < nMinSize) && ((*pILNew)[nPrefix] == m_ILCoastlineGridCRS[nPrefix]))
+      nPrefix++;
+
+   nSuffix = 0;
+   while ((nSuffix < nMinSize - nPrefix) && ((*pILNew)[nNewSize - 1 - nSuffix] == m_ILCoastlineGridCRS[nOldSize - 1 - nSuffix]))
+      nSuffix++;
+}
+
+//! Returns the number of points on the coastline
+int CCoastHistory::nGetSize(void) const
+{
+   return m_LCoastlineExtCRS.nGetSize();
+}
+
+//! Returns a pointer to a point on the smoothed coastline
+CGeom2DPoint* CCoastHistory::pPtGetCoastlinePointExtCRS(int const n)
+{
+   return &m_LCoastlineExtCRS[n];
+}
+
+//! Copies the coast's detailed and smoothed curvature
+void CCoastHistory::SetCurvature(vector<double> const* pVdDetailed, vector<double> const* pVdSmooth)
+{
+   m_VdCurvatureDetailed = *pVdDetailed;
+   m_VdCurvatureSmooth = *pVdSmooth;
+}
+
+//! Returns the detailed curvature at a point on the coastline
+double CCoastHistory::dGetDetailedCurvature(int const n) const
+{
+   return m_VdCurvatureDetailed[n];
+}
+
+//! Returns the smoothed curvature at a point on the coastline
+double CCoastHistory::dGetSmoothCurvature(int const n) const
+{
+   return m_VdCurvatureSmooth[n];
+}
+
+//! Copies the record of the last profile placement from another CCoastHistory object, i.e. from last timestep's version of this coast
+void CCoastHistory::CopyProfilePlacement(CCoastHistory const* pOther)
+{
+   m_bHasProfilePlacement = pOther->m_bHasProfilePlacement;
+   m_nProfileRandomDraws = pOther->m_nProfileRandomDraws;
+   m_VnProfileAttemptPoint = pOther->m_VnProfileAttemptPoint;
+   m_VbProfileAttemptOK = pOther->m_VbProfileAttemptOK;
+   m_VnInterventionPoint = pOther->m_VnInterventionPoint;
+}
+
+//! Discards the record of the last profile placement, ready to record a new one
+void CCoastHistory::StartProfilePlacement(void)
+{
+   m_bHasProfilePlacement = false;
+   m_nProfileRandomDraws = 0;
+   m_VnProfileAttemptPoint.clear();
+   m_VbProfileAttemptOK.clear();
+   m_VnInterventionPoint.clear();
+}
+
+//! Records an attempt to create a profile at a coast point, and whether a profile was created
+void CCoastHistory::AppendProfileAttempt(int const nCoastPoint, bool const bOK)
+{
+   m_VnProfileAttemptPoint.push_back(nCoastPoint);
+   m_VbProfileAttemptOK.push_back(bOK);
+}
+
+//! Records that a random number was drawn while placing profiles
+void CCoastHistory::AddProfileRandomDraw(void)
+{
+   m_nProfileRandomDraws++;
+}
+
+//! Marks the record of the profile placement as complete, and stores the coast points which were intervention landforms
+void CCoastHistory::EndProfilePlacement(vector<int> const* pVnInterventionPoint)
+{
+   m_VnInterventionPoint = *pVnInterventionPoint;
+   m_bHasProfilePlacement = true;
+}
+
+//! Returns true if there is a complete record of the last profile placement, and if the same coast points were then intervention landforms
+bool CCoastHistory::bHasProfilePlacement(vector<int> const* pVnInterventionPoint) const
+{
+   return (m_bHasProfilePlacement && (*pVnInterventionPoint == m_VnInterventionPoint));
+}
+
+//! Returns the number of attempts to create a profile during the last profile placement
+int CCoastHistory::nGetNumProfileAttempts(void) const
+{
+   return static_cast<int>(m_VnProfileAttemptPoint.size());
+}
+
+//! Returns the coast point of an attempt to create a profile during the last profile placement
+int CCoastHistory::nGetProfileAttemptPoint(int const n) const
+{
+   return m_VnProfileAttemptPoint[n];
+}
+
+//! Returns true if an attempt to create a profile during the last profile placement created a profile
+bool CCoastHistory::bGetProfileAttemptOK(int const n) const
+{
+   return m_VbProfileAttemptOK[n];
+}
+
+//! Returns the number of random numbers drawn during the last profile placement
+int CCoastHistory::nGetProfileRandomDraws(void) const
+{
+   return m_nProfileRandomDraws;
+}
@@ -0,0 +1,104 @@
+/*!
+ *
+ * \class CCoastHistory
+ * \brief Class used to keep those parts of a coast which are needed next timestep
+ * \details A CRWCoast object cannot be kept from one timestep to the next, since its landforms and polygons are allocated from the per-timestep arena. So at the end of each trace, the coast's unsmoothed and smoothed coastline, and its curvature, are copied into a CCoastHistory object. Next timestep, when the same coast (i.e. one which starts at the same cell and with the same handedness) is traced again, the new unsmoothed coastline is compared with the old one. Only the part which lies between the common leading and trailing runs of cells, and the points within a smoothing window of this part, are then smoothed and have their curvature calculated; the rest is copied from the CCoastHistory object. The object also records where profiles were attempted when profiles were last placed on the coast, so that if the coast has not changed then the placement can be replayed rather than searched for again
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file coast_history.h
+ * \brief Contains CCoastHistory definitions
+ *
+ */
+
+#ifndef COAST_HISTORY_H
+#define COAST_HISTORY_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <vector>
+using std::vector;
+
+#include "2di_point.h"
+#include "line.h"
+#include "i_line.h"
+
+class CCoastHistory
+{
+private:
+   //! Direction of the sea from the coastline, travelling down-coast
+   int m_nSeaHandedness;
+
+   //! The edge from which the coast starts
+   int m_nStartEdge;
+
+   //! The edge at which the coast ends
+   int m_nEndEdge;
+
+   //! The cell (grid CRS) from which the coast starts
+   CGeom2DIPoint m_PtiStart;
+
+   //! Unsmoothed integer x-y co-ordinates (grid CRS) of each point on the coastline
+   CGeomILine m_ILCoastlineGridCRS;
+
+   //! Smoothed coastline (external CRS)
+   CGeomLine m_LCoastlineExtCRS;
+
+   //! Detailed curvature at each point on the coastline, before any adjustment for a straight coast
+   vector<double> m_VdCurvatureDetailed;
+
+   //! Smoothed curvature at each point on the coastline, before any adjustment for a straight coast
+   vector<double> m_VdCurvatureSmooth;
+
+   //! Is there a record of the coast points at which profiles were attempted, when profiles were last placed on this coast?
+   bool m_bHasProfilePlacement;
+
+   //! The number of random numbers drawn when profiles were last placed on this coast
+   int m_nProfileRandomDraws;
+
+   //! The coast points at which profiles were attempted when profiles were last placed on this coast, in the sequence in which they were attempted
+   vector<int> m_VnProfileAttemptPoint;
+
+   //! For each attempt in m_VnProfileAttemptPoint, was a profile created?
+   vector<bool> m_VbProfileAttemptOK;
+
+   //! The coast points which were intervention landforms when profiles were last placed on this coast
+   vector<int> m_VnInterventionPoint;
+
+public:
+   CCoastHistory(int const, int const, int const, CGeomILine const*, CGeomLine const*);
+
+   bool bIsSameCoast(CGeom2DIPoint const*, int const) const;
+   bool bHasSameEdges(int const, int const) const;
+   void FindCommonPoints(CGeomILine*, int&, int&);
+
+   int nGetSize(void) const;
+   CGeom2DPoint* pPtGetCoastlinePointExtCRS(int const);
+
+   void SetCurvature(vector<double> const*, vector<double> const*);
+   double dGetDetailedCurvature(int const) const;
+   double dGetSmoothCurvature(int const) const;
+
+   void CopyProfilePlacement(CCoastHistory const*);
+   void StartProfilePlacement(void);
+   void AppendProfileAttempt(int const, bool const);
+   void AddProfileRandomDraw(void);
+   void EndProfilePlacement(vector<int> const*);
+   bool bHasProfilePlacement(vector<int> const*) const;
+   int nGetNumProfileAttempts(void) const;
+   int nGetProfileAttemptPoint(int const) const;
+   bool bGetProfileAttemptOK(int const) const;
+   int nGetProfileRandomDraws(void) const;
+};
+#endif // COAST_HISTORY_H
@@ -160,7 +160,7 @@ int CSimulation::nCreateAllPolygons(void)
                }
 
                // Create the coast's polygon object
-               m_VCoast[nCoast].CreatePolygon(++m_nGlobalPolygonID, ++nPolygon, nNodePoint, &PtiNode, &PtiAntiNode, nPrevProfile, nThisProfile, &PtVBoundary, nPrevProfileEnd+1, nThisProfileEnd+1, nPointInPolygonStartPoint);
+               m_VCoast[nCoast].CreatePolygon(&m_TimestepArena, ++m_nGlobalPolygonID, ++nPolygon, nNodePoint, &PtiNode, &PtiAntiNode, nPrevProfile, nThisProfile, &PtVBoundary, nPrevProfileEnd+1, nThisProfileEnd+1, nPointInPolygonStartPoint);
 
                // Get a pointer to this polygon object
                CGeomCoastPolygon* pPolygon = m_VCoast[nCoast].pGetPolygon(nPolygon);
@@ -379,13 +379,13 @@ void CSimulation::MarkPolygonCells(void)
                int nThisLayer = m_pRasterGrid->m_Cell[nX][nY].nGetTopNonZeroLayerAboveBasement();
                
                // And increment some more running totals for this polygon TODO 066 should this be for ALL layers above the basement?
-               dStoredUnconsFine += m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nThisLayer)->pGetUnconsolidatedSediment()->dGetFineDepth();
-               dStoredUnconsSand += m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nThisLayer)->pGetUnconsolidatedSediment()->dGetSandDepth();
-               dStoredUnconsCoarse += m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nThisLayer)->pGetUnconsolidatedSediment()->dGetCoarseDepth();
+               dStoredUnconsFine += m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nThisLayer)->pGetUnconsolidatedSediment()->dGetFineDepth();
+               dStoredUnconsSand += m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nThisLayer)->pGetUnconsolidatedSediment()->dGetSandDepth();
+               dStoredUnconsCoarse += m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nThisLayer)->pGetUnconsolidatedSediment()->dGetCoarseDepth();
 
-               dStoredConsFine += m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nThisLayer)->pGetConsolidatedSediment()->dGetFineDepth();
-               dStoredConsSand += m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nThisLayer)->pGetConsolidatedSediment()->dGetSandDepth();
-               dStoredConsCoarse += m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nThisLayer)->pGetConsolidatedSediment()->dGetCoarseDepth();
+               dStoredConsFine += m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nThisLayer)->pGetConsolidatedSediment()->dGetFineDepth();
+               dStoredConsSand += m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nThisLayer)->pGetConsolidatedSediment()->dGetSandDepth();
+               dStoredConsCoarse += m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nThisLayer)->pGetConsolidatedSediment()->dGetCoarseDepth();
 
                // Add to the start-iteration total of suspended fine sediment within polygons
                m_dStartIterSuspFineInPolygons += m_pRasterGrid->m_Cell[nX][nY].dGetSuspendedSediment();
@@ -65,88 +65,33 @@ int CSimulation::nCreateAllProfiles(void)
    if (m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL)
       LogStream << m_ulIter << ": Creating profiles" << endl;
    
-   int nProfileToNodeSpacing = m_nCoastNormalAvgSpacing / 2;
-
    for (unsigned int nCoast = 0; nCoast < m_VCoast.size(); nCoast++)
    {
       int
           nProfile = -1,
           nCoastSize = m_VCoast[nCoast].nGetCoastlineSize();
 
-      // Any interventions?
-      if (! m_strInterventionHeightFile.empty())
-      {
-         // Create normal profiles(s) on intervention(s) at points on the intervention coastline at which detailed convexity is high (a large -ve value)
-         CreateInterventionProfiles(nCoast, nProfile /*, nProfileToNodeSpacing*/);
-      }
-
-      // Now create a vector of pairs: the first value of the pair is the coastline point, the second is the coastline's smoothed curvature at that point
-      vector<pair<int, double>> prVCurvature;
-      for (int nCoastPoint = 0; nCoastPoint < nCoastSize; nCoastPoint++)
-      {
-         double dCurvature = m_VCoast[nCoast].dGetSmoothCurvature(nCoastPoint);
-         prVCurvature.push_back(make_pair(nCoastPoint, dCurvature));
-      }
-
-      // Sort this pair vector in descending order, so that the most concave smoothed-curvature points are first
-      sort(prVCurvature.begin(), prVCurvature.end(), bCurvaturePairCompareDescending);
-
-      // Create a bool vector to mark coast points which have been searched
-      vector<bool> bVCoastPointSearched(nCoastSize, false);
-
-      // Mark intervention coast points so they don't get searched (already done)
+      // Find the coast points which are intervention landforms
+      vector<int> VnInterventionPoint;
       for (int nCoastPoint = 0; nCoastPoint < nCoastSize; nCoastPoint++)
          if (m_VCoast[nCoast].pGetCoastLandform(nCoastPoint)->nGetLandFormCategory() == LF_CAT_INTERVENTION)
-            bVCoastPointSearched[nCoastPoint] = true;
+            VnInterventionPoint.push_back(nCoastPoint);
 
-      // And mark points near the start and end of the coastline so that they don't get searched (will be creating 'special' start- and end-of-coast profiles there later)
-      for (int n = 0; n < nProfileToNodeSpacing; n++)
+      // If this coast has not changed since last timestep, and profile spacing is not random, then profiles will be placed at the same coast points as last timestep, unless this timestep's grid makes some attempt to create a profile turn out differently. So first try replaying last timestep's placement
+      CCoastHistory* pHistory = &m_VCoastHistory[nCoast];
+      if (m_VCoast[nCoast].bIsUnchanged() && bFPIsEqual(m_dCoastNormalRandSpacingFactor, 0.0, TOLERANCE) && pHistory->bHasProfilePlacement(&VnInterventionPoint) && bReplayProfilePlacement(nCoast, nProfile))
       {
-         if (n < nCoastSize)
-            bVCoastPointSearched[n] = true;
-
-         int m = nCoastSize - n - 1;
-         if (m >= 0)
-            bVCoastPointSearched[m] = true;
+         if (m_nLogFileDetail >= LOG_FILE_ALL)
+            LogStream << m_ulIter << ": Coast " << nCoast << " unchanged, profiles placed at the same " << pHistory->nGetNumProfileAttempts() << " coast points as last timestep" << endl;
       }
-
-      if (m_nNaturalCapeNormals > 0)
+      else
       {
-         // Create normal profiles for natural capes i.e. points on the coastline at which smoothed convexity is high (a large -ve value), but detailed convexity is low
-         CreateNaturalCapeNormalProfiles(nCoast, nProfile, nProfileToNodeSpacing, &bVCoastPointSearched, &prVCurvature);
+         // Place the profiles from scratch, recording where they are attempted
+         pHistory->StartProfilePlacement();
+         PlaceCoastNormalProfiles(nCoast, nProfile);
+         pHistory->EndProfilePlacement(&VnInterventionPoint);
       }
 
-      // TODO 013 Try just one SD below the mean
-      // Calculate a convexity threshold, which is two standard deviations below the mean: will not create non-cape profiles on coast points with smoothed convexity which exceeds this (i.e. with smoothed curvature values which are less than this threshold)
-      double
-          dStdCurvature = m_VCoast[nCoast].dGetSmoothCurvatureSTD(),
-          dCoastProfileSmoothConvexityThreshold = m_VCoast[nCoast].dGetSmoothCurvatureMean(); // - (2 * dStdCurvature);
-      //          dCoastProfileSmoothConvexityThreshold = m_VCoast[nCoast].dGetSmoothCurvatureMean() - dStdCurvature;
-
-      // If we have a coast with almost identical curvature everywhere (e.g. a straight line), then set the threshold to a big -ve value, so that convexity at coastline points is ignored
-      if (tAbs(dStdCurvature) < TOLERANCE)
-         dCoastProfileSmoothConvexityThreshold = -DBL_MAX;
-
-      if (m_nLogFileDetail >= LOG_FILE_ALL)
-         LogStream << m_ulIter << ": Convexity threshold = " << dCoastProfileSmoothConvexityThreshold << endl;
-
-      // Now create normal profiles on either side of points of maximum smoothed convexity
-      CreateRestOfNormalProfiles(nCoast, nProfile, nProfileToNodeSpacing, dCoastProfileSmoothConvexityThreshold, &bVCoastPointSearched, &prVCurvature);
-
-      // Did we fail to create any normal profiles? If so, quit
-      // if (nProfile < 0)
-      // {
-      //    string strErr = ERR + "timestep " + strDblToStr(m_ulIter) + ": could not create profiles for coastline " + strDblToStr(nCoast);
-      //    if (m_ulIter == 1)
-      //       strErr += ". Check the SWL";
-      //    strErr += "\n";
-
-      //    cerr << strErr;
-      //    LogStream << strErr;
-
-      //    return RTN_ERR_NO_PROFILES_1;
-      // }
-
       // Create a 'special' profile at the beginning of the coastline, and put this onto the raster grid
       int nRet = nCreateGridEdgeProfile(true, nCoast, nProfile);
       if (nRet != RTN_OK)
@@ -181,6 +126,89 @@ int CSimulation::nCreateAllProfiles(void)
    return RTN_OK;
 }
 
+//===============================================================================================================================
+//! Places coastline-normal profiles on a coastline: first at a limited number at natural and artificial cape positions, then at locations of greatest concave curvature of the vector coastline. Each attempt to create a profile is recorded in the coast's CCoastHistory object
+//===============================================================================================================================
+void CSimulation::PlaceCoastNormalProfiles(int const nCoast, int& nProfile)
+{
+   int nProfileToNodeSpacing = m_nCoastNormalAvgSpacing / 2;
+   int nCoastSize = m_VCoast[nCoast].nGetCoastlineSize();
+
+   // Any interventions?
+   if (! m_strInterventionHeightFile.empty())
+   {
+      // Create normal profiles(s) on intervention(s) at points on the intervention coastline at which detailed convexity is high (a large -ve value)
+      CreateInterventionProfiles(nCoast, nProfile /*, nProfileToNodeSpacing*/);
+   }
+
+   // Now create a vector of pairs: the first value of the pair is the coastline point, the second is the coastline's smoothed curvature at that point
+   vector<pair<int, double>> prVCurvature;
+   for (int nCoastPoint = 0; nCoastPoint < nCoastSize; nCoastPoint++)
+   {
+      double dCurvature = m_VCoast[nCoast].dGetSmoothCurvature(nCoastPoint);
+      prVCurvature.push_back(make_pair(nCoastPoint, dCurvature));
+   }
+
+   // Sort this pair vector in descending order, so that the most concave smoothed-curvature points are first
+   sort(prVCurvature.begin(), prVCurvature.end(), bCurvaturePairCompareDescending);
+
+   // Create a bool vector to mark coast points which have been searched
+   vector<bool> bVCoastPointSearched(nCoastSize, false);
+
+   // Mark intervention coast points so they don't get searched (already done)
+   for (int nCoastPoint = 0; nCoastPoint < nCoastSize; nCoastPoint++)
+      if (m_VCoast[nCoast].pGetCoastLandform(nCoastPoint)->nGetLandFormCategory() == LF_CAT_INTERVENTION)
+         bVCoastPointSearched[nCoastPoint] = true;
+
+   // And mark points near the start and end of the coastline so that they don't get searched (will be creating 'special' start- and end-of-coast profiles there later)
+   for (int n = 0; n < nProfileToNodeSpacing; n++)
+   {
+      if (n < nCoastSize)
+         bVCoastPointSearched[n] = true;
+
+      int m = nCoastSize - n - 1;
+      if (m >= 0)
+         bVCoastPointSearched[m] = true;
+   }
+
+   if (m_nNaturalCapeNormals > 0)
+   {
+      // Create normal profiles for natural capes i.e. points on the coastline at which smoothed convexity is high (a large -ve value), but detailed convexity is low
+      CreateNaturalCapeNormalProfiles(nCoast, nProfile, nProfileToNodeSpacing, &bVCoastPointSearched, &prVCurvature);
+   }
+
+   // TODO 013 Try just one SD below the mean
+   // Calculate a convexity threshold, which is two standard deviations below the mean: will not create non-cape profiles on coast points with smoothed convexity which exceeds this (i.e. with smoothed curvature values which are less than this threshold)
+   double
+       dStdCurvature = m_VCoast[nCoast].dGetSmoothCurvatureSTD(),
+       dCoastProfileSmoothConvexityThreshold = m_VCoast[nCoast].dGetSmoothCurvatureMean(); // - (2 * dStdCurvature);
+   //          dCoastProfileSmoothConvexityThreshold = m_VCoast[nCoast].dGetSmoothCurvatureMean() - dStdCurvature;
+
+   // If we have a coast with almost identical curvature everywhere (e.g. a straight line), then set the threshold to a big -ve value, so that convexity at coastline points is ignored
+   if (tAbs(dStdCurvature) < TOLERANCE)
+      dCoastProfileSmoothConvexityThreshold = -DBL_MAX;
+
+   if (m_nLogFileDetail >= LOG_FILE_ALL)
+      LogStream << m_ulIter << ": Convexity threshold = " << dCoastProfileSmoothConvexityThreshold << endl;
+
+   // Now create normal profiles on either side of points of maximum smoothed convexity
+   CreateRestOfNormalProfiles(nCoast, nProfile, nProfileToNodeSpacing, dCoastProfileSmoothConvexityThreshold, &bVCoastPointSearched, &prVCurvature);
+
+   // Did we fail to create any normal profiles? If so, quit
+   // if (nProfile < 0)
+   // {
+   //    string strErr = ERR + "timestep " + strDblToStr(m_ulIter) + ": could not create profiles for coastline " + strDblToStr(nCoast);
+   //    if (m_ulIter == 1)
+   //       strErr += ". Check the SWL";
+   //    strErr += "\n";
+
+   //    cerr << strErr;
+   //    LogStream << strErr;
+
+   //    return RTN_ERR_NO_PROFILES_1;
+   // }
+}
+
 //===============================================================================================================================
 //! Create profiles normal to the coastline, modifies these if they intersect, then puts the profiles onto the raster grid
 //===============================================================================================================================
@@ -276,6 +304,7 @@ void CSimulation::CreateInterventionProfiles(int const nCoast, int &nProfile /*,
       {
          // We have not already searched this coast point, so try putting an intervention cape profile here
          int nRet = nCreateProfile(nCoast, nThisCapePoint, nProfile);
+         m_VCoastHistory[nCoast].AppendProfileAttempt(nThisCapePoint, nRet == RTN_OK);
          // bVCoastPointSearched[nThisCapePoint] = true;
 
          if (nRet != RTN_OK)
@@ -333,6 +362,7 @@ void CSimulation::CreateNaturalCapeNormalProfiles(int const nCoast, int &nProfil
       {
          // We have not already searched this coast point, so try putting a natural cape profile here
          int nRet = nCreateProfile(nCoast, nThisCapePoint, nProfile);
+         m_VCoastHistory[nCoast].AppendProfileAttempt(nThisCapePoint, nRet == RTN_OK);
          bVCoastPointSearched->at(nThisCapePoint) = true;
 
          if (nRet != RTN_OK)
@@ -392,6 +422,7 @@ void CSimulation::CreateRestOfNormalProfiles(int const nCoast, int &nProfile, in
          // Calculate the profile spacing, this will vary if we have a random factor but will be the same in both up-coast and down-coast directions
          //             nProfileDist = tMax(m_nCoastNormalAvgSpacing, static_cast<int>(nProfileToNodeSpacing * (1 + (dGetRand0Gaussian() * m_dCoastNormalRandSpacingFactor))));
          int nProfileDist = nProfileToNodeSpacing * (1 + static_cast<int>(abs(dGetRand0Gaussian() * m_dCoastNormalRandSpacingFactor)));
+         m_VCoastHistory[nCoast].AddProfileRandomDraw();
 
          // TODO 014 Assume that the above is the profile spacing on straight bits of coast. Try gradually increasing the profile spacing with increasing concavity, and decreasing the profile spacing with increasing convexity. Could use a Michaelis-Menten S-curve relationship
          //          double fReN = pow(NowCell[nX][nY].dGetReynolds(m_dNu), m_dDepN);
@@ -499,6 +530,7 @@ void CSimulation::CreateRestOfNormalProfiles(int const nCoast, int &nProfile, in
 
                // OK, try to create a profile here
                int nRet = nCreateProfile(nCoast, nThisPoint, nProfile);
+               m_VCoastHistory[nCoast].AppendProfileAttempt(nThisPoint, nRet == RTN_OK);
                if (nRet == RTN_OK)
                {
                   // Profile created OK
@@ -528,6 +560,34 @@ void CSimulation::CreateRestOfNormalProfiles(int const nCoast, int &nProfile, in
    }
 }
 
+//===============================================================================================================================
+//! Tries to place coastline-normal profiles on an unchanged coastline at the same coast points as last timestep, by repeating last timestep's attempts to create a profile. Returns false, having removed any profiles which it created, if any attempt turns out differently from last timestep. Otherwise draws as many random numbers as were drawn last timestep, so that later random numbers are the same as if the profiles had been placed from scratch, and returns true
+//===============================================================================================================================
+bool CSimulation::bReplayProfilePlacement(int const nCoast, int& nProfile)
+{
+   CCoastHistory* pHistory = &m_VCoastHistory[nCoast];
+
+   for (int n = 0; n < pHistory->nGetNumProfileAttempts(); n++)
+   {
+      int nRet = nCreateProfile(nCoast, pHistory->nGetProfileAttemptPoint(n), nProfile);
+      if ((nRet == RTN_OK) != pHistory->bGetProfileAttemptOK(n))
+      {
+         if (m_nLogFileDetail >= LOG_FILE_ALL)
+            LogStream << m_ulIter << ": Coast " << nCoast << " unchanged, but attempt to create a profile at coast point " << pHistory->nGetProfileAttemptPoint(n) << " turned out differently from last timestep, so placing profiles from scratch" << endl;
+
+         m_VCoast[nCoast].RemoveAllProfiles();
+         nProfile = -1;
+
+         return false;
+      }
+   }
+
+   for (int n = 0; n < pHistory->nGetProfileRandomDraws(); n++)
+      dGetRand0Gaussian();
+
+   return true;
+}
+
 //===============================================================================================================================
 //! Creates a single coastline-normal profile (which may be an intervention profile or a cape profile)
 //===============================================================================================================================
@@ -6,6 +6,12 @@ make TO_BUILD=STATICLIB BUILD_VERSION=RELEASE INPUT_AND_OUTPUT=ARGINOUT
 make TO_BUILD=SHAREDLIB BUILD_VERSION=DEBUG INPUT_AND_OUTPUT=ARGINOUT
 make TO_BUILD=SHAREDLIB BUILD_VERSION=RELEASE INPUT_AND_OUTPUT=ARGINOUT
 
+# Do ARGINOUTREENTRANT versions
+make TO_BUILD=STATICLIB BUILD_VERSION=DEBUG INPUT_AND_OUTPUT=ARGINOUTREENTRANT
+make TO_BUILD=STATICLIB BUILD_VERSION=RELEASE INPUT_AND_OUTPUT=ARGINOUTREENTRANT
+make TO_BUILD=SHAREDLIB BUILD_VERSION=DEBUG INPUT_AND_OUTPUT=ARGINOUTREENTRANT
+make TO_BUILD=SHAREDLIB BUILD_VERSION=RELEASE INPUT_AND_OUTPUT=ARGINOUTREENTRANT
+
 # Do ARGINBOTHOUT versions
 make TO_BUILD=STATICLIB BUILD_VERSION=DEBUG INPUT_AND_OUTPUT=ARGINBOTHOUT
 make TO_BUILD=STATICLIB BUILD_VERSION=RELEASE INPUT_AND_OUTPUT=ARGINBOTHOUT
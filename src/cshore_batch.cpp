@@ -0,0 +1,210 @@
+/*!
+ *
+ * \file cshore_batch.cpp
+ * \brief CCShoreBatch routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <algorithm>
+using std::copy;
+using std::fill;
+
+#include "cme.h"
+#include "inc/cshore.h"
+#include "cshore_batch.h"
+
+//! Constructor
+CCShoreBatch::CCShoreBatch(void)
+: m_nArrayOutSize(0),
+  m_dGamma(0)
+{
+}
+
+//! Destructor
+CCShoreBatch::~CCShoreBatch(void)
+{
+}
+
+//! Sets the number of values which CShore outputs for each profile, in each output array
+void CCShoreBatch::SetArrayOutSize(int const nSize)
+{
+   m_nArrayOutSize = nSize;
+}
+
+//! Removes all profiles from the batch. The memory used by the batch is kept, so that it can be reused for the next batch
+void CCShoreBatch::Clear(void)
+{
+   fill(m_VnLine.begin(), m_VnLine.end(), INT_NODATA);
+
+   m_VdDX.clear();
+   m_VdTPIn.clear();
+   m_VdHrmsIn.clear();
+   m_VdWangIn.clear();
+   m_VnNBInp.clear();
+   m_VnFirstInp.clear();
+   m_VdXBInp.clear();
+   m_VdZBInp.clear();
+   m_VdFBInp.clear();
+}
+
+//! Adds a profile's CShore input values to the batch. The arguments after the profile number are the input arguments of CShoreWrapper() for this profile, except In_ILINE which is always one
+void CCShoreBatch::AddProfile(int const nProfile, int const* pnIProfl, int const* pnIPerm, int const* pnIOver, int const* pnIWCInt, int const* pnIRoll, int const* pnIWind, int const* pnITide, int const* pnILab, int const* pnNWave, int const* pnNSurge, double const* pdDX, double const* pdGamma, double const dTWave[], double const dTPIn[], double const dHrmsIn[], double const dWangIn[], double const dTSurg[], double const dSWLIn[], int const* pnNBInp, double const dXBInp[], double const dZBInp[], double const dFBInp[])
+{
+   int nWaveSize = *pnNWave + 1;
+
+   if (m_VdDX.empty())
+   {
+      // This is the first profile, so store the input values which are the same for every profile
+      int const nOptions[] = {*pnIProfl, *pnIPerm, *pnIOver, *pnIWCInt, *pnIRoll, *pnIWind, *pnITide, *pnILab, *pnNWave, *pnNSurge};
+      m_VnOptions.assign(nOptions, nOptions + sizeof(nOptions) / sizeof(nOptions[0]));
+
+      m_dGamma = *pdGamma;
+      m_VdTWave.assign(dTWave, dTWave + nWaveSize);
+      m_VdTSurg.assign(dTSurg, dTSurg + nWaveSize);
+      m_VdSWLIn.assign(dSWLIn, dSWLIn + nWaveSize);
+   }
+
+   if (nProfile >= static_cast<int>(m_VnLine.size()))
+      m_VnLine.resize(nProfile + 1, INT_NODATA);
+
+   m_VnLine[nProfile] = static_cast<int>(m_VdDX.size());
+
+   m_VdDX.push_back(*pdDX);
+   m_VdTPIn.insert(m_VdTPIn.end(), dTPIn, dTPIn + nWaveSize);
+   m_VdHrmsIn.insert(m_VdHrmsIn.end(), dHrmsIn, dHrmsIn + nWaveSize);
+   m_VdWangIn.insert(m_VdWangIn.end(), dWangIn, dWangIn + nWaveSize);
+
+   m_VnNBInp.push_back(*pnNBInp);
+   m_VnFirstInp.push_back(static_cast<int>(m_VdXBInp.size()));
+   m_VdXBInp.insert(m_VdXBInp.end(), dXBInp, dXBInp + *pnNBInp);
+   m_VdZBInp.insert(m_VdZBInp.end(), dZBInp, dZBInp + *pnNBInp);
+   m_VdFBInp.insert(m_VdFBInp.end(), dFBInp, dFBInp + *pnNBInp);
+}
+
+//! Returns the number of profiles in the batch
+int CCShoreBatch::nGetNumProfiles(void) const
+{
+   return static_cast<int>(m_VdDX.size());
+}
+
+//! Returns true if a profile is in the batch
+bool CCShoreBatch::bHasProfile(int const nProfile) const
+{
+   return ((nProfile < static_cast<int>(m_VnLine.size())) && (m_VnLine[nProfile] != INT_NODATA));
+}
+
+//! Runs CShore for every profile in the batch, with a single call to CShoreWrapperLines()
+void CCShoreBatch::Run(void)
+{
+   int nLines = nGetNumProfiles();
+   if (nLines == 0)
+      return;
+
+   // CShoreWrapperLines() takes the bottom geometry as one column per line, so every line is given as many values as the line with most input points. The unused values at the end of shorter lines are not read by CShore
+   int nNBInpMax = 0;
+   for (int nLine = 0; nLine < nLines; nLine++)
+      nNBInpMax = tMax(nNBInpMax, m_VnNBInp[nLine]);
+
+   m_VdXBInpPacked.assign(nNBInpMax * nLines, 0);
+   m_VdZBInpPacked.assign(nNBInpMax * nLines, 0);
+   m_VdFBInpPacked.assign(nNBInpMax * nLines, 0);
+   for (int nLine = 0; nLine < nLines; nLine++)
+   {
+      int
+          nFirst = m_VnFirstInp[nLine],
+          nLast = nFirst + m_VnNBInp[nLine];
+
+      copy(m_VdXBInp.begin() + nFirst, m_VdXBInp.begin() + nLast, m_VdXBInpPacked.begin() + nLine * nNBInpMax);
+      copy(m_VdZBInp.begin() + nFirst, m_VdZBInp.begin() + nLast, m_VdZBInpPacked.begin() + nLine * nNBInpMax);
+      copy(m_VdFBInp.begin() + nFirst, m_VdFBInp.begin() + nLast, m_VdFBInpPacked.begin() + nLine * nNBInpMax);
+   }
+
+   // Start with zeroed output values, as CoastalME does when it runs CShore for a single profile. Set the error flag: this will be changed within CShore if there is a problem
+   m_VnError.assign(nLines, 0);
+   m_VnOutSize.assign(nLines, 0);
+   m_VdXYDist.assign(m_nArrayOutSize * nLines, 0);
+   m_VdFreeSurfaceStd.assign(m_nArrayOutSize * nLines, 0);
+   m_VdWaveSetupSurge.assign(m_nArrayOutSize * nLines, 0);
+   m_VdSinWaveAngleRadians.assign(m_nArrayOutSize * nLines, 0);
+   m_VdFractionBreakingWaves.assign(m_nArrayOutSize * nLines, 0);
+
+   // CShoreWrapperLines() is only in the CShore library if it was built for argument passing
+#if defined CSHORE_ARG_INOUT || CSHORE_BOTH
+   CShoreWrapperLines(&nLines,                        /* In_ILINE */
+                      &m_VnOptions[0],                /* In_IPROFL */
+                      &m_VnOptions[1],                /* In_IPERM */
+                      &m_VnOptions[2],                /* In_IOVER */
+                      &m_VnOptions[3],                /* In_IWCINT */
+                      &m_VnOptions[4],                /* In_IROLL */
+                      &m_VnOptions[5],                /* In_IWIND */
+                      &m_VnOptions[6],                /* In_ITIDE */
+                      &m_VnOptions[7],                /* In_ILAB */
+                      &m_VnOptions[8],                /* In_NWAVE */
+                      &m_VnOptions[9],                /* In_NSURG */
+                      &m_VdDX[0],                     /* In_DX */
+                      &m_dGamma,                      /* In_GAMMA */
+                      &m_VdTWave[0],                  /* In_TWAVE */
+                      &m_VdTPIn[0],                   /* In_TPIN */
+                      &m_VdHrmsIn[0],                 /* In_HRMSIN */
+                      &m_VdWangIn[0],                 /* In_WANGIN */
+                      &m_VdTSurg[0],                  /* In_TSURG */
+                      &m_VdSWLIn[0],                  /* In_SWLIN */
+                      &nNBInpMax,                     /* In_NBINPMAX */
+                      &m_VnNBInp[0],                  /* In_NBINP */
+                      &m_VdXBInpPacked[0],            /* In_XBINP */
+                      &m_VdZBInpPacked[0],            /* In_ZBINP */
+                      &m_VdFBInpPacked[0],            /* In_FBINP */
+                      &m_VnError[0],                  /* Out_IError */
+                      &m_VnOutSize[0],                /* Out_nOutSize */
+                      &m_VdXYDist[0],                 /* Out_XYDist */
+                      &m_VdFreeSurfaceStd[0],         /* Out_FreeSurfaceStd */
+                      &m_VdWaveSetupSurge[0],         /* Out_WaveSetupSurge */
+                      &m_VdSinWaveAngleRadians[0],    /* Out_SinWaveAngleRadians */
+                      &m_VdFractionBreakingWaves[0]); /* Out_FractionBreakingWaves */
+#endif
+}
+
+//! Copies the along-profile distances of a profile in the batch, i.e. its In_XBINP input values
+void CCShoreBatch::GetProfileDistXY(int const nProfile, vector<double>* pVdXBInp) const
+{
+   int
+       nFirst = m_VnFirstInp[m_VnLine[nProfile]],
+       nLast = nFirst + m_VnNBInp[m_VnLine[nProfile]];
+
+   pVdXBInp->assign(m_VdXBInp.begin() + nFirst, m_VdXBInp.begin() + nLast);
+}
+
+//! Copies the CShore output values for a profile in the batch, after Run() has been called. The arguments after the profile number are the output arguments of CShoreWrapper() for this profile
+void CCShoreBatch::GetProfileResults(int const nProfile, int* pnError, int* pnOutSize, double dXYDist[], double dFreeSurfaceStd[], double dWaveSetupSurge[], double dSinWaveAngleRadians[], double dFractionBreakingWaves[]) const
+{
+   int
+       nLine = m_VnLine[nProfile],
+       nFirst = nLine * m_nArrayOutSize,
+       nLast = nFirst + m_nArrayOutSize;
+
+   *pnError = m_VnError[nLine];
+   *pnOutSize = m_VnOutSize[nLine];
+
+   copy(m_VdXYDist.begin() + nFirst, m_VdXYDist.begin() + nLast, dXYDist);
+   copy(m_VdFreeSurfaceStd.begin() + nFirst, m_VdFreeSurfaceStd.begin() + nLast, dFreeSurfaceStd);
+   copy(m_VdWaveSetupSurge.begin() + nFirst, m_VdWaveSetupSurge.begin() + nLast, dWaveSetupSurge);
+   copy(m_VdSinWaveAngleRadians.begin() + nFirst, m_VdSinWaveAngleRadians.begin() + nLast, dSinWaveAngleRadians);
+   copy(m_VdFractionBreakingWaves.begin() + nFirst, m_VdFractionBreakingWaves.begin() + nLast, dFractionBreakingWaves);
+}
@@ -0,0 +1,130 @@
+/*!
+ *
+ * \class CCShoreBatch
+ * \brief Class used to run CShore for all the profiles on a coast in a single call
+ * \details Each time that CShore is run via CShoreWrapper() it has to be set up afresh, so when the profiles on a coast are calculated one at a time this is done once for every profile. Instead, the CShore input values for each profile may be added to a batch, then CShore is run for every profile in the batch by a single call to CShoreWrapperLines(), and the output values for each profile are then fetched from the batch. The batch keeps each profile's input values, so that the profile's along-profile distances (onto which its output values are interpolated) can also be fetched from the batch. Some of the CShore input values (the computational options, the breaking wave height-depth ratio, and the wave and surge times) are the same for every profile: these are taken from the first profile which is added. The output values for each profile are the same as those from running CShoreWrapper() for that profile
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file cshore_batch.h
+ * \brief Contains CCShoreBatch definitions
+ *
+ */
+
+#ifndef CSHORE_BATCH_H
+#define CSHORE_BATCH_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <vector>
+using std::vector;
+
+class CCShoreBatch
+{
+private:
+   //! The number of values which CShore outputs for each profile, in each output array
+   int m_nArrayOutSize;
+
+   //! The computational options In_IPROFL to In_NSURG, which are the same for every profile in the batch
+   vector<int> m_VnOptions;
+
+   //! The breaking wave height-depth ratio, which is the same for every profile in the batch
+   double m_dGamma;
+
+   //! The wave times, which are the same for every profile in the batch
+   vector<double> m_VdTWave;
+
+   //! The surge times, which are the same for every profile in the batch
+   vector<double> m_VdTSurg;
+
+   //! The surge levels, which are the same for every profile in the batch
+   vector<double> m_VdSWLIn;
+
+   //! Indexed by profile: the profile's line in the batch, or INT_NODATA if the profile is not in the batch
+   vector<int> m_VnLine;
+
+   //! Indexed by line: the profile's nodal spacing
+   vector<double> m_VdDX;
+
+   //! The wave periods for every line, one line after the other
+   vector<double> m_VdTPIn;
+
+   //! The wave heights for every line, one line after the other
+   vector<double> m_VdHrmsIn;
+
+   //! The wave angles for every line, one line after the other
+   vector<double> m_VdWangIn;
+
+   //! Indexed by line: the number of input points of bottom elevation
+   vector<int> m_VnNBInp;
+
+   //! Indexed by line: the position of the line's first input point in m_VdXBInp, m_VdZBInp and m_VdFBInp
+   vector<int> m_VnFirstInp;
+
+   //! The along-profile distance of each input point, for every line one line after the other
+   vector<double> m_VdXBInp;
+
+   //! The elevation of each input point, in the same way
+   vector<double> m_VdZBInp;
+
+   //! The friction factor of each input point, in the same way
+   vector<double> m_VdFBInp;
+
+   //! The along-profile distances of every line, packed for CShoreWrapperLines() so that each line has as many values as the line with most input points
+   vector<double> m_VdXBInpPacked;
+
+   //! The elevations of every line, packed in the same way
+   vector<double> m_VdZBInpPacked;
+
+   //! The friction factors of every line, packed in the same way
+   vector<double> m_VdFBInpPacked;
+
+   //! Indexed by line: CShore's error code
+   vector<int> m_VnError;
+
+   //! Indexed by line: the number of valid output values
+   vector<int> m_VnOutSize;
+
+   //! The output along-profile distances for every line, m_nArrayOutSize values per line
+   vector<double> m_VdXYDist;
+
+   //! The output free surface standard deviations for every line, in the same way
+   vector<double> m_VdFreeSurfaceStd;
+
+   //! The output wave setup plus surge for every line, in the same way
+   vector<double> m_VdWaveSetupSurge;
+
+   //! The output sines of wave angle for every line, in the same way
+   vector<double> m_VdSinWaveAngleRadians;
+
+   //! The output fractions of breaking waves for every line, in the same way
+   vector<double> m_VdFractionBreakingWaves;
+
+   CCShoreBatch(CCShoreBatch const&);
+   CCShoreBatch& operator=(CCShoreBatch const&);
+
+public:
+   CCShoreBatch(void);
+   ~CCShoreBatch(void);
+
+   void SetArrayOutSize(int const);
+   void Clear(void);
+   void AddProfile(int const, int const*, int const*, int const*, int const*, int const*, int const*, int const*, int const*, int const*, int const*, double const*, double const*, double const[], double const[], double const[], double const[], double const[], double const[], int const*, double const[], double const[], double const[]);
+   int nGetNumProfiles(void) const;
+   bool bHasProfile(int const) const;
+   void Run(void);
+   void GetProfileDistXY(int const, vector<double>*) const;
+   void GetProfileResults(int const, int*, int*, double[], double[], double[], double[], double[]) const;
+};
+#endif // CSHORE_BATCH_H
@@ -0,0 +1,283 @@
+/*!
+ *
+ * \file cshore_pool.cpp
+ * \brief CCShorePool routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include "cme.h"
+#include "inc/cshore.h"
+#include "cshore_pool.h"
+
+// The number of integer values, and of scalar double values, at the start of each request which is sent to a worker. The integer values are In_ILINE to In_NSURG, then In_NBINP, then the starting values of Out_IError and Out_nOutSize; the double values are In_DX and In_GAMMA
+int const CSHORE_POOL_NUM_INT_IN = 14;
+int const CSHORE_POOL_NUM_DOUBLE_IN = 2;
+
+//! Constructor
+CCShorePool::CCShorePool(void)
+: m_nArrayOutSize(0),
+  m_bFailed(false),
+  m_bInThisProcess(false)
+{
+}
+
+//! Destructor, closes the sockets so that the workers finish, then waits for them
+CCShorePool::~CCShorePool(void)
+{
+#ifndef _WIN32
+   for (unsigned int n = 0; n < m_VnSocket.size(); n++)
+      close(m_VnSocket[n]);
+
+   for (unsigned int n = 0; n < m_VnPID.size(); n++)
+      waitpid(m_VnPID[n], NULL, 0);
+#endif
+}
+
+//! Sets the number of values which CShore outputs for each profile, in each output array. This must be called before the workers are started
+void CCShorePool::SetArrayOutSize(int const nSize)
+{
+   m_nArrayOutSize = nSize;
+}
+
+//! Starts nWorkers worker processes. This must be called before any other threads are started, since only the calling thread is copied into each worker. Returns false if a worker could not be started
+bool CCShorePool::bStart(int const nWorkers)
+{
+#ifndef _WIN32
+   for (int n = 0; n < nWorkers; n++)
+   {
+      int nSockets[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, nSockets) != 0)
+         return false;
+
+      int nPID = fork();
+      if (nPID < 0)
+      {
+         close(nSockets[0]);
+         close(nSockets[1]);
+         return false;
+      }
+
+      if (nPID == 0)
+      {
+         // This is the worker. Close the sockets which connect the other workers to CoastalME, otherwise they would not see the end of their input when CoastalME finishes
+         for (unsigned int m = 0; m < m_VnSocket.size(); m++)
+            close(m_VnSocket[m]);
+         close(nSockets[0]);
+
+         WorkerLoop(nSockets[1], m_nArrayOutSize);
+
+         // Finish without flushing any of CoastalME's output streams, which the worker has inherited
+         _exit(0);
+      }
+
+      close(nSockets[1]);
+
+      m_VnPID.push_back(nPID);
+      m_VnSocket.push_back(nSockets[0]);
+      m_VnIdle.push_back(n);
+   }
+#else
+   // Cannot fork on Windows, so CShore is always run in this process
+   (void) nWorkers;
+#endif
+
+   return true;
+}
+
+//! Returns the number of worker processes, this is zero if CShore is run in this process
+int CCShorePool::nGetNumWorkers(void) const
+{
+   return static_cast<int>(m_VnPID.size());
+}
+
+//! Sets whether CShoreWrapper() is run in this process even if workers have been started. Only one thread may then run CShore
+void CCShorePool::SetRunInThisProcess(bool const bInThisProcess)
+{
+   m_bInThisProcess = bInThisProcess;
+}
+
+//! Sends nBytes bytes to a socket, returns false if this fails
+bool CCShorePool::bSend(int const nSocket, void const* pData, size_t const nBytes)
+{
+#ifndef _WIN32
+   char const* pcData = static_cast<char const*>(pData);
+   size_t nDone = 0;
+   while (nDone < nBytes)
+   {
+      ssize_t nThis = send(nSocket, pcData + nDone, nBytes - nDone, MSG_NOSIGNAL);
+      if (nThis < 0)
+      {
+         if (errno == EINTR)
+            continue;
+
+         return false;
+      }
+
+      nDone += nThis;
+   }
+
+   return true;
+#else
+   (void) nSocket;
+   (void) pData;
+   (void) nBytes;
+   return false;
+#endif
+}
+
+//! Receives nBytes bytes from a socket, returns false if this fails or if the other end has been closed
+bool CCShorePool::bReceive(int const nSocket, void* pData, size_t const nBytes)
+{
+#ifndef _WIN32
+   char* pcData = static_cast<char*>(pData);
+   size_t nDone = 0;
+   while (nDone < nBytes)
+   {
+      ssize_t nThis = recv(nSocket, pcData + nDone, nBytes - nDone, 0);
+      if (nThis < 0)
+      {
+         if (errno == EINTR)
+            continue;
+
+         return false;
+      }
+
+      if (nThis == 0)
+         return false;
+
+      nDone += nThis;
+   }
+
+   return true;
+#else
+   (void) nSocket;
+   (void) pData;
+   (void) nBytes;
+   return false;
+#endif
+}
+
+//! Run by each worker process: receives the input values for a profile, runs CShore, and sends back the output values, until the socket is closed. CShore outputs nArrayOutSize values in each output array
+void CCShorePool::WorkerLoop(int const nSocket, int const nArrayOutSize)
+{
+   int nIn[CSHORE_POOL_NUM_INT_IN];
+   double dIn[CSHORE_POOL_NUM_DOUBLE_IN];
+
+   // The wave and surge time series, the bottom geometry, and the output arrays. These keep their memory from one profile to the next
+   vector<double> VdWave, VdBottom, VdOut;
+
+   while (bReceive(nSocket, nIn, sizeof(nIn)) && bReceive(nSocket, dIn, sizeof(dIn)))
+   {
+      int
+          nWaveSize = nIn[9] + 1,
+          nBottomSize = nIn[11] * nIn[0],
+          nError = nIn[12],
+          nOutSize = nIn[13];
+
+      VdWave.resize(6 * nWaveSize);
+      VdBottom.resize(3 * nBottomSize);
+      if ((! bReceive(nSocket, &VdWave[0], VdWave.size() * sizeof(double))) || (! bReceive(nSocket, &VdBottom[0], VdBottom.size() * sizeof(double))))
+         return;
+
+      // Start with zeroed output arrays, as CoastalME does when it runs CShore itself
+      VdOut.assign(5 * nArrayOutSize, 0);
+
+#if defined CSHORE_ARG_INOUT || CSHORE_BOTH
+      CShoreWrapper(&nIn[0], &nIn[1], &nIn[2], &nIn[3], &nIn[4], &nIn[5], &nIn[6], &nIn[7], &nIn[8], &nIn[9], &nIn[10], &dIn[0], &dIn[1], &VdWave[0], &VdWave[nWaveSize], &VdWave[2 * nWaveSize], &VdWave[3 * nWaveSize], &VdWave[4 * nWaveSize], &VdWave[5 * nWaveSize], &nIn[11], &VdBottom[0], &VdBottom[nBottomSize], &VdBottom[2 * nBottomSize], &nError, &nOutSize, &VdOut[0], &VdOut[nArrayOutSize], &VdOut[2 * nArrayOutSize], &VdOut[3 * nArrayOutSize], &VdOut[4 * nArrayOutSize]);
+#endif
+
+      int nOut[2] = {nError, nOutSize};
+      if ((! bSend(nSocket, nOut, sizeof(nOut))) || (! bSend(nSocket, &VdOut[0], VdOut.size() * sizeof(double))))
+         return;
+   }
+}
+
+//! Runs CShore for a profile, the arguments are the same as those of CShoreWrapper(). If there are workers, this waits for an idle worker and has it run CShore, otherwise CShore is run in this process. Returns false if this or any other worker failed
+bool CCShorePool::bRunCShore(int const* pnILine, int const* pnIProfl, int const* pnIPerm, int const* pnIOver, int const* pnIWCInt, int const* pnIRoll, int const* pnIWind, int const* pnITide, int const* pnILab, int const* pnNWave, int const* pnNSurge, double const* pdDX, double const* pdGamma, double dTWave[], double dTPIn[], double dHrmsIn[], double dWangIn[], double dTSurg[], double dSWLIn[], int const* pnNBInp, double dXBInp[], double dZBInp[], double dFBInp[], int* pnError, int* pnOutSize, double dXYDist[], double dFreeSurfaceStd[], double dWaveSetupSurge[], double dSinWaveAngleRadians[], double dFractionBreakingWaves[])
+{
+   if (m_VnPID.empty() || m_bInThisProcess)
+   {
+      // CShoreWrapper() is only in the CShore library if it was built for argument passing
+#if defined CSHORE_ARG_INOUT || CSHORE_BOTH
+      CShoreWrapper(pnILine, pnIProfl, pnIPerm, pnIOver, pnIWCInt, pnIRoll, pnIWind, pnITide, pnILab, pnNWave, pnNSurge, pdDX, pdGamma, dTWave, dTPIn, dHrmsIn, dWangIn, dTSurg, dSWLIn, pnNBInp, dXBInp, dZBInp, dFBInp, pnError, pnOutSize, dXYDist, dFreeSurfaceStd, dWaveSetupSurge, dSinWaveAngleRadians, dFractionBreakingWaves);
+#endif
+
+      return true;
+   }
+
+   // Take an idle worker
+   int nWorker;
+   {
+      unique_lock<mutex> Lock(m_Mutex);
+      while (m_VnIdle.empty() && (! m_bFailed))
+         m_Condition.wait(Lock);
+
+      // If a worker has failed, the simulation will end, so don't start another
+      if (m_bFailed)
+         return false;
+
+      nWorker = m_VnIdle.back();
+      m_VnIdle.pop_back();
+   }
+
+   int nSocket = m_VnSocket[nWorker];
+   int nIn[CSHORE_POOL_NUM_INT_IN] = {*pnILine, *pnIProfl, *pnIPerm, *pnIOver, *pnIWCInt, *pnIRoll, *pnIWind, *pnITide, *pnILab, *pnNWave, *pnNSurge, *pnNBInp, *pnError, *pnOutSize};
+   double dIn[CSHORE_POOL_NUM_DOUBLE_IN] = {*pdDX, *pdGamma};
+   size_t
+       nWaveBytes = (*pnNWave + 1) * sizeof(double),
+       nBottomBytes = (*pnNBInp) * (*pnILine) * sizeof(double),
+       nOutBytes = m_nArrayOutSize * sizeof(double);
+
+   bool bOK = bSend(nSocket, nIn, sizeof(nIn)) && bSend(nSocket, dIn, sizeof(dIn)) &&
+              bSend(nSocket, dTWave, nWaveBytes) && bSend(nSocket, dTPIn, nWaveBytes) && bSend(nSocket, dHrmsIn, nWaveBytes) && bSend(nSocket, dWangIn, nWaveBytes) && bSend(nSocket, dTSurg, nWaveBytes) && bSend(nSocket, dSWLIn, nWaveBytes) &&
+              bSend(nSocket, dXBInp, nBottomBytes) && bSend(nSocket, dZBInp, nBottomBytes) && bSend(nSocket, dFBInp, nBottomBytes);
+
+   int nOut[2];
+   bOK = bOK && bReceive(nSocket, nOut, sizeof(nOut)) &&
+         bReceive(nSocket, dXYDist, nOutBytes) && bReceive(nSocket, dFreeSurfaceStd, nOutBytes) && bReceive(nSocket, dWaveSetupSurge, nOutBytes) && bReceive(nSocket, dSinWaveAngleRadians, nOutBytes) && bReceive(nSocket, dFractionBreakingWaves, nOutBytes);
+
+   if (bOK)
+   {
+      *pnError = nOut[0];
+      *pnOutSize = nOut[1];
+
+      // Give the worker back to the pool
+      unique_lock<mutex> Lock(m_Mutex);
+      m_VnIdle.push_back(nWorker);
+      m_Condition.notify_one();
+   }
+   else
+   {
+      // A worker which has failed is not given back, since the simulation will end. Wake all waiting threads, so that they give up too
+      unique_lock<mutex> Lock(m_Mutex);
+      m_bFailed = true;
+      m_Condition.notify_all();
+   }
+
+   return bOK;
+}
@@ -0,0 +1,87 @@
+/*!
+ *
+ * \class CCShorePool
+ * \brief Class used to run CShore for several profiles at the same time, using a pool of CShore worker processes
+ * \details CShore keeps its state in Fortran module variables, so CShoreWrapper() may only be running once in any process. To run CShore for several profiles at once, a number of worker processes are forked when the simulation starts, each of which is a copy of CoastalME that waits for the input values for a profile, runs CShoreWrapper() on them, then sends back the output values. Each worker is connected to CoastalME by a Unix domain socket. A thread which wants CShore to be run takes an idle worker, sends it the profile and waits for the results, then returns the worker to the pool, so there should be as many workers as threads. Since CShoreWrapper() sets up all its state at the start of each call, the results do not depend on which worker is used. If no workers have been started (e.g. if only one thread is used, or on Windows) then CShoreWrapper() is run in this process, this may also be asked for so that the workers' results can be checked
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file cshore_pool.h
+ * \brief Contains CCShorePool definitions
+ *
+ */
+
+#ifndef CSHORE_POOL_H
+#define CSHORE_POOL_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <stddef.h>
+
+#include <condition_variable>
+using std::condition_variable;
+
+#include <mutex>
+using std::mutex;
+using std::unique_lock;
+
+#include <vector>
+using std::vector;
+
+class CCShorePool
+{
+private:
+   //! The number of values which CShore outputs for each profile, in each output array
+   int m_nArrayOutSize;
+
+   //! Indexed by worker: the process ID
+   vector<int> m_VnPID;
+
+   //! Indexed by worker: this process's end of the socket which connects it to the worker
+   vector<int> m_VnSocket;
+
+   //! The workers which are not running CShore now
+   vector<int> m_VnIdle;
+
+   //! Protects m_VnIdle and m_bFailed
+   mutex m_Mutex;
+
+   //! Used to wake a thread which is waiting for a worker to become idle, or for a worker to fail
+   condition_variable m_Condition;
+
+   //! Set if a worker has failed, so that threads waiting for an idle worker give up rather than waiting for a worker which will never be given back
+   bool m_bFailed;
+
+   //! If true, CShoreWrapper() is run in this process even if workers have been started
+   bool m_bInThisProcess;
+
+   CCShorePool(CCShorePool const&);
+   CCShorePool& operator=(CCShorePool const&);
+
+   static bool bSend(int const, void const*, size_t const);
+   static bool bReceive(int const, void*, size_t const);
+   static void WorkerLoop(int const, int const);
+
+public:
+   CCShorePool(void);
+   ~CCShorePool(void);
+
+   void SetArrayOutSize(int const);
+   bool bStart(int const);
+   int nGetNumWorkers(void) const;
+   void SetRunInThisProcess(bool const);
+
+   bool bRunCShore(int const*, int const*, int const*, int const*, int const*, int const*, int const*, int const*, int const*, int const*, int const*, double const*, double const*, double[], double[], double[], double[], double[], double[], int const*, double[], double[], double[], int*, int*, double[], double[], double[], double[], double[]);
+};
+#endif // CSHORE_POOL_H
@@ -0,0 +1,202 @@
+/*!
+ *
+ * \file cshore_workspace.cpp
+ * \brief CCShoreWorkspace routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#ifdef _WIN32
+#include <direct.h>        // For _mkdir() and _rmdir()
+#include <process.h>       // For _getpid()
+#else
+#include <sys/stat.h>      // For mkdir() and stat()
+#include <unistd.h>        // For getpid(), access() and rmdir()
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+using std::getenv;
+
+#include <algorithm>
+using std::fill;
+
+#include <fstream>
+using std::ifstream;
+using std::ofstream;
+using std::ios;
+
+#include <string>
+using std::to_string;
+
+#include "cme.h"
+#include "cshore_workspace.h"
+
+//! The files which CShore writes when its output is via files, in the order in which CShore opens them
+static char const* const CSHORE_OUTFILES[] = {"ODOC", "OBPROF", "OSETUP", "OPARAM", "OXMOME", "OYMOME", "OENERG", "OXVELO", "OYVELO", "OROLLE", "OBSUSL", "OPORUS", "OCROSS", "OLONGS", "OSWASH", "OSWASE", "OTIMSE", "OCRVOL", "OLOVOL", "OMESSG"};
+
+//! The number of files which CShore writes when its output is via files
+static int const CSHORE_NUM_OUTFILES = sizeof(CSHORE_OUTFILES) / sizeof(CSHORE_OUTFILES[0]);
+
+//! Constructor
+CCShoreWorkspace::CCShoreWorkspace(void)
+{
+}
+
+//! Destructor
+CCShoreWorkspace::~CCShoreWorkspace(void)
+{
+}
+
+//! Sets the number of values which CShore outputs for each profile, and makes room for these in the CShore output vectors
+void CCShoreWorkspace::SetArrayOutSize(int const nSize)
+{
+   m_VdXYDistOut.assign(nSize, 0);
+   m_VdFreeSurfaceStdOut.assign(nSize, 0);
+   m_VdWaveSetupSurgeOut.assign(nSize, 0);
+   m_VdSinWaveAngleRadiansOut.assign(nSize, 0);
+   m_VdFractionBreakingWavesOut.assign(nSize, 0);
+}
+
+//! Empties the profile vectors, ready for the next profile. Their memory is kept
+void CCShoreWorkspace::ClearProfile(void)
+{
+   m_VdProfileDistXY.clear();
+   m_VdProfileZ.clear();
+   m_VdProfileFrictionFactor.clear();
+}
+
+//! Sets every value in the CShore output vectors to zero, since CShore only sets the values which it outputs for this profile
+void CCShoreWorkspace::ClearOutput(void)
+{
+   fill(m_VdXYDistOut.begin(), m_VdXYDistOut.end(), 0);
+   fill(m_VdFreeSurfaceStdOut.begin(), m_VdFreeSurfaceStdOut.end(), 0);
+   fill(m_VdWaveSetupSurgeOut.begin(), m_VdWaveSetupSurgeOut.end(), 0);
+   fill(m_VdSinWaveAngleRadiansOut.begin(), m_VdSinWaveAngleRadiansOut.end(), 0);
+   fill(m_VdFractionBreakingWavesOut.begin(), m_VdFractionBreakingWavesOut.end(), 0);
+}
+
+//! Frees the memory of every vector, so that the next profile is run with vectors which are allocated afresh. SetArrayOutSize() must be called again before the next profile
+void CCShoreWorkspace::ReleaseMemory(void)
+{
+   vector<double>().swap(m_VdProfileDistXY);
+   vector<double>().swap(m_VdProfileZ);
+   vector<double>().swap(m_VdProfileFrictionFactor);
+   vector<double>().swap(m_VdXYDistOut);
+   vector<double>().swap(m_VdFreeSurfaceStdOut);
+   vector<double>().swap(m_VdWaveSetupSurgeOut);
+   vector<double>().swap(m_VdSinWaveAngleRadiansOut);
+   vector<double>().swap(m_VdFractionBreakingWavesOut);
+   vector<double>().swap(m_VdXYDistCShore);
+   vector<double>().swap(m_VdFreeSurfaceStd);
+   vector<double>().swap(m_VdWaveSetupSurge);
+   vector<double>().swap(m_VdSinWaveAngleRadians);
+   vector<double>().swap(m_VdFractionBreakingWaves);
+}
+
+//! Creates this thread's scratch directory for the CShore ASCII files. Its name includes the process ID and the thread number, so that it is not shared with another thread or another CoastalME run. It is on a memory-backed file system if there is one, otherwise in the temporary directory. Returns false if the directory could not be created
+bool CCShoreWorkspace::bCreateScratchDir(int const nThread)
+{
+#ifdef _WIN32
+   char const* pcTemp = getenv("TEMP");
+   string strParentDir = (pcTemp == NULL) ? "." : pcTemp;
+   strParentDir += "\\";
+
+   string strDir = strParentDir + CSHORE_SCRATCH_DIR_PREFIX + to_string(_getpid()) + "_" + to_string(nThread);
+   if (_mkdir(strDir.c_str()) != 0)
+      return false;
+
+   m_strScratchDir = strDir + "\\";
+#else
+   // Use /dev/shm if it exists and can be written to, since CShore writes and reads many small files for every profile
+   string strParentDir;
+   struct stat StatBuf;
+   if ((stat("/dev/shm", &StatBuf) == 0) && S_ISDIR(StatBuf.st_mode) && (access("/dev/shm", W_OK) == 0))
+      strParentDir = "/dev/shm";
+   else
+   {
+      char const* pcTemp = getenv("TMPDIR");
+      strParentDir = ((pcTemp == NULL) || (pcTemp[0] == 0)) ? "/tmp" : pcTemp;
+   }
+   strParentDir += SLASH;
+
+   string strDir = strParentDir + CSHORE_SCRATCH_DIR_PREFIX + to_string(getpid()) + "_" + to_string(nThread);
+   if (mkdir(strDir.c_str(), 0700) != 0)
+      return false;
+
+   m_strScratchDir = strDir + SLASH;
+#endif
+
+   return true;
+}
+
+//! Appends each CShore output file in the scratch directory to a whole-run master file in strMasterDir, preceded by strHeader. Returns false if a master file could not be written
+bool CCShoreWorkspace::bSaveScratchFiles(string const& strMasterDir, string const& strHeader) const
+{
+   for (int n = 0; n < CSHORE_NUM_OUTFILES; n++)
+   {
+      ifstream InStream((m_strScratchDir + CSHORE_OUTFILES[n]).c_str(), ios::in | ios::binary);
+      if (! InStream.is_open())
+         continue;
+
+      string strMasterFile = strMasterDir + CSHORE_MASTER_FILE_PREFIX + CSHORE_OUTFILES[n] + ".txt";
+      ofstream OutStream(strMasterFile.c_str(), ios::out | ios::app | ios::binary);
+      if (! OutStream.is_open())
+         return false;
+
+      OutStream << strHeader << "\n\n";
+
+      // Copying an empty file would set the output stream's failbit, so only copy files which have something in them
+      if (InStream.peek() != ifstream::traits_type::eof())
+         OutStream << InStream.rdbuf();
+
+      OutStream << "\n*******************************************************************************\n";
+
+      if (OutStream.fail())
+         return false;
+   }
+
+   return true;
+}
+
+//! Deletes the CShore input file and output files from the scratch directory, so that the next profile does not see them
+void CCShoreWorkspace::CleanScratchDir(void) const
+{
+   std::remove((m_strScratchDir + CSHORE_INFILE).c_str());
+
+   for (int n = 0; n < CSHORE_NUM_OUTFILES; n++)
+      std::remove((m_strScratchDir + CSHORE_OUTFILES[n]).c_str());
+}
+
+//! Deletes the scratch directory and any CShore files which are still in it
+void CCShoreWorkspace::RemoveScratchDir(void)
+{
+   if (m_strScratchDir.empty())
+      return;
+
+   CleanScratchDir();
+
+#ifdef _WIN32
+   _rmdir(m_strScratchDir.c_str());
+#else
+   rmdir(m_strScratchDir.c_str());
+#endif
+
+   m_strScratchDir.clear();
+}
@@ -0,0 +1,97 @@
+/*!
+ *
+ * \class CCShoreWorkspace
+ * \brief Class used to hold the vectors which are needed when CShore is run for a profile, so that these can be reused
+ * \details When CShore is run for a profile, vectors are needed for the profile's elevations, distances and friction factors, for the values which are output by CShore, and for the output values once they have been interpolated onto the profile. Instead of creating these vectors afresh for every profile, each thread which runs CShore has its own CCShoreWorkspace, whose vectors keep their memory between profiles and between timesteps. So once the vectors have grown to fit the longest profile, running CShore for a profile does not allocate any memory. The CShore output vectors hold as many values as the CShore library returns for each profile, CoastalME gets this number from the library when the simulation starts. When CoastalME and CShore exchange ASCII files, each CCShoreWorkspace also has a private scratch directory for these files, which if possible is on a memory-backed file system
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file cshore_workspace.h
+ * \brief Contains CCShoreWorkspace definitions
+ *
+ */
+
+#ifndef CSHORE_WORKSPACE_H
+#define CSHORE_WORKSPACE_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+class CCShoreWorkspace
+{
+   friend class CSimulation;
+
+private:
+   //! Along-profile distance of each profile point, measured from the seaward limit, in CShore units
+   vector<double> m_VdProfileDistXY;
+
+   //! Elevation of both consolidated and unconsolidated sediment at each profile point, in CShore units
+   vector<double> m_VdProfileZ;
+
+   //! Friction factor at each profile point
+   vector<double> m_VdProfileFrictionFactor;
+
+   //! Output from CShore: along-profile distances, measured from the seaward limit
+   vector<double> m_VdXYDistOut;
+
+   //! Output from CShore: free surface standard deviations
+   vector<double> m_VdFreeSurfaceStdOut;
+
+   //! Output from CShore: wave setup plus surge
+   vector<double> m_VdWaveSetupSurgeOut;
+
+   //! Output from CShore: sines of wave angle
+   vector<double> m_VdSinWaveAngleRadiansOut;
+
+   //! Output from CShore: fractions of breaking waves
+   vector<double> m_VdFractionBreakingWavesOut;
+
+   //! The CShore along-profile distances, with the origin at the shoreline, used when interpolating the CShore output
+   vector<double> m_VdXYDistCShore;
+
+   //! The free surface standard deviations, interpolated onto the profile points
+   vector<double> m_VdFreeSurfaceStd;
+
+   //! The wave setup plus surge, interpolated onto the profile points
+   vector<double> m_VdWaveSetupSurge;
+
+   //! The sines of wave angle, interpolated onto the profile points
+   vector<double> m_VdSinWaveAngleRadians;
+
+   //! The fractions of breaking waves, interpolated onto the profile points
+   vector<double> m_VdFractionBreakingWaves;
+
+   //! The scratch directory in which CShore reads and writes its ASCII files, with a trailing separator. Empty if there is no scratch directory
+   string m_strScratchDir;
+
+public:
+   CCShoreWorkspace(void);
+   ~CCShoreWorkspace(void);
+
+   void SetArrayOutSize(int const);
+   void ClearProfile(void);
+   void ClearOutput(void);
+   void ReleaseMemory(void);
+
+   bool bCreateScratchDir(int const);
+   bool bSaveScratchFiles(string const&, string const&) const;
+   void CleanScratchDir(void) const;
+   void RemoveScratchDir(void);
+};
+#endif // CSHORE_WORKSPACE_H
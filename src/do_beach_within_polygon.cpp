@@ -593,6 +593,9 @@ int CSimulation::nDoParallelProfileUnconsErosion(int const nPoly, int const nCoa
                   if (nTopLayer == INT_NODATA)
                      return RTN_ERR_NO_TOP_LAYER;
 
+                  // This cell's sediment is about to change, so tell the grid
+                  m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
+
                   if (dTotToDeposit > 0)
                   {
                      dTotToDeposit = tMin(dTotToDeposit, dTotEroded);
@@ -638,7 +641,7 @@ int CSimulation::nDoParallelProfileUnconsErosion(int const nPoly, int const nCoa
                   m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
 
                   // Update the cell's sea depth
-                  m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+                  m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
 
                   // Update the cell's beach deposition, and total beach deposition, values
                   m_pRasterGrid->m_Cell[nX][nY].IncrBeachDeposition(dTotToDeposit);
@@ -694,6 +697,9 @@ void CSimulation::ErodeCellBeachSedimentSupplyLimited(int const nX, int const nY
    dRemoved = tMin(dExistingAvailable, dLowering);
    double dRemaining = dExistingAvailable - dRemoved;
 
+   // This cell's sediment is about to change, so tell the grid
+   m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
+
    if (nTexture == TEXTURE_FINE) 
    {
       // Set the value for this layer
@@ -722,7 +728,7 @@ void CSimulation::ErodeCellBeachSedimentSupplyLimited(int const nX, int const nY
       m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
 
       // And update the cell's sea depth
-      m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+      m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
    }
 }
 
@@ -1109,6 +1115,9 @@ int CSimulation::nDoUnconsDepositionOnPolygon(int const nCoast, int const nPoly,
                   if (dToDepositHere > SEDIMENT_ELEV_TOLERANCE)
                   {
                      bDeposited = true;
+
+                     // This cell's sediment is about to change, so tell the grid
+                     m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
                      
                      if (nTexture == TEXTURE_SAND)
                      {
@@ -1178,7 +1187,7 @@ int CSimulation::nDoUnconsDepositionOnPolygon(int const nCoast, int const nPoly,
                   m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
 
                   // Update the cell's sea depth
-                  m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+                  m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
 
                   // And set the landform category
                   m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->SetLFSubCategory(LF_SUBCAT_DRIFT_BEACH);
@@ -1595,6 +1604,9 @@ int CSimulation::nDoUnconsDepositionOnPolygon(int const nCoast, int const nPoly,
                      if (dToDepositHere > SEDIMENT_ELEV_TOLERANCE)
                      {
                         bDeposited = true;
+
+                        // This cell's sediment is about to change, so tell the grid
+                        m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
                         
                         if (nTexture == TEXTURE_SAND)
                         {
@@ -1659,7 +1671,7 @@ int CSimulation::nDoUnconsDepositionOnPolygon(int const nCoast, int const nPoly,
                      m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
 
                      // Update the cell's sea depth
-                     m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+                     m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
 
                      // And set the landform category
                      m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->SetLFSubCategory(LF_SUBCAT_DRIFT_BEACH);
@@ -239,6 +239,9 @@ int CSimulation::nDoCliffCollapse(int const nCoast, CRWCliff* pCliff, double& dF
    m_bConsChangedThisIter[nTopLayer] = true;
    m_bUnconsChangedThisIter[nTopLayer] = true;
    
+   // This cell's sediment is about to change, so tell the grid
+   m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
+
    // Get the pre-collapse cliff elevation
    dPreCollapseCliffElev = m_pRasterGrid->m_Cell[nX][nY].dGetSedimentTopElev();
 
@@ -400,7 +403,7 @@ int CSimulation::nDoCliffCollapse(int const nCoast, CRWCliff* pCliff, double& dF
    dPostCollapseCliffElev = m_pRasterGrid->m_Cell[nX][nY].dGetSedimentTopElev();
 
    // And update the cell's sea depth
-   m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+   m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
 
    // LogStream << m_ulIter << ": cell [" << nX << "][" << nY << "] after removing sediment, dGetVolEquivSedTopElev() = " << m_pRasterGrid->m_Cell[nX][nY].dGetVolEquivSedTopElev() << ", dGetSedimentTopElev() = " << m_pRasterGrid->m_Cell[nX][nY].dGetSedimentTopElev() << endl << endl;
    
@@ -825,6 +828,8 @@ int CSimulation::nDoCliffCollapseDeposition(int const nCoast, CRWCliff const* pC
             if (dVDeanProfile[n] > dVProfileNow[n])
             {
                // At this point along the profile, the Dean profile is higher than the present profile. So we can deposit some sediment on this cell
+               m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
+
                double dSandToDeposit = 0;
                if (bDoSandDepositionOnThisProfile)
                {
@@ -859,7 +864,7 @@ int CSimulation::nDoCliffCollapseDeposition(int const nCoast, CRWCliff const* pC
                m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
 
                // Update the cell's sea depth
-               m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+               m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
 
                // Update the cell's talus deposition, and total talus deposition, values
                m_pRasterGrid->m_Cell[nX][nY].AddSandTalusDeposition(dSandToDeposit);
@@ -872,6 +877,8 @@ int CSimulation::nDoCliffCollapseDeposition(int const nCoast, CRWCliff const* pC
             else if (dVDeanProfile[n] < dVProfileNow[n])
             {
                // Here, the Dean profile is lower than the existing profile, so we must remove some sediment from this cell  *** TODO CONS or UNCONS?
+               m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
+
                double dThisLowering = dVProfileNow[n] - dVDeanProfile[n];
 
                // Find out how much sediment we have available on this cell
@@ -970,7 +977,7 @@ int CSimulation::nDoCliffCollapseDeposition(int const nCoast, CRWCliff const* pC
                m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
 
                // And update the cell's sea depth
-               m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+               m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
             }
          }     // All cells in this profile 
 
@@ -104,6 +104,8 @@ int CSimulation::nDoSedimentInputEvent(int const nEvent)
          int nTopLayer = m_pRasterGrid->m_Cell[nPointGridX][nPointGridY].nGetTopLayerAboveBasement();
 
          // Add to this cell's unconsolidated sediment
+         m_pRasterGrid->MarkCellSedimentDirty(nPointGridX, nPointGridY);
+
          double dFineDepth = dFineSedVol / m_dCellArea;
          m_pRasterGrid->m_Cell[nPointGridX][nPointGridY].pGetLayerAboveBasement(nTopLayer)->pGetUnconsolidatedSediment()->AddFineDepth(dFineDepth);
          m_dThisiterUnconsFineInput += dFineDepth;
@@ -291,6 +293,8 @@ int CSimulation::nDoSedimentInputEvent(int const nEvent)
          for (unsigned int n = 0; n < nArea; n++)
          {
             // Add to this cell's unconsolidated sediment
+            m_pRasterGrid->MarkCellSedimentDirty(VPoints[n].nGetX(), VPoints[n].nGetY());
+
             m_pRasterGrid->m_Cell[VPoints[n].nGetX()][VPoints[n].nGetY()].pGetLayerAboveBasement(nTopLayer)->pGetUnconsolidatedSediment()->AddFineDepth(dFineDepthPerCell);
             m_dThisiterUnconsFineInput += dFineDepth;
 
@@ -400,6 +404,8 @@ int CSimulation::nDoSedimentInputEvent(int const nEvent)
       int nTopLayer = m_pRasterGrid->m_Cell[nCoastX][nCoastY].nGetTopLayerAboveBasement();
 
       // Add to this cell's unconsolidated sediment
+      m_pRasterGrid->MarkCellSedimentDirty(nCoastX, nCoastY);
+
       double dFineDepth = dFineSedVol / m_dCellArea;
       m_pRasterGrid->m_Cell[nCoastX][nCoastY].pGetLayerAboveBasement(nTopLayer)->pGetUnconsolidatedSediment()->AddFineDepth(dFineDepth);
       m_dThisiterUnconsFineInput += dFineDepth;
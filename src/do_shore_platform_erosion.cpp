@@ -51,7 +51,7 @@ int CSimulation::nDoAllShorePlatFormErosion(void)
    // TODO 023 Only do potential erosion if cell is in a polygon
 
    // Set direction
-   static bool bForward = true;
+   bool bForward = m_bErodeShorePlatformForward;
 
    // Do this for each coast
    for (int nCoast = 0; nCoast < static_cast<int>(m_VCoast.size()); nCoast++)
@@ -85,7 +85,7 @@ int CSimulation::nDoAllShorePlatFormErosion(void)
 
    // If desired, swap direction for next timestep
    if (m_bErodeShorePlatformAlternateDirection)
-      bForward = ! bForward;
+      m_bErodeShorePlatformForward = ! m_bErodeShorePlatformForward;
 
    // Fills in 'holes' in the potential platform erosion i.e. orphan cells which get omitted because of rounding problems
    FillPotentialPlatformErosionHoles();
@@ -93,10 +93,13 @@ int CSimulation::nDoAllShorePlatFormErosion(void)
    // Do the same for beach protection
    FillInBeachProtectionHoles();
 
-   // Finally calculate actual platform erosion on all sea cells (both on profiles, and between profiles)
-   for (int nX = 0; nX < m_nXGridMax; nX++)
+   // Finally calculate actual platform erosion on all sea cells (both on profiles, and between profiles). Potential platform erosion is only ever set on profile and parallel profile cells, and on holes between them, so just do the active window
+   int nXMin, nXEnd, nYMin, nYEnd;
+   GetActiveWindow(false, nXMin, nXEnd, nYMin, nYEnd);
+
+   for (int nX = nXMin; nX < nXEnd; nX++)
    {
-      for (int nY = 0; nY < m_nYGridMax; nY++)
+      for (int nY = nYMin; nY < nYEnd; nY++)
       {
          if (m_pRasterGrid->m_Cell[nX][nY].bPotentialPlatformErosion())
             // Calculate actual (supply-limited) shore platform erosion on each cell that has potential platform erosion, also add the eroded sand/coarse sediment to that cells's polygon, ready to be redistributed within the polygon during beach erosion/deposition
@@ -481,7 +484,7 @@ int CSimulation::nCalcPotentialPlatformErosionBetweenProfiles(int const nCoast,
          int const nYPar = PtiVGridParProfile[i].nGetY();
 
          // Is this a sea cell?
-         if (! m_pRasterGrid->m_Cell[nXPar][nYPar].bIsInundated())
+         if (! m_pRasterGrid->m_Cell[nXPar][nYPar].bIsInundated(m_dThisIterSWL))
          {
             // It isn't so move along, nothing to do here
             //             LogStream << m_ulIter << " : [" << nXPar << "][" << nYPar << "] is not inundated" << endl;
@@ -681,6 +684,9 @@ int CSimulation::nCalcPotentialPlatformErosionBetweenProfiles(int const nCoast,
          // Finally, calculate the beach protection factor, this will be used in estimating actual (supply-limited) erosion
          double const dBeachProtectionFactor = dCalcBeachProtectionFactor(nXPar, nYPar, dBreakingWaveHeight);
          m_pRasterGrid->m_Cell[nXPar][nYPar].SetBeachProtectionFactor(dBeachProtectionFactor);
+
+         // Parallel profiles need not lie within the bounding box of the coastline-normal profiles, so make sure that this cell is in the active window
+         ExpandActiveWindow(nXPar, nYPar);
       }
 
       // If desired, save this parallel coastline-normal profile for checking purposes
@@ -729,6 +735,9 @@ void CSimulation::DoActualPlatformErosionOnCell(int const nX, int const nY)
       // No layer with non-zero thickness left, we are down to basement
       return;
 
+   // This cell's sediment is about to change, so tell the grid
+   m_pRasterGrid->MarkCellSedimentDirty(nX, nY);
+
    // OK, we have a layer that can be eroded so find out how much consolidated sediment we have available on this cell
    double
        dExistingAvailableFine = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nThisLayer)->pGetConsolidatedSediment()->dGetFineDepth(),
@@ -827,7 +836,7 @@ void CSimulation::DoActualPlatformErosionOnCell(int const nX, int const nY)
       m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
 
       // And update the cell's sea depth
-      m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
+      m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
 
       // Update per-timestep totals
       m_ulThisIterNumActualPlatformErosionCells++;
@@ -1069,9 +1078,13 @@ double CSimulation::dCalcBeachProtectionFactor(int const nX, int const nY, doubl
 //===============================================================================================================================
 void CSimulation::FillInBeachProtectionHoles(void)
 {
-   for (int nX = 0; nX < m_nXGridMax; nX++)
+   // Beach protection is only set on profile and parallel profile cells, and a hole must have four neighbours with beach protection, so just do the active window
+   int nXMin, nXEnd, nYMin, nYEnd;
+   GetActiveWindow(false, nXMin, nXEnd, nYMin, nYEnd);
+
+   for (int nX = nXMin; nX < nXEnd; nX++)
    {
-      for (int nY = 0; nY < m_nYGridMax; nY++)
+      for (int nY = nYMin; nY < nYEnd; nY++)
       {
          if ((m_pRasterGrid->m_Cell[nX][nY].bIsInContiguousSea()) && (bFPIsEqual(m_pRasterGrid->m_Cell[nX][nY].dGetBeachProtectionFactor(), DBL_NODATA, TOLERANCE)))
          {
@@ -1134,9 +1147,13 @@ void CSimulation::FillInBeachProtectionHoles(void)
 //===============================================================================================================================
 void CSimulation::FillPotentialPlatformErosionHoles(void)
 {
-   for (int nX = 0; nX < m_nXGridMax; nX++)
+   // Likewise, potential platform erosion is only set on profile and parallel profile cells, so just do the active window
+   int nXMin, nXEnd, nYMin, nYEnd;
+   GetActiveWindow(false, nXMin, nXEnd, nYMin, nYEnd);
+
+   for (int nX = nXMin; nX < nXEnd; nX++)
    {
-      for (int nY = 0; nY < m_nYGridMax; nY++)
+      for (int nY = nYMin; nY < nYEnd; nY++)
       {
          if ((m_pRasterGrid->m_Cell[nX][nY].bIsInContiguousSea()) && (bFPIsEqual(m_pRasterGrid->m_Cell[nX][nY].dGetPotentialPlatformErosion(), 0.0, TOLERANCE)))
          {
@@ -172,44 +172,31 @@ int CSimulation::nReadRasterBasementDEM(void)
    if (nRet != RTN_OK)
       return nRet;
 
-   // Allocate memory for a 1D floating-point array, to hold the scan line for GDAL
-   double* pdScanline = new double[m_nXGridMax];
-   if (NULL == pdScanline)
-   {
-      // Error, can't allocate memory
-      cerr << ERR << "cannot allocate memory for " << m_nXGridMax << " x 1D array" << endl;
-      return (RTN_ERR_MEMALLOC);
-   }
-
-   // Now read in the data
+   // Now read in the data. The basement elevation field plane is row-major, so each scanline is read by GDAL straight into its row of the plane
+   double* pdBasementElev = m_pRasterGrid->pdGetField(CELL_DBL_BASEMENT_ELEV);
    for (int j = 0; j < m_nYGridMax; j++)
    {
+      double* pdRow = pdBasementElev + m_pRasterGrid->ulGetCellIndex(0, j);
+
       // Read scanline
-      if (CE_Failure == pGDALBand->RasterIO(GF_Read, 0, j, m_nXGridMax, 1, pdScanline, m_nXGridMax, 1, GDT_Float64, 0, 0, NULL))
+      if (CE_Failure == pGDALBand->RasterIO(GF_Read, 0, j, m_nXGridMax, 1, pdRow, m_nXGridMax, 1, GDT_Float64, 0, 0, NULL))
       {
          // Error while reading scanline
          cerr << ERR << CPLGetLastErrorMsg() << " in " << m_strInitialBasementDEMFile << endl;
          return RTN_ERR_DEMFILE;
       }
 
-      // All OK, so read scanline into cell elevations (including any missing values)
+      // All OK, so deal with any NaN values (missing values are kept)
       for (int i = 0; i < m_nXGridMax; i++)
       {
-         double dTmp = pdScanline[i];
-
-         if (! isfinite(dTmp)) // Deal with any NaN values
-            dTmp = m_dMissingValue;
-
-         m_pRasterGrid->m_Cell[i][j].SetBasementElev(dTmp);
+         if (! isfinite(pdRow[i]))
+            pdRow[i] = m_dMissingValue;
       }
    }
 
    // Finished, so get rid of dataset object
    GDALClose(pGDALDataset);
 
-   // Get rid of memory allocated to this array
-   delete[] pdScanline;
-
    return RTN_OK;
 }
 
@@ -1266,15 +1253,6 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
    if (CE_Failure == pDataSet->SetGeoTransform(m_dGeoTransform))
       LogStream << WARN << "cannot write geotransformation information to " << m_strRasterGISOutFormat << " file named " << strFilePathName << "\n" << CPLGetLastErrorMsg() << endl;
 
-   // Allocate memory for a 1D array, to hold the floating point raster band data for GDAL
-   double* pdRaster = new double[m_ulNumCells];
-   if (NULL == pdRaster)
-   {
-      // Error, can't allocate memory
-      cerr << ERR << "cannot allocate memory for " << m_ulNumCells << " x 1D floating-point array for " << m_strRasterGISOutFormat << " file named " << strFilePathName << endl;
-      return (RTN_ERR_MEMALLOC);
-   }
-
    bool bScaleOutput = false;
    double dRangeScale = 0;
    double dDataMin = 0;
@@ -1298,13 +1276,137 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
          bScaleOutput = true;
    }
 
+   // Some outputs are held, unaltered, in a single row-major field plane. If so, and if no scaling is needed, then GDAL can write straight from the plane
+   double* pdPlane = NULL;
+   diag_t* ptDiagPlane = NULL;
+   if (! bScaleOutput)
+   {
+      switch (nDataItem)
+      {
+         case (RASTER_PLOT_BASEMENT_ELEVATION):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_BASEMENT_ELEV);
+            break;
+
+         case (RASTER_PLOT_SEDIMENT_TOP_ELEVATION_ELEV):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_SEDIMENT_TOP_ELEV);
+            break;
+
+         case (RASTER_PLOT_LOCAL_SLOPE_OF_CONSOLIDATED_SEDIMENT):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_LOCAL_CONS_SLOPE);
+            break;
+
+         case (RASTER_PLOT_POTENTIAL_PLATFORM_EROSION):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_POTENTIAL_PLATFORM_EROSION);
+            break;
+
+         case (RASTER_PLOT_ACTUAL_PLATFORM_EROSION):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_ACTUAL_PLATFORM_EROSION);
+            break;
+
+         case (RASTER_PLOT_TOTAL_POTENTIAL_PLATFORM_EROSION):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_POTENTIAL_PLATFORM_EROSION);
+            break;
+
+         case (RASTER_PLOT_TOTAL_ACTUAL_PLATFORM_EROSION):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_ACTUAL_PLATFORM_EROSION);
+            break;
+
+         case (RASTER_PLOT_POTENTIAL_BEACH_EROSION):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_POTENTIAL_BEACH_EROSION);
+            break;
+
+         case (RASTER_PLOT_ACTUAL_BEACH_EROSION):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_ACTUAL_BEACH_EROSION);
+            break;
+
+         case (RASTER_PLOT_TOTAL_POTENTIAL_BEACH_EROSION):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_POTENTIAL_BEACH_EROSION);
+            break;
+
+         case (RASTER_PLOT_TOTAL_ACTUAL_BEACH_EROSION):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_ACTUAL_BEACH_EROSION);
+            break;
+
+         case (RASTER_PLOT_BEACH_DEPOSITION):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_BEACH_DEPOSITION);
+            break;
+
+         case (RASTER_PLOT_TOTAL_BEACH_DEPOSITION):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_BEACH_DEPOSITION);
+            break;
+
+         case (RASTER_PLOT_SUSPENDED_SEDIMENT):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_SUSP_SED);
+            break;
+
+         case (RASTER_PLOT_CLIFF_COLLAPSE_EROSION_FINE):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_CLIFF_COLLAPSE_FINE);
+            break;
+
+         case (RASTER_PLOT_CLIFF_COLLAPSE_EROSION_SAND):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_CLIFF_COLLAPSE_SAND);
+            break;
+
+         case (RASTER_PLOT_CLIFF_COLLAPSE_EROSION_COARSE):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_CLIFF_COLLAPSE_COARSE);
+            break;
+
+         case (RASTER_PLOT_TOTAL_CLIFF_COLLAPSE_EROSION_FINE):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_FINE);
+            break;
+
+         case (RASTER_PLOT_TOTAL_CLIFF_COLLAPSE_EROSION_SAND):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_SAND);
+            break;
+
+         case (RASTER_PLOT_TOTAL_CLIFF_COLLAPSE_EROSION_COARSE):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_COARSE);
+            break;
+
+         case (RASTER_PLOT_CLIFF_COLLAPSE_DEPOSIT_SAND):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_TALUS_SAND_DEPOSITION);
+            break;
+
+         case (RASTER_PLOT_CLIFF_COLLAPSE_DEPOSIT_COARSE):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_TALUS_COARSE_DEPOSITION);
+            break;
+
+         case (RASTER_PLOT_TOTAL_CLIFF_COLLAPSE_DEPOSIT_SAND):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_TALUS_SAND_DEPOSITION);
+            break;
+
+         case (RASTER_PLOT_TOTAL_CLIFF_COLLAPSE_DEPOSIT_COARSE):
+            ptDiagPlane = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_TALUS_COARSE_DEPOSITION);
+            break;
+
+         case (RASTER_PLOT_INTERVENTION_HEIGHT):
+            pdPlane = m_pRasterGrid->pdGetField(CELL_DBL_INTERVENTION_HEIGHT);
+            break;
+      }
+   }
+
+   bool bFromPlane = ((pdPlane != NULL) || (ptDiagPlane != NULL));
+
+   // If not writing straight from a field plane, allocate memory for a 1D array, to hold the floating point raster band data for GDAL
+   double* pdRaster = pdPlane;
+   if (! bFromPlane)
+   {
+      pdRaster = new double[m_ulNumCells];
+      if (NULL == pdRaster)
+      {
+         // Error, can't allocate memory
+         cerr << ERR << "cannot allocate memory for " << m_ulNumCells << " x 1D floating-point array for " << m_strRasterGISOutFormat << " file named " << strFilePathName << endl;
+         return (RTN_ERR_MEMALLOC);
+      }
+   }
+
    // Fill the array
    int
        n = 0,
        nPoly = 0,
        nTopLayer = 0;
    double dTmp = 0;
-   for (int nY = 0; nY < m_nYGridMax; nY++)
+   for (int nY = 0; (! bFromPlane) && (nY < m_nYGridMax); nY++)
    {
       for (int nX = 0; nX < m_nXGridMax; nX++)
       {
@@ -1335,28 +1437,28 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
                break;
 
             case (RASTER_PLOT_WAVE_HEIGHT):
-               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated())
+               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated(m_dThisIterSWL))
                   dTmp = m_pRasterGrid->m_Cell[nX][nY].dGetWaveHeight();
                else
                   dTmp = 0;
                break;
 
             case (RASTER_PLOT_AVG_WAVE_HEIGHT):
-               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated())
+               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated(m_dThisIterSWL))
                   dTmp = m_pRasterGrid->m_Cell[nX][nY].dGetTotWaveHeight() / static_cast<double>(m_ulIter);
                else
                   dTmp = 0;
                break;
 
             case (RASTER_PLOT_WAVE_ORIENTATION):
-               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated())
+               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated(m_dThisIterSWL))
                   dTmp = m_pRasterGrid->m_Cell[nX][nY].dGetWaveAngle();
                else
                   dTmp = 0;
                break;
 
             case (RASTER_PLOT_AVG_WAVE_ORIENTATION):
-               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated())
+               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated(m_dThisIterSWL))
                   dTmp = m_pRasterGrid->m_Cell[nX][nY].dGetTotWaveAngle() / static_cast<double>(m_ulIter);
                else
                   dTmp = 0;
@@ -1421,27 +1523,27 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
                break;
 
             case (RASTER_PLOT_FINE_UNCONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetFineDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetFineDepth();
                break;
 
             case (RASTER_PLOT_SAND_UNCONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetSandDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetSandDepth();
                break;
 
             case (RASTER_PLOT_COARSE_UNCONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetCoarseDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetCoarseDepth();
                break;
 
             case (RASTER_PLOT_FINE_CONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetFineDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetFineDepth();
                break;
 
             case (RASTER_PLOT_SAND_CONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetSandDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetSandDepth();
                break;
 
             case (RASTER_PLOT_COARSE_CONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetCoarseDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetCoarseDepth();
                break;
 
             case (RASTER_PLOT_CLIFF_COLLAPSE_EROSION_FINE):
@@ -1489,21 +1591,21 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
                break;
 
             case (RASTER_PLOT_DEEP_WATER_WAVE_ORIENTATION):
-               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated())
+               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated(m_dThisIterSWL))
                   dTmp = m_pRasterGrid->m_Cell[nX][nY].dGetCellDeepWaterWaveAngle();
                else
                   dTmp = 0;
                break;
 
             case (RASTER_PLOT_DEEP_WATER_WAVE_HEIGHT):
-               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated())
+               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated(m_dThisIterSWL))
                   dTmp = m_pRasterGrid->m_Cell[nX][nY].dGetCellDeepWaterWaveHeight();
                else
                   dTmp = 0;
                break;
 
             case (RASTER_PLOT_DEEP_WATER_WAVE_PERIOD):
-               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated())
+               if (m_pRasterGrid->m_Cell[nX][nY].bIsInundated(m_dThisIterSWL))
                   dTmp = m_pRasterGrid->m_Cell[nX][nY].dGetCellDeepWaterWavePeriod();
                else
                   dTmp = 0;
@@ -1538,7 +1640,7 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
                if ((nTopLayer == INT_NODATA) || (nTopLayer == NO_NONZERO_THICKNESS_LAYERS))
                   break;
 
-               if ((m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nTopLayer)->dGetUnconsolidatedThickness() > 0) && (m_pRasterGrid->m_Cell[nX][nY].dGetSedimentTopElev() > m_dThisIterSWL))
+               if ((m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nTopLayer)->dGetUnconsolidatedThickness() > 0) && (m_pRasterGrid->m_Cell[nX][nY].dGetSedimentTopElev() > m_dThisIterSWL))
                   dTmp = 1;
                break;
 
@@ -1594,7 +1696,7 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
                break;
 
             case (RASTER_PLOT_SEDIMENT_INPUT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nTopLayer)->pGetUnconsolidatedSediment()->dGetTotSedimentInputDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nTopLayer)->pGetUnconsolidatedSediment()->dGetTotSedimentInputDepth();
                break;
 
             case (RASTER_PLOT_SETUP_SURGE_FLOOD_MASK):
@@ -1836,12 +1938,21 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
    pBand->SetCategoryNames(papszCategoryNames); // Not supported for some GIS formats
    CPLPopErrorHandler();
    
-   // Now write the data
-   if (CE_Failure == pBand->RasterIO(GF_Write, 0, 0, m_nXGridMax, m_nYGridMax, pdRaster, m_nXGridMax, m_nYGridMax, GDT_Float64, 0, 0, NULL))
+   // Now write the data. A diagnostic field plane may be single precision, if so GDAL does the conversion to the band's data type
+   void* pBuffer = pdRaster;
+   GDALDataType nBufferType = GDT_Float64;
+   if (ptDiagPlane != NULL)
+   {
+      pBuffer = ptDiagPlane;
+      nBufferType = (sizeof(diag_t) == sizeof(float) ? GDT_Float32 : GDT_Float64);
+   }
+
+   if (CE_Failure == pBand->RasterIO(GF_Write, 0, 0, m_nXGridMax, m_nYGridMax, pBuffer, m_nXGridMax, m_nYGridMax, nBufferType, 0, 0, NULL))
    {
       // Write error, better error message
       cerr << ERR << "cannot write data for " << m_strRasterGISOutFormat << " file named " << strFilePathName << "\n" << CPLGetLastErrorMsg() << endl;
-      delete[] pdRaster;
+      if (! bFromPlane)
+         delete[] pdRaster;
       return false;
    }
 
@@ -1876,8 +1987,9 @@ bool CSimulation::bWriteRasterGISFile(int const nDataItem, string const *strPlot
    // Get rid of dataset object
    GDALClose(pDataSet);
 
-   // Also get rid of memory allocated to this array
-   delete[] pdRaster;
+   // Also get rid of memory allocated to this array (if we wrote straight from a field plane, there is nothing to free)
+   if (! bFromPlane)
+      delete[] pdRaster;
 
    return true;
 }
@@ -896,9 +896,9 @@ bool CSimulation::bCheckVectorGISOutputFormat(void)
 }
 
 //===============================================================================================================================
-//! The bSaveAllRasterGISFiles member function saves the raster GIS files using values from the RasterGrid array
+//! Increments the GIS file number, and sets the time of the next GIS save. This must be called before the raster and vector GIS files are saved, since both use the file number
 //===============================================================================================================================
-bool CSimulation::bSaveAllRasterGISFiles(void)
+void CSimulation::AdvanceGISSave(void)
 {
    // Increment file number
    m_nGISSave++;
@@ -908,7 +908,13 @@ bool CSimulation::bSaveAllRasterGISFiles(void)
       m_dRegularSaveTime += m_dRegularSaveInterval;
    else
       m_nThisSave = tMin(++m_nThisSave, m_nUSave);
+}
 
+//===============================================================================================================================
+//! The bSaveAllRasterGISFiles member function saves the raster GIS files using values from the RasterGrid array
+//===============================================================================================================================
+bool CSimulation::bSaveAllRasterGISFiles(void)
+{
    if (m_bSedimentTopSurfSave)
       if (! bWriteRasterGISFile(RASTER_PLOT_SEDIMENT_TOP_ELEVATION_ELEV, &RASTER_PLOT_SEDIMENT_TOP_ELEVATION_ELEV_TITLE))
          return false;
@@ -1531,27 +1537,27 @@ void CSimulation::GetRasterOutputMinMax(int const nDataItem, double&dMin, double
                break;
 
             case (RASTER_PLOT_FINE_UNCONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetFineDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetFineDepth();
                break;
 
             case (RASTER_PLOT_SAND_UNCONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetSandDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetSandDepth();
                break;
 
             case (RASTER_PLOT_COARSE_UNCONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetCoarseDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetUnconsolidatedSediment()->dGetCoarseDepth();
                break;
 
             case (RASTER_PLOT_FINE_CONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetFineDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetFineDepth();
                break;
 
             case (RASTER_PLOT_SAND_CONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetSandDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetSandDepth();
                break;
 
             case (RASTER_PLOT_COARSE_CONSOLIDATED_SEDIMENT):
-               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetCoarseDepth();
+               dTmp = m_pRasterGrid->m_Cell[nX][nY].pGetConstLayerAboveBasement(nLayer)->pGetConsolidatedSediment()->dGetCoarseDepth();
                break;
 
             case (RASTER_PLOT_CLIFF_COLLAPSE_EROSION_FINE):
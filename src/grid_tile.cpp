@@ -0,0 +1,193 @@
+/*!
+ *
+ * \file grid_tile.cpp
+ * \brief CGeomGridTile routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <cstring>
+using std::memcmp;
+
+#include "cme.h"
+#include "grid_tile.h"
+
+//! Constructor
+CGeomGridTile::CGeomGridTile(void)
+: m_bSedimentChanged(true),
+  m_nXMin(0),
+  m_nXEnd(0),
+  m_nYMin(0),
+  m_nYEnd(0),
+  m_nQuietTimesteps(0),
+  m_bCompact(false),
+  m_bOwnsLayers(false),
+  m_bLayersDiffer(false),
+  m_pLayers(NULL)
+{
+}
+
+//! Destructor. Note that the tile's layers are not freed here, since tiles are copied when the grid's vector of tiles is created: instead, the grid calls FreeLayers()
+CGeomGridTile::~CGeomGridTile(void)
+{
+}
+
+//! Sets the extent of this tile: the first cell, and one past the last cell, in each direction
+void CGeomGridTile::SetExtent(int const nXMin, int const nYMin, int const nXEnd, int const nYEnd)
+{
+   m_nXMin = nXMin;
+   m_nYMin = nYMin;
+   m_nXEnd = nXEnd;
+   m_nYEnd = nYEnd;
+}
+
+//! Returns the x co-ordinate (grid CRS) of the first cell in this tile
+int CGeomGridTile::nGetXMin(void) const
+{
+   return m_nXMin;
+}
+
+//! Returns the x co-ordinate (grid CRS) one past the last cell in this tile
+int CGeomGridTile::nGetXEnd(void) const
+{
+   return m_nXEnd;
+}
+
+//! Returns the y co-ordinate (grid CRS) of the first cell in this tile
+int CGeomGridTile::nGetYMin(void) const
+{
+   return m_nYMin;
+}
+
+//! Returns the y co-ordinate (grid CRS) one past the last cell in this tile
+int CGeomGridTile::nGetYEnd(void) const
+{
+   return m_nYEnd;
+}
+
+//! Called once per timestep, before the tiles near the coast are marked
+void CGeomGridTile::IncrQuietTimesteps(void)
+{
+   if (m_nQuietTimesteps < TILE_QUIET_TIMESTEPS_FOR_UNIFORM)
+      m_nQuietTimesteps++;
+}
+
+//! Marks this tile as near a coastline or profile, so its cells are swept for at least the next TILE_QUIET_TIMESTEPS_FOR_UNIFORM timesteps
+void CGeomGridTile::SetActive(void)
+{
+   m_nQuietTimesteps = 0;
+}
+
+//! Marks this tile as having had a change to the sediment of one of its cells, so its cells are swept again
+void CGeomGridTile::SetSedimentChanged(void)
+{
+   m_bSedimentChanged = true;
+   m_bLayersDiffer = false;
+   m_nQuietTimesteps = 0;
+}
+
+//! Returns true if this tile is uniform, i.e. if per-timestep sweeps may skip its cells
+bool CGeomGridTile::bIsUniform(void) const
+{
+   return ((! m_bSedimentChanged) && (m_nQuietTimesteps >= TILE_QUIET_TIMESTEPS_FOR_UNIFORM));
+}
+
+//! Called at the start of each timestep, once the sediment changes of the previous timestep have been accounted for
+void CGeomGridTile::ClearSedimentChanged(void)
+{
+   m_bSedimentChanged = false;
+}
+
+//! Returns the number of cells in this tile
+int CGeomGridTile::nGetNumCells(void) const
+{
+   return (m_nXEnd - m_nXMin) * (m_nYEnd - m_nYMin);
+}
+
+//! Gives this tile its layers, which must hold nGetNumCells() cells' layers. If bOwns is true, the layers were allocated with new[] and the tile may free them; if false, they are in the grid's memory-mapped file and the tile is never made compact
+void CGeomGridTile::SetLayers(CRWCellLayer* pLayers, bool const bOwns)
+{
+   m_pLayers = pLayers;
+   m_bOwnsLayers = bOwns;
+   m_bCompact = false;
+}
+
+//! Frees this tile's layers, if the tile owns them
+void CGeomGridTile::FreeLayers(void)
+{
+   if (m_bOwnsLayers)
+      delete [] m_pLayers;
+
+   m_pLayers = NULL;
+}
+
+//! Returns true if this tile is compact, i.e. if all its cells share a single cell's layers
+bool CGeomGridTile::bIsCompact(void) const
+{
+   return m_bCompact;
+}
+
+//! If this tile is uniform, and the layers of all its cells are bitwise identical, replaces the tile's layers with a single cell's layers and frees the rest. Returns true if the tile was made compact by this call
+bool CGeomGridTile::bCompactLayers(int const nLayers)
+{
+   if (m_bCompact || (! m_bOwnsLayers) || m_bLayersDiffer || (nLayers == 0) || (! bIsUniform()))
+      return false;
+
+   // Compare every cell's layers with those of the tile's first cell. The layers hold only doubles, so a bitwise comparison is exact (and never treats two values as equal if they differ in any way, e.g. 0 and -0)
+   int nCells = nGetNumCells();
+   size_t nBytesPerCell = sizeof(CRWCellLayer) * static_cast<size_t>(nLayers);
+   for (int n = 1; n < nCells; n++)
+   {
+      if (memcmp(m_pLayers + (n * nLayers), m_pLayers, nBytesPerCell) != 0)
+      {
+         // They differ, so don't look again until the sediment of one of this tile's cells next changes
+         m_bLayersDiffer = true;
+         return false;
+      }
+   }
+
+   CRWCellLayer* pShared = new CRWCellLayer[nLayers];
+   for (int n = 0; n < nLayers; n++)
+      pShared[n] = m_pLayers[n];
+
+   delete [] m_pLayers;
+   m_pLayers = pShared;
+   m_bCompact = true;
+
+   return true;
+}
+
+//! If this tile is compact, gives each of its cells its own copy of the shared layers, so that they can be written
+void CGeomGridTile::ExpandLayers(int const nLayers)
+{
+   if (! m_bCompact)
+      return;
+
+   int nCells = nGetNumCells();
+   CRWCellLayer* pAll = new CRWCellLayer[nCells * nLayers];
+   for (int n = 0; n < nCells; n++)
+   {
+      for (int m = 0; m < nLayers; m++)
+         pAll[(n * nLayers) + m] = m_pLayers[m];
+   }
+
+   delete [] m_pLayers;
+   m_pLayers = pAll;
+   m_bCompact = false;
+}
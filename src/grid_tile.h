@@ -0,0 +1,97 @@
+/*!
+ *
+ * \class CGeomGridTile
+ * \brief Geometry class used to represent a square tile of raster grid cells
+ * \details The raster grid is divided into tiles of GRID_TILE_SIZE x GRID_TILE_SIZE cells. A tile which is far from any coastline or profile, and in which no cell's sediment has changed, is treated as uniform: per-timestep sweeps skip its cells. Each tile also holds the sediment layers of its cells. If a uniform tile's cells all have identical layers, the tile is made compact: it then holds only one cell's layers, which are shared by all its cells, until the layers of one of its cells are next written. The cells' other values are still held in the grid's dense field planes, whatever the tile
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file grid_tile.h
+ * \brief Contains CGeomGridTile definitions
+ *
+ */
+
+#ifndef GRID_TILE_H
+#define GRID_TILE_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include "cell_layer.h"
+
+class CGeomGridTile
+{
+private:
+   //! Whether the sediment of any cell in this tile has changed since the start of the previous timestep
+   bool m_bSedimentChanged;
+
+   //! The x co-ordinate (grid CRS) of the first cell in this tile
+   int m_nXMin;
+
+   //! The x co-ordinate (grid CRS) one past the last cell in this tile
+   int m_nXEnd;
+
+   //! The y co-ordinate (grid CRS) of the first cell in this tile
+   int m_nYMin;
+
+   //! The y co-ordinate (grid CRS) one past the last cell in this tile
+   int m_nYEnd;
+
+   //! The number of consecutive timesteps for which this tile has not been near a coastline or profile, and has had no sediment change
+   int m_nQuietTimesteps;
+
+   //! Whether this tile is compact, i.e. whether m_pLayers holds just one cell's layers, which are shared by every cell in the tile
+   bool m_bCompact;
+
+   //! Whether this tile's layers are owned by the tile (i.e. were allocated with new[]), and so may be freed when the tile is made compact
+   bool m_bOwnsLayers;
+
+   //! Whether the layers of this tile's cells were found to differ, when the tile was last checked for compaction. This is cleared by any change to the sediment of one of the tile's cells
+   bool m_bLayersDiffer;
+
+   //! This tile's sediment layers: the layers of each cell in turn (layer 0 being just above basement), with the cells in row-major order within the tile. If the tile is compact, this holds the layers of a single cell
+   CRWCellLayer* m_pLayers;
+
+public:
+   CGeomGridTile(void);
+   ~CGeomGridTile(void);
+
+   void SetExtent(int const, int const, int const, int const);
+   int nGetXMin(void) const;
+   int nGetXEnd(void) const;
+   int nGetYMin(void) const;
+   int nGetYEnd(void) const;
+
+   void IncrQuietTimesteps(void);
+   void SetActive(void);
+   void SetSedimentChanged(void);
+   void ClearSedimentChanged(void);
+   bool bIsUniform(void) const;
+
+   int nGetNumCells(void) const;
+   void SetLayers(CRWCellLayer*, bool const);
+   void FreeLayers(void);
+   bool bIsCompact(void) const;
+   bool bCompactLayers(int const);
+   void ExpandLayers(int const);
+
+   //! Returns a pointer to the layers of a cell in this tile, given the cell's co-ordinates (grid CRS) and the number of layers per cell. If the tile is compact, the layers returned are shared by all its cells, so must not be written
+   CRWCellLayer* pGetCellLayers(int const nX, int const nY, int const nLayers) const
+   {
+      if (m_bCompact)
+         return m_pLayers;
+
+      return m_pLayers + ((((nY - m_nYMin) * (m_nXEnd - m_nXMin)) + (nX - m_nXMin)) * nLayers);
+   }
+};
+#endif // GRID_TILE_H
@@ -4,6 +4,11 @@ extern "C"
 {
     void CShore(int *);
 
+    void CShoreArrayOutSize(int*);        /* Out_nSize */
+
+    void CShoreSetDirectory(int const*,   /* In_nLength */
+                            char const*); /* In_strDirectory */
+
     void CShoreWrapper(int const*,        /* In_ILINE */
                        int const*,        /* In_IPROFL */
                        int const*,        /* In_IPERM */
@@ -34,5 +39,37 @@ extern "C"
                        double[],          /* Out_WaveSetupSurge */
                        double[],          /* Out_SinWaveAngleRadians */
                        double[]);         /* Out_FractionBreakingWaves */
+
+    void CShoreWrapperLines(int const*,       /* In_ILINE */
+                            int const*,       /* In_IPROFL */
+                            int const*,       /* In_IPERM */
+                            int const*,       /* In_IOVER */
+                            int const*,       /* In_IWCINT */
+                            int const*,       /* In_IROLL */
+                            int const*,       /* In_IWIND */
+                            int const*,       /* In_ITIDE */
+                            int const*,       /* In_ILAB */
+                            int const*,       /* In_NWAVE */
+                            int const*,       /* In_NSURG */
+                            double const[],   /* In_DX, one per line */
+                            double const*,    /* In_GAMMA */
+                            double[],         /* In_TWAVE */
+                            double[],         /* In_TPIN, In_NWAVE+1 per line */
+                            double[],         /* In_HRMSIN, In_NWAVE+1 per line */
+                            double[],         /* In_WANGIN, In_NWAVE+1 per line */
+                            double[],         /* In_TSURG */
+                            double[],         /* In_SWLIN */
+                            int const*,       /* In_NBINPMAX */
+                            int const[],      /* In_NBINP, one per line */
+                            double[],         /* In_XBINP, In_NBINPMAX per line */
+                            double[],         /* In_ZBINP, In_NBINPMAX per line */
+                            double[],         /* In_FBINP, In_NBINPMAX per line */
+                            int[],            /* Out_IError, one per line */
+                            int[],            /* Out_nOutSize, one per line */
+                            double[],         /* Out_XYDist, Out_nSize of CShoreArrayOutSize() per line */
+                            double[],         /* Out_FreeSurfaceStd, Out_nSize of CShoreArrayOutSize() per line */
+                            double[],         /* Out_WaveSetupSurge, Out_nSize of CShoreArrayOutSize() per line */
+                            double[],         /* Out_SinWaveAngleRadians, Out_nSize of CShoreArrayOutSize() per line */
+                            double[]);        /* Out_FractionBreakingWaves, Out_nSize of CShoreArrayOutSize() per line */
 }
 #endif // CShore_H
@@ -31,6 +31,9 @@ using std::to_string;
 using std::cerr;
 using std::endl;
 
+#include <algorithm>
+using std::fill;
+
 #include <gdal_priv.h>
 #include <gdal_alg.h>
 
@@ -53,12 +56,36 @@ int CSimulation::nInitGridAndCalcStillWaterLevel(void)
    m_VFloodWaveSetupSurgeRunup.clear();
    m_pVCoastPolygon.clear();
 
+   // The coasts' landforms and polygons have now been destroyed, so their memory can be reused this timestep
+   m_TimestepArena.Reset();
+
    // Do some every-timestep initialization
    m_nXMinBoundingBox = INT_MAX;
    m_nXMaxBoundingBox = INT_MIN;
    m_nYMinBoundingBox = INT_MAX;
    m_nYMaxBoundingBox = INT_MIN;
 
+   // Keep last timestep's active window, then start a new one. In the first timestep, there is no previous active window, so pretend that it covered the whole grid
+   if (m_ulIter == 1)
+   {
+      m_nXMinLastActiveWindow = 0;
+      m_nXMaxLastActiveWindow = m_nXGridMax - 1;
+      m_nYMinLastActiveWindow = 0;
+      m_nYMaxLastActiveWindow = m_nYGridMax - 1;
+   }
+   else
+   {
+      m_nXMinLastActiveWindow = m_nXMinActiveWindow;
+      m_nXMaxLastActiveWindow = m_nXMaxActiveWindow;
+      m_nYMinLastActiveWindow = m_nYMinActiveWindow;
+      m_nYMaxLastActiveWindow = m_nYMaxActiveWindow;
+   }
+
+   m_nXMinActiveWindow =
+   m_nYMinActiveWindow = INT_MAX;
+   m_nXMaxActiveWindow =
+   m_nYMaxActiveWindow = INT_MIN;
+
    m_ulThisIterNumSeaCells =
    m_ulThisIterNumCoastCells =
    m_ulThisIterNumPotentialPlatformErosionCells =
@@ -108,23 +135,27 @@ int CSimulation::nInitGridAndCalcStillWaterLevel(void)
    int nZeroThickness = 0;
    
    m_dStartIterSuspFineAllCells =
-   m_dStartIterSuspFineInPolygons =
-   m_dStartIterUnconsFineAllCells =
-   m_dStartIterUnconsSandAllCells =
-   m_dStartIterUnconsCoarseAllCells =
-   m_dStartIterConsFineAllCells =
-   m_dStartIterConsSandAllCells =
-   m_dStartIterConsCoarseAllCells = 0;
-
-   // And go through all cells in the RasterGrid array
-   for (int nX = 0; nX < m_nXGridMax; nX++)
+   m_dStartIterSuspFineInPolygons = 0;
+
+   // Re-initialize the per-timestep values for all cells, one field plane at a time
+   m_pRasterGrid->InitAllCells();
+
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+
+   if (m_bSingleDeepWaterWaveValues)
+   {
+      // If we have just a single measurement for deep water waves (either given by the user, or from a single wave station) then set all cells, even dry land cells, to the same value for deep water wave height, deep water wave orientation, and deep water period
+      fill(m_pRasterGrid->ptGetDiagField(CELL_DIAG_DEEP_WATER_WAVE_HEIGHT), m_pRasterGrid->ptGetDiagField(CELL_DIAG_DEEP_WATER_WAVE_HEIGHT) + ulNumCells, tToDiag(m_dAllCellsDeepWaterWaveHeight));
+      fill(m_pRasterGrid->ptGetDiagField(CELL_DIAG_DEEP_WATER_WAVE_ANGLE), m_pRasterGrid->ptGetDiagField(CELL_DIAG_DEEP_WATER_WAVE_ANGLE) + ulNumCells, tToDiag(m_dAllCellsDeepWaterWaveAngle));
+      fill(m_pRasterGrid->ptGetDiagField(CELL_DIAG_DEEP_WATER_WAVE_PERIOD), m_pRasterGrid->ptGetDiagField(CELL_DIAG_DEEP_WATER_WAVE_PERIOD) + ulNumCells, tToDiag(m_dAllCellsDeepWaterWavePeriod));
+   }
+
+   if (m_ulIter == 1)
    {
+      // Go through all cells in the RasterGrid array
       for (int nY = 0; nY < m_nYGridMax; nY++)
       {
-         // Re-initialize values for this cell
-         m_pRasterGrid->m_Cell[nX][nY].InitCell();
-
-         if (m_ulIter == 1)
+         for (int nX = 0; nX < m_nXGridMax; nX++)
          {
             // For the first timestep only, check to see that all cells have some sediment on them
             double dSedThickness = m_pRasterGrid->m_Cell[nX][nY].dGetTotAllSedThickness();
@@ -139,27 +170,64 @@ int CSimulation::nInitGridAndCalcStillWaterLevel(void)
             // For the first timestep only, calculate the elevation of all this cell's layers. During the rest of the simulation, each cell's elevation is re-calculated just after any change occurs on that cell
             m_pRasterGrid->m_Cell[nX][nY].CalcAllLayerElevsAndD50();
          }
-         
-         // Note that these totals include sediment which is both within and outside the polygons (because we have not yet defined polygons for this iteration, duh!)
-         m_dStartIterConsFineAllCells += m_pRasterGrid->m_Cell[nX][nY].dGetTotConsFineThickConsiderNotch();
-         m_dStartIterConsSandAllCells += m_pRasterGrid->m_Cell[nX][nY].dGetTotConsSandThickConsiderNotch();
-         m_dStartIterConsCoarseAllCells += m_pRasterGrid->m_Cell[nX][nY].dGetTotConsCoarseThickConsiderNotch();
-         
-         m_dStartIterSuspFineAllCells += m_pRasterGrid->m_Cell[nX][nY].dGetSuspendedSediment();
-         m_dStartIterUnconsFineAllCells += m_pRasterGrid->m_Cell[nX][nY].dGetTotUnconsFine();
-         m_dStartIterUnconsSandAllCells += m_pRasterGrid->m_Cell[nX][nY].dGetTotUnconsSand();
-         m_dStartIterUnconsCoarseAllCells += m_pRasterGrid->m_Cell[nX][nY].dGetTotUnconsCoarse();
-
-         if (m_bSingleDeepWaterWaveValues)
-         {
-            // If we have just a single measurement for deep water waves (either given by the user, or from a single wave station) then set all cells, even dry land cells, to the same value for deep water wave height, deep water wave orientation, and deep water period
-            m_pRasterGrid->m_Cell[nX][nY].SetCellDeepWaterWaveHeight(m_dAllCellsDeepWaterWaveHeight);
-            m_pRasterGrid->m_Cell[nX][nY].SetCellDeepWaterWaveAngle(m_dAllCellsDeepWaterWaveAngle);
-            m_pRasterGrid->m_Cell[nX][nY].SetCellDeepWaterWavePeriod(m_dAllCellsDeepWaterWavePeriod);
-         }
       }
    }
 
+   // Note that these totals include sediment which is both within and outside the polygons (because we have not yet defined polygons for this iteration, duh!). Suspended sediment is only changed by nUpdateGrid(), which totals it during its pass through the grid, so use last timestep's total if we have it. Otherwise (i.e. in the first timestep) total it one field plane at a time
+   if (m_bEndIterSuspFineAllCellsValid)
+      m_dStartIterSuspFineAllCells = m_dEndIterSuspFineAllCells;
+   else
+   {
+      double const* pdSuspSed = m_pRasterGrid->pdGetField(CELL_DBL_SUSP_SED);
+      for (unsigned long n = 0; n < ulNumCells; n++)
+         m_dStartIterSuspFineAllCells += pdSuspSed[n];
+   }
+   m_bEndIterSuspFineAllCellsValid = false;
+
+   // The other sediment totals only change on cells whose sediment has changed. So if the raster grid's list of these dirty cells is complete, just add the changes on the dirty cells to last timestep's totals. If it is not complete (e.g. in the first timestep), calculate the totals from every cell
+   double dTotals[NUM_SEDIMENT_TOTALS];
+   if (m_pRasterGrid->bDirtyCellsComplete())
+   {
+      m_pRasterGrid->SumDirtyCellSedimentChanges(dTotals);
+
+      m_dStartIterConsFineAllCells += dTotals[SEDIMENT_TOTAL_CONS_FINE];
+      m_dStartIterConsSandAllCells += dTotals[SEDIMENT_TOTAL_CONS_SAND];
+      m_dStartIterConsCoarseAllCells += dTotals[SEDIMENT_TOTAL_CONS_COARSE];
+
+      m_dStartIterUnconsFineAllCells += dTotals[SEDIMENT_TOTAL_UNCONS_FINE];
+      m_dStartIterUnconsSandAllCells += dTotals[SEDIMENT_TOTAL_UNCONS_SAND];
+      m_dStartIterUnconsCoarseAllCells += dTotals[SEDIMENT_TOTAL_UNCONS_COARSE];
+
+#if defined CME_CHECK_DIRTY_CELLS
+      CheckDirtyCellUpdates();
+#endif
+
+      // If wave propagation results may be reused, keep track of how much the bathymetry has changed since they were stored
+      if (m_nMaxWaveReuses > 0)
+         m_WaveCache.m_dBedChange += m_pRasterGrid->dGetMaxDirtyCellSedimentChange();
+   }
+   else
+   {
+      if ((m_ulIter > 1) && (m_nLogFileDetail >= LOG_FILE_ALL))
+         LogStream << m_ulIter << ": the sediment of a cell was changed without the cell being marked as dirty, so sediment totals are calculated from all cells" << endl;
+
+      m_pRasterGrid->SumAllCellsSedimentTotals(dTotals);
+
+      m_dStartIterConsFineAllCells = dTotals[SEDIMENT_TOTAL_CONS_FINE];
+      m_dStartIterConsSandAllCells = dTotals[SEDIMENT_TOTAL_CONS_SAND];
+      m_dStartIterConsCoarseAllCells = dTotals[SEDIMENT_TOTAL_CONS_COARSE];
+
+      m_dStartIterUnconsFineAllCells = dTotals[SEDIMENT_TOTAL_UNCONS_FINE];
+      m_dStartIterUnconsSandAllCells = dTotals[SEDIMENT_TOTAL_UNCONS_SAND];
+      m_dStartIterUnconsCoarseAllCells = dTotals[SEDIMENT_TOTAL_UNCONS_COARSE];
+
+      // We do not know how much the bathymetry has changed, so wave propagation results cannot be reused
+      m_WaveCache.Invalidate();
+   }
+
+   // The changes on last timestep's dirty cells have now been accounted for, so start a new dirty-cell list for this timestep
+   m_pRasterGrid->ClearDirtyCells();
+
    if (m_bHaveWaveStationData && (! m_bSingleDeepWaterWaveValues))
    {
       // Each cell's value for deep water wave height and deep water wave orientation is interpolated from multiple user-supplied values
@@ -312,3 +380,138 @@ int CSimulation::nInitGridAndCalcStillWaterLevel(void)
    
    return RTN_OK;
 }
+
+#if defined CME_CHECK_DIRTY_CELLS
+//===============================================================================================================================
+//! Debug check of the incremental per-timestep initialization: compares the sediment totals which were updated from the dirty cells with totals calculated from every cell, and checks that the per-timestep sediment change fields have been reset on every cell. Any mismatch is written to the log file
+//===============================================================================================================================
+void CSimulation::CheckDirtyCellUpdates(void)
+{
+   static int const nSedimentChangeFields[] = {CELL_DBL_ACTUAL_PLATFORM_EROSION, CELL_DBL_CLIFF_COLLAPSE_FINE, CELL_DBL_CLIFF_COLLAPSE_SAND, CELL_DBL_CLIFF_COLLAPSE_COARSE, CELL_DBL_TALUS_SAND_DEPOSITION, CELL_DBL_TALUS_COARSE_DEPOSITION, CELL_DBL_ACTUAL_BEACH_EROSION, CELL_DBL_BEACH_DEPOSITION};
+
+   double dTotals[NUM_SEDIMENT_TOTALS];
+   m_pRasterGrid->SumAllCellsSedimentTotals(dTotals);
+
+   double dIncremental[NUM_SEDIMENT_TOTALS];
+   dIncremental[SEDIMENT_TOTAL_CONS_FINE] = m_dStartIterConsFineAllCells;
+   dIncremental[SEDIMENT_TOTAL_CONS_SAND] = m_dStartIterConsSandAllCells;
+   dIncremental[SEDIMENT_TOTAL_CONS_COARSE] = m_dStartIterConsCoarseAllCells;
+   dIncremental[SEDIMENT_TOTAL_UNCONS_FINE] = m_dStartIterUnconsFineAllCells;
+   dIncremental[SEDIMENT_TOTAL_UNCONS_SAND] = m_dStartIterUnconsSandAllCells;
+   dIncremental[SEDIMENT_TOTAL_UNCONS_COARSE] = m_dStartIterUnconsCoarseAllCells;
+
+   for (int m = 0; m < NUM_SEDIMENT_TOTALS; m++)
+   {
+      if (! bFPIsEqual(dIncremental[m], dTotals[m], MASS_BALANCE_TOLERANCE))
+         LogStream << m_ulIter << ": " << WARN << "sediment total " << m << " updated from " << m_pRasterGrid->ulGetNumDirtyCells() << " dirty cells is " << dIncremental[m] << ", but calculated from all cells is " << dTotals[m] << endl;
+   }
+
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+   for (unsigned int n = 0; n < sizeof(nSedimentChangeFields) / sizeof(nSedimentChangeFields[0]); n++)
+   {
+      double const* pdField = m_pRasterGrid->pdGetField(nSedimentChangeFields[n]);
+      for (unsigned long ul = 0; ul < ulNumCells; ul++)
+      {
+         if (! bFPIsEqual(pdField[ul], 0.0, TOLERANCE))
+         {
+            LogStream << m_ulIter << ": " << WARN << "per-timestep sediment change field " << nSedimentChangeFields[n] << " was not reset on cell " << ul << ", which was not on the dirty-cell list" << endl;
+            break;
+         }
+      }
+   }
+}
+#endif
+
+//===============================================================================================================================
+//! Once the coastlines have been located for this timestep, classifies the raster grid's tiles. Tiles which are near a coastline are active, tiles which have been away from coastlines and profiles (and have had no sediment change) for long enough become uniform, and are skipped by the per-timestep sweeps. Uniform tiles whose cells all have identical layers are made compact. Also starts this timestep's active window
+//===============================================================================================================================
+void CSimulation::ClassifyGridTilesNearCoasts(void)
+{
+   m_pRasterGrid->IncrAllTilesQuietTimesteps();
+
+   for (int i = 0; i < static_cast<int>(m_VCoast.size()); i++)
+   {
+      for (int j = 0; j < m_VCoast[i].nGetCoastlineSize(); j++)
+      {
+         CGeom2DIPoint const* pPti = m_VCoast[i].pPtiGetCellMarkedAsCoastline(j);
+         m_pRasterGrid->SetTilesActiveAroundCell(pPti->nGetX(), pPti->nGetY());
+         ExpandActiveWindow(pPti->nGetX(), pPti->nGetY());
+      }
+   }
+
+   // Uniform tiles whose cells all have the same layers need hold only one cell's layers
+   unsigned long ulNewlyCompact = m_pRasterGrid->ulCompactUniformTiles();
+
+   if (m_nLogFileDetail >= LOG_FILE_ALL)
+      LogStream << m_ulIter << ": " << m_pRasterGrid->ulCountUniformTiles() << " of " << m_pRasterGrid->nGetNumTiles() << " grid tiles are uniform, " << m_pRasterGrid->ulCountCompactTiles() << " are compact (" << ulNewlyCompact << " newly compact)" << endl;
+}
+
+//===============================================================================================================================
+//! Once the coastline-normal profiles have been created for this timestep, marks the tiles along each profile as active i.e. swept in full, and extends the active window to include each profile
+//===============================================================================================================================
+void CSimulation::SetGridTilesActiveAlongProfiles(void)
+{
+   for (int i = 0; i < static_cast<int>(m_VCoast.size()); i++)
+   {
+      for (int j = 0; j < m_VCoast[i].nGetNumProfiles(); j++)
+      {
+         CGeomProfile* pProfile = m_VCoast[i].pGetProfile(j);
+         for (int k = 0; k < pProfile->nGetNumCellsInProfile(); k++)
+         {
+            CGeom2DIPoint const* pPti = pProfile->pPtiGetCellInProfile(k);
+            m_pRasterGrid->SetTilesActiveAroundCell(pPti->nGetX(), pPti->nGetY());
+            ExpandActiveWindow(pPti->nGetX(), pPti->nGetY());
+         }
+      }
+   }
+}
+
+//===============================================================================================================================
+//! Extends this timestep's active window to include a cell. The active window is the bounding box of the cells on which this timestep's coastal processes act: coastline cells, profile and parallel profile cells, and shadow zone and downdrift zone cells. Polygons lie within the coastline and profile cells which bound them
+//===============================================================================================================================
+void CSimulation::ExpandActiveWindow(int const nX, int const nY)
+{
+   if (nX < m_nXMinActiveWindow)
+      m_nXMinActiveWindow = nX;
+
+   if (nX > m_nXMaxActiveWindow)
+      m_nXMaxActiveWindow = nX;
+
+   if (nY < m_nYMinActiveWindow)
+      m_nYMinActiveWindow = nY;
+
+   if (nY > m_nYMaxActiveWindow)
+      m_nYMaxActiveWindow = nY;
+}
+
+//===============================================================================================================================
+//! Gets the active window, widened by ACTIVE_WINDOW_MARGIN cells and clipped to the raster grid, as the first cell and one past the last cell in each direction. If bIncludeLast is true, the window also includes last timestep's active window. If the window is empty, nXEnd equals nXMin and nYEnd equals nYMin
+//===============================================================================================================================
+void CSimulation::GetActiveWindow(bool const bIncludeLast, int& nXMin, int& nXEnd, int& nYMin, int& nYEnd) const
+{
+   int
+      nXMinWindow = m_nXMinActiveWindow,
+      nXMaxWindow = m_nXMaxActiveWindow,
+      nYMinWindow = m_nYMinActiveWindow,
+      nYMaxWindow = m_nYMaxActiveWindow;
+
+   if (bIncludeLast)
+   {
+      nXMinWindow = tMin(nXMinWindow, m_nXMinLastActiveWindow);
+      nXMaxWindow = tMax(nXMaxWindow, m_nXMaxLastActiveWindow);
+      nYMinWindow = tMin(nYMinWindow, m_nYMinLastActiveWindow);
+      nYMaxWindow = tMax(nYMaxWindow, m_nYMaxLastActiveWindow);
+   }
+
+   if ((nXMinWindow > nXMaxWindow) || (nYMinWindow > nYMaxWindow))
+   {
+      // Empty window
+      nXMin = nXEnd = nYMin = nYEnd = 0;
+      return;
+   }
+
+   nXMin = tMax(nXMinWindow - ACTIVE_WINDOW_MARGIN, 0);
+   nXEnd = tMin(nXMaxWindow + ACTIVE_WINDOW_MARGIN + 1, m_nXGridMax);
+   nYMin = tMax(nYMinWindow - ACTIVE_WINDOW_MARGIN, 0);
+   nYEnd = tMin(nYMaxWindow + ACTIVE_WINDOW_MARGIN + 1, m_nYGridMax);
+}
@@ -120,16 +120,16 @@ int nFindIndex(vector<double> const* pVdX, double const dValueIn)
 }
 
 //===============================================================================================================================
-//! Returns a linarly interpolated vector of doubles, to make CShore profile output compatible with CME. The array pVdY has been output by CShore and so always has length CSHOREARRAYOUTSIZE, whereas all other arrays have sizes which depend on CME at runtime
+//! Linearly interpolates a vector of doubles, to make CShore profile output compatible with CME. The interpolated values are put in pVdYNew, which is resized to fit and so keeps its memory if it is reused. The array pVdY has been output by CShore and so has as many values as CShore outputs for each profile, whereas all other arrays have sizes which depend on CME at runtime
 //===============================================================================================================================
-vector<double> VdInterpolateCShoreProfileOutput(vector<double> const* pVdX, vector<double> const* pVdY, vector<double> const* pVdXNew)
+void InterpolateCShoreProfileOutput(vector<double> const* pVdX, vector<double> const* pVdY, vector<double> const* pVdXNew, vector<double>* pVdYNew)
 {
    int nXSize = static_cast<int>(pVdX->size());
    int nXNewSize = static_cast<int>(pVdXNew->size());
 
    double dX;
    double dY;
-   vector<double> VdYNew(nXNewSize, 0.0);
+   pVdYNew->resize(nXNewSize);
 
    for (int i = 0; i < nXNewSize; ++i)
    {
@@ -169,9 +169,7 @@ vector<double> VdInterpolateCShoreProfileOutput(vector<double> const* pVdX, vect
       double dM = dY / dX;
       double dB = pVdY->at(idx) - pVdX->at(idx) * dM;
 
-      VdYNew[i] = (pVdXNew->at(i) * dM) + dB;
+      pVdYNew->at(i) = (pVdXNew->at(i) * dM) + dB;
    }
-
-   return VdYNew;
 }
 
@@ -25,5 +25,5 @@ You should have received a copy of the GNU General Public License along with thi
 double dGetInterpolatedValue(vector<double> const*, vector<double> const*, double, bool);
 double dGetInterpolatedValue(vector<int> const*, vector<double> const*, int, bool);
 int nFindIndex(vector<double> const*, double const);
-vector<double> VdInterpolateCShoreProfileOutput(vector<double> const*, vector<double> const*, vector<double> const*);
+void InterpolateCShoreProfileOutput(vector<double> const*, vector<double> const*, vector<double> const*, vector<double>*);
 #endif // INTERPOLATE_H
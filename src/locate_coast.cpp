@@ -43,6 +43,9 @@ using std::to_string;
 #include <stack>
 using std::stack;
 
+#include <algorithm>
+using std::fill;
+
 #include "cme.h"
 #include "i_line.h"
 #include "line.h"
@@ -50,16 +53,39 @@ using std::stack;
 #include "raster_grid.h"
 #include "coast.h"
 
+//! Indexed by flood level (0 is wave setup plus surge, 1 is wave setup plus surge plus run-up): the flag plane which marks cells already checked during the flood fill. Each level has its own flag planes, so that both levels can be located at the same time
+static int const nFloodCheckFlag[2] = {CELL_FLAG_CHECK_FLOOD, CELL_FLAG_CHECK_FLOOD_RUNUP};
+
+//! Indexed by flood level: the flag plane which marks flooded cells which are connected to a grid edge
+static int const nInContiguousFloodFlag[2] = {CELL_FLAG_IN_CONTIGUOUS_FLOOD, CELL_FLAG_IN_CONTIGUOUS_FLOOD_RUNUP};
+
+//! Indexed by flood level: the flag plane which marks cells under the flood line
+static int const nFloodLineFlag[2] = {CELL_FLAG_FLOOD_LINE, CELL_FLAG_FLOOD_LINE_RUNUP};
+
+//! Indexed by flood level: the flag plane which marks possible flood line start cells
+static int const nPossibleFloodStartFlag[2] = {CELL_FLAG_POSSIBLE_FLOOD_START, CELL_FLAG_POSSIBLE_FLOOD_START_RUNUP};
+
 //===============================================================================================================================
 //! First find all connected sea areas, then locate the vector coastline(s), then put these onto the raster grid
 //===============================================================================================================================
 int CSimulation::nLocateSeaAndCoasts(int &nValidCoast)
 {
+   int nRet;
+   unsigned long ulNumIncrementalSeaFills = m_ulNumIncrementalSeaFills;
+
    // Find all connected sea cells
    FindAllSeaCells();
 
+   // If we are testing, and the sea mask was updated incrementally, check it against the sea mask found from scratch
+   if (m_bCheckOptimisations && (m_ulNumIncrementalSeaFills > ulNumIncrementalSeaFills))
+   {
+      nRet = nCheckSeaMask();
+      if (nRet != RTN_OK)
+         return nRet;
+   }
+
    // Find every coastline on the raster grid, mark raster cells, then create the vector coastline
-   int nRet = nTraceAllCoasts(nValidCoast);
+   nRet = nTraceAllCoasts(nValidCoast);
    if (nRet != RTN_OK)
       return nRet;
 
@@ -74,38 +100,241 @@ int CSimulation::nLocateSeaAndCoasts(int &nValidCoast)
 }
 
 //===============================================================================================================================
-//! Finds and flags all sea areas which have at least one cell at a grid edge (i.e. does not flag 'inland' seas)
+//! Finds and flags all sea areas which have at least one cell at a grid edge (i.e. does not flag 'inland' seas). The sea mask found last timestep is kept, and if possible is updated incrementally around the cells whose inundation state has changed (because of a change in SWL or in elevation). If this is not possible, e.g. if a change could have altered the connectivity of the sea as a whole, the whole sea is re-flooded from the edge cells
 //===============================================================================================================================
 void CSimulation::FindAllSeaCells(void)
 {
+   bool bFirstTime = m_VucSeaMask.empty();
+   if (bFirstTime)
+   {
+      // First time here, so create the per-cell arrays, and flag the edge cells from which a flood fill may start
+      unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+      m_VucSeaFillStartCell.assign(ulNumCells, 0);
+      m_VucInundation.assign(ulNumCells, 0);
+      m_VucLastInundation.assign(ulNumCells, 0);
+      m_VucSeaMask.assign(ulNumCells, 0);
+
+      for (unsigned int n = 0; n < m_VEdgeCell.size(); n++)
+      {
+         if (m_bOmitSearchNorthEdge && m_VEdgeCellEdge[n] == NORTH)
+            continue;
+
+         if (m_bOmitSearchSouthEdge && m_VEdgeCellEdge[n] == SOUTH)
+            continue;
+
+         if (m_bOmitSearchWestEdge && m_VEdgeCellEdge[n] == WEST)
+            continue;
+
+         if (m_bOmitSearchEastEdge && m_VEdgeCellEdge[n] == EAST)
+            continue;
+
+         m_VucSeaFillStartCell[m_pRasterGrid->ulGetCellIndex(m_VEdgeCell[n].nGetX(), m_VEdgeCell[n].nGetY())] = 1;
+      }
+   }
+   else
+   {
+      // Keep last timestep's inundation state, so that we can find the cells which have changed
+      m_VucLastInundation.swap(m_VucInundation);
+   }
+
+   // Evaluate the inundation test for every cell, in bulk a row at a time. This does not change during the flood fill, since only the sea depth is altered
+   m_pRasterGrid->GetInundation(m_dThisIterSWL, &m_VucInundation[0]);
+
+   if (bFirstTime || (! bUpdateSeaMaskIncrementally()))
+   {
+      // We must re-flood the whole sea
+      FloodFillSeaFromEdges();
+
+      m_ulNumFullSeaFills++;
+   }
+   else
+   {
+      m_ulNumIncrementalSeaFills++;
+   }
+
+   // Now that we know which cells are sea, set this timestep's values for them
+   SetSeaCellsFromMask();
+}
+
+//===============================================================================================================================
+//! Finds the sea mask from scratch, by flood-filling from every edge cell which is below SWL
+//===============================================================================================================================
+void CSimulation::FloodFillSeaFromEdges(void)
+{
+   fill(m_VucSeaMask.begin(), m_VucSeaMask.end(), 0);
+
    // Go along the list of edge cells
    for (unsigned int n = 0; n < m_VEdgeCell.size(); n++)
    {
-      if (m_bOmitSearchNorthEdge && m_VEdgeCellEdge[n] == NORTH)
-         continue;
+      int nX = m_VEdgeCell[n].nGetX();
+      int nY = m_VEdgeCell[n].nGetY();
+      unsigned long ulIndex = m_pRasterGrid->ulGetCellIndex(nX, nY);
 
-      if (m_bOmitSearchSouthEdge && m_VEdgeCellEdge[n] == SOUTH)
-         continue;
+      if (m_VucSeaFillStartCell[ulIndex] && (m_VucInundation[ulIndex] & INUNDATION_WET) && (m_VucSeaMask[ulIndex] == 0))
+         // This edge cell is below SWL and has not yet been flooded
+         FloodFillSea(nX, nY);
+   }
+}
 
-      if (m_bOmitSearchWestEdge && m_VEdgeCellEdge[n] == WEST)
+//===============================================================================================================================
+//! Updates last timestep's sea mask to reflect the cells whose inundation state has changed since then. Sea cells which are no longer inundated are removed from the sea mask, and the sea is flood-filled from cells which are newly inundated and which touch the sea. Returns false if the sea mask cannot safely be updated in this way, i.e. if connectivity might have changed globally: the sea mask must then be found again from scratch
+//===============================================================================================================================
+bool CSimulation::bUpdateSeaMaskIncrementally(void)
+{
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+   unsigned long ulMaxChanged = static_cast<unsigned long>(SEA_MASK_MAX_CHANGED_FRACTION * static_cast<double>(ulNumCells));
+
+   // Find the cells whose inundation state has changed
+   m_VulInundationChanged.clear();
+   for (unsigned long n = 0; n < ulNumCells; n++)
+   {
+      if (m_VucInundation[n] == m_VucLastInundation[n])
          continue;
 
-      if (m_bOmitSearchEastEdge && m_VEdgeCellEdge[n] == EAST)
+      // A change on a cell from which the flood fill may start can connect or disconnect a whole sea area, and if many cells have changed then it is quicker to re-flood the whole sea
+      if (m_VucSeaFillStartCell[n] || (m_VulInundationChanged.size() >= ulMaxChanged))
+      {
+         if (m_nLogFileDetail >= LOG_FILE_ALL)
+            LogStream << m_ulIter << ": sea is re-flooded from the grid edges, since " << (m_VucSeaFillStartCell[n] ? "the inundation state of an edge cell has changed" : "the inundation state of many cells has changed") << endl;
+
+         return false;
+      }
+
+      m_VulInundationChanged.push_back(n);
+   }
+
+   // First shrink the sea: remove sea cells which are no longer inundated, provided that this cannot split the sea
+   for (unsigned int n = 0; n < m_VulInundationChanged.size(); n++)
+   {
+      unsigned long ulIndex = m_VulInundationChanged[n];
+      if ((m_VucSeaMask[ulIndex] == 0) || (m_VucInundation[ulIndex] == INUNDATION_WET))
          continue;
 
-      int nX = m_VEdgeCell[n].nGetX();
-      int nY = m_VEdgeCell[n].nGetY();
+      int nX = static_cast<int>(ulIndex % m_nXGridMax);
+      int nY = static_cast<int>(ulIndex / m_nXGridMax);
+      if (! bCanRemoveFromSeaMask(nX, nY))
+      {
+         if (m_nLogFileDetail >= LOG_FILE_ALL)
+            LogStream << m_ulIter << ": sea is re-flooded from the grid edges, since [" << nX << "][" << nY << "] = {" << dGridCentroidXToExtCRSX(nX) << ", " << dGridCentroidYToExtCRSY(nY) << "} is no longer inundated and may have split the sea" << endl;
+
+         return false;
+      }
 
-      // if ((m_pRasterGrid->m_Cell[nX][nY].bIsInundated()) && (m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth() == 0))
-      if ((m_pRasterGrid->m_Cell[nX][nY].bIsInundated()) && (bFPIsEqual(m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth(), 0.0, TOLERANCE)))
+      m_VucSeaMask[ulIndex] = 0;
+   }
 
-         // This edge cell is below SWL and sea depth remains set to zero
+   // Then grow the sea: flood fill from each newly-inundated cell which touches the sea. This also floods any 'inland' sea which is now connected to the sea
+   for (unsigned int n = 0; n < m_VulInundationChanged.size(); n++)
+   {
+      unsigned long ulIndex = m_VulInundationChanged[n];
+      if ((m_VucSeaMask[ulIndex] != 0) || (m_VucInundation[ulIndex] != INUNDATION_WET))
+         continue;
+
+      int nX = static_cast<int>(ulIndex % m_nXGridMax);
+      int nY = static_cast<int>(ulIndex / m_nXGridMax);
+      if (((nX > 0) && m_VucSeaMask[ulIndex - 1]) || ((nX < m_nXGridMax-1) && m_VucSeaMask[ulIndex + 1]) || ((nY > 0) && m_VucSeaMask[ulIndex - m_nXGridMax]) || ((nY < m_nYGridMax-1) && m_VucSeaMask[ulIndex + m_nXGridMax]))
          FloodFillSea(nX, nY);
    }
+
+   return true;
+}
+
+//===============================================================================================================================
+//! Returns true if the sea cell at [nX][nY] can be removed from the sea mask without splitting the sea. This is a local test: it is true if the cell's sea neighbours (the flood fill uses the four orthogonal neighbours) are all connected to one another via the other sea cells in the cell's 3x3 neighbourhood. If it is false, the sea may or may not be split
+//===============================================================================================================================
+bool CSimulation::bCanRemoveFromSeaMask(int const nX, int const nY) const
+{
+   // The cell's eight neighbours, going round clockwise from the north-west. The odd-numbered neighbours are the orthogonal neighbours, and each neighbour is orthogonally adjacent to the next
+   static int const nXOffset[8] = {-1, 0, 1, 1, 1, 0, -1, -1};
+   static int const nYOffset[8] = {-1, -1, -1, 0, 1, 1, 1, 0};
+
+   bool bSea[8];
+   int nNotSea = -1;
+   for (int n = 0; n < 8; n++)
+   {
+      int nXNeighbour = nX + nXOffset[n];
+      int nYNeighbour = nY + nYOffset[n];
+
+      bSea[n] = (nXNeighbour >= 0) && (nXNeighbour < m_nXGridMax) && (nYNeighbour >= 0) && (nYNeighbour < m_nYGridMax) && m_VucSeaMask[m_pRasterGrid->ulGetCellIndex(nXNeighbour, nYNeighbour)];
+
+      if (! bSea[n])
+         nNotSea = n;
+   }
+
+   // If every neighbour is sea, they are all connected
+   if (nNotSea < 0)
+      return true;
+
+   // Go round the neighbours, starting just after a neighbour which is not sea, and count the runs of sea neighbours which include an orthogonal neighbour
+   int nRuns = 0;
+   bool bInRun = false;
+   bool bRunHasOrthogonal = false;
+   for (int m = 1; m <= 8; m++)
+   {
+      int n = (nNotSea + m) % 8;
+      if (bSea[n])
+      {
+         bInRun = true;
+         if (n % 2)
+            bRunHasOrthogonal = true;
+      }
+      else
+      {
+         if (bInRun && bRunHasOrthogonal)
+            nRuns++;
+
+         bInRun = false;
+         bRunHasOrthogonal = false;
+      }
+   }
+
+   return (nRuns <= 1);
 }
 
 //===============================================================================================================================
-//! Flood-fills all sea cells starting from a given cell. The flood fill code used here is adapted from an example by Lode Vandevenne (http://lodev.org/cgtutor/floodfill.html#Scanline_Floodfill_Algorithm_With_Stack)
+//! Sets this timestep's values for every cell in the sea mask, and finds the bounding box of the sea. This is done a row at a time
+//===============================================================================================================================
+void CSimulation::SetSeaCellsFromMask(void)
+{
+   for (int nY = 0; nY < m_nYGridMax; nY++)
+   {
+      unsigned char const* pucMaskRow = &m_VucSeaMask[m_pRasterGrid->ulGetCellIndex(0, nY)];
+      for (int nX = 0; nX < m_nXGridMax; nX++)
+      {
+         if (! pucMaskRow[nX])
+            continue;
+
+         // Set the sea depth for this cell
+         m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth(m_dThisIterSWL);
+
+         // Mark as sea
+         m_pRasterGrid->m_Cell[nX][nY].SetInContiguousSea();
+         m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->SetLFCategory(LF_CAT_SEA);
+
+         // Set this sea cell to have deep water (off-shore) wave orientation and height, will change this later for cells closer to the shoreline if we have on-shore waves
+         m_pRasterGrid->m_Cell[nX][nY].SetWaveValuesToDeepWaterWaveValues();
+
+         // Now sort out the x-y extremities of the contiguous sea for the bounding box (used later in wave propagation)
+         if (nX < m_nXMinBoundingBox)
+            m_nXMinBoundingBox = nX;
+
+         if (nX > m_nXMaxBoundingBox)
+            m_nXMaxBoundingBox = nX;
+
+         if (nY < m_nYMinBoundingBox)
+            m_nYMinBoundingBox = nY;
+
+         if (nY > m_nYMaxBoundingBox)
+            m_nYMaxBoundingBox = nY;
+
+         // Update count
+         m_ulThisIterNumSeaCells++;
+      }
+   }
+}
+
+//===============================================================================================================================
+//! Flood-fills the sea mask starting from a given cell, using the inundation state of each cell as evaluated by CGeomRasterGrid::GetInundation(). Cells which are already in the sea mask are not visited again. The flood fill code used here is adapted from an example by Lode Vandevenne (http://lodev.org/cgtutor/floodfill.html#Scanline_Floodfill_Algorithm_With_Stack)
 //===============================================================================================================================
 void CSimulation::FloodFillSea(int const nXStart, int const nYStart)
 {
@@ -115,7 +344,7 @@ void CSimulation::FloodFillSea(int const nXStart, int const nYStart)
    // Create an empty stack
    stack<CGeom2DIPoint> PtiStack;
 
-   // Start at the given edge cell, push this onto the stack
+   // Start at the given cell, push this onto the stack
    PtiStack.push(CGeom2DIPoint(nXStart, nYStart));
 
    // Then do the flood fill loop until there are no more cell co-ordinates on the stack
@@ -132,7 +361,16 @@ void CSimulation::FloodFillSea(int const nXStart, int const nYStart)
       int nX = Pti.nGetX();
       int nY = Pti.nGetY();
 
-      while ((nX >= 0) && (! m_pRasterGrid->m_Cell[nX][nY].bBasementElevIsMissingValue()) && (m_pRasterGrid->m_Cell[nX][nY].bIsInundated()))
+      // The inundation state of this row, and of the rows above and below. A cell is sea if its state is exactly INUNDATION_WET, i.e. it is inundated and does not have NODATA basement
+      unsigned long ulRowStart = m_pRasterGrid->ulGetCellIndex(0, nY);
+      unsigned char const* pucRow = &m_VucInundation[ulRowStart];
+      unsigned char const* pucRowAbove = (nY > 0) ? pucRow - m_nXGridMax : NULL;
+      unsigned char const* pucRowBelow = (nY < m_nYGridMax-1) ? pucRow + m_nXGridMax : NULL;
+      unsigned char* pucMaskRow = &m_VucSeaMask[ulRowStart];
+      unsigned char const* pucMaskRowAbove = (nY > 0) ? pucMaskRow - m_nXGridMax : NULL;
+      unsigned char const* pucMaskRowBelow = (nY < m_nYGridMax-1) ? pucMaskRow + m_nXGridMax : NULL;
+
+      while ((nX >= 0) && (pucRow[nX] == INUNDATION_WET) && (pucMaskRow[nX] == 0))
          nX--;
 
       nX++;
@@ -140,50 +378,28 @@ void CSimulation::FloodFillSea(int const nXStart, int const nYStart)
       bool bSpanAbove = false;
       bool bSpanBelow = false;
 
-      while ((nX < m_nXGridMax) && (! m_pRasterGrid->m_Cell[nX][nY].bBasementElevIsMissingValue()) && (m_pRasterGrid->m_Cell[nX][nY].bIsInundated()) && (bFPIsEqual(m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth(), 0.0, TOLERANCE)))
+      while ((nX < m_nXGridMax) && (pucRow[nX] == INUNDATION_WET) && (pucMaskRow[nX] == 0))
       {
-         // Set the sea depth for this cell
-         m_pRasterGrid->m_Cell[nX][nY].SetSeaDepth();
-
          // Mark as sea
-         m_pRasterGrid->m_Cell[nX][nY].SetInContiguousSea();
-         m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->SetLFCategory(LF_CAT_SEA);
-
-         // Set this sea cell to have deep water (off-shore) wave orientation and height, will change this later for cells closer to the shoreline if we have on-shore waves
-         m_pRasterGrid->m_Cell[nX][nY].SetWaveValuesToDeepWaterWaveValues();
-
-         // Now sort out the x-y extremities of the contiguous sea for the bounding box (used later in wave propagation)
-         if (nX < m_nXMinBoundingBox)
-            m_nXMinBoundingBox = nX;
-
-         if (nX > m_nXMaxBoundingBox)
-            m_nXMaxBoundingBox = nX;
-
-         if (nY < m_nYMinBoundingBox)
-            m_nYMinBoundingBox = nY;
-
-         if (nY > m_nYMaxBoundingBox)
-            m_nYMaxBoundingBox = nY;
+         pucMaskRow[nX] = 1;
 
-         // Update count
-         m_ulThisIterNumSeaCells++;
-         
-         if ((! bSpanAbove) && (nY > 0) && (! m_pRasterGrid->m_Cell[nX][nY-1].bBasementElevIsMissingValue()) && (m_pRasterGrid->m_Cell[nX][nY-1].bIsInundated()))
+         // Cells with NODATA basement neither start nor end a span, cells which are already sea end a span
+         if ((! bSpanAbove) && (pucRowAbove != NULL) && (pucRowAbove[nX] == INUNDATION_WET) && (pucMaskRowAbove[nX] == 0))
          {
             PtiStack.push(CGeom2DIPoint(nX, nY-1));
             bSpanAbove = true;
          }
-         else if (bSpanAbove && (nY > 0) && (! m_pRasterGrid->m_Cell[nX][nY-1].bBasementElevIsMissingValue()) && (! m_pRasterGrid->m_Cell[nX][nY-1].bIsInundated()))
+         else if (bSpanAbove && (pucRowAbove != NULL) && ((pucRowAbove[nX] == 0) || pucMaskRowAbove[nX]))
          {
             bSpanAbove = false;
          }
 
-         if ((! bSpanBelow) && (nY < m_nYGridMax-1) && (! m_pRasterGrid->m_Cell[nX][nY+1].bBasementElevIsMissingValue()) && (m_pRasterGrid->m_Cell[nX][nY+1].bIsInundated()))
+         if ((! bSpanBelow) && (pucRowBelow != NULL) && (pucRowBelow[nX] == INUNDATION_WET) && (pucMaskRowBelow[nX] == 0))
          {
             PtiStack.push(CGeom2DIPoint(nX, nY+1));
             bSpanBelow = true;
          }
-         else if (bSpanBelow && (nY < m_nYGridMax-1) && (! m_pRasterGrid->m_Cell[nX][nY+1].bBasementElevIsMissingValue()) && (! m_pRasterGrid->m_Cell[nX][nY+1].bIsInundated()))
+         else if (bSpanBelow && (pucRowBelow != NULL) && ((pucRowBelow[nX] == 0) || pucMaskRowBelow[nX]))
          {
             bSpanBelow = false;
          }
@@ -273,6 +489,9 @@ int CSimulation::nTraceAllCoasts(int &nValidCoast)
    vector<int> VnSearchDirection;
    vector<CGeom2DIPoint> V2DIPossibleStartCell;
 
+   // Each coast which is traced this timestep will be kept for next timestep
+   m_VNewCoastHistory.clear();
+
    // Go along the list of edge cells and look for possible coastline start cells
    for (unsigned int n = 0; n < m_VEdgeCell.size() - 1; n++)
    {
@@ -357,6 +576,9 @@ int CSimulation::nTraceAllCoasts(int &nValidCoast)
       }
    }
 
+   // This timestep's coasts replace last timestep's
+   m_VCoastHistory.swap(m_VNewCoastHistory);
+
    if (nValidCoast > 0)
       return RTN_OK;
    else
@@ -915,11 +1137,62 @@ int CSimulation::nTraceCoastLine(unsigned int const nTraceFromStartCellIndex, in
       LTempExtCRS.Append(dGridCentroidXToExtCRSX(ILTempGridCRS[j].nGetX()), dGridCentroidYToExtCRSY(ILTempGridCRS[j].nGetY()));
    }
 
-   // Now do some smoothing of the vector output, if desired
-   if (m_nCoastSmooth == SMOOTH_RUNNING_MEAN)
-      LTempExtCRS = LSmoothCoastRunningMean(&LTempExtCRS);
-   else if (m_nCoastSmooth == SMOOTH_SAVITZKY_GOLAY)
-      LTempExtCRS = LSmoothCoastSavitzkyGolay(&LTempExtCRS, nStartEdge, nEndEdge);
+   // Was this coast also traced last timestep? If so, and if it still starts and ends at the same edges, then we only need to smooth the part of it which has changed
+   CCoastHistory* pOldHistory = NULL;
+   for (unsigned int n = 0; n < m_VCoastHistory.size(); n++)
+   {
+      if (m_VCoastHistory[n].bIsSameCoast(&ILTempGridCRS[0], nHandedness) && m_VCoastHistory[n].bHasSameEdges(nStartEdge, nEndEdge))
+      {
+         pOldHistory = &m_VCoastHistory[n];
+         break;
+      }
+   }
+
+   int nPrefix = 0;
+   int nSuffix = 0;
+   int nOffset = 0;
+   if (pOldHistory != NULL)
+   {
+      pOldHistory->FindCommonPoints(&ILTempGridCRS, nPrefix, nSuffix);
+      nOffset = nCoastSize - pOldHistory->nGetSize();
+   }
+
+   bool bUnchanged = ((pOldHistory != NULL) && (nOffset == 0) && (nPrefix == nCoastSize));
+
+   // Now do some smoothing of the vector output, if desired. A smoothed point depends only on the unsmoothed points within half a smoothing window of it, so if all of these are in the leading or trailing run of points which are the same as last timestep, the smoothed point is copied from last timestep's coast
+   int nHalfWindow = (m_nCoastSmooth == SMOOTH_NONE ? 0 : m_nCoastSmoothWindow / 2);
+   int nFirstChanged = nCoastSize;
+   int nLastChanged = -1;
+   CGeomLine LSmoothExtCRS;
+   LSmoothExtCRS.Resize(nCoastSize);
+   for (int j = 0; j < nCoastSize; j++)
+   {
+      if (bUnchanged || ((pOldHistory != NULL) && (j + nHalfWindow < nPrefix)))
+         LSmoothExtCRS[j] = *pOldHistory->pPtGetCoastlinePointExtCRS(j);
+      else if ((pOldHistory != NULL) && (j - nHalfWindow >= nCoastSize - nSuffix) && (j - nOffset >= nHalfWindow))
+         LSmoothExtCRS[j] = *pOldHistory->pPtGetCoastlinePointExtCRS(j - nOffset);
+      else
+      {
+         if (m_nCoastSmooth == SMOOTH_RUNNING_MEAN)
+            LSmoothExtCRS[j] = PtSmoothCoastPointRunningMean(&LTempExtCRS, j);
+         else if (m_nCoastSmooth == SMOOTH_SAVITZKY_GOLAY)
+            LSmoothExtCRS[j] = PtSmoothCoastPointSavitzkyGolay(&LTempExtCRS, j, nStartEdge, nEndEdge);
+         else
+            LSmoothExtCRS[j] = LTempExtCRS[j];
+
+         nFirstChanged = tMin(nFirstChanged, j);
+         nLastChanged = j;
+      }
+   }
+
+   LTempExtCRS = LSmoothExtCRS;
+
+   if ((! bUnchanged) && (nFirstChanged > nLastChanged))
+   {
+      // No point was smoothed, so points have only been inserted or removed, immediately after the leading run of unchanged points
+      nFirstChanged = nPrefix;
+      nLastChanged = nPrefix - 1;
+   }
 
    //    // DEBUG CODE ==================================
    //    LogStream << "==================================" << endl;
@@ -960,6 +1233,7 @@ int CSimulation::nTraceCoastLine(unsigned int const nTraceFromStartCellIndex, in
    m_VCoast[nCoast].SetSeaHandedness(nHandedness);
    m_VCoast[nCoast].SetStartEdge(nStartEdge);
    m_VCoast[nCoast].SetEndEdge(nEndEdge);
+   m_VCoast[nCoast].SetChangedRange(nFirstChanged, nLastChanged, nOffset);
 
    if (m_nLogFileDetail >= LOG_FILE_HIGH_DETAIL)
    {
@@ -990,8 +1264,25 @@ int CSimulation::nTraceCoastLine(unsigned int const nTraceFromStartCellIndex, in
    //       LogStream << kk << " [" << m_VCoast.back().pPtiGetCellMarkedAsCoastline(kk)->nGetX() << "][" << m_VCoast.back().pPtiGetCellMarkedAsCoastline(kk)->nGetY() << "] = {" << dGridCentroidXToExtCRSX(m_VCoast.back().pPtiGetCellMarkedAsCoastline(kk)->nGetX()) << ", " << dGridCentroidYToExtCRSY(m_VCoast.back().pPtiGetCellMarkedAsCoastline(kk)->nGetY()) << "}" << endl;
    //    LogStream << "-----------------" << endl;
 
+   // Keep the unsmoothed and smoothed coastline for next timestep, together with the record of where profiles were last placed on this coast
+   m_VNewCoastHistory.push_back(CCoastHistory(nHandedness, nStartEdge, nEndEdge, &ILTempGridCRS, &LTempExtCRS));
+   if (pOldHistory != NULL)
+      m_VNewCoastHistory.back().CopyProfilePlacement(pOldHistory);
+
    // Next calculate the curvature of the vector coastline
-   DoCoastCurvature(nCoast, nHandedness);
+   DoCoastCurvature(nCoast, nHandedness, pOldHistory, &m_VNewCoastHistory.back());
+
+   if (m_nLogFileDetail >= LOG_FILE_ALL)
+   {
+      LogStream << m_ulIter << ": Coast " << nCoast;
+      if (pOldHistory == NULL)
+         LogStream << " not found last timestep, all " << nCoastSize << " points smoothed";
+      else if (m_VCoast[nCoast].bIsUnchanged())
+         LogStream << " unchanged since last timestep";
+      else
+         LogStream << " points " << m_VCoast[nCoast].nGetFirstChangedPoint() << " to " << m_VCoast[nCoast].nGetLastChangedPoint() << " of " << nCoastSize << " changed since last timestep (" << nPrefix << " leading and " << nSuffix << " trailing cells unchanged)";
+      LogStream << endl;
+   }
 
    // Calculate values for the coast's flux orientation vector
    CalcCoastTangents(nCoast);
@@ -1000,20 +1291,20 @@ int CSimulation::nTraceCoastLine(unsigned int const nTraceFromStartCellIndex, in
 }
 
 //===============================================================================================================================
-//! First find all connected sea areas, then locate the vector coastline(s), then put these onto the raster grid
+//! For flood level nLevel (0 is wave setup plus surge, 1 is wave setup plus surge plus run-up), first find all connected flooded areas, then locate the vector flood line(s), then put these onto the raster grid. The two levels use separate flag planes and water levels, so may be located at the same time
 //===============================================================================================================================
-int CSimulation::nLocateFloodAndCoasts(void)
+int CSimulation::nLocateFloodAndCoasts(int const nLevel)
 {
    // Find all connected sea cells
-   FindAllInundatedCells();
+   FindAllInundatedCells(nLevel);
 
    // Find every coastline on the raster grid, mark raster cells, then create the vector coastline
-   int nRet = nTraceAllFloodCoasts();
+   int nRet = nTraceAllFloodCoasts(nLevel);
    if (nRet != RTN_OK)
       return nRet;
 
    // Have we created any coasts?
-   switch (m_nLevel)
+   switch (nLevel)
    {
    case 0: // WAVESETUP + SURGE:
    {
@@ -1040,19 +1331,34 @@ int CSimulation::nLocateFloodAndCoasts(void)
 }
 
 //===============================================================================================================================
-//! Finds and flags all sea areas which have at least one cell at a grid edge (i.e. does not flag 'inland' seas)
+//! Called once the flood levels have been located: if the wave setup plus surge plus run-up level was located, its flag planes are copied to the wave setup plus surge level's, which are the ones that are output. This leaves the grid as it would be had the levels been located one after the other
 //===============================================================================================================================
-int CSimulation::FindAllInundatedCells(void)
+void CSimulation::FinishLocateFlood(void)
 {
-   for (int nX = 0; nX < m_nXGridMax; nX++)
+   if (m_bFloodSWLSetupSurgeRunupLine || m_bSetupSurgeRunupFloodMaskSave)
    {
-      for (int nY = 0; nY < m_nYGridMax; nY++)
-      {
-         m_pRasterGrid->m_Cell[nX][nY].UnSetCheckFloodCell();        // TODO 007 Do we need this?
-         m_pRasterGrid->m_Cell[nX][nY].UnSetInContiguousFlood();     // TODO 007 Do we need this?
-         m_pRasterGrid->m_Cell[nX][nY].SetAsFloodLine(false);        // TODO 007 Do we need this?
-      }
+      m_pRasterGrid->CopyFlag(nFloodCheckFlag[1], nFloodCheckFlag[0]);
+      m_pRasterGrid->CopyFlag(nInContiguousFloodFlag[1], nInContiguousFloodFlag[0]);
+      m_pRasterGrid->CopyFlag(nFloodLineFlag[1], nFloodLineFlag[0]);
+
+      m_dThisIterDiffTotWaterLevel = m_dThisIterDiffWaveSetupSurgeRunupWaterLevel;
+   }
+   else if (m_bFloodSWLSetupSurgeLine || m_bSetupSurgeFloodMaskSave)
+   {
+      m_dThisIterDiffTotWaterLevel = m_dThisIterDiffWaveSetupSurgeWaterLevel;
    }
+}
+
+//===============================================================================================================================
+//! Finds and flags all sea areas which have at least one cell at a grid edge (i.e. does not flag 'inland' seas)
+//===============================================================================================================================
+int CSimulation::FindAllInundatedCells(int const nLevel)
+{
+   // Reset the flood switches for all cells, a word (64 cells) at a time
+   m_pRasterGrid->ClearFlag(nFloodCheckFlag[nLevel]);             // TODO 007 Do we need this?
+   m_pRasterGrid->ClearFlag(nInContiguousFloodFlag[nLevel]);      // TODO 007 Do we need this?
+   m_pRasterGrid->ClearFlag(nFloodLineFlag[nLevel]);              // TODO 007 Do we need this?
+
    // Go along the list of edge cells
    for (unsigned int n = 0; n < m_VEdgeCell.size(); n++)
    {
@@ -1071,10 +1377,10 @@ int CSimulation::FindAllInundatedCells(void)
       int nX = m_VEdgeCell[n].nGetX();
       int nY = m_VEdgeCell[n].nGetY();
 
-      if ((! m_pRasterGrid->m_Cell[nX][nY].bIsCellFloodCheck()) && (m_pRasterGrid->m_Cell[nX][nY].bIsInundated()))
+      if ((! m_pRasterGrid->m_Cell[nX][nY].bGetCellFlag(nFloodCheckFlag[nLevel])) && (m_pRasterGrid->m_Cell[nX][nY].bIsInundated(m_dThisIterSWL)))
       {
          // This edge cell is below SWL and sea depth remains set to zero
-         FloodFillLand(nX, nY);
+         FloodFillLand(nX, nY, nLevel);
       }
    }
 
@@ -1084,7 +1390,7 @@ int CSimulation::FindAllInundatedCells(void)
 //===============================================================================================================================
 //! Use the sealevel, wave set-up and run-up to evaluate flood hydraulically connected TODO 007 Not clear why we need this. We already have a flood fill sea routine: every cell that isn't sea is land
 //===============================================================================================================================
-void CSimulation::FloodFillLand(int const nXStart, int const nYStart)
+void CSimulation::FloodFillLand(int const nXStart, int const nYStart, int const nLevel)
 {
    // The flood is at a user-specified location. So get the location from values read from the shapefile
    long unsigned int nLocIDs = m_VdFloodLocationX.size();
@@ -1099,7 +1405,7 @@ void CSimulation::FloodFillLand(int const nXStart, int const nYStart)
          int nCoastSize = m_VCoast[nCoast].pLGetCoastlineExtCRS()->nGetSize();
          for (int nCoastPoint = 0; nCoastPoint < nCoastSize; nCoastPoint++)
          {
-            dAuxWaterLevelDiff = m_VCoast[nCoast].dGetLevel(nCoastPoint, m_nLevel);
+            dAuxWaterLevelDiff = m_VCoast[nCoast].dGetLevel(nCoastPoint, nLevel);
             if (! isnan(dAuxWaterLevelDiff))
             {
                if (abs(dAuxWaterLevelDiff) < 1)       // Limiting the maximum value that can be found (dAuxWaterLevelDiff != DBL_NODATA)
@@ -1135,7 +1441,7 @@ void CSimulation::FloodFillLand(int const nXStart, int const nYStart)
                
                if (dDistSquare < dMinDistSquare)
                {
-                  dAuxWaterLevelDiff = m_VCoast[nCoast].dGetLevel(nCoastPoint, m_nLevel);
+                  dAuxWaterLevelDiff = m_VCoast[nCoast].dGetLevel(nCoastPoint, nLevel);
                   if (! isnan(dAuxWaterLevelDiff))
                   {
                      dMinDistSquare = dDistSquare;
@@ -1149,17 +1455,19 @@ void CSimulation::FloodFillLand(int const nXStart, int const nYStart)
       dDiffTotWaterLevel /= static_cast<double>(nLocIDs);
    }
 
-   m_dThisIterDiffTotWaterLevel = dDiffTotWaterLevel;
-   switch (m_nLevel)
+   switch (nLevel)
    {
       case 0: // WAVESETUP + STORMSURGE:
-         m_dThisIterDiffWaveSetupSurgeWaterLevel = m_dThisIterDiffTotWaterLevel;
+         m_dThisIterDiffWaveSetupSurgeWaterLevel = dDiffTotWaterLevel;
          break;
       case 1: // WAVESETUP + STORMSURGE + RUNUP:
-         m_dThisIterDiffWaveSetupSurgeRunupWaterLevel = m_dThisIterDiffTotWaterLevel;
+         m_dThisIterDiffWaveSetupSurgeRunupWaterLevel = dDiffTotWaterLevel;
          break;
    }
 
+   // The level to flood to is constant for the whole flood fill
+   double dWaterLevel = dDiffTotWaterLevel + m_dThisIterSWL;
+
    // Create an empty stack
    stack<CGeom2DIPoint> PtiStackFlood;
 
@@ -1177,9 +1485,9 @@ void CSimulation::FloodFillLand(int const nXStart, int const nYStart)
 
       while (nX >= 0)
       {
-         if (m_pRasterGrid->m_Cell[nX][nY].bIsCellFloodCheck())
+         if (m_pRasterGrid->m_Cell[nX][nY].bGetCellFlag(nFloodCheckFlag[nLevel]))
             break;
-         if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel())
+         if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel(dWaterLevel))
             break;
          nX--;
       }
@@ -1191,16 +1499,16 @@ void CSimulation::FloodFillLand(int const nXStart, int const nYStart)
 
       while (nX < m_nXGridMax)
       {
-         if (m_pRasterGrid->m_Cell[nX][nY].bIsCellFloodCheck())
+         if (m_pRasterGrid->m_Cell[nX][nY].bGetCellFlag(nFloodCheckFlag[nLevel]))
             break;
-         if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel())
+         if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel(dWaterLevel))
             break;
          
          // Flood this cell
-         m_pRasterGrid->m_Cell[nX][nY].SetCheckFloodCell();             // TODO 007 Do we need this?
-         m_pRasterGrid->m_Cell[nX][nY].SetInContiguousFlood();          // TODO 007 Do we need this?
+         m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nFloodCheckFlag[nLevel], true);            // TODO 007 Do we need this?
+         m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nInContiguousFloodFlag[nLevel], true);     // TODO 007 Do we need this?
 
-         switch (m_nLevel)
+         switch (nLevel)
          {
             case 0: // WAVESETUP + STORMSURGE:
                m_pRasterGrid->m_Cell[nX][nY].SetFloodBySetupSurge();
@@ -1210,22 +1518,22 @@ void CSimulation::FloodFillLand(int const nXStart, int const nYStart)
                break;
          }
 
-         if ((! bSpanAbove) && (nY > 0) && (m_pRasterGrid->m_Cell[nX][nY - 1].bIsElevLessThanWaterLevel()) && (! m_pRasterGrid->m_Cell[nX][nY - 1].bIsCellFloodCheck()))
+         if ((! bSpanAbove) && (nY > 0) && (m_pRasterGrid->m_Cell[nX][nY - 1].bIsElevLessThanWaterLevel(dWaterLevel)) && (! m_pRasterGrid->m_Cell[nX][nY - 1].bGetCellFlag(nFloodCheckFlag[nLevel])))
          {
             PtiStackFlood.push(CGeom2DIPoint(nX, nY - 1));
             bSpanAbove = true;
          }
-         else if (bSpanAbove && (nY > 0) && (! m_pRasterGrid->m_Cell[nX][nY - 1].bIsElevLessThanWaterLevel()))
+         else if (bSpanAbove && (nY > 0) && (! m_pRasterGrid->m_Cell[nX][nY - 1].bIsElevLessThanWaterLevel(dWaterLevel)))
          {
             bSpanAbove = false;
          }
 
-         if ((! bSpanBelow) && (nY < m_nYGridMax - 1) && (m_pRasterGrid->m_Cell[nX][nY + 1].bIsElevLessThanWaterLevel()) && (! m_pRasterGrid->m_Cell[nX][nY + 1].bIsCellFloodCheck()))
+         if ((! bSpanBelow) && (nY < m_nYGridMax - 1) && (m_pRasterGrid->m_Cell[nX][nY + 1].bIsElevLessThanWaterLevel(dWaterLevel)) && (! m_pRasterGrid->m_Cell[nX][nY + 1].bGetCellFlag(nFloodCheckFlag[nLevel])))
          {
             PtiStackFlood.push(CGeom2DIPoint(nX, nY + 1));
             bSpanBelow = true;
          }
-         else if (bSpanBelow && (nY < m_nYGridMax - 1) && (! m_pRasterGrid->m_Cell[nX][nY + 1].bIsElevLessThanWaterLevel()))
+         else if (bSpanBelow && (nY < m_nYGridMax - 1) && (! m_pRasterGrid->m_Cell[nX][nY + 1].bIsElevLessThanWaterLevel(dWaterLevel)))
          {
             bSpanBelow = false;
          }
@@ -1238,7 +1546,7 @@ void CSimulation::FloodFillLand(int const nXStart, int const nYStart)
 //===============================================================================================================================
 //! Locates all the potential coastline start points on the edges of the raster grid, then traces vector coastline(s) from these start points
 //===============================================================================================================================
-int CSimulation::nTraceAllFloodCoasts(void)
+int CSimulation::nTraceAllFloodCoasts(int const nLevel)
 {
    vector<bool> VbPossibleStartCellLHEdge;
    vector<bool> VbTraced;
@@ -1266,8 +1574,8 @@ int CSimulation::nTraceAllFloodCoasts(void)
       int nYNext = m_VEdgeCell[n + 1].nGetY();
 
       // Get "Is it sea?" information for 'this' and 'next' cells TODO 007 Not clear
-      bool bThisCellIsSea = m_pRasterGrid->m_Cell[nXThis][nYThis].bIsInContiguousFlood();      // TODO 007 Do we need this?
-      bool bNextCellIsSea = m_pRasterGrid->m_Cell[nXNext][nYNext].bIsInContiguousFlood();      // TODO 007 Do we need this?
+      bool bThisCellIsSea = m_pRasterGrid->m_Cell[nXThis][nYThis].bGetCellFlag(nInContiguousFloodFlag[nLevel]);      // TODO 007 Do we need this?
+      bool bNextCellIsSea = m_pRasterGrid->m_Cell[nXNext][nYNext].bGetCellFlag(nInContiguousFloodFlag[nLevel]);      // TODO 007 Do we need this?
 
       // Are we at a coast?
       if ((! bThisCellIsSea) && bNextCellIsSea)
@@ -1276,7 +1584,7 @@ int CSimulation::nTraceAllFloodCoasts(void)
          // if (! m_pRasterGrid->m_Cell[nXThis][nYThis].bIsPossibleCoastStartCell())
          {
             // It has not, so flag it
-            m_pRasterGrid->m_Cell[nXThis][nYThis].SetPossibleFloodStartCell();
+            m_pRasterGrid->m_Cell[nXThis][nYThis].SetCellFlag(nPossibleFloodStartFlag[nLevel], true);
 
             // And save it
             V2DIPossibleStartCell.push_back(CGeom2DIPoint(nXThis, nYThis));
@@ -1291,7 +1599,7 @@ int CSimulation::nTraceAllFloodCoasts(void)
          // if (! m_pRasterGrid->m_Cell[nXNext][nYNext].bIsPossibleCoastStartCell())
          {
             // It has not, so flag it
-            m_pRasterGrid->m_Cell[nXNext][nYNext].SetPossibleFloodStartCell();
+            m_pRasterGrid->m_Cell[nXNext][nYNext].SetCellFlag(nPossibleFloodStartFlag[nLevel], true);
 
             // And save it
             V2DIPossibleStartCell.push_back(CGeom2DIPoint(nXNext, nYNext));
@@ -1310,11 +1618,11 @@ int CSimulation::nTraceAllFloodCoasts(void)
          int nRet = 0;
          if (VbPossibleStartCellLHEdge[n])
          {
-            nRet = nTraceFloodCoastLine(n, VnSearchDirection[n], LEFT_HANDED, &VbTraced, &V2DIPossibleStartCell);
+            nRet = nTraceFloodCoastLine(n, VnSearchDirection[n], LEFT_HANDED, &VbTraced, &V2DIPossibleStartCell, nLevel);
          }
          else
          {
-            nRet = nTraceFloodCoastLine(n, VnSearchDirection[n], RIGHT_HANDED, &VbTraced, &V2DIPossibleStartCell);
+            nRet = nTraceFloodCoastLine(n, VnSearchDirection[n], RIGHT_HANDED, &VbTraced, &V2DIPossibleStartCell, nLevel);
          }
 
          if (nRet == RTN_OK)
@@ -1335,7 +1643,7 @@ int CSimulation::nTraceAllFloodCoasts(void)
 //===============================================================================================================================
 //! Traces a coastline (which is defined to be just above still water level) on the grid using the 'wall follower' rule for maze traversal (http://en.wikipedia.org/wiki/Maze_solving_algorithm#Wall_follower). The vector coastlines are then smoothed
 //===============================================================================================================================
-int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellIndex, int const nStartSearchDirection, int const nHandedness, vector<bool>* pVbTraced, vector<CGeom2DIPoint> const* pV2DIPossibleStartCell)
+int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellIndex, int const nStartSearchDirection, int const nHandedness, vector<bool>* pVbTraced, vector<CGeom2DIPoint> const* pV2DIPossibleStartCell, int const nLevel)
 {
    bool bHitStartCell = false;
    bool bAtCoast = false;
@@ -1354,11 +1662,14 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
    //       nLastLen = 0,
    //       nPreLastLen = 0;
 
+   // The water level is constant for the whole trace
+   double dWaterLevel = (nLevel == 0 ? m_dThisIterDiffWaveSetupSurgeWaterLevel : m_dThisIterDiffWaveSetupSurgeRunupWaterLevel) + m_dThisIterSWL;
+
    // Temporary coastline as integer points (grid CRS)
    CGeomILine ILTempGridCRS;
 
    // Mark the start cell as coast and add it to the vector object
-   m_pRasterGrid->m_Cell[nStartX][nStartY].SetAsFloodLine(true);
+   m_pRasterGrid->m_Cell[nStartX][nStartY].SetCellFlag(nFloodLineFlag[nLevel], true);
    CGeom2DIPoint PtiStart(nStartX, nStartY);
    ILTempGridCRS.Append(&PtiStart);
 
@@ -1405,7 +1716,7 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
             bHasLeftStartEdge = true;
 
          // Flag this cell to ensure that it is not chosen as a coastline start cell later
-         m_pRasterGrid->m_Cell[nX][nY].SetPossibleFloodStartCell();
+         m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nPossibleFloodStartFlag[nLevel], true);
          //          LogStream << "Flagging [" << nX << "][" << nY << "] as possible coast start cell NOT YET LEFT EDGE" << endl;
       }
 
@@ -1646,25 +1957,25 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
       if (bIsWithinValidGrid(nXSeaward, nYSeaward))
       {
          // It is, so check if the cell in the seaward direction is a sea cell TODO 007 Not clear
-         if (m_pRasterGrid->m_Cell[nXSeaward][nYSeaward].bIsInContiguousFlood())    // TODO 007 Do we need this?
+         if (m_pRasterGrid->m_Cell[nXSeaward][nYSeaward].bGetCellFlag(nInContiguousFloodFlag[nLevel]))    // TODO 007 Do we need this?
          {
             // There is sea in this seaward direction, so we are on the coast
             bAtCoast = true;
 
             // Has the current cell already marked been marked as a coast cell?
-            if (! m_pRasterGrid->m_Cell[nX][nY].bIsFloodLine())
+            if (! m_pRasterGrid->m_Cell[nX][nY].bGetCellFlag(nFloodLineFlag[nLevel]))
             {
                // Not already marked, is this an intervention cell with the top above SWL?
-               if ((m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->nGetLFCategory() == LF_CAT_INTERVENTION) && (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel()))
+               if ((m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->nGetLFCategory() == LF_CAT_INTERVENTION) && (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel(dWaterLevel)))
                {
                   // It is, so mark as coast and add it to the vector object
-                  m_pRasterGrid->m_Cell[nX][nY].SetAsFloodLine(true);
+                  m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nFloodLineFlag[nLevel], true);
                   ILTempGridCRS.Append(&Pti);
                }
-               else if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel())
+               else if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel(dWaterLevel))
                {
                   // The sediment top is above SWL so mark as coast and add it to the vector object
-                  m_pRasterGrid->m_Cell[nX][nY].SetAsFloodLine(true);
+                  m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nFloodLineFlag[nLevel], true);
                   ILTempGridCRS.Append(&Pti);
                }
             }
@@ -1685,25 +1996,25 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
       if (bIsWithinValidGrid(nXStraightOn, nYStraightOn))
       {
          // It is, so check if there is sea immediately in front TODO 007 Not clear
-         if (m_pRasterGrid->m_Cell[nXStraightOn][nYStraightOn].bIsInContiguousFlood())    // TODO 007 Do we need this?
+         if (m_pRasterGrid->m_Cell[nXStraightOn][nYStraightOn].bGetCellFlag(nInContiguousFloodFlag[nLevel]))    // TODO 007 Do we need this?
          {
             // Sea is in front, so we are on the coast
             bAtCoast = true;
 
             // Has the current cell already marked been marked as a coast cell?
-            if (! m_pRasterGrid->m_Cell[nX][nY].bIsFloodLine())
+            if (! m_pRasterGrid->m_Cell[nX][nY].bGetCellFlag(nFloodLineFlag[nLevel]))
             {
                // Not already marked, is this an intervention cell with the top above SWL?
-               if ((m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->nGetLFCategory() == LF_CAT_INTERVENTION) && (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel()))
+               if ((m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->nGetLFCategory() == LF_CAT_INTERVENTION) && (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel(dWaterLevel)))
                {
                   // It is, so mark as coast and add it to the vector object
-                  m_pRasterGrid->m_Cell[nX][nY].SetAsFloodLine(true);
+                  m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nFloodLineFlag[nLevel], true);
                   ILTempGridCRS.Append(&Pti);
                }
-               else if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel())
+               else if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel(dWaterLevel))
                {
                   // The sediment top is above SWL so mark as coast and add it to the vector object
-                  m_pRasterGrid->m_Cell[nX][nY].SetAsFloodLine(true);
+                  m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nFloodLineFlag[nLevel], true);
                   ILTempGridCRS.Append(&Pti);
                }
             }
@@ -1723,25 +2034,25 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
       if (bIsWithinValidGrid(nXAntiSeaward, nYAntiSeaward))
       {
          // It is, so check if there is sea in this anti-seaward cell TODO 007 Not clear
-         if (m_pRasterGrid->m_Cell[nXAntiSeaward][nYAntiSeaward].bIsInContiguousFlood())        // TODO 007 Do we need this?
+         if (m_pRasterGrid->m_Cell[nXAntiSeaward][nYAntiSeaward].bGetCellFlag(nInContiguousFloodFlag[nLevel]))        // TODO 007 Do we need this?
          {
             // There is sea on the anti-seaward side, so we are on the coast
             bAtCoast = true;
 
             // Has the current cell already marked been marked as a coast cell?
-            if (! m_pRasterGrid->m_Cell[nX][nY].bIsFloodLine())
+            if (! m_pRasterGrid->m_Cell[nX][nY].bGetCellFlag(nFloodLineFlag[nLevel]))
             {
                // Not already marked, is this an intervention cell with the top above SWL?
-               if ((m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->nGetLFCategory() == LF_CAT_INTERVENTION) && (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel()))
+               if ((m_pRasterGrid->m_Cell[nX][nY].pGetLandform()->nGetLFCategory() == LF_CAT_INTERVENTION) && (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel(dWaterLevel)))
                {
                   // It is, so mark as coast and add it to the vector object
-                  m_pRasterGrid->m_Cell[nX][nY].SetAsFloodLine(true);
+                  m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nFloodLineFlag[nLevel], true);
                   ILTempGridCRS.Append(&Pti);
                }
-               else if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel())
+               else if (! m_pRasterGrid->m_Cell[nX][nY].bIsElevLessThanWaterLevel(dWaterLevel))
                {
                   // The sediment top is above SWL so mark as coast and add it to the vector object
-                  m_pRasterGrid->m_Cell[nX][nY].SetAsFloodLine(true);
+                  m_pRasterGrid->m_Cell[nX][nY].SetCellFlag(nFloodLineFlag[nLevel], true);
                   ILTempGridCRS.Append(&Pti);
                }
             }
@@ -1785,7 +2096,7 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
 
       // Unmark these cells as coast cells
       for (int n = 0; n < nCoastSize; n++)
-         m_pRasterGrid->m_Cell[ILTempGridCRS[n].nGetX()][ILTempGridCRS[n].nGetY()].SetAsFloodLine(false);
+         m_pRasterGrid->m_Cell[ILTempGridCRS[n].nGetX()][ILTempGridCRS[n].nGetY()].SetCellFlag(nFloodLineFlag[nLevel], false);
 
       return RTN_ERR_TRACING_COAST;
    }
@@ -1805,7 +2116,7 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
 
       // Unmark these cells as coast cells
       for (int n = 0; n < nCoastSize; n++)
-         m_pRasterGrid->m_Cell[ILTempGridCRS[n].nGetX()][ILTempGridCRS[n].nGetY()].SetAsFloodLine(false);
+         m_pRasterGrid->m_Cell[ILTempGridCRS[n].nGetX()][ILTempGridCRS[n].nGetY()].SetCellFlag(nFloodLineFlag[nLevel], false);
 
       return RTN_ERR_TRACING_COAST;
    }
@@ -1824,7 +2135,7 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
 
       // Unmark these cells as coast cells
       for (int n = 0; n < nCoastSize; n++)
-         m_pRasterGrid->m_Cell[ILTempGridCRS[n].nGetX()][ILTempGridCRS[n].nGetY()].SetAsFloodLine(false);
+         m_pRasterGrid->m_Cell[ILTempGridCRS[n].nGetX()][ILTempGridCRS[n].nGetY()].SetCellFlag(nFloodLineFlag[nLevel], false);
 
       return RTN_ERR_TRACING_COAST;
    }
@@ -1846,7 +2157,7 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
 
       // Unmark these cells as coast cells
       for (int n = 0; n < nCoastSize; n++)
-         m_pRasterGrid->m_Cell[ILTempGridCRS[n].nGetX()][ILTempGridCRS[n].nGetY()].SetAsFloodLine(false);
+         m_pRasterGrid->m_Cell[ILTempGridCRS[n].nGetX()][ILTempGridCRS[n].nGetY()].SetCellFlag(nFloodLineFlag[nLevel], false);
 
       return RTN_ERR_TRACING_COAST;
    }
@@ -1866,7 +2177,7 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
          ILTempGridCRS.Append(nEndX, nEndY);
          nCoastSize++;
 
-         m_pRasterGrid->m_Cell[nEndX][nEndY].SetAsFloodLine(true);
+         m_pRasterGrid->m_Cell[nEndX][nEndY].SetCellFlag(nFloodLineFlag[nLevel], true);
       }
    }
 
@@ -1900,7 +2211,7 @@ int CSimulation::nTraceFloodCoastLine(unsigned int const nTraceFromStartCellInde
    // Create a new coastline object and append to it the vector of coastline objects
    CRWCoast CoastTmp;
    int nCoast;
-   switch (m_nLevel)
+   switch (nLevel)
    {
    case 0:
       m_VFloodWaveSetupSurge.push_back(CoastTmp);
@@ -22,31 +22,143 @@ This program is distributed in the hope that it will be useful, but WITHOUT ANY
 You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
 ===============================================================================================================================*/
+#include <stdint.h>
+
+#include <iostream>
+using std::cerr;
+using std::endl;
+
+#include <algorithm>
+using std::copy;
+using std::fill;
+
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "cme.h"
 #include "raster_grid.h"
 
-CGeomRasterGrid* CGeomCell::m_pGrid = NULL;          // Initialise m_pGrid, the static member of CGeomCell
+//! Allocates a field plane of ulNumCells values, with the start of the plane aligned to GRID_PLANE_ALIGNMENT. The address of the underlying allocation is stored just before the plane, for use by FreePlane()
+template <class T>
+static T* ptAllocPlane(unsigned long const ulNumCells)
+{
+   char* pcRaw = new char[(ulNumCells * sizeof(T)) + GRID_PLANE_ALIGNMENT + sizeof(char*)];
+
+   uintptr_t nStart = reinterpret_cast<uintptr_t>(pcRaw + sizeof(char*));
+   uintptr_t nAligned = (nStart + GRID_PLANE_ALIGNMENT - 1) & ~static_cast<uintptr_t>(GRID_PLANE_ALIGNMENT - 1);
+
+   char** ppcPlane = reinterpret_cast<char**>(nAligned);
+   ppcPlane[-1] = pcRaw;
+
+   return reinterpret_cast<T*>(nAligned);
+}
+
+//! Returns the number of set bits in a flag word
+static int nCountSetBits(uint64_t ulWord)
+{
+#if defined __GNUG__
+   return __builtin_popcountll(ulWord);
+#else
+   int nCount = 0;
+   while (ulWord != 0)
+   {
+      ulWord &= (ulWord - 1);
+      nCount++;
+   }
+   return nCount;
+#endif
+}
+
+//! Frees a field plane which was allocated by ptAllocPlane()
+template <class T>
+static void FreePlane(T* ptPlane)
+{
+   if (ptPlane == NULL)
+      return;
+
+   delete [] reinterpret_cast<char**>(ptPlane)[-1];
+}
+
+//! Allocates a field plane of ulNumValues values, either in RAM or in its own region of the memory-mapped file. Returns NULL if the memory-mapped file cannot be extended
+template <class T>
+T* CGeomRasterGrid::ptAllocFieldPlane(unsigned long const ulNumValues)
+{
+   if (m_bMemoryMapped)
+      return reinterpret_cast<T*>(pcMapRegion(ulNumValues * sizeof(T)));
+
+   return ptAllocPlane<T>(ulNumValues);
+}
 
 //! Constructor
 CGeomRasterGrid::CGeomRasterGrid(CSimulation* pSimIn)
-: m_dD50Fine(0),
+: m_nXGridMax(0),
+  m_nYGridMax(0),
+  m_ulNumCells(0),
+  m_ulNumFlagWords(0),
+  m_nLayers(0),
+  m_nXTiles(0),
+  m_nYTiles(0),
+  m_dD50Fine(0),
   m_dD50Sand(0),
   m_dD50Coarse(0),
   m_pSim(pSimIn),
-  m_Cell(NULL)
+  m_pCellBlock(NULL),
+  m_pdHorizonTopElev(NULL),
+  m_bMemoryMapped(false),
+  m_nMappedFile(-1),
+  m_ulMappedFileBytes(0),
+  m_bDirtyCellsComplete(false)
 {
+   for (int n = 0; n < NUM_CELL_DBL_FIELDS; n++)
+      m_pdCellField[n] = NULL;
+
+   for (int n = 0; n < NUM_CELL_DIAG_FIELDS; n++)
+      m_ptDiagField[n] = NULL;
+
+   for (int n = 0; n < NUM_CELL_INT_FIELDS; n++)
+      m_pnCellField[n] = NULL;
+
+   for (int n = 0; n < NUM_CELL_FLAGS; n++)
+      m_pulCellFlag[n] = NULL;
 }
 
 //! Destructor
 CGeomRasterGrid::~CGeomRasterGrid(void)
 {
-   int nXMax = m_pSim->nGetGridXMax();
+   if (m_bMemoryMapped)
+   {
+      // The field planes, the tiles' layers and the horizon cube are all in the memory-mapped file (the layers have trivial destructors, so need no clean-up)
+      UnmapAllRegions();
+   }
+   else
+   {
+      // Free the field planes
+      for (int n = 0; n < NUM_CELL_DBL_FIELDS; n++)
+         FreePlane(m_pdCellField[n]);
 
-   // Free the m_Cell memory
-   for (int nX = 0; nX < nXMax; nX++)
-      delete [] m_Cell[nX];
+      for (int n = 0; n < NUM_CELL_DIAG_FIELDS; n++)
+         FreePlane(m_ptDiagField[n]);
 
-   delete [] m_Cell;
+      for (int n = 0; n < NUM_CELL_INT_FIELDS; n++)
+         FreePlane(m_pnCellField[n]);
+
+      for (int n = 0; n < NUM_CELL_FLAGS; n++)
+         FreePlane(m_pulCellFlag[n]);
+
+      // Free the tiles' layers and the horizon cube
+      for (unsigned int n = 0; n < m_VTile.size(); n++)
+         m_VTile[n].FreeLayers();
+
+      FreePlane(m_pdHorizonTopElev);
+   }
+
+   // Free the m_Cell memory
+   delete [] m_pCellBlock;
 }
 
 //! Returns a pointer to the simulation object
@@ -60,21 +172,556 @@ CSimulation* CGeomRasterGrid::pGetSim(void)
 //    return &m_Cell[nX][nY];
 // }
 
-//! Creates the 2D CGeomCell array
+//! Creates the 2D CGeomCell array and the field planes
 int CGeomRasterGrid::nCreateGrid(void)
 {
-   // Create the 2D CGeomCell array (this is faster than using 2D STL vectors)
-   int nXMax = m_pSim->nGetGridXMax();
-   int nYMax = m_pSim->nGetGridYMax();
+   // Create the 2D CGeomCell array as a single row-major block, so that a row of cells is contiguous in memory, in the same order as a GDAL raster band
+   m_nXGridMax = m_pSim->nGetGridXMax();
+   m_nYGridMax = m_pSim->nGetGridYMax();
+   m_ulNumCells = static_cast<unsigned long>(m_nXGridMax) * m_nYGridMax;
 
    // TODO 038 Check if we don't have enough memory, if so return RTN_ERR_MEMALLOC
-   m_Cell = new CGeomCell * [nXMax];
-   for (int nX = 0; nX < nXMax; nX++)
-      m_Cell[nX] = new CGeomCell[nYMax];
+   m_pCellBlock = new CGeomCell[m_ulNumCells];
+   m_Cell.Set(m_pCellBlock, m_nXGridMax);
+
+   // Now create the field planes, one value per cell in each, in the same row-major order
+   for (int n = 0; n < NUM_CELL_DBL_FIELDS; n++)
+   {
+      m_pdCellField[n] = ptAllocFieldPlane<double>(m_ulNumCells);
+      if (m_pdCellField[n] == NULL)
+         return RTN_ERR_MEMALLOC;
+   }
+
+   for (int n = 0; n < NUM_CELL_DIAG_FIELDS; n++)
+   {
+      m_ptDiagField[n] = ptAllocFieldPlane<diag_t>(m_ulNumCells);
+      if (m_ptDiagField[n] == NULL)
+         return RTN_ERR_MEMALLOC;
+   }
+
+   for (int n = 0; n < NUM_CELL_INT_FIELDS; n++)
+   {
+      m_pnCellField[n] = ptAllocFieldPlane<int>(m_ulNumCells);
+      if (m_pnCellField[n] == NULL)
+         return RTN_ERR_MEMALLOC;
+   }
+
+   // The flags are bit planes, 64 cells per word
+   m_ulNumFlagWords = (m_ulNumCells + 63) / 64;
+   for (int n = 0; n < NUM_CELL_FLAGS; n++)
+   {
+      m_pulCellFlag[n] = ptAllocFieldPlane<uint64_t>(m_ulNumFlagWords);
+      if (m_pulCellFlag[n] == NULL)
+         return RTN_ERR_MEMALLOC;
+   }
+
+   SetAllFieldDefaults();
+
+   // Divide the grid into tiles, so that per-timestep sweeps can skip uniform tiles. Every cell is still stored, whatever its tile. All tiles start as active
+   m_nXTiles = (m_nXGridMax + GRID_TILE_SIZE - 1) / GRID_TILE_SIZE;
+   m_nYTiles = (m_nYGridMax + GRID_TILE_SIZE - 1) / GRID_TILE_SIZE;
+   m_VTile.resize(static_cast<unsigned int>(m_nXTiles * m_nYTiles));
+   for (int nTileY = 0; nTileY < m_nYTiles; nTileY++)
+   {
+      for (int nTileX = 0; nTileX < m_nXTiles; nTileX++)
+      {
+         int nXMin = nTileX * GRID_TILE_SIZE;
+         int nYMin = nTileY * GRID_TILE_SIZE;
+         m_VTile[(nTileY * m_nXTiles) + nTileX].SetExtent(nXMin, nYMin, tMin(nXMin + GRID_TILE_SIZE, m_nXGridMax), tMin(nYMin + GRID_TILE_SIZE, m_nYGridMax));
+      }
+   }
+
+   // Point each cell at this grid, which holds its values. This is per-cell rather than static, so that more than one grid can exist at once
+   for (unsigned long ul = 0; ul < m_ulNumCells; ul++)
+      m_pCellBlock[ul].SetGrid(this);
 
-   // Initialize the CGeomCell shared pointer to the CGeomRasterGrid object
-   CGeomCell::m_pGrid = this;
+   return RTN_OK;
+}
+
+//! Creates each tile's layers, and the horizon cube. Since the number of layers does not change during the simulation, each cell's layers are held contiguously in its tile's block of layers, rather than in a per-cell vector. Must be called after nCreateGrid()
+int CGeomRasterGrid::nCreateTileLayers(int const nLayers)
+{
+   m_nLayers = nLayers;
+
+   if (m_bMemoryMapped)
+   {
+      // Construct all tiles' layers in place, in a single region of the memory-mapped file. These tiles do not own their layers, so are never made compact
+      unsigned long ulNumLayerCells = m_ulNumCells * m_nLayers;
+      char* pcRegion = pcMapRegion(ulNumLayerCells * sizeof(CRWCellLayer));
+      if (pcRegion == NULL)
+         return RTN_ERR_MEMALLOC;
+
+      CRWCellLayer* pLayers = reinterpret_cast<CRWCellLayer*>(pcRegion);
+      for (unsigned long ul = 0; ul < ulNumLayerCells; ul++)
+         new (pLayers + ul) CRWCellLayer;
+
+      for (unsigned int n = 0; n < m_VTile.size(); n++)
+      {
+         m_VTile[n].SetLayers(pLayers, false);
+         pLayers += (m_VTile[n].nGetNumCells() * m_nLayers);
+      }
+   }
+   else
+   {
+      // TODO 038 Check if we don't have enough memory, if so return RTN_ERR_MEMALLOC
+      for (unsigned int n = 0; n < m_VTile.size(); n++)
+         m_VTile[n].SetLayers(new CRWCellLayer[m_VTile[n].nGetNumCells() * m_nLayers], true);
+   }
+
+   m_pdHorizonTopElev = ptAllocFieldPlane<double>(m_ulNumCells * (m_nLayers + 1));
+   if (m_pdHorizonTopElev == NULL)
+      return RTN_ERR_MEMALLOC;
+
+   fill(m_pdHorizonTopElev, m_pdHorizonTopElev + (m_ulNumCells * (m_nLayers + 1)), 0.0);
 
    return RTN_OK;
 }
 
+//! Extends the memory-mapped file by ulBytes (rounded up to a whole number of pages) and maps the new region into memory. Since each region starts on a page boundary, it is also aligned to GRID_PLANE_ALIGNMENT. Returns NULL if this fails
+char* CGeomRasterGrid::pcMapRegion(unsigned long const ulBytes)
+{
+#ifdef _WIN32
+   // Not supported on this platform, SetMemoryMapped() should never have been called
+   (void) ulBytes;
+   return NULL;
+#else
+   if (m_nMappedFile < 0)
+   {
+      m_nMappedFile = open(m_strMappedFile.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+      if (m_nMappedFile < 0)
+      {
+         cerr << ERR << "cannot create " << m_strMappedFile << " for the memory-mapped grid" << endl;
+         return NULL;
+      }
+   }
+
+   unsigned long ulPageSize = static_cast<unsigned long>(sysconf(_SC_PAGESIZE));
+   unsigned long ulLength = ((ulBytes + ulPageSize - 1) / ulPageSize) * ulPageSize;
+
+   // Reserve the disk space now, so that running out of space is reported here rather than as a bus error when a page is first written
+   if (posix_fallocate(m_nMappedFile, static_cast<off_t>(m_ulMappedFileBytes), static_cast<off_t>(ulLength)) != 0)
+   {
+      cerr << ERR << "cannot extend " << m_strMappedFile << " to " << m_ulMappedFileBytes + ulLength << " bytes for the memory-mapped grid" << endl;
+      return NULL;
+   }
+
+   void* pvRegion = mmap(NULL, ulLength, PROT_READ | PROT_WRITE, MAP_SHARED, m_nMappedFile, static_cast<off_t>(m_ulMappedFileBytes));
+   if (pvRegion == MAP_FAILED)
+   {
+      cerr << ERR << "cannot map " << m_strMappedFile << " into memory" << endl;
+      return NULL;
+   }
+
+   // Most per-timestep sweeps only touch the tiles near the coast, so read-ahead would just page in rows which are not needed
+   madvise(pvRegion, ulLength, MADV_RANDOM);
+
+   m_ulMappedFileBytes += ulLength;
+   m_VpcMappedRegion.push_back(static_cast<char*>(pvRegion));
+   m_VulMappedRegionBytes.push_back(ulLength);
+
+   return static_cast<char*>(pvRegion);
+#endif
+}
+
+//! Unmaps all regions of the memory-mapped file, then closes and deletes the file
+void CGeomRasterGrid::UnmapAllRegions(void)
+{
+#ifndef _WIN32
+   for (unsigned int n = 0; n < m_VpcMappedRegion.size(); n++)
+      munmap(m_VpcMappedRegion[n], m_VulMappedRegionBytes[n]);
+
+   m_VpcMappedRegion.clear();
+   m_VulMappedRegionBytes.clear();
+
+   if (m_nMappedFile >= 0)
+   {
+      close(m_nMappedFile);
+      unlink(m_strMappedFile.c_str());
+      m_nMappedFile = -1;
+   }
+#endif
+}
+
+//! Selects the memory-mapped backend: the field planes, the tiles' layers and the horizon cube will be held in strFile, rather than in RAM. Must be called before nCreateGrid()
+void CGeomRasterGrid::SetMemoryMapped(string const& strFile)
+{
+   m_bMemoryMapped = true;
+   m_strMappedFile = strFile;
+}
+
+//! Returns true if the field planes, the tiles' layers and the horizon cube are held in a memory-mapped file
+bool CGeomRasterGrid::bIsMemoryMapped(void) const
+{
+   return m_bMemoryMapped;
+}
+
+//! Returns the number of sediment layers above the basement
+int CGeomRasterGrid::nGetNumLayers(void) const
+{
+   return m_nLayers;
+}
+
+//! Sets every value in every field plane to its start-of-simulation default
+void CGeomRasterGrid::SetAllFieldDefaults(void)
+{
+   for (int n = 0; n < NUM_CELL_DBL_FIELDS; n++)
+      fill(m_pdCellField[n], m_pdCellField[n] + m_ulNumCells, 0.0);
+
+   fill(m_pdCellField[CELL_DBL_BEACH_PROTECTION], m_pdCellField[CELL_DBL_BEACH_PROTECTION] + m_ulNumCells, DBL_NODATA);
+
+   fill(m_pnCellField[CELL_INT_BOUNDING_BOX_EDGE], m_pnCellField[CELL_INT_BOUNDING_BOX_EDGE] + m_ulNumCells, NO_DIRECTION);
+   fill(m_pnCellField[CELL_INT_POLYGON_ID], m_pnCellField[CELL_INT_POLYGON_ID] + m_ulNumCells, INT_NODATA);
+   fill(m_pnCellField[CELL_INT_COASTLINE_NORMAL], m_pnCellField[CELL_INT_COASTLINE_NORMAL] + m_ulNumCells, INT_NODATA);
+   fill(m_pnCellField[CELL_INT_SHADOW_ZONE], m_pnCellField[CELL_INT_SHADOW_ZONE] + m_ulNumCells, 0);
+   fill(m_pnCellField[CELL_INT_DOWNDRIFT_ZONE], m_pnCellField[CELL_INT_DOWNDRIFT_ZONE] + m_ulNumCells, 0);
+
+   for (int n = 0; n < NUM_CELL_FLAGS; n++)
+      ClearFlag(n);
+
+   for (int n = 0; n < NUM_CELL_DIAG_FIELDS; n++)
+      fill(m_ptDiagField[n], m_ptDiagField[n] + m_ulNumCells, static_cast<diag_t>(0));
+
+   fill(m_ptDiagField[CELL_DIAG_WAVE_ANGLE], m_ptDiagField[CELL_DIAG_WAVE_ANGLE] + m_ulNumCells, static_cast<diag_t>(DBL_NODATA));
+   fill(m_ptDiagField[CELL_DIAG_TOT_WAVE_ANGLE], m_ptDiagField[CELL_DIAG_TOT_WAVE_ANGLE] + m_ulNumCells, static_cast<diag_t>(DBL_NODATA));
+   fill(m_ptDiagField[CELL_DIAG_DEEP_WATER_WAVE_HEIGHT], m_ptDiagField[CELL_DIAG_DEEP_WATER_WAVE_HEIGHT] + m_ulNumCells, static_cast<diag_t>(DBL_NODATA));
+   fill(m_ptDiagField[CELL_DIAG_DEEP_WATER_WAVE_ANGLE], m_ptDiagField[CELL_DIAG_DEEP_WATER_WAVE_ANGLE] + m_ulNumCells, static_cast<diag_t>(DBL_NODATA));
+   fill(m_ptDiagField[CELL_DIAG_DEEP_WATER_WAVE_PERIOD], m_ptDiagField[CELL_DIAG_DEEP_WATER_WAVE_PERIOD] + m_ulNumCells, static_cast<diag_t>(DBL_NODATA));
+}
+
+//! Returns the number of cells in the grid
+unsigned long CGeomRasterGrid::ulGetNumCells(void) const
+{
+   return m_ulNumCells;
+}
+
+//! Returns a pointer to the start of a double-valued field plane
+double* CGeomRasterGrid::pdGetField(int const nField)
+{
+   return m_pdCellField[nField];
+}
+
+//! Returns a pointer to the start of a diagnostic or wave field plane
+diag_t* CGeomRasterGrid::ptGetDiagField(int const nField)
+{
+   return m_ptDiagField[nField];
+}
+
+//! Returns a pointer to the start of an int-valued field plane
+int* CGeomRasterGrid::pnGetField(int const nField)
+{
+   return m_pnCellField[nField];
+}
+
+//! Returns a pointer to the start of a flag bit plane
+uint64_t const* CGeomRasterGrid::pulGetFlagWords(int const nFlag) const
+{
+   return m_pulCellFlag[nFlag];
+}
+
+//! Returns the number of words in each flag bit plane
+unsigned long CGeomRasterGrid::ulGetNumFlagWords(void) const
+{
+   return m_ulNumFlagWords;
+}
+
+//! Clears a flag for every cell, a word (64 cells) at a time
+void CGeomRasterGrid::ClearFlag(int const nFlag)
+{
+   fill(m_pulCellFlag[nFlag], m_pulCellFlag[nFlag] + m_ulNumFlagWords, static_cast<uint64_t>(0));
+}
+
+//! Copies one flag to another for every cell, a word (64 cells) at a time
+void CGeomRasterGrid::CopyFlag(int const nFromFlag, int const nToFlag)
+{
+   copy(m_pulCellFlag[nFromFlag], m_pulCellFlag[nFromFlag] + m_ulNumFlagWords, m_pulCellFlag[nToFlag]);
+}
+
+//! Returns the number of cells for which a flag is set, counting a word (64 cells) at a time
+unsigned long CGeomRasterGrid::ulCountFlag(int const nFlag) const
+{
+   unsigned long ulCount = 0;
+   uint64_t const* pulWord = m_pulCellFlag[nFlag];
+   for (unsigned long n = 0; n < m_ulNumFlagWords; n++)
+      ulCount += nCountSetBits(pulWord[n]);
+
+   return ulCount;
+}
+
+//! Returns the number of cells for which both of two flags are set, counting a word (64 cells) at a time
+unsigned long CGeomRasterGrid::ulCountFlagIntersection(int const nFlag1, int const nFlag2) const
+{
+   unsigned long ulCount = 0;
+   uint64_t const* pulWord1 = m_pulCellFlag[nFlag1];
+   uint64_t const* pulWord2 = m_pulCellFlag[nFlag2];
+   for (unsigned long n = 0; n < m_ulNumFlagWords; n++)
+      ulCount += nCountSetBits(pulWord1[n] & pulWord2[n]);
+
+   return ulCount;
+}
+
+//! Resets the per-timestep values of every cell. This does the same as calling CGeomCell::InitCell() on each cell, but one field plane at a time. The per-timestep sediment change fields are only written on cells whose sediment changes, so if the dirty-cell list is complete then these fields are reset on the dirty cells only
+void CGeomRasterGrid::InitAllCells(void)
+{
+   static int const nFlagsToReset[] = {CELL_FLAG_IN_CONTIGUOUS_SEA, CELL_FLAG_IN_CONTIGUOUS_FLOOD, CELL_FLAG_COASTLINE, CELL_FLAG_FLOOD_LINE, CELL_FLAG_IN_ACTIVE_ZONE, CELL_FLAG_SHADOW_BOUNDARY, CELL_FLAG_POSSIBLE_COAST_START, CELL_FLAG_POSSIBLE_FLOOD_START, CELL_FLAG_WAVE_FLOOD, CELL_FLAG_CHECK_FLOOD, CELL_FLAG_IN_CONTIGUOUS_FLOOD_RUNUP, CELL_FLAG_FLOOD_LINE_RUNUP, CELL_FLAG_CHECK_FLOOD_RUNUP, CELL_FLAG_POSSIBLE_FLOOD_START_RUNUP};
+   static int const nFieldsToZero[] = {CELL_DBL_POTENTIAL_PLATFORM_EROSION, CELL_DBL_POTENTIAL_BEACH_EROSION, CELL_DBL_SEA_DEPTH};
+   static int const nDiagFieldsToZero[] = {CELL_DIAG_LOCAL_CONS_SLOPE, CELL_DIAG_WAVE_HEIGHT, CELL_DIAG_WAVE_ANGLE};
+   static int const nSedimentChangeFieldsToZero[] = {CELL_DBL_ACTUAL_PLATFORM_EROSION, CELL_DBL_CLIFF_COLLAPSE_FINE, CELL_DBL_CLIFF_COLLAPSE_SAND, CELL_DBL_CLIFF_COLLAPSE_COARSE, CELL_DBL_TALUS_SAND_DEPOSITION, CELL_DBL_TALUS_COARSE_DEPOSITION, CELL_DBL_ACTUAL_BEACH_EROSION, CELL_DBL_BEACH_DEPOSITION};
+   static int const nSedimentChangeDiagFieldsToZero[] = {CELL_DIAG_TOT_TALUS_SAND_DEPOSITION, CELL_DIAG_TOT_TALUS_COARSE_DEPOSITION};
+
+   for (unsigned int n = 0; n < sizeof(nFlagsToReset) / sizeof(nFlagsToReset[0]); n++)
+      ClearFlag(nFlagsToReset[n]);
+
+   fill(m_pnCellField[CELL_INT_POLYGON_ID], m_pnCellField[CELL_INT_POLYGON_ID] + m_ulNumCells, INT_NODATA);
+   fill(m_pnCellField[CELL_INT_COASTLINE_NORMAL], m_pnCellField[CELL_INT_COASTLINE_NORMAL] + m_ulNumCells, INT_NODATA);
+   fill(m_pnCellField[CELL_INT_SHADOW_ZONE], m_pnCellField[CELL_INT_SHADOW_ZONE] + m_ulNumCells, 0);
+   fill(m_pnCellField[CELL_INT_DOWNDRIFT_ZONE], m_pnCellField[CELL_INT_DOWNDRIFT_ZONE] + m_ulNumCells, 0);
+
+   for (unsigned int n = 0; n < sizeof(nFieldsToZero) / sizeof(nFieldsToZero[0]); n++)
+      fill(m_pdCellField[nFieldsToZero[n]], m_pdCellField[nFieldsToZero[n]] + m_ulNumCells, 0.0);
+
+   for (unsigned int n = 0; n < sizeof(nDiagFieldsToZero) / sizeof(nDiagFieldsToZero[0]); n++)
+      fill(m_ptDiagField[nDiagFieldsToZero[n]], m_ptDiagField[nDiagFieldsToZero[n]] + m_ulNumCells, static_cast<diag_t>(0));
+
+   fill(m_pdCellField[CELL_DBL_BEACH_PROTECTION], m_pdCellField[CELL_DBL_BEACH_PROTECTION] + m_ulNumCells, DBL_NODATA);
+
+   if (m_bDirtyCellsComplete)
+   {
+      for (unsigned int n = 0; n < sizeof(nSedimentChangeFieldsToZero) / sizeof(nSedimentChangeFieldsToZero[0]); n++)
+      {
+         double* pdField = m_pdCellField[nSedimentChangeFieldsToZero[n]];
+         for (unsigned int m = 0; m < m_VulDirtyCell.size(); m++)
+            pdField[m_VulDirtyCell[m]] = 0;
+      }
+
+      for (unsigned int n = 0; n < sizeof(nSedimentChangeDiagFieldsToZero) / sizeof(nSedimentChangeDiagFieldsToZero[0]); n++)
+      {
+         diag_t* ptField = m_ptDiagField[nSedimentChangeDiagFieldsToZero[n]];
+         for (unsigned int m = 0; m < m_VulDirtyCell.size(); m++)
+            ptField[m_VulDirtyCell[m]] = 0;
+      }
+   }
+   else
+   {
+      for (unsigned int n = 0; n < sizeof(nSedimentChangeFieldsToZero) / sizeof(nSedimentChangeFieldsToZero[0]); n++)
+         fill(m_pdCellField[nSedimentChangeFieldsToZero[n]], m_pdCellField[nSedimentChangeFieldsToZero[n]] + m_ulNumCells, 0.0);
+
+      for (unsigned int n = 0; n < sizeof(nSedimentChangeDiagFieldsToZero) / sizeof(nSedimentChangeDiagFieldsToZero[0]); n++)
+         fill(m_ptDiagField[nSedimentChangeDiagFieldsToZero[n]], m_ptDiagField[nSedimentChangeDiagFieldsToZero[n]] + m_ulNumCells, static_cast<diag_t>(0));
+   }
+}
+
+//! Must be called just before the sediment of a cell is changed. If the cell is not already on the dirty-cell list, adds it, and keeps a copy of its sediment totals before the change. Also marks the tile which contains the cell as having had a change to its sediment
+void CGeomRasterGrid::MarkCellSedimentDirty(int const nX, int const nY)
+{
+   m_VTile[nGetTileIndex(nX, nY)].SetSedimentChanged();
+
+   unsigned long ulIndex = ulGetCellIndex(nX, nY);
+   if (bGetFlag(CELL_FLAG_SEDIMENT_DIRTY, ulIndex))
+      return;
+
+   SetFlag(CELL_FLAG_SEDIMENT_DIRTY, ulIndex, true);
+   m_VulDirtyCell.push_back(ulIndex);
+
+   unsigned long ulOld = m_VdDirtyCellOldTotals.size();
+   m_VdDirtyCellOldTotals.resize(ulOld + NUM_SEDIMENT_TOTALS);
+   m_pCellBlock[ulIndex].GetSedimentTotals(&m_VdDirtyCellOldTotals[ulOld]);
+}
+
+//! Returns true if the dirty-cell list holds every cell whose sediment has changed since the list was last cleared
+bool CGeomRasterGrid::bDirtyCellsComplete(void) const
+{
+   return m_bDirtyCellsComplete;
+}
+
+//! Returns the number of cells on the dirty-cell list
+unsigned long CGeomRasterGrid::ulGetNumDirtyCells(void) const
+{
+   return m_VulDirtyCell.size();
+}
+
+//! Sets the NUM_SEDIMENT_TOTALS elements of pdChange (indexed by the SEDIMENT_TOTAL_* codes) to the change in each sediment total, summed over all cells on the dirty-cell list, since each cell was marked. If the list is complete, this is the change over the whole grid
+void CGeomRasterGrid::SumDirtyCellSedimentChanges(double* pdChange) const
+{
+   double dNow[NUM_SEDIMENT_TOTALS];
+
+   for (int m = 0; m < NUM_SEDIMENT_TOTALS; m++)
+      pdChange[m] = 0;
+
+   for (unsigned int n = 0; n < m_VulDirtyCell.size(); n++)
+   {
+      m_pCellBlock[m_VulDirtyCell[n]].GetSedimentTotals(dNow);
+
+      double const* pdOld = &m_VdDirtyCellOldTotals[n * NUM_SEDIMENT_TOTALS];
+      for (int m = 0; m < NUM_SEDIMENT_TOTALS; m++)
+         pdChange[m] += (dNow[m] - pdOld[m]);
+   }
+}
+
+//! Returns the largest change (m) in the total sediment thickness of any one cell on the dirty-cell list, since the cell was marked
+double CGeomRasterGrid::dGetMaxDirtyCellSedimentChange(void) const
+{
+   double dNow[NUM_SEDIMENT_TOTALS];
+   double dMaxChange = 0;
+
+   for (unsigned int n = 0; n < m_VulDirtyCell.size(); n++)
+   {
+      m_pCellBlock[m_VulDirtyCell[n]].GetSedimentTotals(dNow);
+
+      double const* pdOld = &m_VdDirtyCellOldTotals[n * NUM_SEDIMENT_TOTALS];
+      double dChange = 0;
+      for (int m = 0; m < NUM_SEDIMENT_TOTALS; m++)
+         dChange += (dNow[m] - pdOld[m]);
+
+      dMaxChange = tMax(dMaxChange, tAbs(dChange));
+   }
+
+   return dMaxChange;
+}
+
+//! Sets the NUM_SEDIMENT_TOTALS elements of pdTotals (indexed by the SEDIMENT_TOTAL_* codes) to each sediment total, summed over every cell in the grid
+void CGeomRasterGrid::SumAllCellsSedimentTotals(double* pdTotals) const
+{
+   double dCell[NUM_SEDIMENT_TOTALS];
+
+   for (int m = 0; m < NUM_SEDIMENT_TOTALS; m++)
+      pdTotals[m] = 0;
+
+   for (unsigned long n = 0; n < m_ulNumCells; n++)
+   {
+      m_pCellBlock[n].GetSedimentTotals(dCell);
+
+      for (int m = 0; m < NUM_SEDIMENT_TOTALS; m++)
+         pdTotals[m] += dCell[m];
+   }
+}
+
+//! Empties the dirty-cell list, which is then complete, and marks every tile as having had no change to its sediment
+void CGeomRasterGrid::ClearDirtyCells(void)
+{
+   for (unsigned int n = 0; n < m_VulDirtyCell.size(); n++)
+      SetFlag(CELL_FLAG_SEDIMENT_DIRTY, m_VulDirtyCell[n], false);
+
+   m_VulDirtyCell.clear();
+   m_VdDirtyCellOldTotals.clear();
+   m_bDirtyCellsComplete = true;
+
+   for (unsigned int n = 0; n < m_VTile.size(); n++)
+      m_VTile[n].ClearSedimentChanged();
+}
+
+//! Returns the number of grid tiles
+int CGeomRasterGrid::nGetNumTiles(void) const
+{
+   return static_cast<int>(m_VTile.size());
+}
+
+//! Returns a pointer to a grid tile
+CGeomGridTile* CGeomRasterGrid::pGetTile(int const nTile)
+{
+   return &m_VTile[nTile];
+}
+
+//! Called once per timestep, before the tiles near coastlines and profiles are marked as active
+void CGeomRasterGrid::IncrAllTilesQuietTimesteps(void)
+{
+   for (unsigned int n = 0; n < m_VTile.size(); n++)
+      m_VTile[n].IncrQuietTimesteps();
+}
+
+//! Marks the tile which contains a cell, and all tiles within GRID_TILE_HALO of it, as active i.e. swept in full
+void CGeomRasterGrid::SetTilesActiveAroundCell(int const nX, int const nY)
+{
+   int
+      nTileX = nX / GRID_TILE_SIZE,
+      nTileY = nY / GRID_TILE_SIZE,
+      nTileXMin = tMax(nTileX - GRID_TILE_HALO, 0),
+      nTileXMax = tMin(nTileX + GRID_TILE_HALO, m_nXTiles - 1),
+      nTileYMin = tMax(nTileY - GRID_TILE_HALO, 0),
+      nTileYMax = tMin(nTileY + GRID_TILE_HALO, m_nYTiles - 1);
+
+   for (int nTY = nTileYMin; nTY <= nTileYMax; nTY++)
+      for (int nTX = nTileXMin; nTX <= nTileXMax; nTX++)
+         m_VTile[(nTY * m_nXTiles) + nTX].SetActive();
+}
+
+//! Returns the number of grid tiles which are currently uniform
+unsigned long CGeomRasterGrid::ulCountUniformTiles(void) const
+{
+   unsigned long ulCount = 0;
+   for (unsigned int n = 0; n < m_VTile.size(); n++)
+   {
+      if (m_VTile[n].bIsUniform())
+         ulCount++;
+   }
+
+   return ulCount;
+}
+
+//! Tries to make each uniform tile compact, i.e. to replace its cells' layers with a single shared copy, which is possible if the layers of all its cells are identical. Returns the number of tiles which were made compact by this call
+unsigned long CGeomRasterGrid::ulCompactUniformTiles(void)
+{
+   unsigned long ulCount = 0;
+   for (unsigned int n = 0; n < m_VTile.size(); n++)
+   {
+      if (m_VTile[n].bCompactLayers(m_nLayers))
+         ulCount++;
+   }
+
+   return ulCount;
+}
+
+//! Returns the number of compact tiles
+unsigned long CGeomRasterGrid::ulCountCompactTiles(void) const
+{
+   unsigned long ulCount = 0;
+   for (unsigned int n = 0; n < m_VTile.size(); n++)
+   {
+      if (m_VTile[n].bIsCompact())
+         ulCount++;
+   }
+
+   return ulCount;
+}
+
+//! Returns the number of bytes currently used for all tiles' layers
+unsigned long CGeomRasterGrid::ulGetLayerBytes(void) const
+{
+   unsigned long ulLayers = 0;
+   for (unsigned int n = 0; n < m_VTile.size(); n++)
+   {
+      if (m_VTile[n].bIsCompact())
+         ulLayers += static_cast<unsigned long>(m_nLayers);
+      else
+         ulLayers += static_cast<unsigned long>(m_VTile[n].nGetNumCells() * m_nLayers);
+   }
+
+   return ulLayers * sizeof(CRWCellLayer);
+}
+
+//! Evaluates the inundation test in bulk, for the span of cells from nXStart to nXEnd - 1 on row nY. For each cell, pucState is set to INUNDATION_WET if the top of the cell's sediment (plus any intervention) is below dWaterLevel, and INUNDATION_NODATA_BASEMENT is also set if the cell's basement elevation is NODATA. Since the planes are row-major, this is a single pass over contiguous memory
+void CGeomRasterGrid::GetInundationRowSpan(int const nY, int const nXStart, int const nXEnd, double const dWaterLevel, unsigned char* pucState) const
+{
+   unsigned long ulStart = ulGetCellIndex(nXStart, nY);
+   double const* pdBasementElev = m_pdCellField[CELL_DBL_BASEMENT_ELEV] + ulStart;
+   double const* pdSedTopElev = m_pdCellField[CELL_DBL_SEDIMENT_TOP_ELEV] + ulStart;
+   double const* pdInterventionHeight = m_pdCellField[CELL_DBL_INTERVENTION_HEIGHT] + ulStart;
+   double dMissingValue = m_pSim->dGetMissingValue();
+
+   int nSpan = nXEnd - nXStart;
+   for (int n = 0; n < nSpan; n++)
+   {
+      unsigned char ucState = ((pdSedTopElev[n] + pdInterventionHeight[n]) < dWaterLevel) ? INUNDATION_WET : 0;
+
+      if (bFPIsEqual(pdBasementElev[n], dMissingValue, TOLERANCE))
+         ucState |= INUNDATION_NODATA_BASEMENT;
+
+      pucState[n] = ucState;
+   }
+}
+
+//! Evaluates the inundation test in bulk for every cell in the grid, one row at a time. pucState must have one element per cell, it is filled in the same row-major order as the field planes
+void CGeomRasterGrid::GetInundation(double const dWaterLevel, unsigned char* pucState) const
+{
+   for (int nY = 0; nY < m_nYGridMax; nY++)
+      GetInundationRowSpan(nY, 0, m_nXGridMax, dWaterLevel, pucState + ulGetCellIndex(0, nY));
+}
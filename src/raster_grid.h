@@ -27,12 +27,73 @@ This program is distributed in the hope that it will be useful, but WITHOUT ANY
 You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
 ===============================================================================================================================*/
+#include <stdint.h>
+
+#include <vector>
+using std::vector;
+
+#include <string>
+using std::string;
+
 #include "cme.h"
 #include "cell.h"
+#include "grid_tile.h"
 
 class CGeomCell;           // Forward declaration
 class CSimulation;         // Ditto
 
+//! A lightweight handle to one column of the row-major cell block, so that cells can still be addressed as m_Cell[nX][nY]
+class CGeomCellColumn
+{
+private:
+   //! The cell at the top (nY = 0) of this column
+   CGeomCell* m_pTopCell;
+
+   //! The distance between vertically adjacent cells, which is the number of cells in a row
+   int m_nRowStride;
+
+public:
+   CGeomCellColumn(CGeomCell* pTopCellIn, int const nRowStrideIn)
+   : m_pTopCell(pTopCellIn),
+     m_nRowStride(nRowStrideIn)
+   {
+   }
+
+   CGeomCell& operator[](int const nY) const
+   {
+      return m_pTopCell[static_cast<long>(nY) * m_nRowStride];
+   }
+};
+
+//! The row-major 2D array of cells, indexed as [nX][nY] for compatibility with the original 2D c-style array
+class CGeomCellArray
+{
+private:
+   //! The first cell in the row-major cell block
+   CGeomCell* m_pBlock;
+
+   //! The number of cells in a row
+   int m_nRowStride;
+
+public:
+   CGeomCellArray(void)
+   : m_pBlock(NULL),
+     m_nRowStride(0)
+   {
+   }
+
+   void Set(CGeomCell* pBlockIn, int const nRowStrideIn)
+   {
+      m_pBlock = pBlockIn;
+      m_nRowStride = nRowStrideIn;
+   }
+
+   CGeomCellColumn operator[](int const nX) const
+   {
+      return CGeomCellColumn(m_pBlock + nX, m_nRowStride);
+   }
+};
+
 class CGeomRasterGrid
 {
    //! The CSimulation class is a friend of the CGeomRasterGrid class
@@ -41,7 +102,31 @@ class CGeomRasterGrid
    //! The CGeomProfile is a friend of the CGeomRasterGrid class
    friend class CGeomProfile;
 
+   //! The CGeomCell class is a friend of the CGeomRasterGrid class, since its per-cell values are held in the grid's field planes
+   friend class CGeomCell;
+
 private:
+   //! The number of cells in the x direction
+   int m_nXGridMax;
+
+   //! The number of cells in the y direction
+   int m_nYGridMax;
+
+   //! The total number of cells in the grid, this is also the length of each field plane
+   unsigned long m_ulNumCells;
+
+   //! The number of words in each flag bit plane
+   unsigned long m_ulNumFlagWords;
+
+   //! The number of sediment layers above the basement, this is fixed for the whole simulation
+   int m_nLayers;
+
+   //! The number of tiles in the x direction
+   int m_nXTiles;
+
+   //! The number of tiles in the y direction
+   int m_nYTiles;
+
    //! The d50 of fine-sized  sediment
    double m_dD50Fine;
 
@@ -54,8 +139,63 @@ private:
    //! A pointer to the CSimulation object
    CSimulation* m_pSim;
 
-   //! The 2D array of m_Cell objects. A c-style 2D array seems to be faster than using 2D STL vectors
-   CGeomCell** m_Cell;
+   //! All CGeomCell objects, in a single contiguous block in row-major order (i.e. the same order as a GDAL raster band). The position of a cell in this block is its index into the field planes
+   CGeomCell* m_pCellBlock;
+
+   //! The 2D array of m_Cell objects, addressed as m_Cell[nX][nY] but stored row-major in m_pCellBlock
+   CGeomCellArray m_Cell;
+
+   //! The double-valued field planes, indexed by the CELL_DBL_* codes. Each plane is aligned to GRID_PLANE_ALIGNMENT and holds one value per cell, in the same row-major order as m_pCellBlock
+   double* m_pdCellField[NUM_CELL_DBL_FIELDS];
+
+   //! The diagnostic and wave field planes, indexed by the CELL_DIAG_* codes. These are held as diag_t, which is float if CME_FLOAT_DIAGNOSTICS is defined
+   diag_t* m_ptDiagField[NUM_CELL_DIAG_FIELDS];
+
+   //! The int-valued field planes, indexed by the CELL_INT_* codes
+   int* m_pnCellField[NUM_CELL_INT_FIELDS];
+
+   //! The flag bit planes, indexed by the CELL_FLAG_* codes. Each packs the flags of 64 cells into a word, in the same order as m_pCellBlock: the flag for cell index n is bit (n % 64) of word (n / 64). Unused bits in the last word are always zero
+   uint64_t* m_pulCellFlag[NUM_CELL_FLAGS];
+
+   //! The horizon cube: m_nLayers + 1 layer-top elevations for each cell, in the same order as m_pCellBlock. Element 0 is the top of the basement, the last element is the top of the sediment (which is also cached in the CELL_DBL_SEDIMENT_TOP_ELEV plane)
+   double* m_pdHorizonTopElev;
+
+   //! Are the field planes, the tiles' layers and the horizon cube held in a memory-mapped file, rather than in RAM?
+   bool m_bMemoryMapped;
+
+   //! The file descriptor of the memory-mapped file, or -1 if it has not been opened
+   int m_nMappedFile;
+
+   //! The current length of the memory-mapped file, in bytes
+   unsigned long m_ulMappedFileBytes;
+
+   //! The pathname of the memory-mapped file
+   string m_strMappedFile;
+
+   //! The start of each region of the memory-mapped file which is mapped into memory, one per field plane, one for all tiles' layers and one for the horizon cube
+   vector<char*> m_VpcMappedRegion;
+
+   //! The length in bytes of each mapped region
+   vector<unsigned long> m_VulMappedRegionBytes;
+
+   //! The grid tiles, in row-major order. Each covers GRID_TILE_SIZE x GRID_TILE_SIZE cells, except for those at the right and bottom edges of the grid, which may be smaller. Each tile holds the sediment layers of its cells
+   vector<CGeomGridTile> m_VTile;
+
+   //! The indices of the cells which have been marked by MarkCellSedimentDirty() since the dirty-cell list was last cleared. Each cell appears only once, since it is also flagged with CELL_FLAG_SEDIMENT_DIRTY
+   vector<unsigned long> m_VulDirtyCell;
+
+   //! For each cell in m_VulDirtyCell, NUM_SEDIMENT_TOTALS values (indexed by the SEDIMENT_TOTAL_* codes): the cell's sediment totals when it was marked, i.e. before its sediment was changed
+   vector<double> m_VdDirtyCellOldTotals;
+
+   //! Is m_VulDirtyCell a complete list of the cells whose sediment has changed since the list was last cleared? This is false until the list is first cleared, and becomes false if the sediment of a cell changes without the cell first being marked
+   bool m_bDirtyCellsComplete;
+
+   void SetAllFieldDefaults(void);
+   char* pcMapRegion(unsigned long const);
+   void UnmapAllRegions(void);
+
+   template <class T>
+   T* ptAllocFieldPlane(unsigned long const);
 
 public:
    explicit CGeomRasterGrid(CSimulation*);
@@ -63,6 +203,107 @@ public:
 
    CSimulation* pGetSim(void);
 //    CGeomCell* pGetCell(int const, int const);
+   void SetMemoryMapped(string const&);
+   bool bIsMemoryMapped(void) const;
    int nCreateGrid(void);
+   int nCreateTileLayers(int const);
+   int nGetNumLayers(void) const;
+   unsigned long ulGetNumCells(void) const;
+
+   //! Returns the number of cells between vertically adjacent cells, this is the same as the number of cells in a row
+   int nGetRowStride(void) const
+   {
+      return m_nXGridMax;
+   }
+
+   //! Returns the index of a cell in the row-major cell block and in all field planes
+   unsigned long ulGetCellIndex(int const nX, int const nY) const
+   {
+      return (static_cast<unsigned long>(nY) * m_nXGridMax) + nX;
+   }
+
+   double* pdGetField(int const);
+   diag_t* ptGetDiagField(int const);
+   int* pnGetField(int const);
+
+   //! Returns the flag for a cell, given the cell's index
+   bool bGetFlag(int const nFlag, unsigned long const ulIndex) const
+   {
+      return ((m_pulCellFlag[nFlag][ulIndex >> 6] >> (ulIndex & 63)) & 1) != 0;
+   }
+
+   //! Sets or clears the flag for a cell, given the cell's index
+   void SetFlag(int const nFlag, unsigned long const ulIndex, bool const bValue)
+   {
+      uint64_t ulBit = static_cast<uint64_t>(1) << (ulIndex & 63);
+      if (bValue)
+         m_pulCellFlag[nFlag][ulIndex >> 6] |= ulBit;
+      else
+         m_pulCellFlag[nFlag][ulIndex >> 6] &= ~ulBit;
+   }
+
+   uint64_t const* pulGetFlagWords(int const) const;
+   unsigned long ulGetNumFlagWords(void) const;
+   void ClearFlag(int const);
+   void CopyFlag(int const, int const);
+   unsigned long ulCountFlag(int const) const;
+   unsigned long ulCountFlagIntersection(int const, int const) const;
+   void InitAllCells(void);
+
+   void MarkCellSedimentDirty(int const, int const);
+   bool bDirtyCellsComplete(void) const;
+   unsigned long ulGetNumDirtyCells(void) const;
+   void SumDirtyCellSedimentChanges(double*) const;
+   double dGetMaxDirtyCellSedimentChange(void) const;
+   void SumAllCellsSedimentTotals(double*) const;
+   void ClearDirtyCells(void);
+   void GetInundationRowSpan(int const, int const, int const, double const, unsigned char*) const;
+   void GetInundation(double const, unsigned char*) const;
+
+   int nGetNumTiles(void) const;
+   CGeomGridTile* pGetTile(int const);
+   void IncrAllTilesQuietTimesteps(void);
+   void SetTilesActiveAroundCell(int const, int const);
+   unsigned long ulCountUniformTiles(void) const;
+   unsigned long ulCompactUniformTiles(void);
+   unsigned long ulCountCompactTiles(void) const;
+   unsigned long ulGetLayerBytes(void) const;
+
+   //! Returns the index of the tile which contains a cell
+   int nGetTileIndex(int const nX, int const nY) const
+   {
+      return ((nY / GRID_TILE_SIZE) * m_nXTiles) + (nX / GRID_TILE_SIZE);
+   }
+
+   //! Returns a pointer to a cell's layers, given the cell's index, for reading only. If the cell's tile is compact, these layers are shared by every cell in the tile
+   CRWCellLayer const* pGetCellLayers(unsigned long const ulIndex) const
+   {
+      int nX = static_cast<int>(ulIndex % m_nXGridMax);
+      int nY = static_cast<int>(ulIndex / m_nXGridMax);
+      return m_VTile[nGetTileIndex(nX, nY)].pGetCellLayers(nX, nY, m_nLayers);
+   }
+
+   //! Returns a pointer to a cell's layers, given the cell's index, so that they can be written. If the cell's tile is compact, it is expanded first
+   CRWCellLayer* pGetCellLayersForWrite(unsigned long const ulIndex)
+   {
+      int nX = static_cast<int>(ulIndex % m_nXGridMax);
+      int nY = static_cast<int>(ulIndex / m_nXGridMax);
+      CGeomGridTile* pTile = &m_VTile[nGetTileIndex(nX, nY)];
+      if (pTile->bIsCompact())
+         pTile->ExpandLayers(m_nLayers);
+
+      return pTile->pGetCellLayers(nX, nY, m_nLayers);
+   }
+
+   //! Called just after a cell's sediment has changed, given the cell's index. Marks the tile which contains the cell as having had a change to its sediment. Also, if the cell was not marked by MarkCellSedimentDirty() before the change, the dirty-cell list is no longer complete
+   void SetCellSedimentChanged(unsigned long const ulIndex)
+   {
+      int nX = static_cast<int>(ulIndex % m_nXGridMax);
+      int nY = static_cast<int>(ulIndex / m_nXGridMax);
+      m_VTile[nGetTileIndex(nX, nY)].SetSedimentChanged();
+
+      if (! bGetFlag(CELL_FLAG_SEDIMENT_DIRTY, ulIndex))
+         m_bDirtyCellsComplete = false;
+   }
 };
 #endif // RASTERGRID_H
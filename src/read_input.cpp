@@ -1347,6 +1347,10 @@ bool CSimulation::bReadRunDataFile(void)
                   m_bSuspSedTSSave =
                   m_bFloodSetupSurgeTSSave =
                   m_bFloodSetupSurgeRunupTSSave = true;
+
+                  // The main loop stage times are not model output, so are not included in "all" but may be listed alongside it
+                  if (strRH.find(TIME_SERIES_STAGE_TIMES_CODE) != string::npos)
+                     m_bStageTimesTSSave = true;
                }
                else
                {
@@ -1422,6 +1426,12 @@ bool CSimulation::bReadRunDataFile(void)
                      strRH = strRemoveSubstr(&strRH, &TIME_SERIES_FLOOD_SETUP_SURGE_RUNUP_CODE);
                   }
 
+                  if (strRH.find(TIME_SERIES_STAGE_TIMES_CODE) != string::npos)
+                  {
+                     m_bStageTimesTSSave = true;
+                     strRH = strRemoveSubstr(&strRH, &TIME_SERIES_STAGE_TIMES_CODE);
+                  }
+
                   // Check to see if all codes have been removed
                   if (! strRH.empty())
                      strErr = "line " + to_string(nLine) + ": unknown code '" + strRH + "' in list of time series output files";
@@ -2951,6 +2961,104 @@ bool CSimulation::bReadRunDataFile(void)
                strErr = "line " + to_string(nLine) + ": size of moving window for coastline curvature calculation (must be > 0 and odd)";
 
             break;
+
+         case 88:
+            // Grid backend: RAM or MMAP (this item is optional, if it is absent then the grid is held in RAM)
+            strRH = strToLower(&strRH);
+
+            m_bGridMemoryMapped = false;
+            if (strRH.find("mmap") != string::npos)
+            {
+#ifdef _WIN32
+               cerr << WARN << "line " << to_string(nLine) << ": memory-mapped grid backend is not available on this platform, the grid will be held in RAM" << endl;
+#else
+               m_bGridMemoryMapped = true;
+#endif
+            }
+            else if (strRH.find("ram") == string::npos)
+               strErr = "line " + to_string(nLine) + ": grid backend must be RAM or MMAP";
+
+            break;
+
+         case 89:
+            // Wave propagation reuse: the maximum number of consecutive timesteps for which the results of a wave propagation may be reused, then the tolerances for deep water wave height (m), deep water wave period (s), deep water wave orientation (degrees), still water level (m), and per-cell sediment thickness change (m). This item is optional, if it is absent or the maximum is zero then waves are propagated every timestep
+            VstrTmp = VstrSplit(&strRH, SPACE);
+            if (VstrTmp.size() < 6)
+            {
+               strErr = "line " + to_string(nLine) + ": wave propagation reuse needs six values: maximum consecutive reuses, then tolerances for wave height, wave period, wave orientation, still water level, and sediment thickness change";
+               break;
+            }
+
+            for (unsigned int j = 0; j < 6; j++)
+            {
+               VstrTmp[j] = strTrim(&VstrTmp[j]);
+
+               if (((j == 0) && (! bIsStringValidInt(VstrTmp[j]))) || ((j > 0) && (! bIsStringValidDouble(VstrTmp[j]))))
+               {
+                  strErr = "line " + to_string(nLine) + ": invalid number '" + VstrTmp[j] + "' for wave propagation reuse in " + m_strDataPathName;
+                  break;
+               }
+            }
+
+            if (! strErr.empty())
+               break;
+
+            m_nMaxWaveReuses = stoi(VstrTmp[0]);
+            m_dWaveReuseHeightTolerance = strtod(VstrTmp[1].c_str(), NULL);
+            m_dWaveReusePeriodTolerance = strtod(VstrTmp[2].c_str(), NULL);
+            m_dWaveReuseAngleTolerance = strtod(VstrTmp[3].c_str(), NULL);
+            m_dWaveReuseSWLTolerance = strtod(VstrTmp[4].c_str(), NULL);
+            m_dWaveReuseBedTolerance = strtod(VstrTmp[5].c_str(), NULL);
+
+            if (m_nMaxWaveReuses < 0)
+               strErr = "line " + to_string(nLine) + ": maximum consecutive wave propagation reuses must be >= 0";
+
+            else if ((m_dWaveReuseHeightTolerance < 0) || (m_dWaveReusePeriodTolerance < 0) || (m_dWaveReuseAngleTolerance < 0) || (m_dWaveReuseSWLTolerance < 0) || (m_dWaveReuseBedTolerance < 0))
+               strErr = "line " + to_string(nLine) + ": wave propagation reuse tolerances must be >= 0";
+
+            break;
+
+         case 90:
+            // Skip profiles, polygons, wave propagation and sediment movement in timesteps when waves are off-shore at every coast point? (this item is optional, if it is absent then these are never skipped)
+            strRH = strToLower(&strRH);
+
+            m_bSkipOffshoreTimesteps = false;
+            if (strRH.find("y") != string::npos)
+               m_bSkipOffshoreTimesteps = true;
+            break;
+
+         case 91:
+            // Number of threads for the end-of-timestep tasks: zero means one per processor core, one means that the tasks are run one after the other (this item is optional, if it is absent then the tasks are run one after the other)
+            if (! bIsStringValidInt(strRH))
+            {
+               strErr = "line " + to_string(nLine) + ": invalid integer for number of threads for end-of-timestep tasks '" + strRH + "' in " + m_strDataPathName;
+               break;
+            }
+
+            m_nTaskThreads = stoi(strRH);
+
+            if (m_nTaskThreads < 0)
+               strErr = "line " + to_string(nLine) + ": number of threads for end-of-timestep tasks must be >= 0";
+
+            break;
+
+         case 92:
+            // Check the results of optimised calculations against the results of the calculations which they replace? For testing only (this item is optional, if it is absent then there are no checks)
+            strRH = strToLower(&strRH);
+
+            m_bCheckOptimisations = false;
+            if (strRH.find("y") != string::npos)
+               m_bCheckOptimisations = true;
+            break;
+
+         case 93:
+            // If all cells have the same deep water wave values, calculate polygon d50 and fill wave calculation holes only within the active window? (this item is optional, if it is absent then this is done over the whole grid)
+            strRH = strToLower(&strRH);
+
+            m_bFillHolesInActiveWindow = false;
+            if (strRH.find("y") != string::npos)
+               m_bFillHolesInActiveWindow = true;
+            break;
          }
 
          // Did an error occur?
@@ -16,6 +16,7 @@ cshorelibrary=SHARED
 #cshoreinout=FILE
 cshoreinout=ARG
 #cshoreinout=BOTH
+#cshoreinout=ARG_REENTRANT
 
 # Always build CShore
 echo "Building all versions of the CShore library"
@@ -38,6 +38,12 @@ using std::setprecision;
 #include <string>
 using std::to_string;
 
+#include <sstream>
+using std::ostringstream;
+
+#include <thread>
+using std::thread;
+
 #include "cme.h"
 #include "simulation.h"
 #include "raster_grid.h"
@@ -124,6 +130,7 @@ CSimulation::CSimulation (void)
    m_bSuspSedTSSave =
    m_bFloodSetupSurgeTSSave =
    m_bFloodSetupSurgeRunupTSSave =
+   m_bStageTimesTSSave =
    m_bCliffCollapseDepositionTSSave =
    m_bCliffCollapseErosionTSSave =
    m_bCliffCollapseNetTSSave =
@@ -139,6 +146,11 @@ CSimulation::CSimulation (void)
    m_bOmitSearchWestEdge =
    m_bOmitSearchEastEdge =
    m_bErodeShorePlatformAlternateDirection =
+   m_bGridMemoryMapped =
+   m_bSkipOffshoreTimesteps =
+   m_bFillHolesInActiveWindow =
+   m_bCheckOptimisations =
+   m_bAddToCShoreBatch =
    m_bDoShorePlatformErosion =
    m_bDoCliffCollapse =
    m_bDoBeachSedimentTransport =
@@ -147,6 +159,7 @@ CSimulation::CSimulation (void)
    m_bScaleRasterOutput =
    m_bWorldFile =
    m_bSingleDeepWaterWaveValues =
+   m_bEndIterSuspFineAllCellsValid =
    m_bHaveWaveStationData =
    m_bSedimentInput =
    m_bSedimentInputAtPoint =
@@ -170,6 +183,8 @@ CSimulation::CSimulation (void)
 
    m_bGDALCanCreate = true;
 
+   m_bErodeShorePlatformForward = true;
+
    m_papszGDALRasterOptions =
    m_papszGDALVectorOptions = NULL;
 
@@ -195,6 +210,7 @@ CSimulation::CSimulation (void)
    m_nUnconsSedimentHandlingAtGridEdges =
    m_nBeachErosionDepositionEquation =
    m_nWavePropagationModel =
+   m_nCShoreArrayOutSize =
    m_nSimStartSec =
    m_nSimStartMin =
    m_nSimStartHour =
@@ -204,8 +220,11 @@ CSimulation::CSimulation (void)
    m_nDeepWaterWaveDataNumTimeSteps =
    m_nLogFileDetail =
    m_nRunUpEquation = 
-   m_nLevel =
-   m_nCoastCurvatureMovingWindowSize = 0;
+   m_nCoastCurvatureMovingWindowSize =
+   m_nMaxWaveReuses = 0;
+
+   // By default, the end-of-timestep tasks are run one after the other
+   m_nTaskThreads = 1;
 
    // TODO 011 May wish to make this a user-supplied value
    m_nMissingValue = INT_NODATA;
@@ -215,6 +234,15 @@ CSimulation::CSimulation (void)
    m_nYMinBoundingBox = INT_MAX;
    m_nYMaxBoundingBox = INT_MIN;
 
+   m_nXMinActiveWindow =
+   m_nYMinActiveWindow =
+   m_nXMinLastActiveWindow =
+   m_nYMinLastActiveWindow = INT_MAX;
+   m_nXMaxActiveWindow =
+   m_nYMaxActiveWindow =
+   m_nXMaxLastActiveWindow =
+   m_nYMaxLastActiveWindow = INT_MIN;
+
    m_GDALWriteIntDataType =
    m_GDALWriteFloatDataType = GDT_Unknown;
 
@@ -223,12 +251,16 @@ CSimulation::CSimulation (void)
 
    m_ulIter =
    m_ulTotTimestep =
+   m_ulMainLoopHeapAllocations =
    m_ulThisIterNumPotentialBeachErosionCells =
    m_ulThisIterNumActualBeachErosionCells =
    m_ulThisIterNumBeachDepositionCells =
    m_ulTotPotentialPlatformErosionOnProfiles =
    m_ulTotPotentialPlatformErosionBetweenProfiles =
-   m_ulMissingValueBasementCells = 0;
+   m_ulMissingValueBasementCells =
+   m_ulNumFullSeaFills =
+   m_ulNumIncrementalSeaFills =
+   m_ulNumOffshoreTimesteps = 0;
    m_ulNumCells =
    m_ulThisIterNumSeaCells =
    m_ulThisIterNumCoastCells =
@@ -265,8 +297,6 @@ CSimulation::CSimulation (void)
    m_dFinalSWL =
    m_dDeltaSWLPerTimestep =
    m_dBreakingWaveHeight =
-   m_dC_0 =
-   m_dL_0 =
    m_dWaveDepthRatioForWaveCalcs =
    m_dAllCellsDeepWaterWaveHeight =
    m_dAllCellsDeepWaterWaveAngle =
@@ -334,6 +364,11 @@ CSimulation::CSimulation (void)
    m_dThisIterCliffCollapseSandErodedDuringDeposition =
    m_dThisIterCliffCollapseCoarseErodedDuringDeposition =
    m_dCoastNormalRandSpacingFactor =
+   m_dWaveReuseHeightTolerance =
+   m_dWaveReusePeriodTolerance =
+   m_dWaveReuseAngleTolerance =
+   m_dWaveReuseSWLTolerance =
+   m_dWaveReuseBedTolerance =
    m_dDeanProfileStartAboveSWL =
    m_dAccumulatedSeaLevelChange =
    m_dBreakingWaveHeightDepthRatio =
@@ -345,6 +380,7 @@ CSimulation::CSimulation (void)
    m_dThisiterUnconsCoarseInput = 
    m_dStartIterSuspFineAllCells =
    m_dStartIterSuspFineInPolygons =
+   m_dEndIterSuspFineAllCells =
    m_dStartIterUnconsFineAllCells =
    m_dStartIterUnconsSandAllCells =
    m_dStartIterUnconsCoarseAllCells =
@@ -420,6 +456,10 @@ CSimulation::CSimulation (void)
 //===============================================================================================================================
 CSimulation::~CSimulation (void)
 {
+   // Delete any scratch directories used for CShore files
+   for (unsigned int n = 0; n < m_VCShoreWorkspace.size(); n++)
+      m_VCShoreWorkspace[n].RemoveScratchDir();
+
    // Close output files if open
    if (LogStream && LogStream.is_open())
    {
@@ -487,6 +527,12 @@ CSimulation::~CSimulation (void)
       FloodSetupSurgeRunupTSStream.close();
    }
 
+   if (StageTimesTSStream && StageTimesTSStream.is_open())
+   {
+      StageTimesTSStream.flush();
+      StageTimesTSStream.close();
+   }
+
    if (m_pRasterGrid)
       delete m_pRasterGrid;
 }
@@ -634,6 +680,8 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
 
    // Create the raster grid object
    m_pRasterGrid = new CGeomRasterGrid (this);
+   if (m_bGridMemoryMapped)
+      m_pRasterGrid->SetMemoryMapped(m_strOutPath + GRID_MMAP_FILE);
 
    // Read in the basement layer (must have this file), create the raster grid, then read in the basement DEM data to the array
    AnnounceReadBasementDEM();
@@ -691,9 +739,9 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
    // We have at least one filename for the first layer, so add the correct number of layers. Note the the number of layers does not change during the simulation: however layers can decrease in thickness until they have zero thickness
    AnnounceAddLayers();
 
-   for (int nX = 0; nX < m_nXGridMax; nX++)
-      for (int nY = 0; nY < m_nYGridMax; nY++)
-         m_pRasterGrid->m_Cell[nX][nY].AppendLayers (m_nLayers);
+   nRet = m_pRasterGrid->nCreateTileLayers(m_nLayers);
+   if (nRet != RTN_OK)
+      return nRet;
 
    // Tell the user what is happening then read in the layer files
    AnnounceReadRasterFiles();
@@ -884,10 +932,59 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
       m_dAccumulatedSeaLevelChange -= m_dDeltaSWLPerTimestep;
    }
 
+   // Start the threads on which the end-of-timestep tasks are run: if the user did not say how many, use one per processor core
+   int nTaskThreads = m_nTaskThreads;
+   if (nTaskThreads == 0)
+      nTaskThreads = static_cast<int>(thread::hardware_concurrency());
+
+#if defined CSHORE_ARG_INOUT || CSHORE_BOTH
+   // Ask the CShore library how many values it outputs for each profile, so that there is room for these
+   if (m_nWavePropagationModel == WAVE_MODEL_CSHORE)
+   {
+      CShoreArrayOutSize(&m_nCShoreArrayOutSize);
+
+      m_CShorePool.SetArrayOutSize(m_nCShoreArrayOutSize);
+      m_CShoreBatch.SetArrayOutSize(m_nCShoreArrayOutSize);
+   }
+#endif
+
+#if defined CSHORE_ARG_INOUT && ! defined CSHORE_REENTRANT
+   // CShore can only be run once in any process, so if waves are propagated with CShore on more than one thread then start a CShore worker process for each thread. This must be done before the threads are started
+   if ((m_nWavePropagationModel == WAVE_MODEL_CSHORE) && (nTaskThreads > 1))
+   {
+      if (! m_CShorePool.bStart(nTaskThreads))
+         return RTN_ERR_CSHORE_WORKER;
+   }
+#endif
+
+   m_TaskGraph.Start(this, nTaskThreads);
+
+   // Each thread which may run CShore has its own set of vectors for doing so
+   if (m_nWavePropagationModel == WAVE_MODEL_CSHORE)
+   {
+      m_VCShoreWorkspace.resize(m_TaskGraph.nGetNumThreads());
+      for (unsigned int n = 0; n < m_VCShoreWorkspace.size(); n++)
+         m_VCShoreWorkspace[n].SetArrayOutSize(m_nCShoreArrayOutSize);
+
+#if defined CSHORE_FILE_INOUT || CSHORE_BOTH
+      // And since CShore's files are exchanged via a directory, each thread also has its own scratch directory, so there is no need to change the working directory
+      for (unsigned int n = 0; n < m_VCShoreWorkspace.size(); n++)
+      {
+         if (! m_VCShoreWorkspace[n].bCreateScratchDir(static_cast<int>(n)))
+         {
+            cerr << ERR << "cannot create a scratch directory for CShore files" << endl;
+            return RTN_ERR_CSHORE_SCRATCH_DIR;
+         }
+      }
+#endif
+   }
+
    // ===================================================== The main loop ======================================================
    // Tell the user what is happening
    AnnounceIsRunning();
 
+   unsigned long ulHeapAllocationsAtLoopStart = CTimestepArena::ulGetNumHeapAllocations();
+
    while (true)
    {
       //       // DEBUG CODE =========================================
@@ -905,46 +1002,78 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
          LogStream << "TIMESTEP " << m_ulIter << " " << string(154, '=') << endl;
       
       LogStream << std::fixed << setprecision(3);
+
+      // Start timing this timestep's stages
+      m_StageProfiler.StartTimestep();
       
       // Check to see if there is a new intervention in place: if so, update it on the RasterGrid array
-      nRet = nUpdateIntervention();
-      if (nRet != RTN_OK)
-         return nRet;
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_UPDATE_INTERVENTION);
+
+         nRet = nUpdateIntervention();
+         if (nRet != RTN_OK)
+            return nRet;
+      }
 
       // Calculate changes due to external forcing
-      nRet = nCalcExternalForcing();
-      if (nRet != RTN_OK)
-         return nRet;
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_EXTERNAL_FORCING);
+
+         nRet = nCalcExternalForcing();
+         if (nRet != RTN_OK)
+            return nRet;
+      }
 
       // Do per-timestep intialization: set up the grid cells ready for this timestep, also initialize per-timestep totals. Note that in the first timestep, all cells (including hinterland cells) are given the deep water wave values
-      nRet = nInitGridAndCalcStillWaterLevel();
-      if (nRet != RTN_OK)
-         return nRet;
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_INIT_GRID);
+
+         nRet = nInitGridAndCalcStillWaterLevel();
+         if (nRet != RTN_OK)
+            return nRet;
+      }
 
       // Next find out which cells are inundated and locate the coastline(s). This also gives to all sea cells, wave values which are the same as the deep water values. For shallow water sea cells, these wave values will be changed later, in nDoAllPropagateWaves()
       int nValidCoast = 0;
-      nRet = nLocateSeaAndCoasts(nValidCoast);
-      if (nRet != RTN_OK)
-         return nRet;
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_LOCATE_SEA_AND_COASTS);
+
+         nRet = nLocateSeaAndCoasts(nValidCoast);
+         if (nRet != RTN_OK)
+            return nRet;
+      }
+
+      // Now that we know where the coastlines are, sort out which raster grid tiles are active, and which are uniform and can be skipped
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_CLASSIFY_TILES);
+
+         ClassifyGridTilesNearCoasts();
+      }
       
       // Tell the user how the simulation is progressing
       AnnounceProgress();
 
       // Locate estuaries TODO 044 someday...
 
-      // Sort out hinterland landforms
-      nRet = nAssignNonCoastlineLandforms();
-      if (nRet != RTN_OK)
-         return nRet;
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_ASSIGN_LANDFORMS);
 
-      // For each coastline, use classification rules to assign landform categories
-      nRet = nAssignAllCoastalLandforms();
-      if (nRet != RTN_OK)
-         return nRet;
+         // Sort out hinterland landforms
+         nRet = nAssignNonCoastlineLandforms();
+         if (nRet != RTN_OK)
+            return nRet;
+
+         // For each coastline, use classification rules to assign landform categories
+         nRet = nAssignAllCoastalLandforms();
+         if (nRet != RTN_OK)
+            return nRet;
+      }
 
       // If we have sediment input events, then check to see whether this is time for an event to occur. If it is, then do it
       if (m_bSedimentInput)
       {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_SEDIMENT_INPUT);
+
          m_bSedimentInputThisIter = false;
 
          nRet = nCheckForSedimentInputEvent();
@@ -952,44 +1081,80 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
             return nRet;
       }
 
+      // Will GIS files be saved this timestep?
+      bool bSaveGIS = ((m_bSaveRegular && (m_dSimElapsed >= m_dRegularSaveTime) && (m_dSimElapsed < m_dSimDuration)) || (! m_bSaveRegular && (m_dSimElapsed >= m_dUSaveTime[m_nThisSave])));
+
+      // If the user wishes, check whether waves are off-shore at every coast point. If so, wave propagation, shore platform erosion, cliff collapse, and beach erosion and deposition would change nothing, so skip these, and the creation of profiles and polygons. But not if GIS files are to be saved, since these include profiles, polygons, and wave values
+      bool bWavesOffshore = false;
+      if (m_bSkipOffshoreTimesteps && (! bSaveGIS) && bAreWavesOffshoreEverywhere())
+      {
+         bWavesOffshore = true;
+         m_ulNumOffshoreTimesteps++;
+
+         // Keep the direction of shore platform erosion the same as if the stage had been done
+         if (m_bDoShorePlatformErosion && m_bErodeShorePlatformAlternateDirection)
+            m_bErodeShorePlatformForward = ! m_bErodeShorePlatformForward;
+
+         if (m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL)
+            LogStream << m_ulIter << ": waves off-shore at every coast point, skipping profiles, polygons, wave propagation, and sediment movement" << endl;
+      }
+
       // Create the coastline-normal profiles
-      nRet = nCreateAllProfilesAndCheckForIntersection();
-      if (nRet != RTN_OK)
-         return nRet;
+      if (! bWavesOffshore)
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_CREATE_PROFILES);
+
+         nRet = nCreateAllProfilesAndCheckForIntersection();
+         if (nRet != RTN_OK)
+            return nRet;
+      }
+
+      // Make the raster grid tiles along the profiles active
+      if (! bWavesOffshore)
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_CLASSIFY_TILES);
+
+         SetGridTilesActiveAlongProfiles();
+      }
 
       // Tell the user how the simulation is progressing
       AnnounceProgress();
       
-      // Create the coast polygons
-      nRet = nCreateAllPolygons();
-      if (nRet != RTN_OK)
-         return nRet;
-
-      //       // DEBUG CODE =========================================
-      //       int nNODATA = 0;
-      //       int nPoly0 = 0;
-      //       for (int nX = 0; nX < m_nXGridMax; nX++)
-      //       {
-      //          for (int nY = 0; nY < m_nYGridMax; nY++)
-      //          {
-      //             int nTmp = m_pRasterGrid->m_Cell[nX][nY].nGetPolygonID();
-      //             if (nTmp == INT_NODATA)
-      //                nNODATA++;
-      //             if (nTmp == 0)
-      //                nPoly0++;
-      //          }
-      //       }
-      //       LogStream << "Before marking polygon cells, N cells with NODATA polygon ID = " << nNODATA << endl;
-      //       LogStream << "Before marking polygon cells, N cells with zero polygon ID = " << nPoly0 << endl;
-      //       // DEBUG CODE =========================================
+      // Create the coast polygons, then mark cells of the raster grid that are within each polygon and calculate the length of the shared normal between each polygon and the adjacent polygon(s)
+      if (! bWavesOffshore)
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_CREATE_POLYGONS);
 
-      // Mark cells of the raster grid that are within each polygon
-      MarkPolygonCells();
+         nRet = nCreateAllPolygons();
+         if (nRet != RTN_OK)
+            return nRet;
 
-      // Calculate the length of the shared normal between each polygon and the adjacent polygon(s)
-      nRet = nDoPolygonSharedBoundaries();
-      if (nRet != RTN_OK)
-         return nRet;
+         //       // DEBUG CODE =========================================
+         //       int nNODATA = 0;
+         //       int nPoly0 = 0;
+         //       for (int nX = 0; nX < m_nXGridMax; nX++)
+         //       {
+         //          for (int nY = 0; nY < m_nYGridMax; nY++)
+         //          {
+         //             int nTmp = m_pRasterGrid->m_Cell[nX][nY].nGetPolygonID();
+         //             if (nTmp == INT_NODATA)
+         //                nNODATA++;
+         //             if (nTmp == 0)
+         //                nPoly0++;
+         //          }
+         //       }
+         //       LogStream << "Before marking polygon cells, N cells with NODATA polygon ID = " << nNODATA << endl;
+         //       LogStream << "Before marking polygon cells, N cells with zero polygon ID = " << nPoly0 << endl;
+         //       // DEBUG CODE =========================================
+
+         // Mark cells of the raster grid that are within each polygon
+         MarkPolygonCells();
+
+         // Calculate the length of the shared normal between each polygon and the adjacent polygon(s)
+         nRet = nDoPolygonSharedBoundaries();
+         if (nRet != RTN_OK)
+            return nRet;
+      }
 
       // Tell the user how the simulation is progressing
       AnnounceProgress();
@@ -1014,19 +1179,47 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
 
       // PropagateWind();
 
-      // Give every coast point a value for deep water wave height and direction
-      nRet = nSetAllCoastpointDeepWaterWaveValues();
-      if (nRet != RTN_OK)
-         return nRet;
-      
-      // Change the wave properties in all shallow water sea cells: propagate waves and define the active zone, also locate wave shadow zones
-      nRet = nDoAllPropagateWaves();
-      if (nRet != RTN_OK)
-         return nRet;
+      if (! bWavesOffshore)
+      {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_PROPAGATE_WAVES);
+
+         // Give every coast point a value for deep water wave height and direction
+         nRet = nSetAllCoastpointDeepWaterWaveValues();
+         if (nRet != RTN_OK)
+            return nRet;
+
+         if (bCanReuseWaveCache())
+         {
+            // Forcing, coastlines, and nearshore bathymetry have changed little since waves were last propagated, so reuse the results of that propagation. If we are testing, and the results would be exactly those of propagating waves again, then propagate waves anyway and check the results against those which would have been reused
+            if (m_bCheckOptimisations && bFPIsEqual(m_dWaveReuseHeightTolerance, 0.0, TOLERANCE) && bFPIsEqual(m_dWaveReusePeriodTolerance, 0.0, TOLERANCE) && bFPIsEqual(m_dWaveReuseAngleTolerance, 0.0, TOLERANCE) && bFPIsEqual(m_dWaveReuseSWLTolerance, 0.0, TOLERANCE) && bFPIsEqual(m_dWaveReuseBedTolerance, 0.0, TOLERANCE))
+            {
+               nRet = nCheckWaveCache();
+               if (nRet != RTN_OK)
+                  return nRet;
+            }
+            else
+            {
+               RestoreWaveCache();
+            }
+         }
+         else
+         {
+            if (m_nMaxWaveReuses > 0)
+               StartWaveCache(&m_WaveCache);
+
+            // Change the wave properties in all shallow water sea cells: propagate waves and define the active zone, also locate wave shadow zones
+            nRet = nDoAllPropagateWaves();
+            if (nRet != RTN_OK)
+               return nRet;
+
+            if (m_nMaxWaveReuses > 0)
+               SaveWaveCache(&m_WaveCache);
+         }
+      }
 
 
       // Output polygon share table and pre-existing sediment table to log file
-      if (m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL)
+      if ((m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL) && (! bWavesOffshore))
       {
          for (int nCoast = 0; nCoast < nValidCoast; nCoast++)
          {
@@ -1113,8 +1306,10 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
             LogStream << m_ulIter << ": AT ITERATION START m_dDepositionCoarseDiff = " << m_dDepositionCoarseDiff * m_dCellArea << " m_dUnconsCoarseNotDepositedLastIter = " << m_dUnconsCoarseNotDepositedLastIter << endl;
          }
 
-      if (m_bDoShorePlatformErosion)
+      if (m_bDoShorePlatformErosion && (! bWavesOffshore))
       {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_PLATFORM_EROSION);
+
          // Calculate elevation change on the consolidated sediment which comprises the coastal platform
          nRet = nDoAllShorePlatFormErosion();
          if (nRet != RTN_OK)
@@ -1122,14 +1317,16 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
       }
 
       // Output shore platform erosion table to log file
-      if (m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL)
+      if ((m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL) && (! bWavesOffshore))
       {
          for (int nCoast = 0; nCoast < nValidCoast; nCoast++)
             WritePolygonShorePlatformErosion(nCoast);
       }
 
-      if (m_bDoCliffCollapse)
+      if (m_bDoCliffCollapse && (! bWavesOffshore))
       {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_CLIFF_COLLAPSE);
+
          // Do all cliff collapses for this timestep (if any)
          nRet = nDoAllWaveEnergyToCoastLandforms();
          if (nRet != RTN_OK)
@@ -1137,7 +1334,7 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
       }
 
       // Output cliff collapse table to log file
-      if (m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL)
+      if ((m_nLogFileDetail >= LOG_FILE_MIDDLE_DETAIL) && (! bWavesOffshore))
       {
          for (int nCoast = 0; nCoast < nValidCoast; nCoast++)
             WritePolygonCliffCollapseErosion(nCoast);
@@ -1146,8 +1343,10 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
       // Tell the user how the simulation is progressing
       AnnounceProgress();
 
-      if (m_bDoBeachSedimentTransport)
+      if (m_bDoBeachSedimentTransport && (! bWavesOffshore))
       {
+         CStageTimer StageTimer(&m_StageProfiler, STAGE_BEACH_SEDIMENT);
+
          // Next simulate beach erosion and deposition i.e. simulate alongshore transport of unconsolidated sediment (longshore drift) between polygons. First calculate potential sediment movement between polygons
          DoAllPotentialBeachErosion();
 
@@ -1229,68 +1428,95 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
       //       delete[] pdRaster;
       //       // DEBUG CODE ===========================================
 
+      // The rest of the timestep is run as a set of tasks. Each task says which parts of the simulation's state it reads and writes, so that tasks which are independent of one another can be run at the same time
+      m_TaskGraph.Clear();
+
       // Do some end-of-timestep updates to the raster grid, also update per-timestep and running totals
-      nRet = nUpdateGrid();
-      if (nRet != RTN_OK)
-         return nRet;
+      m_TaskGraph.AddTask(TASK_UPDATE_GRID, STAGE_UPDATE_GRID, TASK_STATE_COASTS, TASK_STATE_GRID | TASK_STATE_TOTALS | TASK_STATE_LOG_FILE);
+
+      // Make water level inundation on grid. Each flood level has its own flag planes and water level, so the two levels are independent of one another. They only write to the log file if it is at high detail
+      unsigned long ulFloodLogFile = (m_nLogFileDetail >= LOG_FILE_HIGH_DETAIL ? TASK_STATE_LOG_FILE : 0);
+      bool bLocateFlood = false;
 
-      // Make water level inundation on grid
       if (m_bFloodSWLSetupSurgeLine || m_bSetupSurgeFloodMaskSave)
       {
-         m_nLevel = 0;
-         
-         nRet = nLocateFloodAndCoasts();
-         if (nRet != RTN_OK)
-            return nRet;
+         m_TaskGraph.AddTask(TASK_LOCATE_FLOOD_SETUP_SURGE, STAGE_LOCATE_FLOOD, TASK_STATE_GRID | TASK_STATE_COASTS, TASK_STATE_FLOOD_SETUP_SURGE | ulFloodLogFile);
+         bLocateFlood = true;
       }
 
       if (m_bFloodSWLSetupSurgeRunupLine || m_bSetupSurgeRunupFloodMaskSave)
       {
-         // TODO 007
-         m_nLevel = 1;
-         
-         nRet = nLocateFloodAndCoasts();
-         if (nRet != RTN_OK)
-            return nRet;
+         m_TaskGraph.AddTask(TASK_LOCATE_FLOOD_SETUP_SURGE_RUNUP, STAGE_LOCATE_FLOOD, TASK_STATE_GRID | TASK_STATE_COASTS, TASK_STATE_FLOOD_SETUP_SURGE_RUNUP | ulFloodLogFile);
+         bLocateFlood = true;
       }
 
+      if (bLocateFlood)
+         m_TaskGraph.AddTask(TASK_FINISH_LOCATE_FLOOD, STAGE_LOCATE_FLOOD, TASK_STATE_FLOOD_SETUP_SURGE_RUNUP, TASK_STATE_FLOOD_SETUP_SURGE);
+
       // Now save results, first the raster and vector GIS files if required
       m_bSaveGISThisIter = false;
 
-      if ((m_bSaveRegular && (m_dSimElapsed >= m_dRegularSaveTime) && (m_dSimElapsed < m_dSimDuration)) || (! m_bSaveRegular && (m_dSimElapsed >= m_dUSaveTime[m_nThisSave])))
+      if (bSaveGIS)
       {
          m_bSaveGISThisIter = true;
 
-         // Save the values from the RasterGrid array into raster GIS files
-         if (! bSaveAllRasterGISFiles())
-            return (RTN_ERR_RASTER_FILE_WRITE);
+         // The raster and vector GIS files both use the file number, so increment it before either is saved
+         AdvanceGISSave();
 
-         // Tell the user how the simulation is progressing
-         AnnounceProgress();
+         unsigned long ulGISReads = TASK_STATE_GRID | TASK_STATE_COASTS | TASK_STATE_TOTALS | TASK_STATE_FLOOD_SETUP_SURGE | TASK_STATE_FLOOD_SETUP_SURGE_RUNUP;
 
-         // Save the vector GIS files
-         if (! bSaveAllVectorGISFiles())
-            return (RTN_ERR_VECTOR_FILE_WRITE);
+         // Save the values from the RasterGrid array into raster GIS files
+         m_TaskGraph.AddTask(TASK_SAVE_RASTER_GIS, STAGE_SAVE_GIS, ulGISReads, TASK_STATE_LOG_FILE);
 
-         // Tell the user how the simulation is progressing
-         AnnounceProgress();
+         // Save the vector GIS files. This writes error messages, so is ordered against the other tasks which do so
+         m_TaskGraph.AddTask(TASK_SAVE_VECTOR_GIS, STAGE_SAVE_GIS, ulGISReads, TASK_STATE_LOG_FILE);
       }
 
       // Output per-timestep results to the .out file
-      if (! bWritePerTimestepResults())
-         return (RTN_ERR_TEXT_FILE_WRITE);
+      m_TaskGraph.AddTask(TASK_WRITE_PER_TIMESTEP_RESULTS, STAGE_WRITE_TEXT, TASK_STATE_TOTALS, TASK_STATE_OUT_FILE);
 
       // Now output time series CSV stuff
-      if (! bWriteTSFiles())
-         return (RTN_ERR_TIMESERIES_FILE_WRITE);
+      m_TaskGraph.AddTask(TASK_WRITE_TIME_SERIES, STAGE_WRITE_TEXT, TASK_STATE_TOTALS | TASK_STATE_FLOOD_SETUP_SURGE | TASK_STATE_FLOOD_SETUP_SURGE_RUNUP, TASK_STATE_TIME_SERIES_FILES);
+
+      nRet = m_TaskGraph.nRun();
+
+      // Add the time taken by each task to the time for its stage. If tasks overlapped, the stage times will add up to more than the timestep's time
+      for (int n = 0; n < m_TaskGraph.nGetNumTasks(); n++)
+         m_StageProfiler.AddStageTime(m_TaskGraph.nGetTaskStage(n), m_TaskGraph.dGetTaskTime(n));
+
+      if (nRet != RTN_OK)
+         return nRet;
+
+      // If we are testing, check that every coast still has its history for next timestep, now that all this timestep's tasks (including flood line tracing) have been run
+      if (m_bCheckOptimisations)
+      {
+         nRet = nCheckCoastHistory();
+         if (nRet != RTN_OK)
+            return nRet;
+      }
 
       // Tell the user how the simulation is progressing
       AnnounceProgress();
 
       // Update grand totals
       DoTimestepTotals();
+
+      // Finish timing this timestep's stages, and output the stage times if required
+      m_StageProfiler.EndTimestep();
+
+      if (m_bStageTimesTSSave)
+      {
+         StageTimesTSStream << m_dSimElapsed;
+         m_StageProfiler.WriteTimestepTimes(StageTimesTSStream);
+
+         // Did a time series file write error occur?
+         if (StageTimesTSStream.fail())
+            return (RTN_ERR_TIMESERIES_FILE_WRITE);
+      }
    } // ================================================ End of main loop ======================================================
 
+   m_ulMainLoopHeapAllocations = CTimestepArena::ulGetNumHeapAllocations() - ulHeapAllocationsAtLoopStart;
+
    // =================================================== post-loop tidying =====================================================
    // Tell the user what is happening
    AnnounceSimEnd();
@@ -1302,3 +1528,76 @@ int CSimulation::nDoSimulation(int nArg, char const* pcArgv[])
 
    return RTN_OK;
 }
+
+//===============================================================================================================================
+//! Runs one of the end-of-timestep tasks, this is called by CTaskGraph. Tasks may be run at the same time as one another, so a task must only touch the parts of the simulation's state which it declared when it was added to the task graph
+//===============================================================================================================================
+int CSimulation::nDoTask(int const nTask)
+{
+   switch (nTask)
+   {
+   case TASK_UPDATE_GRID:
+      return nUpdateGrid();
+
+   case TASK_LOCATE_FLOOD_SETUP_SURGE:
+      return nLocateFloodAndCoasts(0);
+
+   case TASK_LOCATE_FLOOD_SETUP_SURGE_RUNUP:
+      return nLocateFloodAndCoasts(1);
+
+   case TASK_FINISH_LOCATE_FLOOD:
+      FinishLocateFlood();
+      break;
+
+   case TASK_SAVE_RASTER_GIS:
+      if (! bSaveAllRasterGISFiles())
+         return (RTN_ERR_RASTER_FILE_WRITE);
+      break;
+
+   case TASK_SAVE_VECTOR_GIS:
+      if (! bSaveAllVectorGISFiles())
+         return (RTN_ERR_VECTOR_FILE_WRITE);
+      break;
+
+   case TASK_WRITE_PER_TIMESTEP_RESULTS:
+      if (! bWritePerTimestepResults())
+         return (RTN_ERR_TEXT_FILE_WRITE);
+      break;
+
+   case TASK_WRITE_TIME_SERIES:
+      if (! bWriteTSFiles())
+         return (RTN_ERR_TIMESERIES_FILE_WRITE);
+      break;
+   }
+
+   return RTN_OK;
+}
+
+//===============================================================================================================================
+//! Runs a task for one item, this is called by CTaskGraph. Items may be run at the same time as one another, so each must only write to its own item's results
+//===============================================================================================================================
+int CSimulation::nDoTaskItem(int const nTask, int const nItem)
+{
+   switch (nTask)
+   {
+   case TASK_PROPAGATE_WAVES_ON_PROFILE:
+   {
+      int nCoast = m_VnWaveItemCoast[nItem];
+
+      m_VVdWaveItemX[nItem].clear();
+      m_VVdWaveItemY[nItem].clear();
+      m_VVdWaveItemHeightX[nItem].clear();
+      m_VVdWaveItemHeightY[nItem].clear();
+      m_VVbWaveItemBreaking[nItem].clear();
+
+      // Other profiles may be writing to their own log text at the same time, so don't write to the log file here
+      ostringstream strmLog;
+      int nRet = nCalcWavePropertiesOnProfile(nCoast, m_VCoast[nCoast].nGetCoastlineSize(), m_VnWaveItemProfile[nItem], &m_VVdWaveItemX[nItem], &m_VVdWaveItemY[nItem], &m_VVdWaveItemHeightX[nItem], &m_VVdWaveItemHeightY[nItem], &m_VVbWaveItemBreaking[nItem], &strmLog);
+      m_VstrWaveItemLog[nItem] = strmLog.str();
+
+      return nRet;
+   }
+   }
+
+   return RTN_OK;
+}
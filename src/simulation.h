@@ -34,6 +34,7 @@ using std::time_t;
 
 #include <fstream>
 using std::ofstream;
+using std::ostream;
 
 #include <string>
 using std::string;
@@ -48,6 +49,14 @@ using std::stack;
 
 #include "line.h"
 #include "i_line.h"
+#include "timestep_arena.h"
+#include "stage_profiler.h"
+#include "coast_history.h"
+#include "wave_cache.h"
+#include "task_graph.h"
+#include "cshore_pool.h"
+#include "cshore_batch.h"
+#include "cshore_workspace.h"
 
 #include "inc/cshore.h"
 
@@ -63,6 +72,8 @@ class CSedInputEvent;
 
 class CSimulation
 {
+   friend class CTaskGraph;
+
 private:
    //! Does this simulation consider fine-sized sediment?
    bool m_bHaveFineSediment;
@@ -307,6 +318,9 @@ private:
    //! Save the flood setup surge runup time series file? TODO 007 Does this work correctly?
    bool m_bFloodSetupSurgeRunupTSSave;
 
+   //! Save the main loop stage times time series file?
+   bool m_bStageTimesTSSave;
+
    //! Save GIS files this iteration?
    bool m_bSaveGISThisIter;
 
@@ -334,6 +348,21 @@ private:
    //! Erode the shore platform in alternate directions each iteration?
    bool m_bErodeShorePlatformAlternateDirection;
 
+   //! Hold the raster grid's field planes and cubes in a memory-mapped file in the output directory, rather than in RAM?
+   bool m_bGridMemoryMapped;
+
+   //! In timesteps when waves are off-shore at every coast point, skip profile and polygon creation, wave propagation, and the shore platform, cliff and beach stages?
+   bool m_bSkipOffshoreTimesteps;
+
+   //! If all cells have the same deep water wave values, calculate polygon d50 and fill wave calculation holes only within the active window, rather than over the whole grid?
+   bool m_bFillHolesInActiveWindow;
+
+   //! Check the results of optimised calculations against the results of the calculations which they replace? For testing only
+   bool m_bCheckOptimisations;
+
+   //! Will shore platform erosion be calculated in the down-coast direction this timestep?
+   bool m_bErodeShorePlatformForward;
+
    //! Simulate shore platform erosion?
    bool m_bDoShorePlatformErosion;
 
@@ -361,6 +390,9 @@ private:
    //! Do we have just a point source for (i.e. only a single measurement of) deep water wave values
    bool m_bSingleDeepWaterWaveValues;
 
+   //! Does m_dEndIterSuspFineAllCells hold the total suspended sediment on all cells, as left by last timestep's nUpdateGrid()?
+   bool m_bEndIterSuspFineAllCellsValid;
+
    //! Do we have wave station data?
    bool m_bHaveWaveStationData;
 
@@ -505,6 +537,30 @@ private:
    //! The maximum y value of the bounding box
    int m_nYMaxBoundingBox;
 
+   //! The minimum x value of this timestep's active window, i.e. the bounding box of all coastline, profile, parallel profile, shadow zone and downdrift zone cells
+   int m_nXMinActiveWindow;
+
+   //! The maximum x value of this timestep's active window
+   int m_nXMaxActiveWindow;
+
+   //! The minimum y value of this timestep's active window
+   int m_nYMinActiveWindow;
+
+   //! The maximum y value of this timestep's active window
+   int m_nYMaxActiveWindow;
+
+   //! The minimum x value of last timestep's active window
+   int m_nXMinLastActiveWindow;
+
+   //! The maximum x value of last timestep's active window
+   int m_nXMaxLastActiveWindow;
+
+   //! The minimum y value of last timestep's active window
+   int m_nYMinLastActiveWindow;
+
+   //! The maximum y value of last timestep's active window
+   int m_nYMaxLastActiveWindow;
+
    //! The wave propagation model used. Possible values are WAVE_MODEL_CSHORE and WAVE_MODEL_COVE
    int m_nWavePropagationModel;
 
@@ -535,11 +591,14 @@ private:
    //! The run-up equation used TODO 007
    int m_nRunUpEquation;
 
-   //! TODO 007 Used in WAVESETUP + SURGE + RUNUP
-   int m_nLevel;
-
    int m_nCoastCurvatureMovingWindowSize;
 
+   //! The maximum number of consecutive timesteps for which the results of a wave propagation may be reused. If zero, waves are propagated every timestep
+   int m_nMaxWaveReuses;
+
+   //! The number of threads on which the end-of-timestep tasks, and wave propagation on each profile, are run. With CShore, this is also the number of CShore worker processes. If zero, there is one thread per processor core; if one, the tasks are run one after the other
+   int m_nTaskThreads;
+
    //! The data type used by GDAL for integer operations, can be GDT_Byte, GDT_Int16, GDT_UInt16, GDT_Int32, or GDT_UInt32
    GDALDataType m_GDALWriteIntDataType;
 
@@ -558,6 +617,9 @@ private:
    //! The target number of iterations
    unsigned long m_ulTotTimestep;
 
+   //! The number of heap allocations made during the main loop, this is only counted if CME_COUNT_HEAP_ALLOCATIONS is defined
+   unsigned long m_ulMainLoopHeapAllocations;
+
    //! A seed for each of the NRNG random number generators
    unsigned long m_ulRandSeed[NRNG];
 
@@ -594,6 +656,15 @@ private:
    //! The number of basement cells marked with as missing value
    unsigned long m_ulMissingValueBasementCells;
 
+   //! The number of times that the sea has been re-flooded from the grid edges
+   unsigned long m_ulNumFullSeaFills;
+
+   //! The number of times that the sea mask has been updated incrementally
+   unsigned long m_ulNumIncrementalSeaFills;
+
+   //! The number of timesteps in which waves were off-shore at every coast point, so profile and polygon creation, wave propagation, and the shore platform, cliff and beach stages were skipped
+   unsigned long m_ulNumOffshoreTimesteps;
+
    //! Multiplier for duration units, to convert to hours
    double m_dDurationUnitsMult;
 
@@ -693,12 +764,6 @@ private:
    //! The height of breaking waves (m)
    double m_dBreakingWaveHeight;
 
-   //! Deep water wave speed (m/s)
-   double m_dC_0;
-
-   //! Deep water wave length (m)
-   double m_dL_0;
-
    //! Start depth for wave calculations
    double m_dWaveDepthRatioForWaveCalcs;
 
@@ -903,6 +968,21 @@ private:
    //! Random factor for spacing of along-coast normals
    double m_dCoastNormalRandSpacingFactor;
 
+   //! The largest change (m) in the deep water wave height for which the results of the last wave propagation may be reused
+   double m_dWaveReuseHeightTolerance;
+
+   //! The largest change (s) in the deep water wave period for which the results of the last wave propagation may be reused
+   double m_dWaveReusePeriodTolerance;
+
+   //! The largest change (degrees) in the deep water wave orientation for which the results of the last wave propagation may be reused
+   double m_dWaveReuseAngleTolerance;
+
+   //! The largest change (m) in the still water level for which the results of the last wave propagation may be reused
+   double m_dWaveReuseSWLTolerance;
+
+   //! The largest change (m) in the sediment thickness of any one cell for which the results of the last wave propagation may be reused
+   double m_dWaveReuseBedTolerance;
+
    //! Berm height i.e. height above SWL of start of depositional Dean profile
    double m_dDeanProfileStartAboveSWL;
 
@@ -933,6 +1013,9 @@ private:
    //! Depth (m) of fine suspended sediment at the start of the simulation (only cells in polygons)
    double m_dStartIterSuspFineInPolygons;
 
+   //! Depth (m) of fine suspended sediment at the end of the timestep, all cells. This is totalled during the same pass through the grid in which nUpdateGrid() distributes suspended sediment, and becomes next timestep's m_dStartIterSuspFineAllCells
+   double m_dEndIterSuspFineAllCells;
+
    //! Depth (m) of fine unconsolidated sediment at the start of the simulation, all cells (both inside and outside polygons)
    double m_dStartIterUnconsFineAllCells;
 
@@ -1306,6 +1389,9 @@ private:
    //! Flood setup surge runup time series file output stream
    ofstream FloodSetupSurgeRunupTSStream;
 
+   //! Main loop stage times time series file output stream
+   ofstream StageTimesTSStream;
+
    //! One element per layer: has the consolidated sediment of this layer been changed during this iteration?
    vector<bool> m_bConsChangedThisIter;
 
@@ -1480,9 +1566,66 @@ private:
    //! Pointer to the raster grid object
    CGeomRasterGrid* m_pRasterGrid;
 
+   //! The per-timestep arena, from which coast landforms and coast polygons are allocated. This must be declared before m_VCoast, so that it is destroyed after the coasts
+   CTimestepArena m_TimestepArena;
+
+   //! Times the stages of the main loop
+   CStageProfiler m_StageProfiler;
+
+   //! The results of the most recent full wave propagation, which may be reused on later timesteps
+   CWaveCache m_WaveCache;
+
+   //! Runs the end-of-timestep tasks, overlapping those which are independent of one another. Also runs wave propagation on all profiles at once
+   CTaskGraph m_TaskGraph;
+
+   //! The CShore worker processes, which let CShore be run for several profiles at once
+   CCShorePool m_CShorePool;
+
+   //! The CShore input and output values for the profiles on a coast, when CShore is run for all of them in a single call
+   CCShoreBatch m_CShoreBatch;
+
+   //! If true, nCalcWavePropertiesOnProfile() adds the profile's CShore input values to m_CShoreBatch instead of running CShore for the profile
+   bool m_bAddToCShoreBatch;
+
+   //! The number of values which CShore outputs for each profile, in each output array. This is got from the CShore library when the simulation starts
+   int m_nCShoreArrayOutSize;
+
+   //! Indexed by task graph thread: the vectors which the thread uses when it runs CShore for a profile
+   vector<CCShoreWorkspace> m_VCShoreWorkspace;
+
+   //! Indexed by item: the coast of each profile on which waves are propagated, items are in coast then profile order
+   vector<int> m_VnWaveItemCoast;
+
+   //! Indexed by item: the profile on which waves are propagated
+   vector<int> m_VnWaveItemProfile;
+
+   //! Indexed by item: the x coordinates of the profile's inundated cells, as calculated by nCalcWavePropertiesOnProfile()
+   vector<vector<double> > m_VVdWaveItemX;
+
+   //! Indexed by item: the y coordinates of the profile's inundated cells
+   vector<vector<double> > m_VVdWaveItemY;
+
+   //! Indexed by item: the x component of wave height at the profile's inundated cells
+   vector<vector<double> > m_VVdWaveItemHeightX;
+
+   //! Indexed by item: the y component of wave height at the profile's inundated cells
+   vector<vector<double> > m_VVdWaveItemHeightY;
+
+   //! Indexed by item: whether waves are breaking at the profile's inundated cells
+   vector<vector<bool> > m_VVbWaveItemBreaking;
+
+   //! Indexed by item: the text which nCalcWavePropertiesOnProfile() wrote to the log file for the profile, this is written to the log file in profile order
+   vector<string> m_VstrWaveItemLog;
+
    //! The coastline objects
    vector<CRWCoast> m_VCoast;
 
+   //! The parts of last timestep's coastline objects which are re-used when this timestep's coastlines are smoothed and have their curvature calculated
+   vector<CCoastHistory> m_VCoastHistory;
+
+   //! The parts of this timestep's coastline objects which will be re-used next timestep
+   vector<CCoastHistory> m_VNewCoastHistory;
+
    //! TODO 007
    vector<CRWCoast> m_VFloodWaveSetupSurge;
 
@@ -1498,6 +1641,21 @@ private:
    //! The grid edge that each edge cell belongs to
    vector<int> m_VEdgeCellEdge;
 
+   //! For each cell, 1 if it is an edge cell from which the sea flood fill may start, 0 otherwise
+   vector<unsigned char> m_VucSeaFillStartCell;
+
+   //! The inundation state of each cell (see CGeomRasterGrid::GetInundation()) for this timestep's SWL
+   vector<unsigned char> m_VucInundation;
+
+   //! The inundation state of each cell when FindAllSeaCells() was last called
+   vector<unsigned char> m_VucLastInundation;
+
+   //! For each cell, 1 if it was in the contiguous sea when FindAllSeaCells() was last called, 0 otherwise. This is kept between timesteps so that it can be updated incrementally
+   vector<unsigned char> m_VucSeaMask;
+
+   //! The cells whose inundation state has changed since FindAllSeaCells() was last called
+   vector<unsigned long> m_VulInundationChanged;
+
    //! The location to compute the total water level for flooding
    vector<int> m_VCellFloodLocation;
 
@@ -1543,8 +1701,16 @@ private:
    int nCheckForSedimentInputEvent(void);
    int nCalcExternalForcing(void);
    int nInitGridAndCalcStillWaterLevel(void);
+#if defined CME_CHECK_DIRTY_CELLS
+   void CheckDirtyCellUpdates(void);
+#endif
+   void ClassifyGridTilesNearCoasts(void);
+   void SetGridTilesActiveAlongProfiles(void);
+   void ExpandActiveWindow(int const, int const);
+   void GetActiveWindow(bool const, int&, int&, int&, int&) const;
    int nLocateSeaAndCoasts(int&);
-   int nLocateFloodAndCoasts(void);
+   int nLocateFloodAndCoasts(int const);
+   void FinishLocateFlood(void);
    int nAssignAllCoastalLandforms(void);
    int nAssignNonCoastlineLandforms(void);
    int nDoAllPropagateWaves(void);
@@ -1553,19 +1719,27 @@ private:
    int nDoCliffCollapse(int const, CRWCliff*, double&, double&, double&, double&, double&);
    int nDoCliffCollapseDeposition(int const, CRWCliff const*, double const, double const, double const, double const);
    int nUpdateGrid(void);
+   int nDoTask(int const);
+   int nDoTaskItem(int const, int const);
 
    // Lower-level simulation routines
    void FindAllSeaCells(void);
-   int FindAllInundatedCells(void);
+   int FindAllInundatedCells(int const);
+   bool bUpdateSeaMaskIncrementally(void);
+   bool bCanRemoveFromSeaMask(int const, int const) const;
+   void SetSeaCellsFromMask(void);
+   void FloodFillSeaFromEdges(void);
    void FloodFillSea(int const, int const);
-   void FloodFillLand(int const, int const);
+   void FloodFillLand(int const, int const, int const);
    int nTraceCoastLine(unsigned int const, int const, int const, vector<bool>*, vector<CGeom2DIPoint> const*);
    int nTraceAllCoasts(int&);
-   int nTraceFloodCoastLine(unsigned int const, int const, int const, vector<bool>*, vector<CGeom2DIPoint> const*);
-   int nTraceAllFloodCoasts(void);
-   void DoCoastCurvature(int const, int const);
+   int nTraceFloodCoastLine(unsigned int const, int const, int const, vector<bool>*, vector<CGeom2DIPoint> const*, int const);
+   int nTraceAllFloodCoasts(int const);
+   void DoCoastCurvature(int const, int const, CCoastHistory*, CCoastHistory*);
    int nCreateAllProfilesAndCheckForIntersection(void);
    int nCreateAllProfiles(void);
+   void PlaceCoastNormalProfiles(int const, int&);
+   bool bReplayProfilePlacement(int const, int&);
    void CreateNaturalCapeNormalProfiles(int const, int&, int const, vector<bool>*, vector<pair<int, double>> const*);
    void CreateRestOfNormalProfiles(int const, int&, int const, double const, vector<bool>*, vector<pair<int, double>> const*);
    void CreateInterventionProfiles(int const, int& /*, int const*/);
@@ -1593,11 +1767,16 @@ private:
    static CGeom2DPoint PtChooseEndPoint(int const, CGeom2DPoint const*, CGeom2DPoint const*, double const, double const, double const, double const);
    int nGetCoastNormalEndPoint(int const, int const, int const, CGeom2DPoint const*, double const, CGeom2DPoint*, CGeom2DIPoint*);
    int nLandformToGrid(int const, int const);
-   int nCalcWavePropertiesOnProfile(int const, int const, int const, vector<double>*, vector<double>*, vector<double>*, vector<double>*, vector<bool>*);
-   int nGetThisProfileElevationVectorsForCShore(int const, int const, int const, vector<double>*, vector<double>*, vector<double>*);
-   int nCreateCShoreInfile(int const, int const, int const, int const, int const, int const, int const, int const, int const, int const, int const, int const, int const, double const, double const, double const, double const, double const, double const, double const, double const, vector<double> const*, vector<double> const*, vector<double> const*);
-   int nReadCShoreOutput(int const, string const*, int const, int const, vector<double> const*, vector<double>*);   
-   static void InterpolateCShoreOutput(vector<double> const*, int const, vector<double> const*, vector<double> const*, vector<double> const*, vector<double> const*, vector<double> const*, vector<double>*, vector<double>*, vector<double>*, vector<double>*);
+   int nCalcWavePropertiesOnProfile(int const, int const, int const, vector<double>*, vector<double>*, vector<double>*, vector<double>*, vector<bool>*, ostream*);
+   int nCalcWavePropertiesUsingCShoreBatches(int const);
+   int nCalcWavePropertiesOnProfileFromCShoreBatch(int const, int const, vector<double>*, vector<double>*, vector<double>*, vector<double>*, vector<bool>*, ostream*);
+   int nInterpolateCShoreOutputOnProfile(int const, int const, int const, int, CCShoreWorkspace*, ostream*);
+   void CalcWavePropertiesFromCShoreOutput(int const, int const, CCShoreWorkspace*, vector<double>*, vector<double>*, vector<double>*, vector<double>*, vector<bool>*);
+   void SetWavePropertiesOnProfile(int const, int const, vector<double> const*, vector<double> const*, vector<bool> const*, vector<double> const*, int const, double const, double const, double const, vector<double>*, vector<double>*, vector<double>*, vector<double>*, vector<bool>*);
+   int nGetThisProfileElevationVectorsForCShore(int const, int const, int const, vector<double>*, vector<double>*, vector<double>*, ostream*);
+   int nCreateCShoreInfile(string const*, int const, int const, int const, int const, int const, int const, int const, int const, int const, int const, int const, int const, int const, double const, double const, double const, double const, double const, double const, double const, double const, vector<double> const*, vector<double> const*, vector<double> const*, ostream*);
+   int nReadCShoreOutput(int const, string const*, int const, int const, vector<double> const*, vector<double>*, ostream*);   
+   static void InterpolateCShoreOutput(vector<double> const*, int const, vector<double> const*, vector<double> const*, vector<double> const*, vector<double> const*, vector<double> const*, vector<double>*, vector<double>*, vector<double>*, vector<double>*, vector<double>*);
    static double dCalcWaveAngleToCoastNormal(double const, double const, int const);
    void CalcCoastTangents(int const);
    void InterpolateWavePropertiesBetweenProfiles(int const, int const, int const);
@@ -1605,7 +1784,18 @@ private:
    // void InterpolateWavePropertiesToCells(int const, int const, int const);
    void ModifyBreakingWavePropertiesWithinShadowZoneToCoastline(int const, int const);
    static double dCalcCurvature(int const, CGeom2DPoint const*, CGeom2DPoint const*, CGeom2DPoint const*);
-   void CalcD50AndFillWaveCalcHoles(void);
+   void CalcD50AndFillWaveCalcHoles(bool const);
+   bool bAreWavesOffshoreEverywhere(void);
+   int nCheckSeaMask(void);
+   int nCheckCoastHistory(void);
+   int nCheckWavePropertiesOnProfiles(int const);
+   int nCheckWaveCache(void);
+   int nCheckActiveWindowHoleFill(void);
+   void CalcAllPolygonD50(void);
+   void StartWaveCache(CWaveCache*);
+   void SaveWaveCache(CWaveCache*);
+   bool bCanReuseWaveCache(void);
+   void RestoreWaveCache(void);
    int nDoAllShadowZones(void);
    static bool bOnOrOffShoreAndUpOrDownCoast(double const, double const, int const, bool&);
    static CGeom2DIPoint PtiFollowWaveAngle(CGeom2DIPoint const*, double const, double&);
@@ -1641,6 +1831,7 @@ private:
    int nMarkBoundingBoxEdgeCells(void);
    bool bCheckRasterGISOutputFormat(void);
    bool bCheckVectorGISOutputFormat(void);
+   void AdvanceGISSave(void);
    bool bSaveAllRasterGISFiles(void);
    bool bSaveAllVectorGISFiles(void);
    bool bIsWithinValidGrid(int const, int const) const;
@@ -1727,6 +1918,8 @@ private:
    void CalcSavitzkyGolayCoeffs(void);
    CGeomLine LSmoothCoastSavitzkyGolay(CGeomLine*, int const, int const) const;
    CGeomLine LSmoothCoastRunningMean(CGeomLine*) const;
+   CGeom2DPoint PtSmoothCoastPointSavitzkyGolay(CGeomLine*, int const, int const, int const) const;
+   CGeom2DPoint PtSmoothCoastPointRunningMean(CGeomLine*, int const) const;
    vector<double> dVSmoothProfileSlope(vector<double>*) const;
    // vector<double> dVCalCGeomProfileSlope(vector<CGeom2DPoint>*, vector<double>*);         // TODO 007 Why was this removed?
    // vector<double> dVSmoothProfileSavitzkyGolay(vector<double>*, vector<double>*);         // TODO 007 was this removed?
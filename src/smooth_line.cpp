@@ -76,9 +76,6 @@ void CSimulation::CalcSavitzkyGolayCoeffs(void)
 //===============================================================================================================================
 CGeomLine CSimulation::LSmoothCoastSavitzkyGolay(CGeomLine* pLineIn, int const nStartEdge, int const nEndEdge) const
 {
-   // Note that m_nCoastSmoothWindow must be odd (have already checked this)
-   int nHalfWindow = m_nCoastSmoothWindow / 2;
-
    // Make a copy of the unsmoothed CGeomLine (must be blank)
    int nSize = pLineIn->nGetSize();
    CGeomLine LTemp;
@@ -86,103 +83,116 @@ CGeomLine CSimulation::LSmoothCoastSavitzkyGolay(CGeomLine* pLineIn, int const n
 
    // Apply the Savitzky-Golay smoothing filter
    for (int i = 0; i < nSize; i++)
+      LTemp[i] = PtSmoothCoastPointSavitzkyGolay(pLineIn, i, nStartEdge, nEndEdge);
+
+   // Return the smoothed CGeomLine
+   return LTemp;
+}
+
+//===============================================================================================================================
+//! Returns point i of a CGeomLine coastline vector, smoothed using a Savitzky-Golay filter. The result depends only on the unsmoothed points within half a smoothing window of point i
+//===============================================================================================================================
+CGeom2DPoint CSimulation::PtSmoothCoastPointSavitzkyGolay(CGeomLine* pLineIn, int const i, int const nStartEdge, int const nEndEdge) const
+{
+   // Note that m_nCoastSmoothWindow must be odd (have already checked this)
+   int nHalfWindow = m_nCoastSmoothWindow / 2;
+   int nSize = pLineIn->nGetSize();
+   CGeom2DPoint PtSmoothed;
+
+   if (i < nHalfWindow)
    {
-      if (i < nHalfWindow)
+      // For the first few values of LTemp, just apply a running mean with a variable-sized window
+      int nTmpWindow = 0;
+      double dWindowTotX = 0, dWindowTotY = 0;
+      for (int j = -nHalfWindow; j < m_nCoastSmoothWindow - nHalfWindow; j++)
       {
-         // For the first few values of LTemp, just apply a running mean with a variable-sized window
-         int nTmpWindow = 0;
-         double dWindowTotX = 0, dWindowTotY = 0;
-         for (int j = -nHalfWindow; j < m_nCoastSmoothWindow - nHalfWindow; j++)
-         {
-            int k = i + j;
-
-            if ((k > 0) && (k < nSize))
-            {
-               dWindowTotX += pLineIn->dGetXAt(k);
-               dWindowTotY += pLineIn->dGetYAt(k);
-               nTmpWindow++;
-            }
-         }
+         int k = i + j;
 
-         switch (nStartEdge)
+         if ((k > 0) && (k < nSize))
          {
-         case NORTH:
-         case SOUTH:
-            // Don't apply the filter in the Y direction
-            LTemp[i] = CGeom2DPoint(dWindowTotX / nTmpWindow, pLineIn->dGetYAt(i));
-            //                LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
-            //                LTemp.SetYAt(i, pLineIn->dGetYAt(i));
-            break;
-
-         case EAST:
-         case WEST:
-            // Don't apply the filter in the X direction
-            LTemp[i] = CGeom2DPoint(pLineIn->dGetXAt(i), dWindowTotY / nTmpWindow);
-            //                LTemp.SetXAt(i, pLineIn->dGetXAt(i));
-            //                LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
-            break;
+            dWindowTotX += pLineIn->dGetXAt(k);
+            dWindowTotY += pLineIn->dGetYAt(k);
+            nTmpWindow++;
          }
       }
-      else if (i >= (nSize - nHalfWindow))
+
+      switch (nStartEdge)
       {
-         // For the last few values of PtVTemp, just apply a running mean with a variable-sized window
-         int nTmpWindow = 0;
-         double dWindowTotX = 0, dWindowTotY = 0;
-         for (int j = -nHalfWindow; j < m_nCoastSmoothWindow - nHalfWindow; j++)
-         {
-            int k = i + j;
-
-            if ((k > 0) && (k < nSize))
-            {
-               dWindowTotX += pLineIn->dGetXAt(k);
-               dWindowTotY += pLineIn->dGetYAt(k);
-               nTmpWindow++;
-            }
-         }
+      case NORTH:
+      case SOUTH:
+         // Don't apply the filter in the Y direction
+         PtSmoothed = CGeom2DPoint(dWindowTotX / nTmpWindow, pLineIn->dGetYAt(i));
+         //                LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
+         //                LTemp.SetYAt(i, pLineIn->dGetYAt(i));
+         break;
+
+      case EAST:
+      case WEST:
+         // Don't apply the filter in the X direction
+         PtSmoothed = CGeom2DPoint(pLineIn->dGetXAt(i), dWindowTotY / nTmpWindow);
+         //                LTemp.SetXAt(i, pLineIn->dGetXAt(i));
+         //                LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
+         break;
+      }
+   }
+   else if (i >= (nSize - nHalfWindow))
+   {
+      // For the last few values of PtVTemp, just apply a running mean with a variable-sized window
+      int nTmpWindow = 0;
+      double dWindowTotX = 0, dWindowTotY = 0;
+      for (int j = -nHalfWindow; j < m_nCoastSmoothWindow - nHalfWindow; j++)
+      {
+         int k = i + j;
 
-         switch (nEndEdge)
+         if ((k > 0) && (k < nSize))
          {
-         case NORTH:
-         case SOUTH:
-            // Don't apply the filter in the Y direction
-            LTemp[i] = CGeom2DPoint(dWindowTotX / nTmpWindow, pLineIn->dGetYAt(i));
-            //                LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
-            //                LTemp.SetYAt(i, pLineIn->dGetYAt(i));
-            break;
-
-         case EAST:
-         case WEST:
-            // Don't apply the filter in the X direction
-            LTemp[i] = CGeom2DPoint(pLineIn->dGetXAt(i), dWindowTotY / nTmpWindow);
-            //                LTemp.SetXAt(i, pLineIn->dGetXAt(i));
-            //                LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
-            break;
+            dWindowTotX += pLineIn->dGetXAt(k);
+            dWindowTotY += pLineIn->dGetYAt(k);
+            nTmpWindow++;
          }
       }
-      else
+
+      switch (nEndEdge)
+      {
+      case NORTH:
+      case SOUTH:
+         // Don't apply the filter in the Y direction
+         PtSmoothed = CGeom2DPoint(dWindowTotX / nTmpWindow, pLineIn->dGetYAt(i));
+         //                LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
+         //                LTemp.SetYAt(i, pLineIn->dGetYAt(i));
+         break;
+
+      case EAST:
+      case WEST:
+         // Don't apply the filter in the X direction
+         PtSmoothed = CGeom2DPoint(pLineIn->dGetXAt(i), dWindowTotY / nTmpWindow);
+         //                LTemp.SetXAt(i, pLineIn->dGetXAt(i));
+         //                LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
+         break;
+      }
+   }
+   else
+   {
+      // For all other PtVTemp values, calc Savitzky-Golay weighted values for both X and Y
+      for (int j = 0; j < m_nCoastSmoothWindow; j++)
       {
-         // For all other PtVTemp values, calc Savitzky-Golay weighted values for both X and Y
-         for (int j = 0; j < m_nCoastSmoothWindow; j++)
+         int k = i + m_VnSavGolIndexCoast[j + 1];
+         if ((k >= 0) && (k < nSize)) // Skip points that do not exist, note starts from 1
          {
-            int k = i + m_VnSavGolIndexCoast[j + 1];
-            if ((k >= 0) && (k < nSize)) // Skip points that do not exist, note starts from 1
-            {
-               double dX = LTemp.dGetXAt(i);
-               dX += m_VdSavGolFCRWCoast[j + 1] * pLineIn->dGetXAt(k);
-               //                LTemp.SetXAt(i, dX);
-
-               double dY = LTemp.dGetYAt(i);
-               dY += m_VdSavGolFCRWCoast[j + 1] * pLineIn->dGetYAt(k);
-
-               LTemp[i] = CGeom2DPoint(dX, dY);
-               //                LTemp.SetYAt(i, dY);
-            }
+            double dX = PtSmoothed.dGetX();
+            dX += m_VdSavGolFCRWCoast[j + 1] * pLineIn->dGetXAt(k);
+            //                LTemp.SetXAt(i, dX);
+
+            double dY = PtSmoothed.dGetY();
+            dY += m_VdSavGolFCRWCoast[j + 1] * pLineIn->dGetYAt(k);
+
+            PtSmoothed = CGeom2DPoint(dX, dY);
+            //                LTemp.SetYAt(i, dY);
          }
       }
    }
 
-   // Return the smoothed CGeomLine
-   return LTemp;
+   return PtSmoothed;
 }
 
 //===============================================================================================================================
@@ -190,10 +200,6 @@ CGeomLine CSimulation::LSmoothCoastSavitzkyGolay(CGeomLine* pLineIn, int const n
 //===============================================================================================================================
 CGeomLine CSimulation::LSmoothCoastRunningMean(CGeomLine* pLineIn) const
 {
-   // Note that m_nCoastSmoothWindow must be odd (have already checked this)
-   int nHalfWindow = m_nCoastSmoothWindow / 2;
-   double dHalfWindow = nHalfWindow;
-
    // Make a copy of the unsmoothed CGeomLine
    int nSize = pLineIn->nGetSize();
    CGeomLine LTemp;
@@ -201,102 +207,113 @@ CGeomLine CSimulation::LSmoothCoastRunningMean(CGeomLine* pLineIn) const
 
    // Apply the running mean smoothing filter, with a variable window size at both ends of the line
    for (int i = 0; i < nSize; i++)
+      LTemp[i] = PtSmoothCoastPointRunningMean(pLineIn, i);
+
+   // Return the smoothed CGeomLine
+   return LTemp;
+}
+
+//===============================================================================================================================
+//! Returns point i of a CGeomLine coastline vector, smoothed using a running mean. The result depends only on the unsmoothed points within half a smoothing window of point i
+//===============================================================================================================================
+CGeom2DPoint CSimulation::PtSmoothCoastPointRunningMean(CGeomLine* pLineIn, int const i) const
+{
+   // Note that m_nCoastSmoothWindow must be odd (have already checked this)
+   int nHalfWindow = m_nCoastSmoothWindow / 2;
+   double dHalfWindow = nHalfWindow;
+   int nSize = pLineIn->nGetSize();
+
+   // bool bNearStartEdge = false, bNearEndEdge = false;
+   // int consTant = 0;
+   double nTmpWindow = 0;
+   double dWindowTotX = 0, dWindowTotY = 0;
+   if (i < nHalfWindow)
    {
-      // bool bNearStartEdge = false, bNearEndEdge = false;
-      // int consTant = 0;
-      double nTmpWindow = 0;
-      double dWindowTotX = 0, dWindowTotY = 0;
-      if (i < nHalfWindow)
+      for (int j = 0; j <= i; j++)
       {
-         for (int j = 0; j <= i; j++)
-         {
-            // // For points at both ends of the coastline, use a smaller window
-            double weight = (dHalfWindow - abs(i - j)) / dHalfWindow;
-            dWindowTotX += pLineIn->dGetXAt(j) * weight;
-            dWindowTotY += pLineIn->dGetYAt(j) * weight;
-            nTmpWindow += weight;
-         }
+         // // For points at both ends of the coastline, use a smaller window
+         double weight = (dHalfWindow - abs(i - j)) / dHalfWindow;
+         dWindowTotX += pLineIn->dGetXAt(j) * weight;
+         dWindowTotY += pLineIn->dGetYAt(j) * weight;
+         nTmpWindow += weight;
       }
-      else if (i >= nSize - nHalfWindow)
+   }
+   else if (i >= nSize - nHalfWindow)
+   {
+      for (int j = nSize - 1; j >= i; j--)
       {
-         for (int j = nSize - 1; j >= i; j--)
-         {
-            double weight = (dHalfWindow - abs(i - j)) / dHalfWindow;
-            dWindowTotX += pLineIn->dGetXAt(j) * weight;
-            dWindowTotY += pLineIn->dGetYAt(j) * weight;
-            nTmpWindow += weight;
-         }
-      } // namespace name
-      else
+         double weight = (dHalfWindow - abs(i - j)) / dHalfWindow;
+         dWindowTotX += pLineIn->dGetXAt(j) * weight;
+         dWindowTotY += pLineIn->dGetYAt(j) * weight;
+         nTmpWindow += weight;
+      }
+   } // namespace name
+   else
+   {
+      for (int j = i - nHalfWindow; j < i + nHalfWindow; j++)
       {
-         for (int j = i - nHalfWindow; j < i + nHalfWindow; j++)
-         {
-            double weight = (dHalfWindow - abs(i - j)) / dHalfWindow;
-            dWindowTotX += pLineIn->dGetXAt(j) * weight;
-            dWindowTotY += pLineIn->dGetYAt(j) * weight;
-            nTmpWindow += weight;
-         }
+         double weight = (dHalfWindow - abs(i - j)) / dHalfWindow;
+         dWindowTotX += pLineIn->dGetXAt(j) * weight;
+         dWindowTotY += pLineIn->dGetYAt(j) * weight;
+         nTmpWindow += weight;
       }
-
-      // if (bNearStartEdge)
-      // {
-      //    // We are near the start edge
-      //    switch (nStartEdge)
-      //    {
-      //    case NORTH:
-      //       // Don't apply the filter in the y direction
-      //       LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
-      //       break;
-      //    case SOUTH:
-      //       // Don't apply the filter in the y direction
-      //       LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
-      //       break;
-
-      //    case EAST:
-      //       // Don't apply the filter in the x direction
-      //       LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
-      //       break;
-      //    case WEST:
-      //       // Don't apply the filter in the x direction
-      //       LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
-      //       break;
-      //    }
-      // }
-      // else if (bNearEndEdge)
-      // {
-      //    // We are near the end edge
-      //    switch (nEndEdge)
-      //    {
-      //    case NORTH:
-      //       // Don't apply the filter in the y direction
-      //       LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
-      //       break;
-      //    case SOUTH:
-      //       // Don't apply the filter in the y direction
-      //       LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
-      //       break;
-
-      //    case EAST:
-      //       // Don't apply the filter in the x direction
-      //       LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
-      //       break;
-      //    case WEST:
-      //       // Don't apply the filter in the x direction
-      //       LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
-      //       break;
-      //    }
-      // }
-      // else
-      // {
-      //    // Not near any edge, apply both x and y filters
-      LTemp[i] = CGeom2DPoint(dWindowTotX / nTmpWindow, dWindowTotY / nTmpWindow);
-      //          LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
-      //          LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
-      // }
    }
 
-   // Return the smoothed CGeomLine
-   return LTemp;
+   // if (bNearStartEdge)
+   // {
+   //    // We are near the start edge
+   //    switch (nStartEdge)
+   //    {
+   //    case NORTH:
+   //       // Don't apply the filter in the y direction
+   //       LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
+   //       break;
+   //    case SOUTH:
+   //       // Don't apply the filter in the y direction
+   //       LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
+   //       break;
+
+   //    case EAST:
+   //       // Don't apply the filter in the x direction
+   //       LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
+   //       break;
+   //    case WEST:
+   //       // Don't apply the filter in the x direction
+   //       LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
+   //       break;
+   //    }
+   // }
+   // else if (bNearEndEdge)
+   // {
+   //    // We are near the end edge
+   //    switch (nEndEdge)
+   //    {
+   //    case NORTH:
+   //       // Don't apply the filter in the y direction
+   //       LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
+   //       break;
+   //    case SOUTH:
+   //       // Don't apply the filter in the y direction
+   //       LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
+   //       break;
+
+   //    case EAST:
+   //       // Don't apply the filter in the x direction
+   //       LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
+   //       break;
+   //    case WEST:
+   //       // Don't apply the filter in the x direction
+   //       LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
+   //       break;
+   //    }
+   // }
+   // else
+   // {
+   //    // Not near any edge, apply both x and y filters
+   return CGeom2DPoint(dWindowTotX / nTmpWindow, dWindowTotY / nTmpWindow);
+   //          LTemp.SetXAt(i, dWindowTotX / static_cast<double>(nTmpWindow));
+   //          LTemp.SetYAt(i, dWindowTotY / static_cast<double>(nTmpWindow));
+   // }
 }
 
 //===============================================================================================================================
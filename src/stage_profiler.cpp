@@ -0,0 +1,175 @@
+/*!
+ *
+ * \file stage_profiler.cpp
+ * \brief CStageProfiler routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <cmath>
+using std::frexp;
+using std::ldexp;
+
+#include <iomanip>
+using std::fixed;
+using std::left;
+using std::right;
+using std::setprecision;
+using std::setw;
+
+#include <ostream>
+using std::endl;
+
+#include "cme.h"
+#include "stage_profiler.h"
+
+//! Indexed by stage, with an extra element for the whole timestep: the names used when writing stage times
+static char const* const pcStageName[NUM_STAGES + 1] =
+{
+   "Update interventions",
+   "External forcing",
+   "Initialise grid",
+   "Locate sea and coasts",
+   "Classify grid tiles",
+   "Assign landforms",
+   "Sediment input events",
+   "Create profiles",
+   "Create polygons",
+   "Propagate waves",
+   "Shore platform erosion",
+   "Cliff collapse",
+   "Beach erosion and deposition",
+   "Update grid",
+   "Locate flood and coasts",
+   "Save GIS files",
+   "Write text output",
+   "Whole timestep"
+};
+
+//! Constructor
+CStageProfiler::CStageProfiler(void)
+: m_VdThisTimestep(NUM_STAGES + 1, 0),
+  m_VbRanThisTimestep(NUM_STAGES + 1, false),
+  m_VulNumTimesteps(NUM_STAGES + 1, 0),
+  m_VdTotal(NUM_STAGES + 1, 0),
+  m_VdMin(NUM_STAGES + 1, 0),
+  m_VdMax(NUM_STAGES + 1, 0),
+  m_VVulHistogram(NUM_STAGES + 1, vector<unsigned long>(STAGE_PROFILER_HISTOGRAM_BINS, 0))
+{
+}
+
+//! Called at the start of each timestep, resets the per-timestep times and starts timing the whole timestep
+void CStageProfiler::StartTimestep(void)
+{
+   for (int n = 0; n <= NUM_STAGES; n++)
+   {
+      m_VdThisTimestep[n] = 0;
+      m_VbRanThisTimestep[n] = false;
+   }
+
+   m_tTimestepStart = steady_clock::now();
+}
+
+//! Called at the end of each timestep, folds this timestep's times into the whole-run statistics. This timestep's times remain available until StartTimestep() is next called
+void CStageProfiler::EndTimestep(void)
+{
+   AddStageTime(NUM_STAGES, std::chrono::duration<double>(steady_clock::now() - m_tTimestepStart).count());
+
+   for (int n = 0; n <= NUM_STAGES; n++)
+   {
+      if (! m_VbRanThisTimestep[n])
+         continue;
+
+      double dTime = m_VdThisTimestep[n];
+
+      if ((m_VulNumTimesteps[n] == 0) || (dTime < m_VdMin[n]))
+         m_VdMin[n] = dTime;
+
+      if ((m_VulNumTimesteps[n] == 0) || (dTime > m_VdMax[n]))
+         m_VdMax[n] = dTime;
+
+      m_VdTotal[n] += dTime;
+      m_VulNumTimesteps[n]++;
+
+      // Find the histogram bin: frexp() returns nExp such that the time in microseconds is at least 2^(nExp-1) and less than 2^nExp
+      int nExp = 0;
+      frexp(dTime * 1e6, &nExp);
+      int nBin = tMin(tMax(nExp, 0), STAGE_PROFILER_HISTOGRAM_BINS - 1);
+      m_VVulHistogram[n][nBin]++;
+   }
+}
+
+//! Returns an upper bound (s) on the dPercentile'th percentile of the time spent in stage nStage per timestep, using the histogram. This is the upper edge of the bin in which the percentile falls, limited by the longest time seen
+double CStageProfiler::dGetPercentile(int const nStage, double const dPercentile) const
+{
+   if (m_VulNumTimesteps[nStage] == 0)
+      return 0;
+
+   double dRank = dPercentile * static_cast<double>(m_VulNumTimesteps[nStage]) / 100;
+   unsigned long ulCumulative = 0;
+   for (int m = 0; m < STAGE_PROFILER_HISTOGRAM_BINS; m++)
+   {
+      ulCumulative += m_VVulHistogram[nStage][m];
+      if (static_cast<double>(ulCumulative) >= dRank)
+         return tMin(ldexp(1e-6, m), m_VdMax[nStage]);
+   }
+
+   return m_VdMax[nStage];
+}
+
+//! Writes the header row of the per-timestep stage times CSV file
+void CStageProfiler::WriteTimestepHeader(ostream& Stream) const
+{
+   Stream << "Elapsed (hours)";
+   for (int n = 0; n <= NUM_STAGES; n++)
+      Stream << "\t,\t" << pcStageName[n];
+   Stream << endl;
+}
+
+//! Writes this timestep's time (s) for each stage, and for the whole timestep, as the rest of a row of the per-timestep stage times CSV file
+void CStageProfiler::WriteTimestepTimes(ostream& Stream) const
+{
+   for (int n = 0; n <= NUM_STAGES; n++)
+      Stream << "\t,\t" << m_VdThisTimestep[n];
+   Stream << endl;
+}
+
+//! Writes the whole-run statistics for each stage
+void CStageProfiler::WriteStats(ostream& Stream) const
+{
+   double dWholeRun = m_VdTotal[NUM_STAGES];
+
+   Stream << endl;
+   Stream << "Main loop stage timings (wall clock, per timestep; percentiles are upper bounds)" << endl;
+   Stream << "--------------------------------------------------------------------------------" << endl;
+   Stream << left << setw(30) << "Stage" << right << setw(10) << "Timesteps" << setw(12) << "Total (s)" << setw(8) << "%" << setw(12) << "Mean (ms)" << setw(12) << "Min (ms)" << setw(12) << "Max (ms)" << setw(12) << "p50 (ms)" << setw(12) << "p90 (ms)" << setw(12) << "p99 (ms)" << endl;
+
+   Stream << fixed;
+   for (int n = 0; n <= NUM_STAGES; n++)
+   {
+      unsigned long ulNum = m_VulNumTimesteps[n];
+
+      Stream << left << setw(30) << pcStageName[n] << right << setw(10) << ulNum;
+      Stream << setprecision(3) << setw(12) << m_VdTotal[n];
+      Stream << setprecision(1) << setw(8) << (dWholeRun > 0 ? 100 * m_VdTotal[n] / dWholeRun : 0);
+      Stream << setprecision(3) << setw(12) << (ulNum > 0 ? 1000 * m_VdTotal[n] / static_cast<double>(ulNum) : 0);
+      Stream << setw(12) << 1000 * m_VdMin[n] << setw(12) << 1000 * m_VdMax[n];
+      Stream << setw(12) << 1000 * dGetPercentile(n, 50) << setw(12) << 1000 * dGetPercentile(n, 90) << setw(12) << 1000 * dGetPercentile(n, 99) << endl;
+   }
+}
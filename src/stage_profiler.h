@@ -0,0 +1,116 @@
+/*!
+ *
+ * \class CStageProfiler
+ * \brief Class used to time the stages of the main loop
+ * \details Each stage of the main loop in CSimulation::nDoSimulation() is timed, using a wall clock, by a CStageTimer object which lives for as long as the stage runs. Times for a stage are summed over the timestep, since some stages run more than once per timestep. At the end of each timestep, the per-stage totals are folded into whole-run statistics: the cumulative, minimum and maximum time, plus a histogram with power-of-two bins from which approximate percentiles are found. The histogram is of fixed size, so the memory needed does not grow with the length of the run. The profiler is always enabled
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file stage_profiler.h
+ * \brief Contains CStageProfiler and CStageTimer definitions
+ *
+ */
+
+#ifndef STAGE_PROFILER_H
+#define STAGE_PROFILER_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <chrono>
+using std::chrono::steady_clock;
+
+#include <ostream>
+using std::ostream;
+
+#include <vector>
+using std::vector;
+
+class CStageProfiler
+{
+private:
+   //! The wall clock time at which this timestep started
+   steady_clock::time_point m_tTimestepStart;
+
+   //! Indexed by stage, with an extra element for the whole timestep: the time (s) spent in this stage so far this timestep
+   vector<double> m_VdThisTimestep;
+
+   //! Indexed by stage, with an extra element for the whole timestep: has this stage run this timestep?
+   vector<bool> m_VbRanThisTimestep;
+
+   //! Indexed by stage, with an extra element for the whole timestep: the number of timesteps in which this stage has run
+   vector<unsigned long> m_VulNumTimesteps;
+
+   //! Indexed by stage, with an extra element for the whole timestep: the total time (s) spent in this stage during the run
+   vector<double> m_VdTotal;
+
+   //! Indexed by stage, with an extra element for the whole timestep: the shortest time (s) spent in this stage in any one timestep
+   vector<double> m_VdMin;
+
+   //! Indexed by stage, with an extra element for the whole timestep: the longest time (s) spent in this stage in any one timestep
+   vector<double> m_VdMax;
+
+   //! Indexed by stage, with an extra element for the whole timestep: the number of timesteps in which the time spent in this stage fell into each histogram bin. Bin n holds times of less than 2^n microseconds, and at least 2^(n-1) microseconds if n > 0
+   vector<vector<unsigned long> > m_VVulHistogram;
+
+   double dGetPercentile(int const, double const) const;
+
+public:
+   CStageProfiler(void);
+
+   void StartTimestep(void);
+   void EndTimestep(void);
+
+   //! Adds dTime seconds to the time spent in stage nStage during this timestep
+   void AddStageTime(int const nStage, double const dTime)
+   {
+      m_VdThisTimestep[nStage] += dTime;
+      m_VbRanThisTimestep[nStage] = true;
+   }
+
+   void WriteTimestepHeader(ostream&) const;
+   void WriteTimestepTimes(ostream&) const;
+   void WriteStats(ostream&) const;
+};
+
+class CStageTimer
+{
+private:
+   //! The profiler to which the elapsed time is added
+   CStageProfiler* m_pProfiler;
+
+   //! The stage being timed
+   int m_nStage;
+
+   //! The wall clock time at which the stage started
+   steady_clock::time_point m_tStart;
+
+   CStageTimer(CStageTimer const&);
+   CStageTimer& operator=(CStageTimer const&);
+
+public:
+   //! Constructor, starts timing stage nStage
+   CStageTimer(CStageProfiler* pProfiler, int const nStage)
+   : m_pProfiler(pProfiler),
+     m_nStage(nStage),
+     m_tStart(steady_clock::now())
+   {
+   }
+
+   //! Destructor, adds the elapsed time to the profiler. This is called however the stage's scope is left, including by an early return on error
+   ~CStageTimer(void)
+   {
+      m_pProfiler->AddStageTime(m_nStage, std::chrono::duration<double>(steady_clock::now() - m_tStart).count());
+   }
+};
+#endif // STAGE_PROFILER_H
@@ -0,0 +1,327 @@
+/*!
+ *
+ * \file task_graph.cpp
+ * \brief CTaskGraph routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <chrono>
+using std::chrono::steady_clock;
+
+#include "cme.h"
+#include "simulation.h"
+#include "task_graph.h"
+
+// The number of the thread which is running this code: zero for the thread which calls nRun() and nRunForEach(), one or more for the worker threads
+static thread_local int nThisThread = 0;
+
+//! Constructor
+CTaskGraph::CTaskGraph(void)
+: m_pSim(NULL),
+  m_nThreads(1),
+  m_bStopping(false),
+  m_bFailed(false),
+  m_nNumUnfinished(0),
+  m_nNumRunning(0),
+  m_nItemTask(0),
+  m_nNumItems(0),
+  m_nNextItem(0)
+{
+}
+
+//! Destructor, stops the worker threads
+CTaskGraph::~CTaskGraph(void)
+{
+   {
+      unique_lock<mutex> Lock(m_Mutex);
+      m_bStopping = true;
+   }
+   m_Condition.notify_all();
+
+   for (unsigned int n = 0; n < m_VThread.size(); n++)
+      m_VThread[n].join();
+}
+
+//! Sets the simulation whose tasks are to be run, and starts the worker threads. nThreads is the total number of threads including the one which will call nRun(), if it is one or less then tasks are run one after the other
+void CTaskGraph::Start(CSimulation* pSim, int const nThreads)
+{
+   m_pSim = pSim;
+   m_nThreads = tMax(nThreads, 1);
+
+   for (int n = 1; n < m_nThreads; n++)
+      m_VThread.push_back(thread(&CTaskGraph::WorkerLoop, this, n));
+}
+
+//! Returns the number of threads on which tasks are run, including the thread which calls nRun()
+int CTaskGraph::nGetNumThreads(void) const
+{
+   return m_nThreads;
+}
+
+//! Returns the number of the thread which calls this, from zero to one less than the number of threads. This may be used by tasks and items to pick things which belong to their thread
+int CTaskGraph::nGetThisThread(void)
+{
+   return nThisThread;
+}
+
+//! Removes all tasks, ready for the tasks of the next timestep to be added
+void CTaskGraph::Clear(void)
+{
+   m_VnTask.clear();
+   m_VnStage.clear();
+   m_VulReads.clear();
+   m_VulWrites.clear();
+}
+
+//! Adds a task, with the STAGE_* code of the stage to which it belongs, and the TASK_STATE_* bits for the state which it reads and writes
+void CTaskGraph::AddTask(int const nTask, int const nStage, unsigned long const ulReads, unsigned long const ulWrites)
+{
+   m_VnTask.push_back(nTask);
+   m_VnStage.push_back(nStage);
+   m_VulReads.push_back(ulReads);
+   m_VulWrites.push_back(ulWrites);
+}
+
+//! Runs all the tasks which have been added, then returns RTN_OK or, if any task failed, the RTN_* code of the earliest-added task which failed. Tasks which depend on a failed task are not run
+int CTaskGraph::nRun(void)
+{
+   int nTasks = static_cast<int>(m_VnTask.size());
+
+   m_VnRet.assign(nTasks, RTN_OK);
+   m_VdTime.assign(nTasks, 0);
+
+   if (m_nThreads <= 1)
+   {
+      // Just one thread, so run the tasks in the order in which they were added
+      for (int n = 0; n < nTasks; n++)
+      {
+         steady_clock::time_point tStart = steady_clock::now();
+         m_VnRet[n] = m_pSim->nDoTask(m_VnTask[n]);
+         m_VdTime[n] = std::chrono::duration<double>(steady_clock::now() - tStart).count();
+
+         if (m_VnRet[n] != RTN_OK)
+            return m_VnRet[n];
+      }
+
+      return RTN_OK;
+   }
+
+   // Find the dependencies between tasks: a task depends on an earlier task if either writes state which the other reads or writes
+   m_VVnDependent.assign(nTasks, vector<int>());
+   m_VnNumWaiting.assign(nTasks, 0);
+   for (int nLater = 0; nLater < nTasks; nLater++)
+   {
+      for (int nEarlier = 0; nEarlier < nLater; nEarlier++)
+      {
+         if ((m_VulWrites[nEarlier] & (m_VulReads[nLater] | m_VulWrites[nLater])) || (m_VulReads[nEarlier] & m_VulWrites[nLater]))
+         {
+            m_VVnDependent[nEarlier].push_back(nLater);
+            m_VnNumWaiting[nLater]++;
+         }
+      }
+   }
+
+   unique_lock<mutex> Lock(m_Mutex);
+
+   m_bFailed = false;
+   m_nNumUnfinished = nTasks;
+   m_nNumRunning = 0;
+   m_DnReady.clear();
+   for (int n = 0; n < nTasks; n++)
+   {
+      if (m_VnNumWaiting[n] == 0)
+         m_DnReady.push_back(n);
+   }
+   m_Condition.notify_all();
+
+   // This thread also runs tasks, until all have finished or (if a task has failed) until none are running
+   while ((m_nNumUnfinished > 0) && (! (m_bFailed && (m_nNumRunning == 0))))
+   {
+      if ((! m_bFailed) && (! m_DnReady.empty()))
+         RunReadyTask(Lock);
+      else
+         m_Condition.wait(Lock);
+   }
+
+   for (int n = 0; n < nTasks; n++)
+   {
+      if (m_VnRet[n] != RTN_OK)
+         return m_VnRet[n];
+   }
+
+   return RTN_OK;
+}
+
+//! Runs the task with TASK_* code nTask once for each of nItems items, by calling CSimulation::nDoTaskItem(). The items must be independent of one another, since they are spread over all the threads. Returns RTN_OK or, if any item failed, the RTN_* code of the lowest-numbered item which failed. Items which are not started when an item fails are not run
+int CTaskGraph::nRunForEach(int const nTask, int const nItems)
+{
+   if (m_nThreads <= 1)
+   {
+      // Just one thread, so run the items in order
+      for (int n = 0; n < nItems; n++)
+      {
+         int nRet = m_pSim->nDoTaskItem(nTask, n);
+         if (nRet != RTN_OK)
+            return nRet;
+      }
+
+      return RTN_OK;
+   }
+
+   m_VnItemRet.assign(nItems, RTN_OK);
+
+   unique_lock<mutex> Lock(m_Mutex);
+
+   m_bFailed = false;
+   m_nItemTask = nTask;
+   m_nNumItems = nItems;
+   m_nNextItem = 0;
+   m_nNumUnfinished = nItems;
+   m_nNumRunning = 0;
+   m_Condition.notify_all();
+
+   // This thread also runs items, until all have finished or (if an item has failed) until none are running
+   while ((m_nNumUnfinished > 0) && (! (m_bFailed && (m_nNumRunning == 0))))
+   {
+      if (bIsItemReady())
+         RunNextItem(Lock);
+      else
+         m_Condition.wait(Lock);
+   }
+
+   m_nNumItems = 0;
+
+   // Items are started in order, so every item before one which failed has been run
+   for (int n = 0; n < nItems; n++)
+   {
+      if (m_VnItemRet[n] != RTN_OK)
+         return m_VnItemRet[n];
+   }
+
+   return RTN_OK;
+}
+
+//! Run by each worker thread: waits for tasks to become ready, or for items to be run, and runs them, until the graph is destroyed
+void CTaskGraph::WorkerLoop(int const nThread)
+{
+   nThisThread = nThread;
+
+   unique_lock<mutex> Lock(m_Mutex);
+
+   while (true)
+   {
+      while ((! m_bStopping) && (! bIsItemReady()) && (m_bFailed || m_DnReady.empty()))
+         m_Condition.wait(Lock);
+
+      if (m_bStopping)
+         return;
+
+      if (bIsItemReady())
+         RunNextItem(Lock);
+      else
+         RunReadyTask(Lock);
+   }
+}
+
+//! Takes a task which is ready to run, and runs it with the mutex unlocked. Then marks it as finished, and any tasks which were waiting only for this one as ready
+void CTaskGraph::RunReadyTask(unique_lock<mutex>& Lock)
+{
+   int nThis = m_DnReady.front();
+   m_DnReady.pop_front();
+   m_nNumRunning++;
+
+   Lock.unlock();
+
+   steady_clock::time_point tStart = steady_clock::now();
+   int nRet = m_pSim->nDoTask(m_VnTask[nThis]);
+   double dTime = std::chrono::duration<double>(steady_clock::now() - tStart).count();
+
+   Lock.lock();
+
+   m_VnRet[nThis] = nRet;
+   m_VdTime[nThis] = dTime;
+   m_nNumRunning--;
+   m_nNumUnfinished--;
+
+   if (nRet != RTN_OK)
+   {
+      // Don't start any more tasks
+      m_bFailed = true;
+      m_DnReady.clear();
+   }
+   else
+   {
+      for (unsigned int n = 0; n < m_VVnDependent[nThis].size(); n++)
+      {
+         int nLater = m_VVnDependent[nThis][n];
+         if (--m_VnNumWaiting[nLater] == 0)
+            m_DnReady.push_back(nLater);
+      }
+   }
+
+   m_Condition.notify_all();
+}
+
+//! Returns true if, during a call to nRunForEach(), there is an item which has not yet been started and no item has failed
+bool CTaskGraph::bIsItemReady(void) const
+{
+   return ((! m_bFailed) && (m_nNextItem < m_nNumItems));
+}
+
+//! Takes the next item and runs it with the mutex unlocked, then marks it as finished
+void CTaskGraph::RunNextItem(unique_lock<mutex>& Lock)
+{
+   int nThis = m_nNextItem++;
+   m_nNumRunning++;
+
+   Lock.unlock();
+
+   int nRet = m_pSim->nDoTaskItem(m_nItemTask, nThis);
+
+   Lock.lock();
+
+   m_VnItemRet[nThis] = nRet;
+   m_nNumRunning--;
+   m_nNumUnfinished--;
+
+   // Don't start any more items if this one failed
+   if (nRet != RTN_OK)
+      m_bFailed = true;
+
+   m_Condition.notify_all();
+}
+
+//! Returns the number of tasks which have been added
+int CTaskGraph::nGetNumTasks(void) const
+{
+   return static_cast<int>(m_VnTask.size());
+}
+
+//! Returns the STAGE_* code of the stage to which a task belongs
+int CTaskGraph::nGetTaskStage(int const nTask) const
+{
+   return m_VnStage[nTask];
+}
+
+//! Returns the wall clock time (s) taken by a task during the last call to nRun(), this is zero if the task was not run
+double CTaskGraph::dGetTaskTime(int const nTask) const
+{
+   return m_VdTime[nTask];
+}
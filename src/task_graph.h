@@ -0,0 +1,142 @@
+/*!
+ *
+ * \class CTaskGraph
+ * \brief Class used to run the tasks of part of a timestep, overlapping those which are independent of one another
+ * \details Each task is added together with the parts of the simulation's state which it reads and which it writes, given as bit masks of TASK_STATE_* codes. A task depends on every earlier-added task which writes something that it reads or writes, or which reads something that it writes. This gives a dependency graph with no cycles, in which a task may start as soon as all the tasks on which it depends have finished. The tasks are run on a pool of threads which is kept for the whole run; the thread which calls nRun() is one of these. If there is only one thread then the tasks are run one after the other in the order in which they were added, which is useful for debugging. Either way, since tasks which touch the same state always run in the order in which they were added, the results are the same. The same pool of threads is also used by nRunForEach(), which runs one task for each of a number of independent items, e.g. for every profile
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file task_graph.h
+ * \brief Contains CTaskGraph definitions
+ *
+ */
+
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <condition_variable>
+using std::condition_variable;
+
+#include <deque>
+using std::deque;
+
+#include <mutex>
+using std::mutex;
+using std::unique_lock;
+
+#include <thread>
+using std::thread;
+
+#include <vector>
+using std::vector;
+
+class CSimulation;         // Forward declaration
+
+class CTaskGraph
+{
+private:
+   //! The simulation whose tasks are run, by calling CSimulation::nDoTask()
+   CSimulation* m_pSim;
+
+   //! The number of threads on which tasks are run, including the thread which calls nRun()
+   int m_nThreads;
+
+   //! Set when the worker threads are to finish
+   bool m_bStopping;
+
+   //! Set if a task has failed during this call to nRun(), no more tasks are then started
+   bool m_bFailed;
+
+   //! The number of tasks which have not yet finished during this call to nRun()
+   int m_nNumUnfinished;
+
+   //! The number of tasks which are running now
+   int m_nNumRunning;
+
+   //! The worker threads
+   vector<thread> m_VThread;
+
+   //! Protects all of the values which are used while running tasks
+   mutex m_Mutex;
+
+   //! Used to wake the worker threads when a task is ready, and the thread which called nRun() when a task has finished
+   condition_variable m_Condition;
+
+   //! Indexed by task: the TASK_* code, which is passed to CSimulation::nDoTask()
+   vector<int> m_VnTask;
+
+   //! Indexed by task: the STAGE_* code of the stage to which the task belongs
+   vector<int> m_VnStage;
+
+   //! Indexed by task: the TASK_STATE_* bits for the state which the task reads
+   vector<unsigned long> m_VulReads;
+
+   //! Indexed by task: the TASK_STATE_* bits for the state which the task writes
+   vector<unsigned long> m_VulWrites;
+
+   //! Indexed by task: the later tasks which depend on this task
+   vector<vector<int> > m_VVnDependent;
+
+   //! Indexed by task: the number of tasks on which this task depends, and which have not yet finished
+   vector<int> m_VnNumWaiting;
+
+   //! Indexed by task: the RTN_* code which the task returned
+   vector<int> m_VnRet;
+
+   //! Indexed by task: the wall clock time (s) taken by the task
+   vector<double> m_VdTime;
+
+   //! The tasks which are ready to run
+   deque<int> m_DnReady;
+
+   //! The TASK_* code which is run for each item during a call to nRunForEach()
+   int m_nItemTask;
+
+   //! The number of items during this call to nRunForEach()
+   int m_nNumItems;
+
+   //! The next item to be run during this call to nRunForEach()
+   int m_nNextItem;
+
+   //! Indexed by item: the RTN_* code which was returned for the item
+   vector<int> m_VnItemRet;
+
+   CTaskGraph(CTaskGraph const&);
+   CTaskGraph& operator=(CTaskGraph const&);
+
+   void WorkerLoop(int const);
+   void RunReadyTask(unique_lock<mutex>&);
+   bool bIsItemReady(void) const;
+   void RunNextItem(unique_lock<mutex>&);
+
+public:
+   CTaskGraph(void);
+   ~CTaskGraph(void);
+
+   void Start(CSimulation*, int const);
+   int nGetNumThreads(void) const;
+   static int nGetThisThread(void);
+
+   void Clear(void);
+   void AddTask(int const, int const, unsigned long const, unsigned long const);
+   int nRun(void);
+   int nRunForEach(int const, int const);
+
+   int nGetNumTasks(void) const;
+   int nGetTaskStage(int const) const;
+   double dGetTaskTime(int const) const;
+};
+#endif // TASK_GRAPH_H
@@ -0,0 +1,174 @@
+/*!
+ *
+ * \file timestep_arena.cpp
+ * \brief CTimestepArena routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <stdlib.h>
+
+#if defined CME_COUNT_HEAP_ALLOCATIONS
+#include <atomic>
+using std::atomic;
+using std::memory_order_relaxed;
+
+#include <new>
+using std::bad_alloc;
+#endif
+
+#include "cme.h"
+#include "timestep_arena.h"
+
+#if defined CME_COUNT_HEAP_ALLOCATIONS
+//! The number of calls to operator new (including operator new[], which calls it) since the program started
+static atomic<unsigned long> ulNumHeapAllocations(0);
+
+//! Replaces the global operator new, so that heap allocations can be counted
+void* operator new(size_t ulBytes)
+{
+   ulNumHeapAllocations.fetch_add(1, memory_order_relaxed);
+
+   void* pv = malloc(ulBytes > 0 ? ulBytes : 1);
+   if (pv == NULL)
+      throw bad_alloc();
+
+   return pv;
+}
+
+//! Replaces the global operator delete, to match operator new
+void operator delete(void* pv) noexcept
+{
+   free(pv);
+}
+#endif
+
+//! Constructor
+CTimestepArena::CTimestepArena(void)
+: m_nThisChunk(0),
+  m_ulThisChunkUsed(0),
+  m_ulThisTimestepBytes(0),
+  m_ulHighWaterBytes(0),
+  m_ulNumAllocations(0),
+  m_ulNumChunkAllocations(0),
+  m_ulNumResets(0)
+{
+}
+
+//! Destructor
+CTimestepArena::~CTimestepArena(void)
+{
+   for (unsigned int n = 0; n < m_VpcChunk.size(); n++)
+      delete [] m_VpcChunk[n];
+}
+
+//! Returns ulBytes of memory from the arena, aligned to ARENA_ALIGNMENT. If the current chunk does not have room, moves on to the next chunk which was kept from an earlier timestep, or if there is none then creates a new chunk
+void* CTimestepArena::pvAllocate(size_t const ulBytes)
+{
+   size_t ulAlignedBytes = (ulBytes + ARENA_ALIGNMENT - 1) & ~static_cast<size_t>(ARENA_ALIGNMENT - 1);
+
+   while ((m_nThisChunk < m_VpcChunk.size()) && (m_ulThisChunkUsed + ulAlignedBytes > m_VulChunkBytes[m_nThisChunk]))
+   {
+      m_nThisChunk++;
+      m_ulThisChunkUsed = 0;
+   }
+
+   if (m_nThisChunk == m_VpcChunk.size())
+   {
+      // No chunk has room, so make a new one. Since new[] returns memory which is suitably aligned for any fundamental type, the start of the chunk is aligned to ARENA_ALIGNMENT
+      size_t ulChunkBytes = tMax(static_cast<size_t>(ARENA_CHUNK_SIZE), ulAlignedBytes);
+      m_VpcChunk.push_back(new char[ulChunkBytes]);
+      m_VulChunkBytes.push_back(ulChunkBytes);
+      m_ulNumChunkAllocations++;
+   }
+
+   void* pv = m_VpcChunk[m_nThisChunk] + m_ulThisChunkUsed;
+   m_ulThisChunkUsed += ulAlignedBytes;
+
+   m_ulThisTimestepBytes += ulAlignedBytes;
+   m_ulNumAllocations++;
+
+   return pv;
+}
+
+//! Makes all of the arena's memory available for reuse. Any objects which were constructed in the arena must already have been destroyed
+void CTimestepArena::Reset(void)
+{
+   if (m_ulThisTimestepBytes > m_ulHighWaterBytes)
+      m_ulHighWaterBytes = m_ulThisTimestepBytes;
+
+   m_nThisChunk = 0;
+   m_ulThisChunkUsed = 0;
+   m_ulThisTimestepBytes = 0;
+   m_ulNumResets++;
+}
+
+//! Returns the total number of allocations made from the arena
+unsigned long CTimestepArena::ulGetNumAllocations(void) const
+{
+   return m_ulNumAllocations;
+}
+
+//! Returns the total number of heap allocations made by the arena
+unsigned long CTimestepArena::ulGetNumChunkAllocations(void) const
+{
+   return m_ulNumChunkAllocations;
+}
+
+//! Returns the number of times that the arena has been reset
+unsigned long CTimestepArena::ulGetNumResets(void) const
+{
+   return m_ulNumResets;
+}
+
+//! Returns the largest number of bytes allocated from the arena in any one timestep
+size_t CTimestepArena::ulGetHighWaterBytes(void) const
+{
+   return tMax(m_ulHighWaterBytes, m_ulThisTimestepBytes);
+}
+
+//! Returns the number of bytes held by the arena
+size_t CTimestepArena::ulGetReservedBytes(void) const
+{
+   size_t ulBytes = 0;
+   for (unsigned int n = 0; n < m_VulChunkBytes.size(); n++)
+      ulBytes += m_VulChunkBytes[n];
+
+   return ulBytes;
+}
+
+//! Returns true if heap allocations are being counted, i.e. if CME_COUNT_HEAP_ALLOCATIONS is defined
+bool CTimestepArena::bIsCountingHeapAllocations(void)
+{
+#if defined CME_COUNT_HEAP_ALLOCATIONS
+   return true;
+#else
+   return false;
+#endif
+}
+
+//! Returns the number of heap allocations made since the program started, or zero if heap allocations are not being counted
+unsigned long CTimestepArena::ulGetNumHeapAllocations(void)
+{
+#if defined CME_COUNT_HEAP_ALLOCATIONS
+   return ulNumHeapAllocations.load(memory_order_relaxed);
+#else
+   return 0;
+#endif
+}
@@ -0,0 +1,96 @@
+/*!
+ *
+ * \class CTimestepArena
+ * \brief Class used to allocate per-timestep objects from a bump allocator
+ * \details Coast landforms and coast polygons are rebuilt from scratch every timestep. Rather than making a heap allocation for each of these objects, they are placement-constructed in memory taken from this arena, which is reset wholesale at the start of each timestep. The arena's memory is held in chunks which are kept between timesteps, so once the arena has grown to the size needed for a timestep it makes no further heap allocations
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file timestep_arena.h
+ * \brief Contains CTimestepArena definitions
+ *
+ */
+
+#ifndef TIMESTEP_ARENA_H
+#define TIMESTEP_ARENA_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <stddef.h>
+
+#include <new>
+
+#include <utility>
+using std::forward;
+
+#include <vector>
+using std::vector;
+
+class CTimestepArena
+{
+private:
+   //! The chunks of memory from which allocations are made, these are kept when the arena is reset
+   vector<char*> m_VpcChunk;
+
+   //! The size in bytes of each chunk
+   vector<size_t> m_VulChunkBytes;
+
+   //! The index of the chunk which is currently being allocated from
+   unsigned int m_nThisChunk;
+
+   //! The number of bytes used so far in the current chunk
+   size_t m_ulThisChunkUsed;
+
+   //! The number of bytes allocated from the arena since it was last reset
+   size_t m_ulThisTimestepBytes;
+
+   //! The largest number of bytes allocated from the arena in any one timestep
+   size_t m_ulHighWaterBytes;
+
+   //! The total number of allocations made from the arena
+   unsigned long m_ulNumAllocations;
+
+   //! The total number of heap allocations made by the arena, i.e. the number of chunks which it has created
+   unsigned long m_ulNumChunkAllocations;
+
+   //! The number of times that the arena has been reset
+   unsigned long m_ulNumResets;
+
+   CTimestepArena(CTimestepArena const&);
+   CTimestepArena& operator=(CTimestepArena const&);
+
+public:
+   CTimestepArena(void);
+   ~CTimestepArena(void);
+
+   void* pvAllocate(size_t const);
+   void Reset(void);
+
+   //! Constructs an object of class T in memory taken from the arena. The object must be destroyed by an explicit call to its destructor (not by delete) before the arena is next reset
+   template <class T, class... Args>
+   T* pNew(Args&&... args)
+   {
+      return new (pvAllocate(sizeof(T))) T(forward<Args>(args)...);
+   }
+
+   unsigned long ulGetNumAllocations(void) const;
+   unsigned long ulGetNumChunkAllocations(void) const;
+   unsigned long ulGetNumResets(void) const;
+   size_t ulGetHighWaterBytes(void) const;
+   size_t ulGetReservedBytes(void) const;
+
+   static bool bIsCountingHeapAllocations(void);
+   static unsigned long ulGetNumHeapAllocations(void);
+};
+#endif // TIMESTEP_ARENA_H
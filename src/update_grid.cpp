@@ -36,49 +36,63 @@ using std::endl;
 //===============================================================================================================================
 int CSimulation::nUpdateGrid(void)
 {
-   // Go through all cells in the raster grid and calculate some this-timestep totals
-   m_dThisIterTopElevMax = -DBL_MAX;
-   m_dThisIterTopElevMin = DBL_MAX;
-   for (int nX = 0; nX < m_nXGridMax; nX++)
-   {
-      for (int nY = 0; nY < m_nYGridMax; nY++)
-      {
-         if (m_pRasterGrid->m_Cell[nX][nY].bIsCoastline())
-            m_ulThisIterNumCoastCells++;
-
-         if (m_pRasterGrid->m_Cell[nX][nY].bIsInContiguousSea())
-         {
-            // Is a sea cell
-            m_dThisIterTotSeaDepth += m_pRasterGrid->m_Cell[nX][nY].dGetSeaDepth();
-         }
-
-         double dTopElev = m_pRasterGrid->m_Cell[nX][nY].dGetOverallTopElev();
-
-         // Get highest and lowest elevations of the top surface of the DEM
-         if (dTopElev > m_dThisIterTopElevMax)
-            m_dThisIterTopElevMax = dTopElev;
-
-         if (dTopElev < m_dThisIterTopElevMin)
-            m_dThisIterTopElevMin = dTopElev;
-      }
-   }
+   // Count the coast cells, a word (64 cells) at a time
+   m_ulThisIterNumCoastCells += m_pRasterGrid->ulCountFlag(CELL_FLAG_COASTLINE);
 
    // No sea cells?
    if (m_ulThisIterNumSeaCells == 0)
       // All land, assume this is an error
       return RTN_ERR_NOSEACELLS;
 
-   // Now go through all cells again and sort out suspended sediment load
+   // Now make a single pass through the raster grid, one word (64 cells) of the sea flag bit plane at a time. For every cell, get the highest and lowest elevations of the top surface of the DEM, and total the suspended sediment. For sea cells only, also total the sea depth and sort out suspended sediment load. Doing all of these in the same pass means that each field plane is read from memory once per timestep, rather than once per task
+   unsigned long ulNumCells = m_pRasterGrid->ulGetNumCells();
+   double const* pdSeaDepth = m_pRasterGrid->pdGetField(CELL_DBL_SEA_DEPTH);
+   double const* pdInterventionHeight = m_pRasterGrid->pdGetField(CELL_DBL_INTERVENTION_HEIGHT);
+   double const* pdSedTopElev = m_pRasterGrid->pdGetField(CELL_DBL_SEDIMENT_TOP_ELEV);
+   double* pdSuspSed = m_pRasterGrid->pdGetField(CELL_DBL_SUSP_SED);
+   diag_t* ptTotSuspSed = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_SUSP_SED);
+   uint64_t const* pulSea = m_pRasterGrid->pulGetFlagWords(CELL_FLAG_IN_CONTIGUOUS_SEA);
+   unsigned long ulNumWords = m_pRasterGrid->ulGetNumFlagWords();
+
    double dSuspPerSeaCell = m_dThisIterFineSedimentToSuspension / static_cast<double>(m_ulThisIterNumSeaCells);
-   for (int nX = 0; nX < m_nXGridMax; nX++)
+   double dTopElevMax = -DBL_MAX;
+   double dTopElevMin = DBL_MAX;
+   double dTotSeaDepth = 0;
+   double dTotSuspSed = 0;
+   for (unsigned long nWord = 0; nWord < ulNumWords; nWord++)
    {
-      for (int nY = 0; nY < m_nYGridMax; nY++)
+      uint64_t ulBits = pulSea[nWord];
+      unsigned long nEnd = tMin(nWord * 64 + 64, ulNumCells);
+      for (unsigned long n = nWord * 64; n < nEnd; n++, ulBits >>= 1)
       {
-         if (m_pRasterGrid->m_Cell[nX][nY].bIsInContiguousSea())
-            m_pRasterGrid->m_Cell[nX][nY].AddSuspendedSediment(dSuspPerSeaCell);
+         double dTopElev = pdSedTopElev[n] + pdInterventionHeight[n] + pdSeaDepth[n];
+
+         if (dTopElev > dTopElevMax)
+            dTopElevMax = dTopElev;
+
+         if (dTopElev < dTopElevMin)
+            dTopElevMin = dTopElev;
+
+         if (ulBits & 1)
+         {
+            dTotSeaDepth += pdSeaDepth[n];
+
+            pdSuspSed[n] += dSuspPerSeaCell;
+            ptTotSuspSed[n] += tToDiag(dSuspPerSeaCell);
+         }
+
+         dTotSuspSed += pdSuspSed[n];
       }
    }
 
+   m_dThisIterTopElevMax = dTopElevMax;
+   m_dThisIterTopElevMin = dTopElevMin;
+   m_dThisIterTotSeaDepth += dTotSeaDepth;
+
+   // Suspended sediment is not changed again before the start of next timestep, so this total can be used then
+   m_dEndIterSuspFineAllCells = dTotSuspSed;
+   m_bEndIterSuspFineAllCellsValid = true;
+
    // Go along each coastline and update the grid with landform attributes, ready for next timestep
    for (int i = 0; i < static_cast<int>(m_VCoast.size()); i++)
    {
@@ -1049,6 +1049,12 @@ string CSimulation::strListTSFiles(void) const
       strTmp.append(", ");
    }
 
+   if (m_bStageTimesTSSave)
+   {
+      strTmp.append(TIME_SERIES_STAGE_TIMES_CODE);
+      strTmp.append(", ");
+   }
+
    // Remove the trailing comma and space
    if (strTmp.size() > 2)
       strTmp.resize(strTmp.size() - 2);
@@ -1267,6 +1273,26 @@ bool CSimulation::bSetUpTSFiles(void)
       }
    }
 
+   if (m_bStageTimesTSSave)
+   {
+      // Main loop stage times
+      strTSFile = m_strOutPath;
+      strTSFile.append(TIME_SERIES_STAGE_TIMES_CODE);
+      strTSFile.append(CSVEXT);
+
+      // Open main loop stage times time-series CSV file
+      StageTimesTSStream.open(strTSFile.c_str(), ios::out | ios::trunc);
+      if (! StageTimesTSStream)
+      {
+         // Error, cannot open main loop stage times time-series file
+         cerr << ERR << "cannot open " << strTSFile << " for output" << endl;
+         return false;
+      }
+
+      // Unlike the other time series files, this one has a header row, since it has a column for each stage
+      m_StageProfiler.WriteTimestepHeader(StageTimesTSStream);
+   }
+
    return true;
 }
 
@@ -1844,6 +1870,20 @@ void CSimulation::CalcProcessStats(void)
       }
    }
 #endif
+
+   // Allocator statistics for the main loop
+   OutStream << "Allocations from per-timestep arena          \t: " << m_TimestepArena.ulGetNumAllocations() << " in " << m_TimestepArena.ulGetNumResets() << " timesteps" << endl;
+   OutStream << "Heap allocations made by per-timestep arena  \t: " << m_TimestepArena.ulGetNumChunkAllocations() << " (" << static_cast<double>(m_TimestepArena.ulGetReservedBytes()) / 1024.0 << " Kb reserved)" << endl;
+   OutStream << "Per-timestep arena high-water mark           \t: " << static_cast<double>(m_TimestepArena.ulGetHighWaterBytes()) / 1024.0 << " Kb" << endl;
+   OutStream << "Heap allocations in main loop                \t: ";
+   if (CTimestepArena::bIsCountingHeapAllocations())
+      OutStream << m_ulMainLoopHeapAllocations << " (" << static_cast<double>(m_ulMainLoopHeapAllocations) / static_cast<double>(tMax(m_ulTotTimestep, 1ul)) << " per timestep)" << endl;
+   else
+      OutStream << NA << " (build with CME_COUNT_HEAP_ALLOCATIONS)" << endl;
+
+   // Sediment layer storage at the end of the run
+   OutStream << "Compact grid tiles at end of run             \t: " << m_pRasterGrid->ulCountCompactTiles() << " of " << m_pRasterGrid->nGetNumTiles() << endl;
+   OutStream << "Sediment layer storage at end of run         \t: " << static_cast<double>(m_pRasterGrid->ulGetLayerBytes()) / 1024.0 << " Kb (" << static_cast<double>(m_pRasterGrid->ulGetNumCells() * static_cast<unsigned long>(m_pRasterGrid->nGetNumLayers()) * sizeof(CRWCellLayer)) / 1024.0 << " Kb if no tiles were compact)" << endl;
 }
 
 //===============================================================================================================================
@@ -2044,6 +2084,15 @@ string CSimulation::strGetErrorText(int const nErr)
    case RTN_ERR_CLIFF_NOT_IN_POLYGON:
       strErr = "cliff not in polygon";
       break;
+   case RTN_ERR_CSHORE_WORKER:
+      strErr = "could not start or communicate with a CShore worker process";
+      break;
+   case RTN_ERR_CSHORE_SCRATCH_DIR:
+      strErr = "creating a CShore scratch directory, or saving CShore output files";
+      break;
+   case RTN_ERR_OPTIMISATION_CHECK:
+      strErr = "an optimised calculation gave a different result from the calculation it replaces";
+      break;
    default:
       // should never get here
       strErr = "unknown error";
@@ -2081,6 +2130,7 @@ void CSimulation::DoSimulationEnd(int const nRtn)
          // If the run has actually started, then output all GIS files: this is very helpful in tracking down problems
          m_bSaveGISThisIter = true;
          m_nGISSave = 998; // Will get incremented to 999 when we write the files
+         AdvanceGISSave();
          bSaveAllRasterGISFiles();
          bSaveAllVectorGISFiles();
       }
@@ -28,6 +28,9 @@ You should have received a copy of the GNU General Public License along with thi
 #include <cstdio>
 using std::sprintf;
 
+#include <cstring>
+using std::memcmp;
+
 #include <sstream>
 using std::stringstream;
 
@@ -54,6 +57,14 @@ int nRound(double const d)
    return static_cast<int>((d < 0.0) ? ceil(d - 0.5) : floor(d + 0.5));
 }
 
+//===============================================================================================================================
+//! Returns true if two doubles have exactly the same bit pattern. This is for checks that an optimised calculation gives exactly the same result as the unoptimised one, for which a comparison within a tolerance (see bFPIsEqual) is too lax. Comparing the bits, rather than using ==, also makes the intent explicit; note that it treats 0 and -0 as different, and a NaN as equal to itself
+//===============================================================================================================================
+bool bBitwiseEqual(double const d1, double const d2)
+{
+   return (memcmp(&d1, &d2, sizeof(double)) == 0);
+}
+
 // bool bIsWhole(double d)
 // {
 //    // From http://answers.yahoo.com/question/index?qid=20110320132617AAMdb7u
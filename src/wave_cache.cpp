@@ -0,0 +1,77 @@
+/*!
+ *
+ * \file wave_cache.cpp
+ * \brief CWaveCache routines
+ * \details TODO 001 A more detailed description of these routines.
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ */
+
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <cmath>
+using std::fabs;
+using std::fmod;
+
+#include "cme.h"
+#include "wave_cache.h"
+
+//! Constructor
+CWaveCache::CWaveCache(void)
+: m_bValid(false),
+  m_bCalcPolygonD50(false),
+  m_nConsecutiveReuses(0),
+  m_ulNumComputed(0),
+  m_ulNumReused(0),
+  m_dSWL(0),
+  m_dBedChange(0),
+  m_nXMinActiveWindow(0),
+  m_nXMaxActiveWindow(0),
+  m_nYMinActiveWindow(0),
+  m_nYMaxActiveWindow(0)
+{
+}
+
+//! Marks the stored results as not valid, so that they will not be reused
+void CWaveCache::Invalidate(void)
+{
+   m_bValid = false;
+}
+
+//! Returns true if the stored results are valid
+bool CWaveCache::bIsValid(void) const
+{
+   return m_bValid;
+}
+
+//! Returns the number of timesteps in which waves were fully propagated, and the results stored
+unsigned long CWaveCache::ulGetNumComputed(void) const
+{
+   return m_ulNumComputed;
+}
+
+//! Returns the number of timesteps in which the stored results were reused
+unsigned long CWaveCache::ulGetNumReused(void) const
+{
+   return m_ulNumReused;
+}
+
+//! Returns the absolute difference (degrees) between two orientations, allowing for the wrap-around at 360 degrees
+double CWaveCache::dGetAngleDifference(double const dAngle1, double const dAngle2)
+{
+   double dDiff = fmod(fabs(dAngle1 - dAngle2), 360);
+   return tMin(dDiff, 360 - dDiff);
+}
@@ -0,0 +1,179 @@
+/*!
+ *
+ * \class CWaveCache
+ * \brief Class used to hold the results of the most recent full wave propagation, so that they can be reused
+ * \details Propagating waves is one of the costliest stages of each timestep. When the deep water wave forcing, the still water level, the coastlines and profiles, and the nearshore bathymetry have changed little since waves were last propagated, the result of doing so again would differ little from last time. So after each full wave propagation, its results (the wave values at each coast point, the shadow zone boundaries, and the wave, active zone and shadow zone values of each cell) are stored here, together with the inputs from which they were calculated. On later timesteps, CSimulation::bCanReuseWaveCache() compares this timestep's inputs with those stored here, and if every difference is within the user-supplied tolerances then the stored results are reused instead of propagating waves again. There is a limit to the number of consecutive timesteps for which the stored results may be reused
+ * \author David Favis-Mortlock
+ * \author Andres Payo
+
+ * \date 2024
+ * \copyright GNU General Public License
+ *
+ * \file wave_cache.h
+ * \brief Contains CWaveCache definitions
+ *
+ */
+
+#ifndef WAVE_CACHE_H
+#define WAVE_CACHE_H
+/*===============================================================================================================================
+
+This file is part of CoastalME, the Coastal Modelling Environment.
+
+CoastalME is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+===============================================================================================================================*/
+#include <stdint.h>
+
+#include <vector>
+using std::vector;
+
+#include "line.h"
+
+class CWaveCache
+{
+   friend class CSimulation;
+
+private:
+   //! Are the stored results valid, i.e. may they be reused?
+   bool m_bValid;
+
+   //! Did the stored wave propagation go on to calculate the D50 of each polygon?
+   bool m_bCalcPolygonD50;
+
+   //! The number of consecutive timesteps for which the stored results have been reused
+   int m_nConsecutiveReuses;
+
+   //! The number of timesteps in which waves were fully propagated, and the results stored
+   unsigned long m_ulNumComputed;
+
+   //! The number of timesteps in which the stored results were reused
+   unsigned long m_ulNumReused;
+
+   //! The still water level (m) when the stored results were calculated
+   double m_dSWL;
+
+   //! The largest change (m) in the total sediment thickness of any one cell since the stored results were calculated, summed over timesteps
+   double m_dBedChange;
+
+   //! The deep water wave heights (m) when the stored results were calculated: either one value which is used for all cells, or one value per wave station
+   vector<double> m_VdDeepWaterWaveHeight;
+
+   //! The deep water wave orientations (degrees) when the stored results were calculated, as for m_VdDeepWaterWaveHeight
+   vector<double> m_VdDeepWaterWaveAngle;
+
+   //! The deep water wave periods (s) when the stored results were calculated, as for m_VdDeepWaterWaveHeight
+   vector<double> m_VdDeepWaterWavePeriod;
+
+   //! For each coast, the number of points on the coastline
+   vector<int> m_VnCoastSize;
+
+   //! For each coast, the x co-ordinate (grid CRS) of the cell from which the coast starts
+   vector<int> m_VnCoastStartX;
+
+   //! For each coast, the y co-ordinate (grid CRS) of the cell from which the coast starts
+   vector<int> m_VnCoastStartY;
+
+   //! For each coast, the number of profiles
+   vector<int> m_VnNumProfiles;
+
+   //! For every profile on every coast, in sequence: the coast point at which the profile starts
+   vector<int> m_VnProfileCoastPoint;
+
+   //! For every profile on every coast, in sequence: is the profile OK?
+   vector<bool> m_VbProfileOK;
+
+   //! For every profile on every coast, in sequence: the deep water wave height (m) at the seaward end of the profile
+   vector<double> m_VdProfileDeepWaterWaveHeight;
+
+   //! For every profile on every coast, in sequence: the deep water wave orientation (degrees) at the seaward end of the profile
+   vector<double> m_VdProfileDeepWaterWaveAngle;
+
+   //! For every profile on every coast, in sequence: the deep water wave period (s) at the seaward end of the profile
+   vector<double> m_VdProfileDeepWaterWavePeriod;
+
+   //! For every point on every coast, in sequence: the distance to the breaking point (in cells)
+   vector<int> m_VnBreakingDistance;
+
+   //! For every point on every coast, in sequence: the breaking wave height (m)
+   vector<double> m_VdBreakingWaveHeight;
+
+   //! For every point on every coast, in sequence: the wave height at the coast (m)
+   vector<double> m_VdCoastWaveHeight;
+
+   //! For every point on every coast, in sequence: the breaking wave orientation (degrees)
+   vector<double> m_VdBreakingWaveAngle;
+
+   //! For every point on every coast, in sequence: the wave setup and surge (m)
+   vector<double> m_VdWaveSetupSurge;
+
+   //! For every point on every coast, in sequence: the run-up (m)
+   vector<double> m_VdRunUp;
+
+   //! For every point on every coast, in sequence: the depth of breaking (m)
+   vector<double> m_VdDepthOfBreaking;
+
+   //! For every point on every coast, in sequence: the wave energy at breaking
+   vector<double> m_VdWaveEnergyAtBreaking;
+
+   //! For each coast, the shadow zone boundaries
+   vector<vector<CGeomLine> > m_VVLShadowBoundary;
+
+   //! For each coast, the downdrift boundaries of the shadow zones
+   vector<vector<CGeomLine> > m_VVLShadowDowndriftBoundary;
+
+   //! For every cell, in the same order as the raster grid's field planes: the wave height (m)
+   vector<double> m_VdWaveHeight;
+
+   //! For every cell: the wave orientation (degrees)
+   vector<double> m_VdWaveAngle;
+
+   //! For every cell: the change in the total wave height (m) which was made by propagating waves. Before the results are stored, this holds the total wave height
+   vector<double> m_VdTotWaveHeightChange;
+
+   //! For every cell: the change in the total wave orientation (degrees) which was made by propagating waves. Before the results are stored, this holds the total wave orientation
+   vector<double> m_VdTotWaveAngleChange;
+
+   //! For every cell: the shadow zone number
+   vector<int> m_VnShadowZone;
+
+   //! For every cell: the downdrift zone number
+   vector<int> m_VnDownDriftZone;
+
+   //! The words of the raster grid's in-contiguous-sea flag bit plane
+   vector<uint64_t> m_VulSea;
+
+   //! The words of the raster grid's in-active-zone flag bit plane
+   vector<uint64_t> m_VulActiveZone;
+
+   //! The words of the raster grid's shadow zone boundary flag bit plane
+   vector<uint64_t> m_VulShadowBoundary;
+
+   //! The minimum x co-ordinate (grid CRS) of the active window when the stored results were calculated
+   int m_nXMinActiveWindow;
+
+   //! The maximum x co-ordinate (grid CRS) of the active window when the stored results were calculated
+   int m_nXMaxActiveWindow;
+
+   //! The minimum y co-ordinate (grid CRS) of the active window when the stored results were calculated
+   int m_nYMinActiveWindow;
+
+   //! The maximum y co-ordinate (grid CRS) of the active window when the stored results were calculated
+   int m_nYMaxActiveWindow;
+
+public:
+   CWaveCache(void);
+
+   void Invalidate(void);
+   bool bIsValid(void) const;
+
+   unsigned long ulGetNumComputed(void) const;
+   unsigned long ulGetNumReused(void) const;
+
+   static double dGetAngleDifference(double const, double const);
+};
+#endif // WAVE_CACHE_H
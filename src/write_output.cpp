@@ -526,6 +526,25 @@ void CSimulation::WriteStartRunDetails(void)
    OutStream << endl;
    OutStream << " Erode coast in alternate directions?                      \t: " << (m_bErodeShorePlatformAlternateDirection ? "Y" : "N") << endl;
    OutStream << " Size of moving window for calculating coastline curvature \t: " << m_nCoastCurvatureMovingWindowSize << endl;
+   OutStream << " Grid backend                                              \t: " << (m_bGridMemoryMapped ? "MMAP" : "RAM");
+   if (m_bGridMemoryMapped)
+      OutStream << " (see " << m_strOutPath << GRID_MMAP_FILE << ")";
+   OutStream << endl;
+   OutStream << " Max consecutive timesteps reusing wave propagation        \t: " << m_nMaxWaveReuses;
+   if (m_nMaxWaveReuses > 0)
+      OutStream << " (tolerances: height " << m_dWaveReuseHeightTolerance << " m, period " << m_dWaveReusePeriodTolerance << " s, orientation " << m_dWaveReuseAngleTolerance << " degrees, SWL " << m_dWaveReuseSWLTolerance << " m, sediment thickness " << m_dWaveReuseBedTolerance << " m)";
+   OutStream << endl;
+   OutStream << " Skip coastal stages when waves are off-shore everywhere?  \t: " << (m_bSkipOffshoreTimesteps ? "Y" : "N") << endl;
+   OutStream << " Threads for end-of-timestep tasks                         \t: ";
+   if (m_nTaskThreads == 0)
+      OutStream << "one per processor core";
+   else
+      OutStream << m_nTaskThreads;
+   if (m_nTaskThreads == 1)
+      OutStream << " (tasks are run one after the other)";
+   OutStream << endl;
+   OutStream << " Check optimised calculations?                             \t: " << (m_bCheckOptimisations ? "Y" : "N") << endl;
+   OutStream << " Fill wave calculation holes in active window only?        \t: " << (m_bFillHolesInActiveWindow ? "Y" : "N") << endl;
 
    OutStream << endl
              << endl;
@@ -1089,6 +1108,7 @@ int CSimulation::nWriteEndRunDetails(void)
       return (RTN_ERR_TIMESERIES_FILE_WRITE);
 
    // Save the values from the RasterGrid array into raster GIS files
+   AdvanceGISSave();
    if (! bSaveAllRasterGISFiles())
       return (RTN_ERR_RASTER_FILE_WRITE);
 
@@ -1207,6 +1227,44 @@ int CSimulation::nWriteEndRunDetails(void)
       OutStream << MASS_BALANCE_ERROR << endl;
    
    OutStream << endl;
+
+   // Now check the per-cell running totals (which are held as diag_t, so may be single precision) against the grand totals (which are always long double)
+   OutStream << "PER-CELL TOTALS CHECK (diagnostic fields held as " << (sizeof(diag_t) == sizeof(float) ? "float" : "double") << ")" << endl;
+   long double
+       ldCellTotPlatformErosion = 0,
+       ldCellTotCliffCollapseFine = 0,
+       ldCellTotCliffCollapseSand = 0,
+       ldCellTotCliffCollapseCoarse = 0;
+   diag_t const* ptTotPlatformErosion = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_ACTUAL_PLATFORM_EROSION);
+   diag_t const* ptTotCliffCollapseFine = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_FINE);
+   diag_t const* ptTotCliffCollapseSand = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_SAND);
+   diag_t const* ptTotCliffCollapseCoarse = m_pRasterGrid->ptGetDiagField(CELL_DIAG_TOT_CLIFF_COLLAPSE_COARSE);
+   for (unsigned long n = 0; n < m_ulNumCells; n++)
+   {
+      ldCellTotPlatformErosion += ptTotPlatformErosion[n];
+      ldCellTotCliffCollapseFine += ptTotCliffCollapseFine[n];
+      ldCellTotCliffCollapseSand += ptTotCliffCollapseSand[n];
+      ldCellTotCliffCollapseCoarse += ptTotCliffCollapseCoarse[n];
+   }
+
+   long double ldGTotPlatformErosion = m_ldGTotFineActualPlatformErosion + m_ldGTotSandActualPlatformErosion + m_ldGTotCoarseActualPlatformErosion;
+   OutStream << "Actual platform erosion, all size classes, sum of cells = " << ldCellTotPlatformErosion * m_dCellArea << " m^3" << endl;
+   if (! bFPIsEqual(ldGTotPlatformErosion, ldCellTotPlatformErosion, static_cast<long double>(MASS_BALANCE_TOLERANCE)))
+      OutStream << MASS_BALANCE_ERROR << endl;
+
+   OutStream << "Cliff collapse, fine, sum of cells                      = " << ldCellTotCliffCollapseFine * m_dCellArea << " m^3" << endl;
+   if (! bFPIsEqual(m_ldGTotCliffCollapseFine, ldCellTotCliffCollapseFine, static_cast<long double>(MASS_BALANCE_TOLERANCE)))
+      OutStream << MASS_BALANCE_ERROR << endl;
+
+   OutStream << "Cliff collapse, sand, sum of cells                      = " << ldCellTotCliffCollapseSand * m_dCellArea << " m^3" << endl;
+   if (! bFPIsEqual(m_ldGTotCliffCollapseSand, ldCellTotCliffCollapseSand, static_cast<long double>(MASS_BALANCE_TOLERANCE)))
+      OutStream << MASS_BALANCE_ERROR << endl;
+
+   OutStream << "Cliff collapse, coarse, sum of cells                    = " << ldCellTotCliffCollapseCoarse * m_dCellArea << " m^3" << endl;
+   if (! bFPIsEqual(m_ldGTotCliffCollapseCoarse, ldCellTotCliffCollapseCoarse, static_cast<long double>(MASS_BALANCE_TOLERANCE)))
+      OutStream << MASS_BALANCE_ERROR << endl;
+
+   OutStream << endl;
    
    long double ldActualTotalEroded = m_ldGTotFineActualPlatformErosion + m_ldGTotSandActualPlatformErosion + m_ldGTotCoarseActualPlatformErosion + m_ldGTotCliffCollapseFine + m_ldGTotCliffCollapseSand + m_ldGTotCliffCollapseCoarse + m_ldGTotCliffCollapseFineErodedDuringDeposition + m_ldGTotCliffCollapseSandErodedDuringDeposition + m_ldGTotCliffCollapseCoarseErodedDuringDeposition + m_ldGTotActualFineBeachErosion + m_ldGTotActualSandBeachErosion + m_ldGTotActualCoarseBeachErosion;
    OutStream << "Total sediment eroded (all processes)                  = " << ldActualTotalEroded * m_dCellArea << " m^3" << endl;
@@ -1280,6 +1338,11 @@ int CSimulation::nWriteEndRunDetails(void)
       LogStream << "On-profile average potential shore platform erosion      = " << (m_ulTotPotentialPlatformErosionOnProfiles > 0 ? m_dTotPotentialPlatformErosionOnProfiles / static_cast<double>(m_ulTotPotentialPlatformErosionOnProfiles) : 0) << " mm (n = " << m_ulTotPotentialPlatformErosionOnProfiles << ")" << endl;
       LogStream << "Between-profile average potential shore platform erosion = " << (m_ulTotPotentialPlatformErosionBetweenProfiles > 0 ? m_dTotPotentialPlatformErosionBetweenProfiles / static_cast<double>(m_ulTotPotentialPlatformErosionBetweenProfiles) : 0) << " mm (n = " << m_ulTotPotentialPlatformErosionBetweenProfiles << ")" << endl;
       LogStream << endl;
+
+      // Output the number of times that the sea was found by re-flooding from the grid edges, and by updating last timestep's sea incrementally
+      LogStream << "Sea re-flooded from grid edges                           = " << m_ulNumFullSeaFills << " times" << endl;
+      LogStream << "Sea updated incrementally                                = " << m_ulNumIncrementalSeaFills << " times" << endl;
+      LogStream << endl;
    }
    
 #if !defined RANDCHECK
@@ -1287,6 +1350,27 @@ int CSimulation::nWriteEndRunDetails(void)
    CalcTime(m_dSimDuration * 3600);
 #endif
 
+   // Show how long each stage of the main loop took
+   m_StageProfiler.WriteStats(OutStream);
+
+   // Show how often the results of a wave propagation were reused
+   if (m_nMaxWaveReuses > 0)
+   {
+      unsigned long ulComputed = m_WaveCache.ulGetNumComputed();
+      unsigned long ulReused = m_WaveCache.ulGetNumReused();
+      unsigned long ulTotal = ulComputed + ulReused;
+
+      OutStream << endl;
+      OutStream << "Waves propagated in " << ulComputed << " timesteps, wave propagation results reused in " << ulReused << " timesteps (" << std::fixed << setprecision(1) << (ulTotal > 0 ? 100 * static_cast<double>(ulReused) / static_cast<double>(ulTotal) : 0) << "% reused)" << endl;
+   }
+
+   // Show how many timesteps had waves off-shore everywhere
+   if (m_bSkipOffshoreTimesteps)
+   {
+      OutStream << endl;
+      OutStream << "Waves off-shore at every coast point in " << m_ulNumOffshoreTimesteps << " timesteps, profiles, polygons, wave propagation and sediment movement skipped in these" << endl;
+   }
+
    // Calculate statistics re. memory usage etc.
    CalcProcessStats();
    OutStream << endl